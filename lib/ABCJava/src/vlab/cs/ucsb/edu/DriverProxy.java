@@ -1,6 +1,7 @@
 package vlab.cs.ucsb.edu;
 
 import java.math.BigInteger;
+import java.nio.ByteBuffer;
 import java.util.Map;
 
 /**
@@ -31,7 +32,24 @@ public class DriverProxy {
 			COUNT_BOUND_EXACT(14),
 		REGEX_FLAG(15),						
 		OUTPUT_PATH(16), 					// not actively used through Java
-		SCRIPT_PATH(17);					// not actively used
+		SCRIPT_PATH(17),					// not actively used
+		CACHE_FILE(18),						// persistent result cache, disabled by default
+		CACHE_MAX_SIZE(19),					// cache size limit in megabytes
+		ENABLE_ARITHMETIC_QUANTIFIER_SCHEDULING(20),
+		DISABLE_ARITHMETIC_QUANTIFIER_SCHEDULING(21),	// default option
+		ENABLE_ALPHABET_COMPRESSION(22),
+		DISABLE_ALPHABET_COMPRESSION(23),				// default option
+		CHARACTER_WIDTH(24),				// bits per string character: 8, 16 or 21
+		ENABLE_TRACK_ORDERING(25),
+		DISABLE_TRACK_ORDERING(26),				// default option
+		INTEGER_WIDTH(27),				// bits of integers converted to and from strings, 64 by default
+		TIME_LIMIT(28),					// wall time limit of a query in milliseconds, 0 (no limit) by default
+		STATE_LIMIT(29),				// state limit of an automaton built by a query, 0 (no limit) by default
+		BDD_NODE_LIMIT(30),				// bdd node limit of an automaton built by a query, 0 (no limit) by default
+		APPROXIMATION_STATE_LIMIT(31),	// string values with more states are over-approximated, 0 (exact) by default
+		TRACE_FILE(32),					// chrome trace-event file, written when the driver is disposed
+		ENABLE_SATISFIABILITY_ONLY(33),	// isSatisfiable only decides sat/unsat, values are solved when queried
+		DISABLE_SATISFIABILITY_ONLY(34);	// default option
 
 		private final int value;
 
@@ -118,8 +136,29 @@ public class DriverProxy {
 
 	private native void setOption(final int option, final String value);
 
+	/**
+	 * @throws IllegalArgumentException if the constraint has a syntax error
+	 */
 	public native boolean isSatisfiable(final String constraint);
 
+	/**
+	 * Solves a UTF-8 encoded constraint stored in a direct buffer without copying it
+	 * 
+	 * @throws IllegalArgumentException if the buffer is not direct, the length is out of its range or the constraint has a syntax error
+	 */
+	public native boolean isSatisfiable(final ByteBuffer constraint, final int length);
+
+	/**
+	 * True if the last solve, count or model query stopped at a limit, its result is not valid
+	 */
+	public native boolean isUnknown();
+
+	/**
+	 * False if the last solve applied widening or a recorded over-approximation, counts are then upper bounds and
+	 * the lower bound is always 0. True means none of these was applied
+	 */
+	public native boolean isExact();
+
 	public native BigInteger countVariable(final String varName, final long bound);
 	
 	public native BigInteger countInts(final long bound);
@@ -140,6 +179,39 @@ public class DriverProxy {
 
 	public native BigInteger count(final long intBound, final long strBound, final byte[] modelCounter);
 
+	/**
+	 * Native model counter handles stay valid until they are disposed,
+	 * counting with a handle does not serialize the model counter again
+	 */
+	public native long getModelCounterHandle();
+
+	public native long getModelCounterHandleForVariable(final String varName);
+
+	public static native long loadModelCounterHandle(final byte[] modelCounter);
+
+	public static native void disposeModelCounterHandle(final long handle);
+
+	/**
+	 * Counts all queries with one native call. Buffers must be direct and use native byte order.
+	 * 
+	 * @param handles one model counter handle (long) per query, non-positive handles (unsat or unknown) count 0
+	 * @param bounds integer bound and string bound (long, long) per query, a negative bound excludes that part from the count
+	 * @throws IllegalArgumentException if a buffer is not direct or the number of queries is negative or out of range
+	 */
+	public static native BigInteger[] countBatch(final ByteBuffer handles, final ByteBuffer bounds, final int numOfQueries);
+
+	/**
+	 * Solves all constraints with one native call. Buffers must be direct and use native byte order.
+	 * 
+	 * @param constraints concatenated UTF-8 encoded constraints
+	 * @param lengths byte length (int) of each constraint
+	 * @return a model counter handle per constraint, 0 for unsatisfiable constraints and -1 for constraints whose
+	 *         solve stopped at a limit (unknown, see {@link #isUnknown()}); non-positive handles need
+	 *         not be disposed
+	 * @throws IllegalArgumentException if a buffer is not direct, a length is negative or out of range, or a constraint has a syntax error; no handles are returned then
+	 */
+	public native long[] solveBatch(final ByteBuffer constraints, final ByteBuffer lengths, final int numOfConstraints);
+
 	public native void printResultAutomaton();
 
 	public native void printResultAutomaton(String filePath);
@@ -153,4 +225,15 @@ public class DriverProxy {
 	public native void reset();
 
 	public native void dispose();
+
+	/**
+	 * Cumulative solver metrics of this process by name: results, stopped queries, cache hits and
+	 * misses, automata created, peak dfa states and per phase latency histograms
+	 */
+	public static native Map<String, Long> getMetrics();
+
+	/**
+	 * Solver metrics of this process in the Prometheus text exposition format
+	 */
+	public static native String getMetricsText();
 }
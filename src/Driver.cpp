@@ -11,19 +11,72 @@ namespace Vlab {
 
 //const Log::Level Driver::TAG = Log::DRIVER;
 bool Driver::IS_LOGGING_INITIALIZED = false;
+const int Driver::VLOG_LEVEL = 5;
 
 Driver::Driver()
     : script_(nullptr),
       symbol_table_(nullptr),
       constraint_information_(nullptr),
-      is_model_counter_cached_ { false } {
+      is_model_counter_cached_ { false },
+      cache_(nullptr),
+      num_of_cached_int_variables_ { 0 },
+      num_of_cached_str_variables_ { 0 },
+      is_solved_from_cache_ { false },
+      num_of_propagations_ { 0 },
+      is_solve_unknown_ { false },
+      is_query_unknown_ { false },
+      is_exact_ { true },
+      is_satisfiability_only_ { false },
+      satisfiability_only_time_ { 0 },
+      trace_id_ { 0 } {
 }
 
 Driver::~Driver() {
   delete symbol_table_;
-  delete script_;
   delete constraint_information_;
+  arena_.Release();
+  delete cache_;
   Theory::Automaton::CleanUp();
+  if (trace_id_ != 0) {
+    // a trace started by another driver keeps running
+    Util::Trace::Stop(trace_id_);
+  }
+}
+
+template <typename T>
+void Driver::RunPass(const Util::Metrics::Phase phase, T& pass) {
+  Util::Trace::Event event(Util::Metrics::get_name(phase), "pass");
+  Util::Metrics::Timer timer(phase);
+  pass.start();
+}
+
+template <typename T>
+T Driver::RunWithinBudget(std::function<T()> query, const T unknown_result, bool& is_unknown,
+                          const Util::Metrics::Phase phase) {
+  if (is_solve_unknown_) {
+    // the symbol table is left as it was when solving stopped
+    is_unknown = true;
+    return unknown_result;
+  }
+  Theory::StringAutomaton::Context::Scope string_scope(&string_context_);
+  if (Util::Budget::is_active()) {
+    return query();
+  }
+  is_unknown = false;
+  Util::Metrics::Timer timer(phase);
+  Util::Budget::Scope budget_scope(Option::Solver::TIME_LIMIT, Option::Solver::STATE_LIMIT,
+                                   Option::Solver::BDD_NODE_LIMIT);
+  try {
+    T result = query();
+    // constructions over the budget finish early with partial results
+    Util::Budget::Check();
+    return result;
+  } catch (const Util::BudgetExceeded& e) {
+    LOG(WARNING)<< "query stopped, result is unknown: " << e.what();
+    Util::Metrics::Increment(Util::Metrics::Counter::STOPPED_QUERIES);
+    is_unknown = true;
+    return unknown_result;
+  }
 }
 
 void Driver::InitializeLogger(int log_level) {
@@ -40,13 +93,17 @@ void Driver::error(const std::string& m) {
 }
 
 int Driver::Parse(std::istream* in) {
+  SMT::Arena::Scope arena_scope(&arena_);
+  Theory::StringAutomaton::Context::Scope string_scope(&string_context_);
+  Util::Metrics::Timer timer(Util::Metrics::Phase::PARSE);
   SMT::Scanner scanner(in);
   //  scanner.set_debug(trace_scanning);
   SMT::Parser parser(script_, scanner);
   //  parser.set_debug_level (trace_parsing);
   int res = parser.parse();
-  CHECK_EQ(0, res)<< "Syntax error";
-  
+  if (res != 0) {
+    LOG(ERROR)<< "syntax error";
+  }
   return res;
 }
 
@@ -67,25 +124,44 @@ void Driver::ast2dot(std::string file_name) {
 }
 
 void Driver::InitializeSolver() {
+  SMT::Arena::Scope arena_scope(&arena_);
+  Theory::StringAutomaton::Context::Scope string_scope(&string_context_);
+  Util::Metrics::Timer timer(Util::Metrics::Phase::INITIALIZE);
 
   symbol_table_ = new Solver::SymbolTable();
   constraint_information_ = new Solver::ConstraintInformation();
 
   Solver::Initializer initializer(script_, symbol_table_);
-  initializer.start();
+  RunPass(Util::Metrics::Phase::INITIALIZER, initializer);
 
   std::string output_root {"./output"};
 //   ast2dot(output_root + "/post_initializer.dot");
   // std::cin.get();
 
   Solver::SyntacticProcessor syntactic_processor(script_);
-  syntactic_processor.start();
+  RunPass(Util::Metrics::Phase::SYNTACTIC_PROCESSOR, syntactic_processor);
 
 //  ast2dot(output_root + "/post_syntactic_processor.dot");
   // std::cin.get();
 
+  // regular expressions are parsed with the syntax of the character width from here on
+  Theory::StringAutomaton::SetEncoding(Theory::StringEncoding(Option::Theory::CHARACTER_WIDTH));
+
   Solver::SyntacticOptimizer syntactic_optimizer(script_, symbol_table_);
-  syntactic_optimizer.start();
+  RunPass(Util::Metrics::Phase::SYNTACTIC_OPTIMIZER, syntactic_optimizer);
+
+  // string constants are final from here on, automata are built after this point
+  Theory::StringEncoding string_encoding (Option::Theory::CHARACTER_WIDTH);
+  bool is_alphabet_compressed = false;
+  if (Option::Solver::ENABLE_ALPHABET_COMPRESSION) {
+    Solver::AlphabetPartitioner alphabet_partitioner(script_, symbol_table_);
+    RunPass(Util::Metrics::Phase::ALPHABET_PARTITIONER, alphabet_partitioner);
+    if (alphabet_partitioner.is_compressible()) {
+      string_encoding = alphabet_partitioner.get_encoding();
+      is_alphabet_compressed = true;
+    }
+  }
+  Theory::StringAutomaton::SetEncoding(string_encoding);
 
 //  ast2dot(output_root + "/post_syntactic_optimizer.dot");
   //std::cin.get();
@@ -94,7 +170,7 @@ void Driver::InitializeSolver() {
   if (Option::Solver::ENABLE_EQUIVALENCE_CLASSES) {
     Solver::EquivalenceGenerator equivalence_generator(script_, symbol_table_);
     do {
-      equivalence_generator.start();
+      RunPass(Util::Metrics::Phase::EQUIVALENCE_GENERATOR, equivalence_generator);
 //      std::string filename = output_root + "/post_equivalence_" + std::to_string(count) + ".dot";
 //      ast2dot(filename);
 //      count++;
@@ -105,45 +181,131 @@ void Driver::InitializeSolver() {
 //   ast2dot(output_root + "/post_equivalence.dot");
 
   Solver::DependencySlicer dependency_slicer(script_, symbol_table_, constraint_information_);
-	dependency_slicer.start();
+  RunPass(Util::Metrics::Phase::DEPENDENCY_SLICER, dependency_slicer);
+
+  // components are keyed before the passes below rewrite them, automata over an alphabet compressed
+  // for the whole script are not shared
+  if (GetCache() != nullptr and not is_alphabet_compressed) {
+    Solver::ComponentCanonicalizer component_canonicalizer(script_, symbol_table_, constraint_information_);
+    RunPass(Util::Metrics::Phase::COMPONENT_CANONICALIZER, component_canonicalizer);
+    for (auto& entry : constraint_information_->get_canonical_forms()) {
+      component_keys_[entry.first] = GetCacheKey(entry.second);
+    }
+  }
 
 	//ast2dot(output_root + "/post_dependency_slicer.dot");
 
   if (Option::Solver::ENABLE_IMPLICATIONS) {
     Solver::ImplicationRunner implication_runner(script_, symbol_table_, constraint_information_);
-    implication_runner.start();
+    RunPass(Util::Metrics::Phase::IMPLICATION_RUNNER, implication_runner);
     //ast2dot(output_root + "/post_implication_runner.dot");
   }
 
   Solver::FormulaOptimizer formula_optimizer(script_, symbol_table_);
-  formula_optimizer.start();
+  RunPass(Util::Metrics::Phase::FORMULA_OPTIMIZER, formula_optimizer);
 
   //ast2dot(output_root + "/post_formula_optimizer.dot");
 	//std::cin.get();
 
   if (Option::Solver::ENABLE_SORTING_HEURISTICS) {
     Solver::ConstraintSorter constraint_sorter(script_, symbol_table_);
-    constraint_sorter.start();
+    RunPass(Util::Metrics::Phase::CONSTRAINT_SORTER, constraint_sorter);
   }
 }
 
 void Driver::Solve() {
+  SMT::Arena::Scope arena_scope(&arena_);
+  Theory::StringAutomaton::Context::Scope string_scope(&string_context_);
 //  TODO move arithmetic formula generation and string relation generation here to guide constraint solving better
 //
 //  Solver::ArithmeticFormulaGenerator arithmetic_formula_generator(script_, symbol_table_, constraint_information_);
 //  arithmetic_formula_generator.start();
 
-  Solver::ConstraintSolver constraint_solver(script_, symbol_table_, constraint_information_);
-  constraint_solver.start();
   is_model_counter_cached_ = false;
   model_counter_ = Solver::ModelCounter();
+  num_of_propagations_ = 0;
+  is_satisfiability_only_ = false;
+  is_solve_unknown_ = false;
+  is_query_unknown_ = false;
+  is_exact_ = true;
+  RunWithinBudget<bool>([this]() {
+    LoadCachedComponents();
+    if (is_solved_from_cache_) {
+      return true;
+    }
+    Solver::ConstraintSolver constraint_solver(script_, symbol_table_, constraint_information_);
+    RunPass(Util::Metrics::Phase::CONSTRAINT_SOLVER, constraint_solver);
+    num_of_propagations_ = constraint_solver.get_num_of_propagations();
+    is_exact_ = constraint_solver.is_exact();
+    DVLOG(VLOG_LEVEL) << "number of propagations: " << num_of_propagations_;
+    StoreCachedComponents();
+    return true;
+  }, false, is_solve_unknown_, Util::Metrics::Phase::SOLVE);
+  CountSolveResult();
+}
+
+void Driver::SolveSatisfiability(const std::set<std::string>& requested_variables) {
+  SMT::Arena::Scope arena_scope(&arena_);
+  Theory::StringAutomaton::Context::Scope string_scope(&string_context_);
+  is_model_counter_cached_ = false;
+  model_counter_ = Solver::ModelCounter();
+  num_of_propagations_ = 0;
+  is_satisfiability_only_ = false;
+  is_solve_unknown_ = false;
+  is_query_unknown_ = false;
+  is_exact_ = true;
+  RunWithinBudget<bool>([this, &requested_variables]() {
+    LoadCachedComponents();
+    if (is_solved_from_cache_) {
+      return true;
+    }
+    auto start = std::chrono::steady_clock::now();
+    Solver::ConstraintSolver constraint_solver(script_, symbol_table_, constraint_information_);
+    constraint_solver.set_satisfiability_only(true, requested_variables);
+    RunPass(Util::Metrics::Phase::CONSTRAINT_SOLVER, constraint_solver);
+    auto end = std::chrono::steady_clock::now();
+    num_of_propagations_ = constraint_solver.get_num_of_propagations();
+    is_exact_ = constraint_solver.is_exact();
+    is_satisfiability_only_ = true;
+    satisfiability_only_time_ = std::chrono::duration<double, std::milli>(end - start).count();
+    DVLOG(VLOG_LEVEL) << "satisfiability-only solve: " << satisfiability_only_time_ << " ms";
+    // values are refined by the full solve before the components are stored
+    return true;
+  }, false, is_solve_unknown_, Util::Metrics::Phase::SOLVE);
+  CountSolveResult();
+}
+
+std::map<std::string, unsigned long> Driver::GetMetrics() {
+  return Util::Metrics::GetSnapshot();
+}
+
+std::string Driver::GetMetricsText() {
+  return Util::Metrics::GetText();
+}
+
+bool Driver::is_unknown() const {
+  return is_solve_unknown_ or is_query_unknown_;
+}
+
+bool Driver::is_exact() const {
+  return is_exact_;
+}
+
+int Driver::get_num_of_propagations() const {
+  return num_of_propagations_;
 }
 
 bool Driver::is_sat() {
+  if (is_solve_unknown_) {
+    return false;
+  }
   return symbol_table_->isSatisfiable();
 }
 
 void Driver::GetModels(const unsigned long bound,const unsigned long num_models) {
+  EnsureSolved();
+  SMT::Arena::Scope arena_scope(&arena_);
+  Theory::StringAutomaton::Context::Scope string_scope(&string_context_);
 
 	LOG(FATAL) << "IMPLEMENT ME";
 
@@ -389,51 +551,87 @@ void Driver::GetModels(const unsigned long bound,const unsigned long num_models)
 }
 
 Theory::BigInteger Driver::CountVariable(const std::string var_name, const unsigned long bound) {
-  Theory::BigInteger projected_count, tuple_count;
-  tuple_count = GetModelCounterForVariable(var_name,false).Count(bound, bound);
-  projected_count = GetModelCounterForVariable(var_name,true).Count(bound, bound);
+  return RunWithinBudget<Theory::BigInteger>([this, &var_name, bound]() {
+    Theory::BigInteger projected_count, tuple_count;
+    tuple_count = GetModelCounterForVariable(var_name,false).Count(bound, bound);
+    projected_count = GetModelCounterForVariable(var_name,true).Count(bound, bound);
 
-	return (projected_count < tuple_count) ? projected_count : tuple_count;
+    return (projected_count < tuple_count) ? projected_count : tuple_count;
+  }, 0, is_query_unknown_, Util::Metrics::Phase::COUNT);
 }
 
 Theory::BigInteger Driver::CountInts(const unsigned long bound) {
-  auto i = GetModelCounter().CountInts(bound);
-  std::cout << i << std::endl;
-  return i;
+  return RunWithinBudget<Theory::BigInteger>([this, bound]() {
+    return GetModelCounter().CountInts(bound);
+  }, 0, is_query_unknown_, Util::Metrics::Phase::COUNT);
 }
 
 Theory::BigInteger Driver::CountStrs(const unsigned long bound) {
-  return GetModelCounter().CountStrs(bound);
+  return RunWithinBudget<Theory::BigInteger>([this, bound]() {
+    return GetModelCounter().CountStrs(bound);
+  }, 0, is_query_unknown_, Util::Metrics::Phase::COUNT);
 }
 
 Theory::BigInteger Driver::Count(const unsigned long int_bound, const unsigned long str_bound) {
-  return CountInts(int_bound) * CountStrs(str_bound);
+  return RunWithinBudget<Theory::BigInteger>([this, int_bound, str_bound]() {
+    return CountInts(int_bound) * CountStrs(str_bound);
+  }, 0, is_query_unknown_, Util::Metrics::Phase::COUNT);
+}
+
+Solver::CountBounds Driver::CountVariableWithBounds(const std::string var_name, const unsigned long bound) {
+  return MakeCountBounds(CountVariable(var_name, bound));
+}
+
+Solver::CountBounds Driver::CountWithBounds(const unsigned long int_bound, const unsigned long str_bound) {
+  return MakeCountBounds(Count(int_bound, str_bound));
 }
 
 Solver::ModelCounter& Driver::GetModelCounterForVariable(const std::string var_name, bool project) {
+  Theory::StringAutomaton::Context::Scope string_scope(&string_context_);
   auto variable = symbol_table_->get_variable(var_name);
   auto representative_variable = symbol_table_->get_representative_variable_of_at_scope(script_, variable);
 
+  const std::string cache_key = GetCacheKeyForVariable(representative_variable->getName(), project);
+  if (LoadCachedVariableCounter(cache_key, variable_model_counter_[representative_variable])) {
+    return variable_model_counter_[representative_variable];
+  }
+
+  // a counter that exceeds the budget is left empty
+  auto& model_counter = variable_model_counter_[representative_variable];
+  return *RunWithinBudget<Solver::ModelCounter*>([&]() {
 //  auto it = variable_model_counter_.find(representative_variable);
 //  if (it == variable_model_counter_.end()) {
     SetModelCounterForVariable(var_name,project);
     auto it = variable_model_counter_.find(representative_variable);
   //}
-  return it->second;
+    StoreCachedVariableCounter(cache_key, it->second);
+    return &it->second;
+  }, &model_counter, is_query_unknown_, Util::Metrics::Phase::COUNT);
 }
 
 Solver::ModelCounter& Driver::GetModelCounter() {
-  if (not is_model_counter_cached_) {
-    SetModelCounter();
-  }
-  return model_counter_;
+  // a counter that exceeds the budget is left empty
+  return *RunWithinBudget<Solver::ModelCounter*>([this]() {
+    if (not is_model_counter_cached_) {
+      SetModelCounter();
+    }
+    return &model_counter_;
+  }, &model_counter_, is_query_unknown_, Util::Metrics::Phase::COUNT);
 }
 
 void Driver::SetModelCounterForVariable(const std::string var_name, bool project) {
+  EnsureSolved();
   auto variable = symbol_table_->get_variable(var_name);
   auto representative_variable = symbol_table_->get_representative_variable_of_at_scope(script_, variable);
   Solver::Value_ptr var_value = nullptr;
 
+  // a variable loaded from the cache only has its projected value, its group is counted by the cached counter
+  auto cached_it = cached_variable_counters_.find(representative_variable);
+  if (not project and cached_it != cached_variable_counters_.end()) {
+    variable_model_counter_[representative_variable] = cached_it->second;
+    return;
+  }
+
   if(project) {
   	var_value = symbol_table_->get_projected_value_at_scope(script_, representative_variable);
   } else {
@@ -443,11 +641,8 @@ void Driver::SetModelCounterForVariable(const std::string var_name, bool project
   // test get_models
   //auto models = var_value->getStringAutomaton()->GetModelsWithinBound(100,-1);
 //  auto models = var_value->getBinaryIntAutomaton()->GetModelsWithinBound(100,-1);
-  if(variable_model_counter_.find(representative_variable) != variable_model_counter_.end()) {
-  	variable_model_counter_.erase(representative_variable);
-  }
-
-  auto& mc = variable_model_counter_[representative_variable];
+  // the counter is stored once it is complete, counting may stop at the budget of the query
+  Solver::ModelCounter mc;
   mc.set_use_sign_integers(Option::Solver::USE_SIGNED_INTEGERS);
   mc.set_count_bound_exact(Option::Solver::COUNT_BOUND_EXACT);
   if (var_value == nullptr) {
@@ -475,72 +670,88 @@ void Driver::SetModelCounterForVariable(const std::string var_name, bool project
         break;
       }
     }
+  variable_model_counter_[representative_variable] = mc;
   }
 
   /**
    * TODO add string part as well
    */
 void Driver::SetModelCounter() {
-  model_counter_.set_use_sign_integers(Option::Solver::USE_SIGNED_INTEGERS);
+  EnsureSolved();
+  // the counter is stored once it is complete, counting may stop at the budget of the query
+  Solver::ModelCounter model_counter;
+  model_counter.set_use_sign_integers(Option::Solver::USE_SIGNED_INTEGERS);
   int num_bin_var = 0;
   int num_str_var = 0;
 
   for (const auto &variable_entry : getSatisfyingVariables()) {
-    if (variable_entry.second == nullptr) {
+    if (variable_entry.second == nullptr or cached_variables_.find(variable_entry.first) != cached_variables_.end()) {
       continue;
     }
-    switch (variable_entry.second->getType()) {
-      case Vlab::Solver::Value::Type::BINARYINT_AUTOMATON: {
-        auto binary_auto = variable_entry.second->getBinaryIntAutomaton();
-        auto formula = binary_auto->GetFormula();
-        for (auto& el : formula->GetVariableCoefficientMap()) {
-          if (symbol_table_->get_variable_unsafe(el.first) != nullptr) {
-            ++num_bin_var;
-          }
-        }
-        model_counter_.add_symbolic_counter(binary_auto->GetSymbolicCounter());
-      }
-        break;
-      case Vlab::Solver::Value::Type::INT_CONSTANT: {
-        model_counter_.add_constant(variable_entry.second->getIntConstant());
-      }
-        break;
-      case Vlab::Solver::Value::Type::STRING_AUTOMATON: {
-				auto string_auto = variable_entry.second->getStringAutomaton();
-        auto formula = string_auto->GetFormula();
-        for (auto& el : formula->GetVariableCoefficientMap()) {
-          if (symbol_table_->get_variable_unsafe(el.first) != nullptr) {
-            ++num_str_var;
-          }
-        }
-				model_counter_.add_symbolic_counter(string_auto->GetSymbolicCounter());
-      }
-      	break;
-      case Vlab::Solver::Value::Type::INT_AUTOMATON: {
-        auto int_auto = variable_entry.second->getIntAutomaton();
-        model_counter_.add_symbolic_counter(int_auto->GetSymbolicCounter());
-      }
-        break;
-      default:
-        break;
-    }
+    AddValueToModelCounter(variable_entry.second, model_counter, num_bin_var, num_str_var);
   }
 
+  // components loaded from the cache are counted by their stored counters
+  model_counter.add_model_counter(cached_components_counter_);
+  num_bin_var += num_of_cached_int_variables_;
+  num_str_var += num_of_cached_str_variables_;
+
   int number_of_int_variables = symbol_table_->get_num_of_variables(SMT::Variable::Type::INT);
   int number_of_substituted_int_variables = symbol_table_->get_num_of_substituted_variables(script_,
                                                                                             SMT::Variable::Type::INT);
   int number_of_untracked_int_variables = number_of_int_variables - number_of_substituted_int_variables - num_bin_var;
-  model_counter_.set_num_of_unconstraint_int_vars(number_of_untracked_int_variables);
+  model_counter.set_num_of_unconstraint_int_vars(number_of_untracked_int_variables);
 
   int number_of_str_variables = symbol_table_->get_num_of_variables(SMT::Variable::Type::STRING);
   int number_of_substituted_str_variables = symbol_table_->get_num_of_substituted_variables(script_,
                                                                                             SMT::Variable::Type::STRING);
   int number_of_untracked_str_variables = number_of_str_variables - number_of_substituted_str_variables - num_str_var;
-  model_counter_.set_num_of_unconstraint_str_vars(number_of_untracked_str_variables);
+  model_counter.set_num_of_unconstraint_str_vars(number_of_untracked_str_variables);
 
+  model_counter_ = model_counter;
   is_model_counter_cached_ = true;
 }
 
+bool Driver::AddValueToModelCounter(Solver::Value_ptr value, Solver::ModelCounter& model_counter,
+                                    int& num_of_int_variables, int& num_of_str_variables) {
+  switch (value->getType()) {
+    case Vlab::Solver::Value::Type::BINARYINT_AUTOMATON: {
+      auto binary_auto = value->getBinaryIntAutomaton();
+      auto formula = binary_auto->GetFormula();
+      for (auto& el : formula->GetVariableCoefficientMap()) {
+        if (symbol_table_->get_variable_unsafe(el.first) != nullptr) {
+          ++num_of_int_variables;
+        }
+      }
+      model_counter.add_symbolic_counter(binary_auto->GetSymbolicCounter());
+    }
+      break;
+    case Vlab::Solver::Value::Type::INT_CONSTANT: {
+      model_counter.add_constant(value->getIntConstant());
+    }
+      break;
+    case Vlab::Solver::Value::Type::STRING_AUTOMATON: {
+      auto string_auto = value->getStringAutomaton();
+      auto formula = string_auto->GetFormula();
+      for (auto& el : formula->GetVariableCoefficientMap()) {
+        if (symbol_table_->get_variable_unsafe(el.first) != nullptr) {
+          ++num_of_str_variables;
+        }
+      }
+      model_counter.add_symbolic_counter(string_auto->GetSymbolicCounter());
+    }
+      break;
+    case Vlab::Solver::Value::Type::INT_AUTOMATON: {
+      auto int_auto = value->getIntAutomaton();
+      model_counter.add_symbolic_counter(int_auto->GetSymbolicCounter());
+    }
+      break;
+    default:
+      return false;
+  }
+  return true;
+}
+
 void Driver::inspectResult(Solver::Value_ptr value, std::string file_name) {
   std::ofstream outfile(file_name.c_str());
 
@@ -559,6 +770,7 @@ void Driver::inspectResult(Solver::Value_ptr value, std::string file_name) {
 }
 
 void Driver::printResult(Solver::Value_ptr value, std::ostream& out) {
+  Theory::StringAutomaton::Context::Scope string_scope(&string_context_);
   switch (value->getType()) {
     case Solver::Value::Type::STRING_AUTOMATON:
       value->getStringAutomaton()->toDotAscii(false, out);
@@ -574,11 +786,15 @@ void Driver::printResult(Solver::Value_ptr value, std::ostream& out) {
   }
 }
 
-std::map<SMT::Variable_ptr, Solver::Value_ptr> Driver::getSatisfyingVariables() const {
-  return symbol_table_->get_values_at_scope(script_);
+std::map<SMT::Variable_ptr, Solver::Value_ptr> Driver::getSatisfyingVariables() {
+  return RunWithinBudget<std::map<SMT::Variable_ptr, Solver::Value_ptr>>([this]() {
+    EnsureSolved();
+    return symbol_table_->get_values_at_scope(script_);
+  }, std::map<SMT::Variable_ptr, Solver::Value_ptr>(), is_query_unknown_, Util::Metrics::Phase::MODELS);
 }
 
 std::map<std::string, std::string> Driver::getSatisfyingExamples() {
+  Theory::StringAutomaton::Context::Scope string_scope(&string_context_);
   std::map<std::string, std::string> results;
   for (auto& variable_entry : getSatisfyingVariables()) {
     if (Solver::Value::Type::BINARYINT_AUTOMATON == variable_entry.second->getType()) {
@@ -604,6 +820,7 @@ std::map<std::string, std::string> Driver::getSatisfyingExamples() {
 }
 
 std::map<std::string, std::string> Driver::getSatisfyingExamplesRandom() {
+  Theory::StringAutomaton::Context::Scope string_scope(&string_context_);
   std::map<std::string, std::string> results;
 
 
@@ -631,6 +848,7 @@ std::map<std::string, std::string> Driver::getSatisfyingExamplesRandom() {
 }
 
 std::map<std::string, std::string> Driver::getSatisfyingExamplesRandomBounded(const int bound) {
+  Theory::StringAutomaton::Context::Scope string_scope(&string_context_);
   std::map<std::string, std::string> results;
 
   // check to see if we've cached automata/projected-automata for variables first
@@ -678,13 +896,436 @@ void Driver::reset() {
 	}
 	cached_bounded_values_.clear();
 
+  variable_model_counter_.clear();
+  model_counter_ = Solver::ModelCounter();
+  is_model_counter_cached_ = false;
+
+  component_keys_.clear();
+  uncached_components_.clear();
+  variable_cache_keys_.clear();
+  cached_variables_.clear();
+  cached_variable_counters_.clear();
+  cached_components_counter_ = Solver::ModelCounter();
+  num_of_cached_int_variables_ = 0;
+  num_of_cached_str_variables_ = 0;
+  is_solved_from_cache_ = false;
+  is_satisfiability_only_ = false;
+  is_solve_unknown_ = false;
+  is_query_unknown_ = false;
+  is_exact_ = true;
+
   delete symbol_table_;
-  delete script_;
-  script_ = nullptr;
+  delete constraint_information_;
   symbol_table_ = nullptr;
+  constraint_information_ = nullptr;
+  // destroys the script with every other node of the arena
+  script_ = nullptr;
+  arena_.Release();
 //  LOG(INFO) << "Driver reseted.";
 }
 
+Util::PersistentCache* Driver::GetCache() {
+  if (Option::Solver::CACHE_FILE.empty()) {
+    return nullptr;
+  }
+  if (cache_ == nullptr or cache_->get_file_path() != Option::Solver::CACHE_FILE) {
+    delete cache_;
+    cache_ = new Util::PersistentCache(Option::Solver::CACHE_FILE);
+  }
+  cache_->set_max_size(static_cast<std::size_t>(Option::Solver::CACHE_MAX_SIZE) * 1024 * 1024);
+  return cache_;
+}
+
+/**
+ * Key of a canonical form: its hash and the options that change results or counts
+ */
+std::string Driver::GetCacheKey(const Solver::CanonicalForm& form) {
+  std::stringstream ss;
+  ss << "abc:" << form.hash.str()
+     << ":o" << Option::Solver::USE_SIGNED_INTEGERS << Option::Solver::USE_MULTITRACK_AUTO
+     << Option::Solver::COUNT_BOUND_EXACT << Option::Solver::ENABLE_LEN_IMPLICATIONS
+     << Option::Solver::FORCE_DNF_FORMULA << Option::Solver::ENABLE_ARITHMETIC_QUANTIFIER_SCHEDULING << ":r" << Util::RegularExpression::DEFAULT
+     << ":w" << Option::Theory::CHARACTER_WIDTH << ":i" << Option::Theory::INTEGER_WIDTH;
+  return ss.str();
+}
+
+/**
+ * Key of a variable of a cached component, empty for other variables
+ */
+std::string Driver::GetCacheKeyForVariable(const std::string var_name, bool project) {
+  auto it = variable_cache_keys_.find(var_name);
+  if (it == variable_cache_keys_.end()) {
+    return "";
+  }
+  return it->second + (project ? ":p" : ":t");
+}
+
+void Driver::LoadCachedComponents() {
+  if (GetCache() == nullptr or component_keys_.empty()) {
+    return;
+  }
+  auto components = Solver::ComponentCanonicalizer::GetTopLevelComponents(script_, constraint_information_);
+  Solver::ComponentCanonicalizer component_canonicalizer(script_, symbol_table_, constraint_information_);
+  std::set<SMT::Visitable_ptr> loaded_components;
+  for (auto component : components) {
+    auto key_it = component_keys_.find(component);
+    if (key_it == component_keys_.end()) {
+      continue;
+    }
+    // variables are named after the component as rewritten by the passes that run after it is keyed
+    auto form = component_canonicalizer.canonicalize(component);
+    bool is_cacheable = true;
+    for (auto& var_name : form.variables) {
+      auto variable = symbol_table_->get_variable_unsafe(var_name);
+      // values set by the equivalence rules before solving do not follow from the component
+      if (variable == nullptr or symbol_table_->get_value_at_scope(script_, variable) != nullptr) {
+        is_cacheable = false;
+        break;
+      }
+    }
+    if (not is_cacheable) {
+      continue;
+    }
+
+    for (auto& entry : form.renaming) {
+      variable_cache_keys_[entry.first] = key_it->second + ":" + entry.second;
+    }
+    if (LoadCachedComponent(component, form)) {
+      loaded_components.insert(component);
+      Util::Metrics::Increment(Util::Metrics::Counter::CACHE_HITS);
+    } else {
+      uncached_components_.insert(component);
+      Util::Metrics::Increment(Util::Metrics::Counter::CACHE_MISSES);
+    }
+  }
+
+  if (loaded_components.empty()) {
+    return;
+  }
+  if (loaded_components.size() == components.size()) {
+    is_solved_from_cache_ = true;
+    DVLOG(VLOG_LEVEL) << "script is answered from cache";
+    return;
+  }
+
+  // several components are only found under the root conjunction, the solver visits the others
+  auto assert_command = dynamic_cast<SMT::Assert_ptr>(script_->command_list->front());
+  auto term_list = dynamic_cast<SMT::And_ptr>(assert_command->term)->term_list;
+  term_list->erase(std::remove_if(term_list->begin(), term_list->end(), [&loaded_components](SMT::Term_ptr term) {
+    return loaded_components.find(term) != loaded_components.end();
+  }), term_list->end());
+  DVLOG(VLOG_LEVEL) << loaded_components.size() << " of " << components.size() << " components are answered from cache";
+}
+
+/**
+ * An entry keeps the canonical hash of the rewritten component, the number of variables tracked by its
+ * values, the counters of its variable groups and, for each variable in canonical order, the index of
+ * its group counter and its projected value
+ */
+bool Driver::LoadCachedComponent(SMT::Visitable_ptr component, const Solver::CanonicalForm& form) {
+  std::string entry;
+  if (not GetCache()->Get(component_keys_[component], entry)) {
+    return false;
+  }
+
+  std::vector<Solver::Value_ptr> values;
+  std::vector<int> group_indices;
+  std::vector<Solver::ModelCounter> group_counters;
+  int num_of_int_variables = 0;
+  int num_of_str_variables = 0;
+  try {
+    std::stringstream is(entry);
+    cereal::BinaryInputArchive ar(is);
+    std::string hash;
+    ar(hash);
+    if (hash != form.hash.str()) {
+      // rewritten differently, its variables may not be named the same
+      return false;
+    }
+    ar(num_of_int_variables, num_of_str_variables, group_counters);
+    for (auto& var_name : form.variables) {
+      int group_index = -1;
+      ar(group_index);
+      if (group_index >= static_cast<int>(group_counters.size())) {
+        throw cereal::Exception("group counter is out of range");
+      }
+      group_indices.push_back(group_index);
+      values.push_back(LoadCachedValue(ar, var_name));
+    }
+  } catch (const cereal::Exception& e) {
+    LOG(WARNING)<< "ignoring malformed cache entry: " << e.what();
+    for (auto value : values) {
+      delete value;
+    }
+    return false;
+  }
+
+  symbol_table_->push_scope(script_);
+  for (std::size_t i = 0; i < form.variables.size(); ++i) {
+    auto variable = symbol_table_->get_variable(form.variables[i]);
+    if (values[i] != nullptr) {
+      symbol_table_->set_value(variable, values[i]);
+      delete values[i];
+    }
+    if (group_indices[i] >= 0) {
+      auto& variable_counter = cached_variable_counters_[variable];
+      variable_counter = group_counters[group_indices[i]];
+      variable_counter.set_count_bound_exact(Option::Solver::COUNT_BOUND_EXACT);
+    }
+    cached_variables_.insert(variable);
+  }
+  symbol_table_->pop_scope();
+
+  for (auto& group_counter : group_counters) {
+    cached_components_counter_.add_model_counter(group_counter);
+  }
+  num_of_cached_int_variables_ += num_of_int_variables;
+  num_of_cached_str_variables_ += num_of_str_variables;
+  DVLOG(VLOG_LEVEL) << "component@" << component << " is answered from cache: " << component_keys_[component];
+  return true;
+}
+
+void Driver::StoreCachedComponents() {
+  if (GetCache() == nullptr or uncached_components_.empty()) {
+    return;
+  }
+  // the solver stops at the first unsatisfiable component, values of the others are not final
+  if (is_exact_ and is_sat()) {
+    for (auto component : uncached_components_) {
+      if (not StoreCachedComponent(component)) {
+        DVLOG(VLOG_LEVEL) << "component@" << component << " has values that are not cached";
+      }
+    }
+  }
+  uncached_components_.clear();
+}
+
+bool Driver::StoreCachedComponent(SMT::Visitable_ptr component) {
+  Solver::ComponentCanonicalizer component_canonicalizer(script_, symbol_table_, constraint_information_);
+  auto form = component_canonicalizer.canonicalize(component);
+  auto& values = symbol_table_->get_values_at_scope(script_);
+
+  std::map<SMT::Variable_ptr, int> group_counter_indices;
+  std::vector<Solver::ModelCounter> group_counters;
+  std::vector<int> group_indices;
+  std::vector<Solver::Value_ptr> projected_values;
+  int num_of_int_variables = 0;
+  int num_of_str_variables = 0;
+  for (auto& var_name : form.variables) {
+    auto variable = symbol_table_->get_variable(var_name);
+    auto group_variable = symbol_table_->get_group_variable_of(
+        symbol_table_->get_representative_variable_of_at_scope(script_, variable));
+    int group_index = -1;
+    auto value_it = values.find(group_variable);
+    if (value_it != values.end() and value_it->second != nullptr) {
+      auto index_it = group_counter_indices.find(group_variable);
+      if (index_it == group_counter_indices.end()) {
+        Solver::ModelCounter group_counter;
+        group_counter.set_use_sign_integers(Option::Solver::USE_SIGNED_INTEGERS);
+        if (not AddValueToModelCounter(value_it->second, group_counter, num_of_int_variables, num_of_str_variables)) {
+          return false;
+        }
+        index_it = group_counter_indices.insert(std::make_pair(group_variable, group_counters.size())).first;
+        group_counters.push_back(group_counter);
+      }
+      group_index = index_it->second;
+    }
+    auto projected_value = symbol_table_->get_projected_value_at_scope(script_, variable);
+    if (projected_value != nullptr and not IsCacheableValue(projected_value)) {
+      return false;
+    }
+    group_indices.push_back(group_index);
+    projected_values.push_back(projected_value);
+  }
+
+  std::stringstream os;
+  {
+    cereal::BinaryOutputArchive ar(os);
+    const std::string hash = form.hash.str();
+    ar(hash, num_of_int_variables, num_of_str_variables, group_counters);
+    for (std::size_t i = 0; i < projected_values.size(); ++i) {
+      ar(group_indices[i]);
+      SaveCachedValue(ar, projected_values[i]);
+    }
+  }
+  GetCache()->Put(component_keys_[component], os.str());
+  return true;
+}
+
+/**
+ * Values of component variables kept in the cache: integer constants and automata of a single variable
+ */
+bool Driver::IsCacheableValue(Solver::Value_ptr value) {
+  switch (value->getType()) {
+    case Solver::Value::Type::INT_CONSTANT:
+      return true;
+    case Solver::Value::Type::STRING_AUTOMATON: {
+      auto formula = value->getStringAutomaton()->GetFormula();
+      return formula != nullptr and formula->GetNumberOfVariables() == 1;
+    }
+    case Solver::Value::Type::BINARYINT_AUTOMATON: {
+      auto formula = value->getBinaryIntAutomaton()->GetFormula();
+      return formula != nullptr and formula->GetNumberOfVariables() == 1;
+    }
+    default:
+      return false;
+  }
+}
+
+void Driver::SaveCachedValue(cereal::BinaryOutputArchive& ar, Solver::Value_ptr value) {
+  const int type = static_cast<int>((value == nullptr) ? Solver::Value::Type::NONE : value->getType());
+  ar(type);
+  if (value == nullptr) {
+    return;
+  }
+  switch (value->getType()) {
+    case Solver::Value::Type::INT_CONSTANT: {
+      const int constant = value->getIntConstant();
+      ar(constant);
+    }
+      break;
+    case Solver::Value::Type::STRING_AUTOMATON: {
+      auto string_auto = value->getStringAutomaton();
+      const int number_of_bdd_variables = string_auto->get_number_of_bdd_variables();
+      const std::string dfa = Theory::Automaton::DFASerialize(string_auto->getDFA(), number_of_bdd_variables);
+      ar(number_of_bdd_variables, dfa);
+    }
+      break;
+    case Solver::Value::Type::BINARYINT_AUTOMATON: {
+      auto binary_auto = value->getBinaryIntAutomaton();
+      const bool is_natural_number = binary_auto->is_natural_number();
+      const int number_of_bdd_variables = binary_auto->get_number_of_bdd_variables();
+      const std::string dfa = Theory::Automaton::DFASerialize(binary_auto->getDFA(), number_of_bdd_variables);
+      ar(is_natural_number, number_of_bdd_variables, dfa);
+    }
+      break;
+    default:
+      LOG(FATAL) << "value is not cacheable: " << type;
+      break;
+  }
+}
+
+/**
+ * Rebuilds a projected value the way the symbol table projects a group value for the variable
+ */
+Solver::Value_ptr Driver::LoadCachedValue(cereal::BinaryInputArchive& ar, const std::string& var_name) {
+  int type = 0;
+  ar(type);
+  switch (static_cast<Solver::Value::Type>(type)) {
+    case Solver::Value::Type::NONE:
+      return nullptr;
+    case Solver::Value::Type::INT_CONSTANT: {
+      int constant = 0;
+      ar(constant);
+      return new Solver::Value(constant);
+    }
+    case Solver::Value::Type::STRING_AUTOMATON: {
+      int number_of_bdd_variables = 0;
+      std::string data;
+      ar(number_of_bdd_variables, data);
+      auto dfa = (number_of_bdd_variables > 0) ? Theory::Automaton::DFADeserialize(data, number_of_bdd_variables) : nullptr;
+      if (dfa == nullptr) {
+        throw cereal::Exception("malformed string automaton");
+      }
+      auto formula = new Theory::StringFormula();
+      formula->SetType(Theory::StringFormula::Type::VAR);
+      formula->AddVariable(var_name, 1);
+      return new Solver::Value(new Theory::StringAutomaton(dfa, formula, number_of_bdd_variables));
+    }
+    case Solver::Value::Type::BINARYINT_AUTOMATON: {
+      bool is_natural_number = false;
+      int number_of_bdd_variables = 0;
+      std::string data;
+      ar(is_natural_number, number_of_bdd_variables, data);
+      auto dfa = (number_of_bdd_variables > 0) ? Theory::Automaton::DFADeserialize(data, number_of_bdd_variables) : nullptr;
+      if (dfa == nullptr) {
+        throw cereal::Exception("malformed integer automaton");
+      }
+      auto formula = new Theory::ArithmeticFormula();
+      formula->SetType(Theory::ArithmeticFormula::Type::INTERSECT);
+      formula->AddVariable(var_name, 1);
+      return new Solver::Value(new Theory::BinaryIntAutomaton(dfa, formula, is_natural_number));
+    }
+    default:
+      throw cereal::Exception("unknown value type");
+  }
+}
+
+bool Driver::LoadCachedVariableCounter(const std::string& variable_key, Solver::ModelCounter& model_counter) {
+  auto cache = GetCache();
+  if (cache == nullptr or variable_key.empty() or not is_sat()) {
+    return false;
+  }
+  std::string entry;
+  if (not cache->Get(variable_key, entry)) {
+    return false;
+  }
+  try {
+    std::stringstream is(entry);
+    cereal::BinaryInputArchive ar(is);
+    model_counter.load(ar);
+    model_counter.set_count_bound_exact(Option::Solver::COUNT_BOUND_EXACT);
+  } catch (const cereal::Exception& e) {
+    LOG(WARNING)<< "ignoring malformed cache entry: " << e.what();
+    model_counter = Solver::ModelCounter();
+    return false;
+  }
+  return true;
+}
+
+void Driver::StoreCachedVariableCounter(const std::string& variable_key, const Solver::ModelCounter& model_counter) {
+  auto cache = GetCache();
+  if (cache == nullptr or variable_key.empty() or not is_exact_ or not is_sat()) {
+    return;
+  }
+  std::stringstream os;
+  {
+    cereal::BinaryOutputArchive ar(os);
+    model_counter.save(ar);
+  }
+  cache->Put(variable_key, os.str());
+}
+
+void Driver::CountSolveResult() {
+  if (is_solve_unknown_) {
+    Util::Metrics::Increment(Util::Metrics::Counter::UNKNOWN);
+  } else if (is_sat()) {
+    Util::Metrics::Increment(Util::Metrics::Counter::SAT);
+  } else {
+    Util::Metrics::Increment(Util::Metrics::Counter::UNSAT);
+  }
+}
+
+Solver::CountBounds Driver::MakeCountBounds(const Theory::BigInteger& count) const {
+  // widening only adds solutions, an empty over-approximation is exact
+  if (is_exact_ or count == 0) {
+    return Solver::CountBounds { count, count, true };
+  }
+  return Solver::CountBounds { 0, count, false };
+}
+
+void Driver::EnsureSolved() {
+  if (not is_satisfiability_only_) {
+    return;
+  }
+  SMT::Arena::Scope arena_scope(&arena_);
+  Theory::StringAutomaton::Context::Scope string_scope(&string_context_);
+  auto start = std::chrono::steady_clock::now();
+  Solver::ConstraintSolver constraint_solver(script_, symbol_table_, constraint_information_);
+  RunPass(Util::Metrics::Phase::CONSTRAINT_SOLVER, constraint_solver);
+  auto end = std::chrono::steady_clock::now();
+  num_of_propagations_ = constraint_solver.get_num_of_propagations();
+  is_exact_ = constraint_solver.is_exact();
+  if (is_satisfiability_only_) {
+    // values left by the satisfiability-only solve over-approximate the solutions, the full solve refines them
+    auto full_time = std::chrono::duration<double, std::milli>(end - start).count();
+    LOG(INFO) << "report satisfiability-only time: " << satisfiability_only_time_ << " ms, full solve time: "
+              << full_time << " ms, saved: " << (full_time - satisfiability_only_time_) << " ms";
+  }
+  is_satisfiability_only_ = false;
+  StoreCachedComponents();
+}
+
 void Driver::set_option(const Option::Name option) {
   switch (option) {
     case Option::Name::USE_SIGNED_INTEGERS:
@@ -732,6 +1373,30 @@ void Driver::set_option(const Option::Name option) {
     case Option::Name::COUNT_BOUND_EXACT:
     	Option::Solver::COUNT_BOUND_EXACT = true;
     	break;
+    case Option::Name::ENABLE_ARITHMETIC_QUANTIFIER_SCHEDULING:
+      Option::Solver::ENABLE_ARITHMETIC_QUANTIFIER_SCHEDULING = true;
+      break;
+    case Option::Name::DISABLE_ARITHMETIC_QUANTIFIER_SCHEDULING:
+      Option::Solver::ENABLE_ARITHMETIC_QUANTIFIER_SCHEDULING = false;
+      break;
+    case Option::Name::ENABLE_ALPHABET_COMPRESSION:
+      Option::Solver::ENABLE_ALPHABET_COMPRESSION = true;
+      break;
+    case Option::Name::DISABLE_ALPHABET_COMPRESSION:
+      Option::Solver::ENABLE_ALPHABET_COMPRESSION = false;
+      break;
+    case Option::Name::ENABLE_TRACK_ORDERING:
+      Option::Solver::ENABLE_TRACK_ORDERING = true;
+      break;
+    case Option::Name::DISABLE_TRACK_ORDERING:
+      Option::Solver::ENABLE_TRACK_ORDERING = false;
+      break;
+    case Option::Name::ENABLE_SATISFIABILITY_ONLY:
+      Option::Solver::ENABLE_SATISFIABILITY_ONLY = true;
+      break;
+    case Option::Name::DISABLE_SATISFIABILITY_ONLY:
+      Option::Solver::ENABLE_SATISFIABILITY_ONLY = false;
+      break;
     default:
       LOG(ERROR)<< "option is not recognized: " << static_cast<int>(option);
       break;
@@ -743,6 +1408,27 @@ void Driver::set_option(const Option::Name option, const int value) {
     case Option::Name::REGEX_FLAG:
       Util::RegularExpression::DEFAULT = value;
       break;
+    case Option::Name::CACHE_MAX_SIZE:
+      Option::Solver::CACHE_MAX_SIZE = value;
+      break;
+    case Option::Name::CHARACTER_WIDTH:
+      Option::Theory::CHARACTER_WIDTH = value;
+      break;
+    case Option::Name::INTEGER_WIDTH:
+      Option::Theory::INTEGER_WIDTH = value;
+      break;
+    case Option::Name::TIME_LIMIT:
+      Option::Solver::TIME_LIMIT = value;
+      break;
+    case Option::Name::STATE_LIMIT:
+      Option::Solver::STATE_LIMIT = value;
+      break;
+    case Option::Name::BDD_NODE_LIMIT:
+      Option::Solver::BDD_NODE_LIMIT = value;
+      break;
+    case Option::Name::APPROXIMATION_STATE_LIMIT:
+      Option::Solver::APPROXIMATION_STATE_LIMIT = value;
+      break;
     default:
       LOG(ERROR)<< "option is not recognized: " << static_cast<int>(option) << " -> " << value;
       break;
@@ -759,6 +1445,12 @@ void Driver::set_option(const Option::Name option, const std::string value) {
       Option::Solver::SCRIPT_PATH = value;
       Option::Theory::SCRIPT_PATH = value;
       break;
+    case Option::Name::CACHE_FILE:
+      Option::Solver::CACHE_FILE = value;
+      break;
+    case Option::Name::TRACE_FILE:
+      trace_id_ = Util::Trace::Start(value);
+      break;
     default:
       LOG(ERROR)<< "option is not recognized: " << static_cast<int>(option) << " -> " << value;
       break;
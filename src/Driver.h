@@ -8,26 +8,36 @@
 #ifndef SRC_DRIVER_H_
 #define SRC_DRIVER_H_
 
+#include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <limits>
 #include <map>
+#include <set>
 #include <sstream>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <glog/logging.h>
 
 #include "boost/multiprecision/cpp_int.hpp"
 #include "Eigen/SparseCore"
 #include "cereal/archives/binary.hpp"
+#include "cereal/types/map.hpp"
+#include "cereal/types/string.hpp"
 #include "parser/location.hh"
 #include "parser/parser.hpp"
 #include "parser/Scanner.h"
+#include "smt/Arena.h"
 #include "smt/ast.h"
 #include "smt/typedefs.h"
+#include "solver/AlphabetPartitioner.h"
 #include "solver/Ast2Dot.h"
+#include "solver/ComponentCanonicalizer.h"
 #include "solver/ConstraintInformation.h"
 #include "solver/ConstraintSolver.h"
 #include "solver/ConstraintSorter.h"
@@ -50,7 +60,11 @@
 #include "theory/StringFormula.h"
 #include "theory/Formula.h"
 #include "theory/SymbolicCounter.h"
+#include "utils/Budget.h"
+#include "utils/Metrics.h"
+#include "utils/PersistentCache.h"
 #include "utils/Serialize.h"
+#include "utils/Trace.h"
 
 namespace Vlab {
 namespace SMT {
@@ -69,13 +83,38 @@ public:
   // Error handling.
   void error(const Vlab::SMT::location& l, const std::string& m);
   void error(const std::string& m);
+  /**
+   * Parses a script, returns 0 on success and non-zero on a syntax error, which is logged
+   */
   int Parse(std::istream* in = &std::cin);
   void ast2dot(std::string file_name);
   void ast2dot(std::ostream* out);
 //	void collectStatistics();
   void InitializeSolver();
   void Solve();
+  /**
+   * Decides satisfiability only, variables are not refined unless they are requested.
+   * Values of variables are solved exactly once they are queried.
+   */
+  void SolveSatisfiability(const std::set<std::string>& requested_variables = std::set<std::string>());
   bool is_sat();
+  /**
+   * True if the last solve, or the last count or model query, stopped at a limit of its budget;
+   * the result of that call is not valid. The driver can be reused after reset().
+   */
+  bool is_unknown() const;
+  /**
+   * False if the last solve applied widening (--approximate) or one of the over-approximations the constraint
+   * solver records: the negation of a non-singleton, not-equal between non-singletons, the fallbacks of
+   * not-contains/begins/ends and unknown operations. A sat result may then be spurious and counts are upper
+   * bounds, see CountWithBounds. True means none of these was applied, it does not cover approximations made
+   * inside the automata operations (e.g. integers beyond --integer-width).
+   */
+  bool is_exact() const;
+  /**
+   * Number of constraints solved again after a variable they mention is shrunk, in the last solve
+   */
+  int get_num_of_propagations() const;
 
   void GetModels(const unsigned long bound,const unsigned long num_models);
 
@@ -83,13 +122,20 @@ public:
   Theory::BigInteger CountInts(const unsigned long bound);
   Theory::BigInteger CountStrs(const unsigned long bound);
   Theory::BigInteger Count(const unsigned long int_bound, const unsigned long str_bound);
+  /**
+   * Counts with the bounds of the exact count. When the solve is not exact (see is_exact()) the count is the
+   * upper bound and the lower bound is always 0, no under-approximation is computed. Bounds are not valid if the
+   * count is unknown.
+   */
+  Solver::CountBounds CountVariableWithBounds(const std::string var_name, const unsigned long bound);
+  Solver::CountBounds CountWithBounds(const unsigned long int_bound, const unsigned long str_bound);
 
   Solver::ModelCounter& GetModelCounterForVariable(const std::string var_name, bool project = true);
   Solver::ModelCounter& GetModelCounter();
 
   void printResult(Solver::Value_ptr value, std::ostream& out);
   void inspectResult(Solver::Value_ptr value, std::string file_name);
-  std::map<SMT::Variable_ptr, Solver::Value_ptr> getSatisfyingVariables() const;
+  std::map<SMT::Variable_ptr, Solver::Value_ptr> getSatisfyingVariables();
   std::map<std::string, std::string> getSatisfyingExamples();
   std::map<std::string, std::string> getSatisfyingExamplesRandom();
   std::map<std::string, std::string> getSatisfyingExamplesRandomBounded(const int bound);
@@ -97,6 +143,15 @@ public:
   void reset();
 //	void solveAst();
 
+  /**
+   * Snapshot of the process-wide solver metrics, see Util::Metrics
+   */
+  static std::map<std::string, unsigned long> GetMetrics();
+  /**
+   * Process-wide solver metrics in the Prometheus text format
+   */
+  static std::string GetMetricsText();
+
   void set_option(const Option::Name option);
   void set_option(const Option::Name option, const int value);
   void set_option(const Option::Name option, const std::string value);
@@ -114,6 +169,64 @@ public:
 protected:
   void SetModelCounterForVariable(const std::string var_name, bool project = true);
   void SetModelCounter();
+  /**
+   * Adds the counter of a value and the number of variables it tracks, false for a value that is not counted
+   */
+  bool AddValueToModelCounter(Solver::Value_ptr value, Solver::ModelCounter& model_counter,
+                              int& num_of_int_variables, int& num_of_str_variables);
+
+  /**
+   * Persistent result cache, nullptr when no cache file is set
+   */
+  Util::PersistentCache* GetCache();
+  std::string GetCacheKey(const Solver::CanonicalForm& form);
+  std::string GetCacheKeyForVariable(const std::string var_name, bool project);
+  /**
+   * Loads the solved top level components found in the cache before solving, the loaded components
+   * are taken out of the script and only the other components are solved
+   */
+  void LoadCachedComponents();
+  bool LoadCachedComponent(SMT::Visitable_ptr component, const Solver::CanonicalForm& form);
+  /**
+   * Stores the components solved by the last full solve, exact results of satisfiable scripts only
+   */
+  void StoreCachedComponents();
+  bool StoreCachedComponent(SMT::Visitable_ptr component);
+  bool IsCacheableValue(Solver::Value_ptr value);
+  void SaveCachedValue(cereal::BinaryOutputArchive& ar, Solver::Value_ptr value);
+  Solver::Value_ptr LoadCachedValue(cereal::BinaryInputArchive& ar, const std::string& var_name);
+  /**
+   * Model counters of variables are kept in entries of their own under the key of their component,
+   * counting a variable appends only its counter
+   */
+  bool LoadCachedVariableCounter(const std::string& variable_key, Solver::ModelCounter& model_counter);
+  void StoreCachedVariableCounter(const std::string& variable_key, const Solver::ModelCounter& model_counter);
+  Solver::CountBounds MakeCountBounds(const Theory::BigInteger& count) const;
+
+  /**
+   * Runs the constraint solver for a script solved for satisfiability only, once automata are needed
+   */
+  void EnsureSolved();
+
+  /**
+   * Runs a query within the time, state and bdd node limits of the options, a query that exceeds them
+   * sets the unknown flag and returns the unknown result. Queries run by another query share its budget
+   * and its time is observed for the phase of the outer query.
+   */
+  template <typename T>
+  T RunWithinBudget(std::function<T()> query, const T unknown_result, bool& is_unknown,
+                    const Util::Metrics::Phase phase);
+
+  /**
+   * Runs a preprocessing pass or the constraint solver, timed and traced as its phase
+   */
+  template <typename T>
+  void RunPass(const Util::Metrics::Phase phase, T& pass);
+
+  /**
+   * Counts the result of the last solve in the metrics
+   */
+  void CountSolveResult();
 
   bool is_model_counter_cached_;
   Solver::ModelCounter model_counter_;
@@ -132,8 +245,60 @@ protected:
    */
   std::map<std::string, Solver::Value_ptr> cached_bounded_values_;
 
+  /**
+   * Owns the AST nodes of the current script, released all at once on reset
+   */
+  SMT::Arena arena_;
+
+  /**
+   * Encoding of the string automata of this driver, installed in its entry points
+   */
+  Theory::StringAutomaton::Context string_context_;
+
+  Util::PersistentCache* cache_;
+  /**
+   * Keys of the top level components, shared by scripts that have the same component
+   */
+  std::map<SMT::Visitable_ptr, std::string> component_keys_;
+  /**
+   * Components missed in the cache, stored once they are fully solved
+   */
+  std::set<SMT::Visitable_ptr> uncached_components_;
+  /**
+   * Keys of the variables of cached components: the key of the component and the canonical name of the variable
+   */
+  std::map<std::string, std::string> variable_cache_keys_;
+  /**
+   * Variables of the components loaded from the cache, their values are the projected values;
+   * the counters of their groups are kept to count the script and the variables without projection
+   */
+  std::set<SMT::Variable_ptr> cached_variables_;
+  std::map<SMT::Variable_ptr, Solver::ModelCounter> cached_variable_counters_;
+  Solver::ModelCounter cached_components_counter_;
+  int num_of_cached_int_variables_;
+  int num_of_cached_str_variables_;
+  /**
+   * All components are loaded from the cache, the script is not solved
+   */
+  bool is_solved_from_cache_;
+
+  int num_of_propagations_;
+  bool is_solve_unknown_;
+  bool is_query_unknown_;
+  bool is_exact_;
+  bool is_satisfiability_only_;
+  /**
+   * Time of the last satisfiability-only solve in milliseconds, compared with the full solve once it runs
+   */
+  double satisfiability_only_time_;
+  /**
+   * Recording started by the TRACE_FILE option of this driver, 0 if none; it is written when the driver is deleted
+   */
+  unsigned long trace_id_;
+
 private:
   static bool IS_LOGGING_INITIALIZED;
+  static const int VLOG_LEVEL;
 
 };
 
@@ -23,6 +23,7 @@
 #include <glog/vlog_is_on.h>
 
 #include "Driver.h"
+#include "server/Server.h"
 #include "solver/options/Solver.h"
 #include "smt/ast.h"
 #include "solver/Value.h"
@@ -56,10 +57,17 @@ int main(const int argc, const char **argv) {
   driver.set_option(Vlab::Option::Name::REGEX_FLAG, 0x000e);
 
   bool experiment_mode = false;
+  bool satisfiability_only = false;
+  bool print_metrics = false;
   std::vector<unsigned long> str_bounds;
   std::vector<unsigned long> int_bounds;
   std::string count_variable {""};
   unsigned long num_models = 0;
+  std::string serve_socket {""};
+  int serve_workers = 0;
+  int serve_max_pending = Vlab::Server::Server::DEFAULT_MAX_PENDING_CONNECTIONS;
+  unsigned serve_max_queue_wait = Vlab::Server::Server::DEFAULT_MAX_QUEUE_WAIT_MS;
+  unsigned serve_deadline = 0;
 
   for (int i = 1; i < argc; ++i) {
     if (argv[i] == std::string("-i") or argv[i] == std::string("--input-file")) {
@@ -126,6 +134,64 @@ int main(const int argc, const char **argv) {
     } else if (argv[i] == std::string("-v")) {
       FLAGS_v = std::stoi(argv[i + 1]);
       ++i;
+    } else if (argv[i] == std::string("--enable-quantifier-scheduling")) {
+      driver.set_option(Vlab::Option::Name::ENABLE_ARITHMETIC_QUANTIFIER_SCHEDULING);
+    } else if (argv[i] == std::string("--disable-quantifier-scheduling")) {
+      driver.set_option(Vlab::Option::Name::DISABLE_ARITHMETIC_QUANTIFIER_SCHEDULING);
+    } else if (argv[i] == std::string("--enable-alphabet-compression")) {
+      driver.set_option(Vlab::Option::Name::ENABLE_ALPHABET_COMPRESSION);
+    } else if (argv[i] == std::string("--disable-alphabet-compression")) {
+      driver.set_option(Vlab::Option::Name::DISABLE_ALPHABET_COMPRESSION);
+    } else if (argv[i] == std::string("--enable-track-ordering")) {
+      driver.set_option(Vlab::Option::Name::ENABLE_TRACK_ORDERING);
+    } else if (argv[i] == std::string("--disable-track-ordering")) {
+      driver.set_option(Vlab::Option::Name::DISABLE_TRACK_ORDERING);
+    } else if (argv[i] == std::string("--character-width")) {
+      driver.set_option(Vlab::Option::Name::CHARACTER_WIDTH, std::stoi(argv[i + 1]));
+      ++i;
+    } else if (argv[i] == std::string("--integer-width")) {
+      driver.set_option(Vlab::Option::Name::INTEGER_WIDTH, std::stoi(argv[i + 1]));
+      ++i;
+    } else if (argv[i] == std::string("--cache-file")) {
+      driver.set_option(Vlab::Option::Name::CACHE_FILE, std::string(argv[i + 1]));
+      ++i;
+    } else if (argv[i] == std::string("--cache-max-size")) {
+      driver.set_option(Vlab::Option::Name::CACHE_MAX_SIZE, std::stoi(argv[i + 1]));
+      ++i;
+    } else if (argv[i] == std::string("--serve")) {
+      serve_socket = argv[i + 1];
+      ++i;
+    } else if (argv[i] == std::string("--serve-workers")) {
+      serve_workers = std::stoi(argv[i + 1]);
+      ++i;
+    } else if (argv[i] == std::string("--serve-max-pending")) {
+      serve_max_pending = std::stoi(argv[i + 1]);
+      ++i;
+    } else if (argv[i] == std::string("--serve-max-queue-wait")) {
+      serve_max_queue_wait = std::stoul(argv[i + 1]);
+      ++i;
+    } else if (argv[i] == std::string("--serve-deadline")) {
+      serve_deadline = std::stoul(argv[i + 1]);
+      ++i;
+    } else if (argv[i] == std::string("--time-limit")) {
+      driver.set_option(Vlab::Option::Name::TIME_LIMIT, std::stoi(argv[i + 1]));
+      ++i;
+    } else if (argv[i] == std::string("--state-limit")) {
+      driver.set_option(Vlab::Option::Name::STATE_LIMIT, std::stoi(argv[i + 1]));
+      ++i;
+    } else if (argv[i] == std::string("--bdd-node-limit")) {
+      driver.set_option(Vlab::Option::Name::BDD_NODE_LIMIT, std::stoi(argv[i + 1]));
+      ++i;
+    } else if (argv[i] == std::string("--trace-file")) {
+      driver.set_option(Vlab::Option::Name::TRACE_FILE, std::string(argv[i + 1]));
+      ++i;
+    } else if (argv[i] == std::string("--approximate")) {
+      driver.set_option(Vlab::Option::Name::APPROXIMATION_STATE_LIMIT, std::stoi(argv[i + 1]));
+      ++i;
+    } else if (argv[i] == std::string("--print-metrics")) {
+      print_metrics = true;
+    } else if (argv[i] == std::string("--sat-only")) {
+      satisfiability_only = true;
     } else if (argv[i] == std::string("-e")) {
       experiment_mode = true;
     } else if (argv[i] == std::string("-h") or argv[i] == std::string("--help")) {
@@ -151,6 +217,28 @@ int main(const int argc, const char **argv) {
       std::cout << std::setw(col) << "--limit-len-implications" << ": disables length implications for word equations" << std::endl;
       std::cout << std::setw(col) << "--enable-sorting" << ": enables sorting heuristics for string constraints" << std::endl;
       std::cout << std::setw(col) << "--disable-sorting" << ": disables sorting heuristics for string constraints" << std::endl;
+      std::cout << std::setw(col) << "--enable-quantifier-scheduling" << ": projects away internal integer variables after their last arithmetic constraint" << std::endl;
+      std::cout << std::setw(col) << "--disable-quantifier-scheduling" << ": keeps all integer variables while solving arithmetic constraints" << std::endl;
+      std::cout << std::setw(col) << "--enable-alphabet-compression" << ": encodes characters not distinguished by the constraints with a shared code" << std::endl;
+      std::cout << std::setw(col) << "--disable-alphabet-compression" << ": encodes every character with its own code" << std::endl;
+      std::cout << std::setw(col) << "--enable-track-ordering" << ": places tracks of related string variables next to each other in multitrack automata (experimental, off by default)" << std::endl;
+      std::cout << std::setw(col) << "--disable-track-ordering" << ": places tracks of string variables in name order" << std::endl;
+      std::cout << std::setw(col) << "--character-width <8|16|21>" << ": bits per string character, 16 and 21 read strings as utf-8" << std::endl;
+      std::cout << std::setw(col) << "--integer-width <n>" << ": bits of integers converted to and from decimal strings, 64 by default" << std::endl;
+      std::cout << std::setw(col) << "--time-limit <ms>" << ": wall time limit of solving and of each count, the result is unknown beyond it" << std::endl;
+      std::cout << std::setw(col) << "--state-limit <n>" << ": limit on the number of states of an automaton, the result is unknown beyond it" << std::endl;
+      std::cout << std::setw(col) << "--bdd-node-limit <n>" << ": limit on the number of bdd nodes of an automaton, the result is unknown beyond it" << std::endl;
+      std::cout << std::setw(col) << "--approximate <n>" << ": widens string values with more than n states, counts are reported with lower and upper bounds" << std::endl;
+      std::cout << std::setw(col) << "--trace-file <path>" << ": writes timed automata operations, passes and counts as chrome trace-event json" << std::endl;
+      std::cout << std::setw(col) << "--print-metrics" << ": prints results, cache hits, peak automaton size and phase latencies in prometheus text format" << std::endl;
+      std::cout << std::setw(col) << "--sat-only" << ": decides satisfiability without refining variables, they are solved exactly when counted" << std::endl;
+      std::cout << std::setw(col) << "--cache-file <path>" << ": reuses results of identical scripts up to variable renaming across runs" << std::endl;
+      std::cout << std::setw(col) << "--cache-max-size <mb>" << ": size limit of the cache file, older entries are evicted beyond it" << std::endl;
+      std::cout << std::setw(col) << "--serve <socket>" << ": runs as a solver daemon on the given unix domain socket" << std::endl;
+      std::cout << std::setw(col) << "--serve-workers <n>" << ": number of daemon worker processes, defaults to number of cores" << std::endl;
+      std::cout << std::setw(col) << "--serve-max-pending <n>" << ": number of connections queued while all workers are busy" << std::endl;
+      std::cout << std::setw(col) << "--serve-max-queue-wait <ms>" << ": queued connections are rejected as busy after waiting this long, 0 means no limit" << std::endl;
+      std::cout << std::setw(col) << "--serve-deadline <ms>" << ": upper limit for the deadline of a daemon request, 0 means no limit" << std::endl;
       std::cout << std::setw(col) << "--output-dir <dir>" << ": used for debugging outputs" << std::endl;
       std::cout << std::setw(col) << "--log-dir <dir>" << ": redirect logs from stderr to files and saves in the directory specified." << std::endl;
       std::cout << std::setw(col) << "--v <value>" << ": sets verbose logging level, unless you build ABC with configure --disable-debug" << std::endl;
@@ -163,6 +251,17 @@ int main(const int argc, const char **argv) {
 
   google::InitGoogleLogging(argv[0]);
 
+  if (not serve_socket.empty()) {
+    Vlab::Server::Server server(serve_socket);
+    if (serve_workers > 0) {
+      server.set_num_of_workers(serve_workers);
+    }
+    server.set_max_pending_connections(serve_max_pending);
+    server.set_max_queue_wait(serve_max_queue_wait);
+    server.set_default_deadline(serve_deadline);
+    return server.Run();
+  }
+
   /* log test start */
 //  DLOG(INFO)<< "debug log start";
 //  LOG(INFO)<< "production log";
@@ -178,7 +277,9 @@ int main(const int argc, const char **argv) {
   }
 
   driver.test();
-  driver.Parse(in);
+  if (driver.Parse(in) != 0) {
+    return 2;
+  }
 
 #ifndef NDEBUG
   if (VLOG_IS_ON(30) and not output_root.empty()) {
@@ -198,12 +299,21 @@ int main(const int argc, const char **argv) {
     driver.ast2dot(output_root + "/optimized.dot");
   }
 #endif
-  driver.Solve();
+  if (satisfiability_only) {
+    driver.SolveSatisfiability();
+  } else {
+    driver.Solve();
+  }
   auto end = std::chrono::steady_clock::now();
   auto solving_time = end - start;
   LOG(INFO) << "Done solving";
+  LOG(INFO) << "report propagations: " << driver.get_num_of_propagations();
 
-  std::cout << (driver.is_sat() ? "sat" : "unsat") << std::endl;
+  if (driver.is_unknown()) {
+    std::cout << "unknown" << std::endl;
+  } else {
+    std::cout << (driver.is_sat() ? "sat" : "unsat") << std::endl;
+  }
 
 
 
@@ -303,30 +413,39 @@ int main(const int argc, const char **argv) {
       LOG(INFO) << "report var: " << count_variable;
       for (auto b : int_bounds) {
         start = std::chrono::steady_clock::now();
-        auto count_result = driver.CountVariable(count_variable, b);
+        auto count_result = driver.CountVariableWithBounds(count_variable, b);
         end = std::chrono::steady_clock::now();
         auto count_time = end - start;
-        LOG(INFO) << "report bound: " << b << " count: " << count_result << " time: "
+        LOG(INFO) << "report bound: " << b << " count: " << count_result.upper << " time: "
                   << std::chrono::duration<long double, std::milli>(count_time).count() << " ms";
+        if (not count_result.is_exact) {
+          LOG(INFO) << "report bound: " << b << " lower: " << count_result.lower << " upper: " << count_result.upper;
+        }
       }
       for (auto b : str_bounds) {
         start = std::chrono::steady_clock::now();
-        auto count_result = driver.CountVariable(count_variable, b);
+        auto count_result = driver.CountVariableWithBounds(count_variable, b);
         end = std::chrono::steady_clock::now();
         auto count_time = end - start;
-        LOG(INFO) << "report bound: " << b << " count: " << count_result << " time: "
+        LOG(INFO) << "report bound: " << b << " count: " << count_result.upper << " time: "
                   << std::chrono::duration<long double, std::milli>(count_time).count() << " ms";
+        if (not count_result.is_exact) {
+          LOG(INFO) << "report bound: " << b << " lower: " << count_result.lower << " upper: " << count_result.upper;
+        }
         
       }
     } else {
       if(int_bounds.size() == 1 and str_bounds.size() == 1 and int_bounds[0] == str_bounds[0]) {
         auto b = int_bounds[0];
         start = std::chrono::steady_clock::now();
-        auto count = driver.Count(b,b);
+        auto count = driver.CountWithBounds(b,b);
         end = std::chrono::steady_clock::now();
         auto count_time = end - start;
-        LOG(INFO) << "report bound: " << b << " count: " << count << " time: "
+        LOG(INFO) << "report bound: " << b << " count: " << count.upper << " time: "
                   << std::chrono::duration<long double, std::milli>(count_time).count() << " ms";
+        if (not count.is_exact) {
+          LOG(INFO) << "report bound: " << b << " lower: " << count.lower << " upper: " << count.upper;
+        }
       } else {
         for (auto b : int_bounds) {
           start = std::chrono::steady_clock::now();
@@ -335,6 +454,9 @@ int main(const int argc, const char **argv) {
           auto count_time = end - start;
           LOG(INFO) << "report bound: " << b << " count: " << count << " time: "
                     << std::chrono::duration<long double, std::milli>(count_time).count() << " ms";
+          if (not driver.is_exact() and count != 0) {
+            LOG(INFO) << "report bound: " << b << " lower: 0 upper: " << count;
+          }
         }
         for (auto b : str_bounds) {
           start = std::chrono::steady_clock::now();
@@ -343,6 +465,9 @@ int main(const int argc, const char **argv) {
           auto count_time = end - start;
           LOG(INFO) << "report bound: " << b << " count: " << count << " time: "
                     << std::chrono::duration<long double, std::milli>(count_time).count() << " ms";
+          if (not driver.is_exact() and count != 0) {
+            LOG(INFO) << "report bound: " << b << " lower: 0 upper: " << count;
+          }
         }
       }
 
@@ -353,6 +478,10 @@ int main(const int argc, const char **argv) {
     LOG(INFO) << "report count: 0 time: 0";
   }
 
+  if (print_metrics) {
+    std::cout << Vlab::Driver::GetMetricsText();
+  }
+
   LOG(INFO) << "done.";
 
   if (file != nullptr) {
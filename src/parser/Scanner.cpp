@@ -27,8 +27,8 @@ void Scanner::LexerOutput(const char* buf, int size) {
 }
 
 void Scanner::LexerError(const char* msg) {
-  std::cerr << std::setw(9) << Scanner::TAG << ": '" << yytext << "' at " << loc << " - " << msg << "\n";
-  std::exit(2);
+  // reported by the parser, a long running process keeps serving after a malformed script
+  throw Parser::syntax_error(loc, std::string("'") + yytext + "' - " + msg);
 }
 
 } /* namespace SMT */
@@ -0,0 +1,195 @@
+/*
+ * Protocol.cpp
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "Protocol.h"
+
+#include <cerrno>
+#include <unistd.h>
+
+namespace Vlab {
+namespace Server {
+
+const uint32_t Protocol::MAX_PAYLOAD_SIZE = 64 * 1024 * 1024;
+const std::size_t Protocol::REQUEST_HEADER_SIZE = 9;
+const std::size_t Protocol::RESPONSE_HEADER_SIZE = 5;
+
+bool Protocol::ReadRequest(int fd, Request& request) {
+  char header[REQUEST_HEADER_SIZE];
+  if (not ReadFully(fd, header, REQUEST_HEADER_SIZE)) {
+    return false;
+  }
+  std::string header_str(header, REQUEST_HEADER_SIZE);
+  std::size_t pos = 0;
+  uint32_t length = 0;
+  GetU32(header_str, pos, length);
+  request.command = static_cast<Command>(header_str[pos++]);
+  GetU32(header_str, pos, request.deadline_ms);
+  if (length > MAX_PAYLOAD_SIZE) {
+    return false;
+  }
+  request.payload.resize(length);
+  return (length == 0) or ReadFully(fd, &request.payload[0], length);
+}
+
+bool Protocol::WriteRequest(int fd, const Request& request) {
+  std::string out;
+  out.reserve(REQUEST_HEADER_SIZE + request.payload.size());
+  PutU32(out, request.payload.size());
+  out.push_back(static_cast<char>(request.command));
+  PutU32(out, request.deadline_ms);
+  out.append(request.payload);
+  return WriteFully(fd, out.data(), out.size());
+}
+
+bool Protocol::ReadResponse(int fd, Response& response) {
+  char header[RESPONSE_HEADER_SIZE];
+  if (not ReadFully(fd, header, RESPONSE_HEADER_SIZE)) {
+    return false;
+  }
+  std::string header_str(header, RESPONSE_HEADER_SIZE);
+  std::size_t pos = 0;
+  uint32_t length = 0;
+  GetU32(header_str, pos, length);
+  response.status = static_cast<Status>(header_str[pos]);
+  if (length > MAX_PAYLOAD_SIZE) {
+    return false;
+  }
+  response.payload.resize(length);
+  return (length == 0) or ReadFully(fd, &response.payload[0], length);
+}
+
+bool Protocol::WriteResponse(int fd, const Response& response) {
+  std::string out = EncodeResponse(response);
+  return WriteFully(fd, out.data(), out.size());
+}
+
+std::string Protocol::EncodeResponse(const Response& response) {
+  std::string out;
+  out.reserve(RESPONSE_HEADER_SIZE + response.payload.size());
+  PutU32(out, response.payload.size());
+  out.push_back(static_cast<char>(response.status));
+  out.append(response.payload);
+  return out;
+}
+
+void Protocol::PutU32(std::string& out, const uint32_t value) {
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    out.push_back(static_cast<char>((value >> shift) & 0xff));
+  }
+}
+
+void Protocol::PutU64(std::string& out, const uint64_t value) {
+  for (int shift = 56; shift >= 0; shift -= 8) {
+    out.push_back(static_cast<char>((value >> shift) & 0xff));
+  }
+}
+
+void Protocol::PutString(std::string& out, const std::string& value) {
+  PutU32(out, value.size());
+  out.append(value);
+}
+
+bool Protocol::GetU32(const std::string& in, std::size_t& pos, uint32_t& value) {
+  if (pos + 4 > in.size()) {
+    return false;
+  }
+  value = 0;
+  for (int i = 0; i < 4; ++i) {
+    value = (value << 8) | static_cast<unsigned char>(in[pos++]);
+  }
+  return true;
+}
+
+bool Protocol::GetU64(const std::string& in, std::size_t& pos, uint64_t& value) {
+  if (pos + 8 > in.size()) {
+    return false;
+  }
+  value = 0;
+  for (int i = 0; i < 8; ++i) {
+    value = (value << 8) | static_cast<unsigned char>(in[pos++]);
+  }
+  return true;
+}
+
+bool Protocol::GetString(const std::string& in, std::size_t& pos, std::string& value) {
+  uint32_t length = 0;
+  if (not GetU32(in, pos, length) or pos + length > in.size()) {
+    return false;
+  }
+  value = in.substr(pos, length);
+  pos += length;
+  return true;
+}
+
+std::string Protocol::EncodeModels(const std::vector<Model>& models) {
+  std::string out;
+  PutU32(out, models.size());
+  for (const auto& model : models) {
+    PutU32(out, model.size());
+    for (const auto& entry : model) {
+      PutString(out, entry.first);
+      PutString(out, entry.second);
+    }
+  }
+  return out;
+}
+
+bool Protocol::DecodeModels(const std::string& in, std::vector<Model>& models) {
+  std::size_t pos = 0;
+  uint32_t num_of_models = 0;
+  if (not GetU32(in, pos, num_of_models)) {
+    return false;
+  }
+  for (uint32_t i = 0; i < num_of_models; ++i) {
+    uint32_t num_of_pairs = 0;
+    if (not GetU32(in, pos, num_of_pairs)) {
+      return false;
+    }
+    Model model;
+    for (uint32_t j = 0; j < num_of_pairs; ++j) {
+      std::string name, value;
+      if (not GetString(in, pos, name) or not GetString(in, pos, value)) {
+        return false;
+      }
+      model[name] = value;
+    }
+    models.push_back(model);
+  }
+  return true;
+}
+
+bool Protocol::ReadFully(int fd, char* buffer, std::size_t length) {
+  while (length > 0) {
+    ssize_t n = ::read(fd, buffer, length);
+    if (n < 0 and errno == EINTR) {
+      continue;
+    } else if (n <= 0) {
+      return false;
+    }
+    buffer += n;
+    length -= n;
+  }
+  return true;
+}
+
+bool Protocol::WriteFully(int fd, const char* buffer, std::size_t length) {
+  while (length > 0) {
+    ssize_t n = ::write(fd, buffer, length);
+    if (n < 0 and errno == EINTR) {
+      continue;
+    } else if (n <= 0) {
+      return false;
+    }
+    buffer += n;
+    length -= n;
+  }
+  return true;
+}
+
+} /* namespace Server */
+} /* namespace Vlab */
@@ -0,0 +1,109 @@
+/*
+ * Protocol.h
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef SRC_SERVER_PROTOCOL_H_
+#define SRC_SERVER_PROTOCOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Vlab {
+namespace Server {
+
+/**
+ * Wire format used by the solver daemon (all integers are big endian).
+ *
+ * request : | payload length (u32) | command (u8) | deadline in ms (u32) | payload |
+ * response: | payload length (u32) | status (u8)  | payload |
+ *
+ * Payloads per command:
+ *  SOLVE             : request  smt2 script
+ *                      response 1 byte, 1 for sat and 0 for unsat
+ *  COUNT             : request  int bound (u64) | str bound (u64) | variable name (optional)
+ *                      response decimal count
+ *  GET_MODELS        : request  number of models (u32) | length bound (u32, 0 means unbounded)
+ *                      response number of models (u32) | per model: number of pairs (u32) | (name, value) strings
+ *  GET_MODEL_COUNTER : request  variable name (optional)
+ *                      response serialized model counter
+ *  RESET             : request  empty
+ *                      response empty
+ *  GET_METRICS       : request  empty
+ *                      response metrics of the worker process in the Prometheus text format
+ *
+ * Strings embedded into structured payloads are prefixed with their length (u32).
+ * Failed requests, including scripts with syntax errors, return ERROR with an explanation as payload.
+ * Solve, count, model and model counter requests that stop at a query limit return UNKNOWN with an empty payload.
+ */
+enum class Command : uint8_t {
+  SOLVE = 1,
+  COUNT,
+  GET_MODELS,
+  GET_MODEL_COUNTER,
+  RESET,
+  GET_METRICS
+};
+
+enum class Status : uint8_t {
+  OK = 0,
+  ERROR,
+  BUSY,
+  TIMEOUT,
+  UNKNOWN
+};
+
+struct Request {
+  Command command;
+  uint32_t deadline_ms;
+  std::string payload;
+};
+
+struct Response {
+  Status status;
+  std::string payload;
+};
+
+using Model = std::map<std::string, std::string>;
+
+class Protocol {
+ public:
+  static const uint32_t MAX_PAYLOAD_SIZE;
+  static const std::size_t REQUEST_HEADER_SIZE;
+  static const std::size_t RESPONSE_HEADER_SIZE;
+
+  static bool ReadRequest(int fd, Request& request);
+  static bool WriteRequest(int fd, const Request& request);
+  static bool ReadResponse(int fd, Response& response);
+  static bool WriteResponse(int fd, const Response& response);
+
+  /**
+   * Encodes a response into a single buffer, used where the response must be sent with one write call
+   */
+  static std::string EncodeResponse(const Response& response);
+
+  static void PutU32(std::string& out, const uint32_t value);
+  static void PutU64(std::string& out, const uint64_t value);
+  static void PutString(std::string& out, const std::string& value);
+  static bool GetU32(const std::string& in, std::size_t& pos, uint32_t& value);
+  static bool GetU64(const std::string& in, std::size_t& pos, uint64_t& value);
+  static bool GetString(const std::string& in, std::size_t& pos, std::string& value);
+
+  static std::string EncodeModels(const std::vector<Model>& models);
+  static bool DecodeModels(const std::string& in, std::vector<Model>& models);
+
+ protected:
+  static bool ReadFully(int fd, char* buffer, std::size_t length);
+  static bool WriteFully(int fd, const char* buffer, std::size_t length);
+};
+
+} /* namespace Server */
+} /* namespace Vlab */
+
+#endif /* SRC_SERVER_PROTOCOL_H_ */
@@ -0,0 +1,503 @@
+/*
+ * Server.cpp
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "Server.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace Vlab {
+namespace Server {
+
+const int Server::DEFAULT_MAX_PENDING_CONNECTIONS = 64;
+const unsigned Server::DEFAULT_MAX_QUEUE_WAIT_MS = 10000;
+const int Server::TIMEOUT_EXIT_CODE = 3;
+const unsigned Server::RESPAWN_BACKOFF_MS = 100;
+const unsigned Server::MAX_RESPAWN_BACKOFF_MS = 10000;
+const unsigned Server::MAX_RESPAWN_ATTEMPTS = 10;
+const int Server::VLOG_LEVEL = 10;
+
+volatile sig_atomic_t Server::is_stopping_ = 0;
+volatile sig_atomic_t Server::deadline_client_fd_ = -1;
+std::string Server::timeout_response_;
+
+Server::Server(const std::string socket_path)
+    : socket_path_ { socket_path },
+      listen_fd_ { -1 },
+      num_of_workers_ { static_cast<int>(std::thread::hardware_concurrency()) },
+      max_pending_connections_ { DEFAULT_MAX_PENDING_CONNECTIONS },
+      default_deadline_ms_ { 0 },
+      max_queue_wait_ms_ { DEFAULT_MAX_QUEUE_WAIT_MS } {
+  if (num_of_workers_ < 1) {
+    num_of_workers_ = 1;
+  }
+}
+
+Server::~Server() {
+  CloseSocket();
+}
+
+void Server::set_num_of_workers(const int num_of_workers) {
+  num_of_workers_ = (num_of_workers < 1) ? 1 : num_of_workers;
+}
+
+void Server::set_max_pending_connections(const int max_pending_connections) {
+  max_pending_connections_ = (max_pending_connections < 0) ? 0 : max_pending_connections;
+}
+
+void Server::set_default_deadline(const unsigned deadline_ms) {
+  default_deadline_ms_ = deadline_ms;
+}
+
+void Server::set_max_queue_wait(const unsigned max_queue_wait_ms) {
+  max_queue_wait_ms_ = max_queue_wait_ms;
+}
+
+int Server::Run() {
+  if (not OpenSocket()) {
+    return EXIT_FAILURE;
+  }
+
+  struct sigaction stop_action;
+  std::memset(&stop_action, 0, sizeof(stop_action));
+  stop_action.sa_handler = &Server::OnStopSignal;
+  sigaction(SIGINT, &stop_action, nullptr);
+  sigaction(SIGTERM, &stop_action, nullptr);
+  signal(SIGPIPE, SIG_IGN);
+
+  workers_.resize(num_of_workers_, Worker { -1, -1, false, 0, std::chrono::steady_clock::time_point() });
+  for (auto& worker : workers_) {
+    if (not SpawnWorker(worker)) {
+      StopWorkers();
+      CloseSocket();
+      return EXIT_FAILURE;
+    }
+  }
+  LOG(INFO) << "serving on " << socket_path_ << " with " << num_of_workers_ << " workers";
+
+  std::vector<struct pollfd> poll_fds;
+  while (not is_stopping_) {
+    poll_fds.clear();
+    poll_fds.push_back({ listen_fd_, POLLIN, 0 });
+    for (auto& worker : workers_) {
+      poll_fds.push_back({ worker.channel, POLLIN, 0 });
+    }
+
+    int ready = poll(poll_fds.data(), poll_fds.size(), GetPollTimeout());
+    if (ready < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG(ERROR) << "poll failed: " << std::strerror(errno);
+      break;
+    }
+
+    for (std::size_t i = 0; i < workers_.size(); ++i) {
+      if (poll_fds[i + 1].revents == 0) {
+        continue;
+      }
+      char message = 0;
+      ssize_t n = read(workers_[i].channel, &message, 1);
+      if (n == 1) {
+        OnWorkerIdle(workers_[i]);
+      } else if (n == 0 or (n < 0 and errno != EINTR and errno != EAGAIN)) {
+        ReapWorker(workers_[i]);
+      }
+    }
+
+    if (not is_stopping_ and not RespawnWorkers()) {
+      LOG(ERROR) << "no worker left, giving up after " << MAX_RESPAWN_ATTEMPTS << " failed respawns";
+      StopWorkers();
+      CloseSocket();
+      return EXIT_FAILURE;
+    }
+
+    if (poll_fds[0].revents & POLLIN) {
+      int client_fd = accept(listen_fd_, nullptr, nullptr);
+      if (client_fd >= 0) {
+        Admit(client_fd);
+      } else if (errno != EINTR and errno != EAGAIN) {
+        LOG(ERROR) << "accept failed: " << std::strerror(errno);
+      }
+    }
+    ExpirePendingConnections();
+  }
+
+  LOG(INFO) << "stopping server";
+  StopWorkers();
+  CloseSocket();
+  return EXIT_SUCCESS;
+}
+
+bool Server::OpenSocket() {
+  struct sockaddr_un address;
+  if (socket_path_.size() >= sizeof(address.sun_path)) {
+    LOG(ERROR) << "socket path is too long: " << socket_path_;
+    return false;
+  }
+
+  listen_fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listen_fd_ < 0) {
+    LOG(ERROR) << "cannot create socket: " << std::strerror(errno);
+    return false;
+  }
+
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  std::strncpy(address.sun_path, socket_path_.c_str(), sizeof(address.sun_path) - 1);
+  unlink(socket_path_.c_str());
+  if (bind(listen_fd_, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) < 0
+      or listen(listen_fd_, SOMAXCONN) < 0) {
+    LOG(ERROR) << "cannot listen on " << socket_path_ << ": " << std::strerror(errno);
+    close(listen_fd_);
+    listen_fd_ = -1;
+    return false;
+  }
+  return true;
+}
+
+void Server::CloseSocket() {
+  if (listen_fd_ >= 0) {
+    close(listen_fd_);
+    listen_fd_ = -1;
+    unlink(socket_path_.c_str());
+  }
+  for (auto& pending : pending_connections_) {
+    close(pending.client_fd);
+  }
+  pending_connections_.clear();
+}
+
+bool Server::SpawnWorker(Worker& worker) {
+  int channels[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, channels) < 0) {
+    LOG(ERROR) << "cannot create worker channel: " << std::strerror(errno);
+    return false;
+  }
+
+  pid_t pid = fork();
+  if (pid < 0) {
+    LOG(ERROR) << "cannot fork worker: " << std::strerror(errno);
+    close(channels[0]);
+    close(channels[1]);
+    return false;
+  } else if (pid == 0) {
+    close(channels[0]);
+    close(listen_fd_);
+    for (auto& other : workers_) {
+      if (other.pid > 0 and other.channel >= 0) {
+        close(other.channel);
+      }
+    }
+    for (auto& pending : pending_connections_) {
+      close(pending.client_fd);
+    }
+    WorkerLoop(channels[1]);
+    _exit(EXIT_SUCCESS);
+  }
+
+  close(channels[1]);
+  worker.pid = pid;
+  worker.channel = channels[0];
+  worker.is_busy = false;
+  DVLOG(VLOG_LEVEL) << "spawned worker " << pid;
+  return true;
+}
+
+void Server::ReapWorker(Worker& worker) {
+  int status = 0;
+  waitpid(worker.pid, &status, 0);
+  if (WIFEXITED(status) and WEXITSTATUS(status) == TIMEOUT_EXIT_CODE) {
+    LOG(WARNING) << "worker " << worker.pid << " exceeded a request deadline";
+  } else if (not is_stopping_) {
+    LOG(WARNING) << "worker " << worker.pid << " terminated unexpectedly with status " << status;
+  }
+  close(worker.channel);
+  worker.pid = -1;
+  worker.channel = -1;
+  worker.is_busy = false;
+  worker.respawn_failures = 0;
+  worker.respawn_at = std::chrono::steady_clock::now();
+}
+
+void Server::StopWorkers() {
+  for (auto& worker : workers_) {
+    if (worker.pid > 0) {
+      close(worker.channel);
+      kill(worker.pid, SIGTERM);
+    }
+  }
+  for (auto& worker : workers_) {
+    if (worker.pid > 0) {
+      waitpid(worker.pid, nullptr, 0);
+      worker.pid = -1;
+      worker.channel = -1;
+    }
+  }
+}
+
+/**
+ * Replaces terminated workers whose backoff elapsed, doubling the backoff of a worker on every failed attempt
+ * @return false if no worker is alive and a replacement failed MAX_RESPAWN_ATTEMPTS times in a row
+ */
+bool Server::RespawnWorkers() {
+  auto now = std::chrono::steady_clock::now();
+  bool is_any_alive = false;
+  bool is_exhausted = false;
+  for (auto& worker : workers_) {
+    if (worker.pid < 0 and worker.respawn_at <= now) {
+      if (SpawnWorker(worker)) {
+        worker.respawn_failures = 0;
+        OnWorkerIdle(worker);
+      } else {
+        unsigned shift = std::min(worker.respawn_failures, 16u);
+        unsigned backoff_ms = std::min(RESPAWN_BACKOFF_MS << shift, MAX_RESPAWN_BACKOFF_MS);
+        ++worker.respawn_failures;
+        worker.respawn_at = now + std::chrono::milliseconds(backoff_ms);
+        LOG(WARNING) << "cannot replace worker, attempt " << worker.respawn_failures << ", retrying in " << backoff_ms
+                     << "ms";
+      }
+    }
+    if (worker.pid > 0) {
+      is_any_alive = true;
+    } else if (worker.respawn_failures >= MAX_RESPAWN_ATTEMPTS) {
+      is_exhausted = true;
+    }
+  }
+  return is_any_alive or not is_exhausted;
+}
+
+void Server::Admit(int client_fd) {
+  for (auto& worker : workers_) {
+    if (worker.pid > 0 and not worker.is_busy) {
+      if (Handover(worker, client_fd)) {
+        return;
+      }
+    }
+  }
+
+  if (pending_connections_.size() < static_cast<std::size_t>(max_pending_connections_)) {
+    pending_connections_.push_back( { client_fd, std::chrono::steady_clock::now() });
+    DVLOG(VLOG_LEVEL) << "queued connection, pending: " << pending_connections_.size();
+  } else {
+    Reject(client_fd);
+  }
+}
+
+void Server::Reject(int client_fd) {
+  DVLOG(VLOG_LEVEL) << "rejected connection, pending: " << pending_connections_.size();
+  Response response { Status::BUSY, "server is at capacity" };
+  Protocol::WriteResponse(client_fd, response);
+  close(client_fd);
+}
+
+bool Server::Handover(Worker& worker, int client_fd) {
+  if (not SendFd(worker.channel, client_fd)) {
+    return false;
+  }
+  worker.is_busy = true;
+  close(client_fd);
+  return true;
+}
+
+void Server::OnWorkerIdle(Worker& worker) {
+  worker.is_busy = false;
+  while (not pending_connections_.empty()) {
+    int client_fd = pending_connections_.front().client_fd;
+    pending_connections_.pop_front();
+    if (Handover(worker, client_fd)) {
+      return;
+    }
+    Reject(client_fd);
+  }
+}
+
+/**
+ * Milliseconds until the oldest queued connection reaches the queue wait limit or the next worker respawn is due,
+ * -1 to wait without a timeout
+ */
+int Server::GetPollTimeout() const {
+  auto now = std::chrono::steady_clock::now();
+  bool has_timeout = false;
+  long timeout_ms = 0;
+  if (max_queue_wait_ms_ != 0 and not pending_connections_.empty()) {
+    auto waited = now - pending_connections_.front().queued_at;
+    timeout_ms = static_cast<long>(max_queue_wait_ms_)
+        - std::chrono::duration_cast<std::chrono::milliseconds>(waited).count();
+    has_timeout = true;
+  }
+  for (auto& worker : workers_) {
+    if (worker.pid < 0) {
+      long respawn_ms = std::chrono::duration_cast<std::chrono::milliseconds>(worker.respawn_at - now).count();
+      if (not has_timeout or respawn_ms < timeout_ms) {
+        timeout_ms = respawn_ms;
+        has_timeout = true;
+      }
+    }
+  }
+  if (not has_timeout) {
+    return -1;
+  }
+  return (timeout_ms < 0) ? 0 : static_cast<int>(timeout_ms);
+}
+
+void Server::ExpirePendingConnections() {
+  if (max_queue_wait_ms_ == 0) {
+    return;
+  }
+  auto now = std::chrono::steady_clock::now();
+  const std::chrono::milliseconds max_queue_wait { max_queue_wait_ms_ };
+  while (not pending_connections_.empty() and now - pending_connections_.front().queued_at >= max_queue_wait) {
+    int client_fd = pending_connections_.front().client_fd;
+    pending_connections_.pop_front();
+    Reject(client_fd);
+  }
+}
+
+void Server::WorkerLoop(int channel) {
+  signal(SIGINT, SIG_IGN);
+  signal(SIGTERM, SIG_DFL);
+  signal(SIGPIPE, SIG_IGN);
+
+  struct sigaction deadline_action;
+  std::memset(&deadline_action, 0, sizeof(deadline_action));
+  deadline_action.sa_handler = &Server::OnDeadlineSignal;
+  sigaction(SIGALRM, &deadline_action, nullptr);
+  timeout_response_ = Protocol::EncodeResponse( { Status::TIMEOUT, "request deadline exceeded" });
+
+  while (true) {
+    int client_fd = ReceiveFd(channel);
+    if (client_fd < 0) {
+      break;
+    }
+    ServeConnection(client_fd);
+    close(client_fd);
+    char idle = 1;
+    if (write(channel, &idle, 1) != 1) {
+      break;
+    }
+  }
+  close(channel);
+}
+
+void Server::ServeConnection(int client_fd) {
+  Session session;
+  Request request;
+  while (Protocol::ReadRequest(client_fd, request)) {
+    unsigned deadline_ms = request.deadline_ms;
+    if (default_deadline_ms_ > 0 and (deadline_ms == 0 or deadline_ms > default_deadline_ms_)) {
+      deadline_ms = default_deadline_ms_;
+    }
+    ArmDeadline(client_fd, deadline_ms);
+    Response response = session.Handle(request);
+    DisarmDeadline();
+    if (not Protocol::WriteResponse(client_fd, response)) {
+      break;
+    }
+  }
+}
+
+void Server::ArmDeadline(int client_fd, unsigned deadline_ms) {
+  if (deadline_ms == 0) {
+    return;
+  }
+  deadline_client_fd_ = client_fd;
+  struct itimerval timer;
+  std::memset(&timer, 0, sizeof(timer));
+  timer.it_value.tv_sec = deadline_ms / 1000;
+  timer.it_value.tv_usec = (deadline_ms % 1000) * 1000;
+  setitimer(ITIMER_REAL, &timer, nullptr);
+}
+
+void Server::DisarmDeadline() {
+  struct itimerval timer;
+  std::memset(&timer, 0, sizeof(timer));
+  setitimer(ITIMER_REAL, &timer, nullptr);
+  deadline_client_fd_ = -1;
+}
+
+bool Server::SendFd(int channel, int fd) {
+  char data = 0;
+  struct iovec io = { &data, 1 };
+  char control[CMSG_SPACE(sizeof(int))];
+  std::memset(control, 0, sizeof(control));
+
+  struct msghdr message;
+  std::memset(&message, 0, sizeof(message));
+  message.msg_iov = &io;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+
+  struct cmsghdr* control_message = CMSG_FIRSTHDR(&message);
+  control_message->cmsg_level = SOL_SOCKET;
+  control_message->cmsg_type = SCM_RIGHTS;
+  control_message->cmsg_len = CMSG_LEN(sizeof(int));
+  std::memcpy(CMSG_DATA(control_message), &fd, sizeof(int));
+
+  return sendmsg(channel, &message, 0) == 1;
+}
+
+int Server::ReceiveFd(int channel) {
+  char data = 0;
+  struct iovec io = { &data, 1 };
+  char control[CMSG_SPACE(sizeof(int))];
+
+  struct msghdr message;
+  std::memset(&message, 0, sizeof(message));
+  message.msg_iov = &io;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+
+  ssize_t n = 0;
+  do {
+    n = recvmsg(channel, &message, 0);
+  } while (n < 0 and errno == EINTR);
+  if (n <= 0) {
+    return -1;
+  }
+
+  struct cmsghdr* control_message = CMSG_FIRSTHDR(&message);
+  if (control_message == nullptr or control_message->cmsg_type != SCM_RIGHTS) {
+    return -1;
+  }
+  int fd = -1;
+  std::memcpy(&fd, CMSG_DATA(control_message), sizeof(int));
+  return fd;
+}
+
+void Server::OnStopSignal(int signal) {
+  is_stopping_ = 1;
+}
+
+/**
+ * Solver operations cannot be interrupted safely, the worker answers the client and exits,
+ * the server spawns a replacement.
+ * Only async-signal-safe calls are used here.
+ */
+void Server::OnDeadlineSignal(int signal) {
+  int client_fd = deadline_client_fd_;
+  if (client_fd >= 0) {
+    ssize_t r = write(client_fd, timeout_response_.data(), timeout_response_.size());
+    (void) r;
+  }
+  _exit(TIMEOUT_EXIT_CODE);
+}
+
+} /* namespace Server */
+} /* namespace Vlab */
@@ -0,0 +1,124 @@
+/*
+ * Server.h
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef SRC_SERVER_SERVER_H_
+#define SRC_SERVER_SERVER_H_
+
+#include <chrono>
+#include <csignal>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+#include <glog/logging.h>
+
+#include "Protocol.h"
+#include "Session.h"
+
+namespace Vlab {
+namespace Server {
+
+/**
+ * Long running solver daemon listening on a unix domain socket.
+ *
+ * MONA and the solver options keep process wide state, hence requests are not solved on threads.
+ * The server keeps a bounded pool of forked worker processes instead, each serving one connection
+ * at a time with its own session. Accepted connections are handed to idle workers, queued up to a
+ * limit while all workers are busy and rejected with a BUSY response beyond that limit or when they
+ * wait in the queue longer than the queue wait limit.
+ * A worker that misses a request deadline answers with TIMEOUT, closes the connection and is
+ * replaced with a fresh worker.
+ * A worker that cannot be replaced is retried with exponential backoff; the server exits with a
+ * failure once no worker is left and a replacement failed MAX_RESPAWN_ATTEMPTS times in a row.
+ */
+class Server {
+ public:
+  Server(const std::string socket_path);
+  virtual ~Server();
+
+  void set_num_of_workers(const int num_of_workers);
+  void set_max_pending_connections(const int max_pending_connections);
+  void set_default_deadline(const unsigned deadline_ms);
+  /**
+   * Longest time a connection waits for a worker before it is rejected with BUSY, 0 means no limit
+   */
+  void set_max_queue_wait(const unsigned max_queue_wait_ms);
+
+  /**
+   * Serves requests until the process receives SIGINT or SIGTERM
+   * @return exit code of the server
+   */
+  int Run();
+
+  static const int DEFAULT_MAX_PENDING_CONNECTIONS;
+  static const unsigned DEFAULT_MAX_QUEUE_WAIT_MS;
+
+ protected:
+  struct Worker {
+    pid_t pid;
+    int channel;
+    bool is_busy;
+    unsigned respawn_failures;
+    std::chrono::steady_clock::time_point respawn_at;
+  };
+
+  struct PendingConnection {
+    int client_fd;
+    std::chrono::steady_clock::time_point queued_at;
+  };
+
+  bool OpenSocket();
+  void CloseSocket();
+  bool SpawnWorker(Worker& worker);
+  void ReapWorker(Worker& worker);
+  void StopWorkers();
+  bool RespawnWorkers();
+  void Admit(int client_fd);
+  void Reject(int client_fd);
+  bool Handover(Worker& worker, int client_fd);
+  void OnWorkerIdle(Worker& worker);
+  int GetPollTimeout() const;
+  void ExpirePendingConnections();
+
+  void WorkerLoop(int channel);
+  void ServeConnection(int client_fd);
+  void ArmDeadline(int client_fd, unsigned deadline_ms);
+  void DisarmDeadline();
+
+  static bool SendFd(int channel, int fd);
+  static int ReceiveFd(int channel);
+  static void OnStopSignal(int signal);
+  static void OnDeadlineSignal(int signal);
+
+  std::string socket_path_;
+  int listen_fd_;
+  int num_of_workers_;
+  int max_pending_connections_;
+  unsigned default_deadline_ms_;
+  unsigned max_queue_wait_ms_;
+  std::vector<Worker> workers_;
+  std::deque<PendingConnection> pending_connections_;
+
+  static volatile sig_atomic_t is_stopping_;
+  static volatile sig_atomic_t deadline_client_fd_;
+  static std::string timeout_response_;
+
+ private:
+  static const int TIMEOUT_EXIT_CODE;
+  static const unsigned RESPAWN_BACKOFF_MS;
+  static const unsigned MAX_RESPAWN_BACKOFF_MS;
+  static const unsigned MAX_RESPAWN_ATTEMPTS;
+  static const int VLOG_LEVEL;
+};
+
+} /* namespace Server */
+} /* namespace Vlab */
+
+#endif /* SRC_SERVER_SERVER_H_ */
@@ -0,0 +1,175 @@
+/*
+ * Session.cpp
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "Session.h"
+
+namespace Vlab {
+namespace Server {
+
+const int Session::VLOG_LEVEL = 10;
+
+Session::Session() : is_solved_ { false } {
+}
+
+Session::~Session() {
+}
+
+Response Session::Handle(const Request& request) {
+  DVLOG(VLOG_LEVEL) << "session request: " << static_cast<int>(request.command);
+  switch (request.command) {
+    case Command::SOLVE:
+      return Solve(request);
+    case Command::COUNT:
+      return Count(request);
+    case Command::GET_MODELS:
+      return GetModels(request);
+    case Command::GET_MODEL_COUNTER:
+      return GetModelCounter(request);
+    case Command::RESET:
+      return Reset(request);
+    case Command::GET_METRICS:
+      return GetMetrics(request);
+    default:
+      break;
+  }
+  return MakeError("unknown command: " + std::to_string(static_cast<int>(request.command)));
+}
+
+Response Session::Solve(const Request& request) {
+  driver_.reset();
+  is_solved_ = false;
+  std::istringstream input_constraint(request.payload);
+  if (driver_.Parse(&input_constraint) != 0) {
+    driver_.reset();
+    return MakeError("syntax error in script");
+  }
+  driver_.InitializeSolver();
+  driver_.Solve();
+  is_solved_ = true;
+  if (driver_.is_unknown()) {
+    return MakeUnknown();
+  }
+  Response response { Status::OK, std::string(1, driver_.is_sat() ? 1 : 0) };
+  return response;
+}
+
+Response Session::Count(const Request& request) {
+  if (not is_solved_) {
+    return MakeError("no solved script in session");
+  }
+  std::size_t pos = 0;
+  uint64_t int_bound = 0, str_bound = 0;
+  if (not Protocol::GetU64(request.payload, pos, int_bound) or not Protocol::GetU64(request.payload, pos, str_bound)) {
+    return MakeError("malformed count request");
+  }
+  std::string var_name = request.payload.substr(pos);
+
+  Theory::BigInteger result;
+  if (not driver_.is_sat()) {
+    result = 0;
+  } else if (var_name.empty()) {
+    result = driver_.Count(int_bound, str_bound);
+  } else {
+    auto variable = driver_.symbol_table_->get_variable_unsafe(var_name);
+    if (variable == nullptr) {
+      return MakeError("variable is not found: " + var_name);
+    }
+    auto bound = (SMT::Variable::Type::INT == variable->getType()) ? int_bound : str_bound;
+    result = driver_.CountVariable(var_name, bound);
+  }
+  if (driver_.is_unknown()) {
+    return MakeUnknown();
+  }
+
+  std::stringstream ss;
+  ss << result;
+  Response response { Status::OK, ss.str() };
+  return response;
+}
+
+Response Session::GetModels(const Request& request) {
+  if (not is_solved_) {
+    return MakeError("no solved script in session");
+  }
+  std::size_t pos = 0;
+  uint32_t num_of_models = 0, bound = 0;
+  if (not Protocol::GetU32(request.payload, pos, num_of_models) or not Protocol::GetU32(request.payload, pos, bound)) {
+    return MakeError("malformed get-models request");
+  }
+
+  std::vector<Model> models;
+  if (driver_.is_sat()) {
+    if (num_of_models == 1 and bound == 0) {
+      models.push_back(driver_.getSatisfyingExamples());
+    } else {
+      for (uint32_t i = 0; i < num_of_models; ++i) {
+        if (bound == 0) {
+          models.push_back(driver_.getSatisfyingExamplesRandom());
+        } else {
+          models.push_back(driver_.getSatisfyingExamplesRandomBounded(bound));
+        }
+      }
+    }
+  }
+
+  if (driver_.is_unknown()) {
+    return MakeUnknown();
+  }
+  Response response { Status::OK, Protocol::EncodeModels(models) };
+  return response;
+}
+
+Response Session::GetModelCounter(const Request& request) {
+  if (not is_solved_) {
+    return MakeError("no solved script in session");
+  }
+  const std::string& var_name = request.payload;
+  if (not var_name.empty() and driver_.symbol_table_->get_variable_unsafe(var_name) == nullptr) {
+    return MakeError("variable is not found: " + var_name);
+  }
+
+  std::stringstream os;
+  {
+    cereal::BinaryOutputArchive ar(os);
+    if (var_name.empty()) {
+      driver_.GetModelCounter().save(ar);
+    } else {
+      driver_.GetModelCounterForVariable(var_name).save(ar);
+    }
+  }
+  if (driver_.is_unknown()) {
+    return MakeUnknown();
+  }
+  Response response { Status::OK, os.str() };
+  return response;
+}
+
+Response Session::Reset(const Request& request) {
+  driver_.reset();
+  is_solved_ = false;
+  Response response { Status::OK, "" };
+  return response;
+}
+
+Response Session::GetMetrics(const Request& request) {
+  Response response { Status::OK, Driver::GetMetricsText() };
+  return response;
+}
+
+Response Session::MakeError(const std::string& message) const {
+  Response response { Status::ERROR, message };
+  return response;
+}
+
+Response Session::MakeUnknown() const {
+  Response response { Status::UNKNOWN, "" };
+  return response;
+}
+
+} /* namespace Server */
+} /* namespace Vlab */
@@ -0,0 +1,57 @@
+/*
+ * Session.h
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef SRC_SERVER_SESSION_H_
+#define SRC_SERVER_SESSION_H_
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "../Driver.h"
+#include "Protocol.h"
+
+namespace Vlab {
+namespace Server {
+
+/**
+ * Keeps the solver state of a single client connection.
+ * Results of the last solved script stay available for counting and model queries until
+ * the next solve or reset request.
+ */
+class Session {
+ public:
+  Session();
+  virtual ~Session();
+
+  Response Handle(const Request& request);
+
+ protected:
+  Response Solve(const Request& request);
+  Response Count(const Request& request);
+  Response GetModels(const Request& request);
+  Response GetModelCounter(const Request& request);
+  Response Reset(const Request& request);
+  Response GetMetrics(const Request& request);
+
+  Response MakeError(const std::string& message) const;
+  Response MakeUnknown() const;
+
+  Driver driver_;
+  bool is_solved_;
+
+ private:
+  static const int VLOG_LEVEL;
+};
+
+} /* namespace Server */
+} /* namespace Vlab */
+
+#endif /* SRC_SERVER_SESSION_H_ */
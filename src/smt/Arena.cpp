@@ -0,0 +1,133 @@
+/*
+ * Arena.cpp
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "Arena.h"
+
+#include <new>
+
+#include "Visitable.h"
+
+namespace Vlab {
+namespace SMT {
+
+const std::size_t Arena::DEFAULT_BLOCK_SIZE = 64 * 1024;
+const std::size_t Arena::ALIGNMENT = alignof(std::max_align_t);
+const std::size_t Arena::HEADER_SIZE = alignof(std::max_align_t);
+
+thread_local Arena_ptr Arena::current_ = nullptr;
+thread_local bool Arena::is_releasing_ = false;
+
+Arena::Arena(const std::size_t block_size)
+    : block_size_ { block_size },
+      allocated_bytes_ { 0 },
+      reserved_bytes_ { 0 },
+      cursor_ { nullptr },
+      limit_ { nullptr } {
+}
+
+Arena::~Arena() {
+  Release();
+}
+
+void* Arena::Allocate(const std::size_t size) {
+  const std::size_t aligned_size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+  if (cursor_ == nullptr or static_cast<std::size_t>(limit_ - cursor_) < aligned_size) {
+    const std::size_t new_block_size = (aligned_size > block_size_) ? aligned_size : block_size_;
+    char* block = static_cast<char*>(::operator new(new_block_size));
+    blocks_.push_back(block);
+    cursor_ = block;
+    limit_ = block + new_block_size;
+    reserved_bytes_ += new_block_size;
+  }
+  void* ptr = cursor_;
+  cursor_ += aligned_size;
+  allocated_bytes_ += aligned_size;
+  return ptr;
+}
+
+void Arena::Release() {
+  // newest nodes first, parents are usually created after their children
+  const bool was_releasing = is_releasing_;
+  is_releasing_ = true;
+  for (auto it = nodes_.rbegin(); it != nodes_.rend(); ++it) {
+    Origin* origin = get_origin(*it);
+    if (*origin == Origin::ARENA) {
+      *origin = Origin::DESTROYED;
+      static_cast<Visitable*>(*it)->~Visitable();
+    }
+  }
+  is_releasing_ = was_releasing;
+  nodes_.clear();
+
+  for (auto block : blocks_) {
+    ::operator delete(block);
+  }
+  blocks_.clear();
+  cursor_ = nullptr;
+  limit_ = nullptr;
+  allocated_bytes_ = 0;
+  reserved_bytes_ = 0;
+}
+
+std::size_t Arena::get_allocated_bytes() const {
+  return allocated_bytes_;
+}
+
+std::size_t Arena::get_reserved_bytes() const {
+  return reserved_bytes_;
+}
+
+Arena_ptr Arena::get_current() {
+  return current_;
+}
+
+Arena::Scope::Scope(Arena_ptr arena)
+    : previous_ { Arena::current_ } {
+  Arena::current_ = arena;
+}
+
+Arena::Scope::~Scope() {
+  Arena::current_ = previous_;
+}
+
+void* Arena::AllocateNode(const std::size_t size) {
+  char* base = nullptr;
+  Origin origin = Origin::HEAP;
+  if (current_ != nullptr) {
+    base = static_cast<char*>(current_->Allocate(HEADER_SIZE + size));
+    origin = Origin::ARENA;
+    current_->nodes_.push_back(base + HEADER_SIZE);
+  } else {
+    base = static_cast<char*>(::operator new(HEADER_SIZE + size));
+  }
+  *reinterpret_cast<Origin*>(base) = origin;
+  return base + HEADER_SIZE;
+}
+
+void Arena::DeallocateNode(void* ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+  Origin* origin = get_origin(ptr);
+  if (*origin == Origin::HEAP) {
+    ::operator delete(reinterpret_cast<char*>(origin));
+  } else {
+    *origin = Origin::DESTROYED;
+  }
+}
+
+bool Arena::is_destroyed_by_release(const void* ptr) {
+  return is_releasing_ and ptr != nullptr and *get_origin(ptr) != Origin::HEAP;
+}
+
+Arena::Origin* Arena::get_origin(const void* ptr) {
+  return reinterpret_cast<Origin*>(const_cast<char*>(static_cast<const char*>(ptr)) - HEADER_SIZE);
+}
+
+} /* namespace SMT */
+} /* namespace Vlab */
@@ -0,0 +1,108 @@
+/*
+ * Arena.h
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef SRC_SMT_ARENA_H_
+#define SRC_SMT_ARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Vlab {
+namespace SMT {
+
+class Arena;
+using Arena_ptr = Arena*;
+
+/**
+ * Bump allocator for the AST nodes of a single script.
+ *
+ * While an arena is installed with an Arena::Scope, every AST node is carved out of the arena
+ * blocks instead of the global heap. Deleting an arena node only runs its destructor, the memory
+ * is given back in one shot with Release(). Nodes created without an installed arena keep using
+ * the global heap, so a node can always be deleted no matter where it was allocated.
+ *
+ * Release() also destroys the arena nodes that were not deleted, including nodes that passes
+ * detached from the tree. Each node is destroyed once without recursing into its children, so a
+ * script does not have to be deleted before its arena is released.
+ */
+class Arena {
+ public:
+  Arena(const std::size_t block_size = DEFAULT_BLOCK_SIZE);
+  virtual ~Arena();
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  void* Allocate(const std::size_t size);
+
+  /**
+   * Destroys the nodes that are still alive and frees all the blocks at once; nodes allocated from
+   * this arena must not be used afterwards.
+   */
+  void Release();
+
+  std::size_t get_allocated_bytes() const;
+  std::size_t get_reserved_bytes() const;
+
+  static Arena_ptr get_current();
+
+  /**
+   * Installs an arena as the current allocation target until the end of the enclosing block.
+   */
+  class Scope {
+   public:
+    Scope(Arena_ptr arena);
+    ~Scope();
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+   private:
+    Arena_ptr previous_;
+  };
+
+  /**
+   * Used by Visitable::operator new/delete. Each node is prefixed with a small header that tells
+   * whether it lives in an arena or in the global heap.
+   */
+  static void* AllocateNode(const std::size_t size);
+  static void DeallocateNode(void* ptr);
+
+  /**
+   * True for arena nodes while an arena is released on this thread, Release() destroys them itself
+   */
+  static bool is_destroyed_by_release(const void* ptr);
+
+  static const std::size_t DEFAULT_BLOCK_SIZE;
+
+ protected:
+  enum class Origin : uint8_t {
+    HEAP = 0, ARENA, DESTROYED
+  };
+
+  static Origin* get_origin(const void* ptr);
+
+  std::size_t block_size_;
+  std::size_t allocated_bytes_;
+  std::size_t reserved_bytes_;
+  char* cursor_;
+  char* limit_;
+  std::vector<char*> blocks_;
+  std::vector<void*> nodes_;
+
+  static thread_local Arena_ptr current_;
+  static thread_local bool is_releasing_;
+
+ private:
+  static const std::size_t ALIGNMENT;
+  static const std::size_t HEADER_SIZE;
+};
+
+} /* namespace SMT */
+} /* namespace Vlab */
+
+#endif /* SRC_SMT_ARENA_H_ */
@@ -8,8 +8,10 @@
 #ifndef SMT_VISITABLE_H_
 #define SMT_VISITABLE_H_
 
+#include <cstddef>
 #include <vector>
 
+#include "Arena.h"
 #include "typedefs.h"
 
 namespace Vlab {
@@ -23,12 +25,33 @@ public:
   virtual void accept(Visitor_ptr) = 0;
   virtual void visit_children(Visitor_ptr) = 0;
 
+  /**
+   * AST nodes are allocated from the current script arena when one is installed.
+   */
+  static void* operator new(std::size_t size) {
+    return Arena::AllocateNode(size);
+  }
+
+  static void operator delete(void* ptr) {
+    Arena::DeallocateNode(ptr);
+  }
+
+  /**
+   * Deletes a child node. While an arena is released it destroys each of its nodes once, children
+   * living in the arena are left to it.
+   */
+  static void delete_node(Visitable* node) {
+    if (not Arena::is_destroyed_by_release(node)) {
+      delete node;
+    }
+  }
+
   template<class T>
   void deallocate_list(std::vector<T*> *v) {
     if (v == nullptr)
       return;
     for (auto& el : *v) {
-      delete (el);
+      delete_node(el);
       el = nullptr;
     }
   }
@@ -90,7 +90,7 @@ SetLogic* SetLogic::clone() const {
 }
 
 SetLogic::~SetLogic() {
-  delete symbol;
+  delete_node(symbol);
 }
 
 std::string SetLogic::str() const {
@@ -127,10 +127,10 @@ DeclareFun* DeclareFun::clone() const {
 }
 
 DeclareFun::~DeclareFun() {
-  delete symbol;
+  delete_node(symbol);
   deallocate_list(sort_list);
   delete sort_list;
-  delete sort;
+  delete_node(sort);
 }
 
 std::string DeclareFun::str() const {
@@ -158,7 +158,7 @@ Assert_ptr Assert::clone() const {
 }
 
 Assert::~Assert() {
-  delete term;
+  delete_node(term);
 }
 
 void Assert::accept(Visitor_ptr v) {
@@ -193,7 +193,7 @@ CheckSat* CheckSat::clone() const {
 }
 
 CheckSat::~CheckSat() {
-  delete symbol;
+  delete_node(symbol);
 }
 
 std::string CheckSat::str() const {
@@ -227,8 +227,8 @@ CheckSatAndCount* CheckSatAndCount::clone() const {
 }
 
 CheckSatAndCount::~CheckSatAndCount() {
-  delete bound;
-  delete symbol;
+  delete_node(bound);
+  delete_node(symbol);
 }
 
 std::string CheckSatAndCount::str() const {
@@ -304,7 +304,7 @@ Exclamation_ptr Exclamation::clone() const {
 }
 
 Exclamation::~Exclamation() {
-  delete term;
+  delete_node(term);
   deallocate_list(attribute_list);
   delete attribute_list;
 }
@@ -344,7 +344,7 @@ Exists_ptr Exists::clone() const {
 Exists::~Exists() {
   deallocate_list(sorted_var_list);
   delete sorted_var_list;
-  delete term;
+  delete_node(term);
 }
 
 std::string Exists::str() const {
@@ -382,7 +382,7 @@ ForAll_ptr ForAll::clone() const {
 ForAll::~ForAll() {
   deallocate_list(sorted_var_list);
   delete sorted_var_list;
-  delete term;
+  delete_node(term);
 }
 
 std::string ForAll::str() const {
@@ -420,7 +420,7 @@ Let_ptr Let::clone() const {
 Let::~Let() {
   deallocate_list(var_binding_list);
   delete var_binding_list;
-  delete term;
+  delete_node(term);
 }
 
 std::string Let::str() const {
@@ -513,7 +513,7 @@ Not_ptr Not::clone() const {
 }
 
 Not::~Not() {
-  delete term;
+  delete_node(term);
 }
 
 std::string Not::str() const {
@@ -543,7 +543,7 @@ UMinus_ptr UMinus::clone() const {
 }
 
 UMinus::~UMinus() {
-  delete term;
+  delete_node(term);
 }
 
 std::string UMinus::str() const {
@@ -575,8 +575,8 @@ Minus_ptr Minus::clone() const {
 }
 
 Minus::~Minus() {
-  delete left_term;
-  delete right_term;
+  delete_node(left_term);
+  delete_node(right_term);
 }
 
 std::string Minus::str() const {
@@ -711,8 +711,8 @@ Eq_ptr Eq::clone() const {
 }
 
 Eq::~Eq() {
-  delete left_term;
-  delete right_term;
+  delete_node(left_term);
+  delete_node(right_term);
 }
 
 std::string Eq::str() const {
@@ -745,8 +745,8 @@ NotEq_ptr NotEq::clone() const {
 }
 
 NotEq::~NotEq() {
-  delete left_term;
-  delete right_term;
+  delete_node(left_term);
+  delete_node(right_term);
 }
 
 std::string NotEq::str() const {
@@ -779,7 +779,8 @@ Gt_ptr Gt::clone() const {
 }
 
 Gt::~Gt() {
-  delete left_term, delete right_term;
+  delete_node(left_term);
+  delete_node(right_term);
 }
 
 std::string Gt::str() const {
@@ -812,7 +813,8 @@ Ge_ptr Ge::clone() const {
 }
 
 Ge::~Ge() {
-  delete left_term, delete right_term;
+  delete_node(left_term);
+  delete_node(right_term);
 }
 
 std::string Ge::str() const {
@@ -845,7 +847,8 @@ Lt_ptr Lt::clone() const {
 }
 
 Lt::~Lt() {
-  delete left_term, delete right_term;
+  delete_node(left_term);
+  delete_node(right_term);
 }
 
 std::string Lt::str() const {
@@ -878,7 +881,8 @@ Le_ptr Le::clone() const {
 }
 
 Le::~Le() {
-  delete left_term, delete right_term;
+  delete_node(left_term);
+  delete_node(right_term);
 }
 
 std::string Le::str() const {
@@ -945,7 +949,8 @@ In_ptr In::clone() const {
 }
 
 In::~In() {
-  delete left_term, delete right_term;
+  delete_node(left_term);
+  delete_node(right_term);
 }
 
 std::string In::str() const {
@@ -978,7 +983,8 @@ NotIn_ptr NotIn::clone() const {
 }
 
 NotIn::~NotIn() {
-  delete left_term, delete right_term;
+  delete_node(left_term);
+  delete_node(right_term);
 }
 
 std::string NotIn::str() const {
@@ -1009,7 +1015,7 @@ Len_ptr Len::clone() const {
 }
 
 Len::~Len() {
-  delete term;
+  delete_node(term);
 }
 
 std::string Len::str() const {
@@ -1041,8 +1047,8 @@ Contains_ptr Contains::clone() const {
 }
 
 Contains::~Contains() {
-  delete subject_term;
-  delete search_term;
+  delete_node(subject_term);
+  delete_node(search_term);
 }
 
 std::string Contains::str() const {
@@ -1075,8 +1081,8 @@ NotContains_ptr NotContains::clone() const {
 }
 
 NotContains::~NotContains() {
-  delete subject_term;
-  delete search_term;
+  delete_node(subject_term);
+  delete_node(search_term);
 }
 
 std::string NotContains::str() const {
@@ -1108,8 +1114,8 @@ Begins_ptr Begins::clone() const {
 }
 
 Begins::~Begins() {
-  delete subject_term;
-  delete search_term;
+  delete_node(subject_term);
+  delete_node(search_term);
 }
 
 std::string Begins::str() const {
@@ -1142,8 +1148,8 @@ NotBegins_ptr NotBegins::clone() const {
 }
 
 NotBegins::~NotBegins() {
-  delete subject_term;
-  delete search_term;
+  delete_node(subject_term);
+  delete_node(search_term);
 }
 
 std::string NotBegins::str() const {
@@ -1176,8 +1182,8 @@ Ends_ptr Ends::clone() const {
 }
 
 Ends::~Ends() {
-  delete subject_term;
-  delete search_term;
+  delete_node(subject_term);
+  delete_node(search_term);
 }
 
 std::string Ends::str() const {
@@ -1210,8 +1216,8 @@ NotEnds_ptr NotEnds::clone() const {
 }
 
 NotEnds::~NotEnds() {
-  delete subject_term;
-  delete search_term;
+  delete_node(subject_term);
+  delete_node(search_term);
 }
 
 std::string NotEnds::str() const {
@@ -1260,9 +1266,9 @@ IndexOf_ptr IndexOf::clone() const {
 }
 
 IndexOf::~IndexOf() {
-  delete subject_term;
-  delete search_term;
-  delete from_index;
+  delete_node(subject_term);
+  delete_node(search_term);
+  delete_node(from_index);
 }
 
 std::string IndexOf::str() const {
@@ -1320,9 +1326,9 @@ LastIndexOf_ptr LastIndexOf::clone() const {
 }
 
 LastIndexOf::~LastIndexOf() {
-  delete subject_term;
-  delete search_term;
-  delete from_index;
+  delete_node(subject_term);
+  delete_node(search_term);
+  delete_node(from_index);
 }
 
 std::string LastIndexOf::str() const {
@@ -1364,8 +1370,8 @@ CharAt_ptr CharAt::clone() const {
 }
 
 CharAt::~CharAt() {
-  delete subject_term;
-  delete index_term;
+  delete_node(subject_term);
+  delete_node(index_term);
 }
 
 std::string CharAt::str() const {
@@ -1414,9 +1420,9 @@ SubString_ptr SubString::clone() const {
 }
 
 SubString::~SubString() {
-  delete subject_term;
-  delete start_index_term;
-  delete end_index_term;
+  delete_node(subject_term);
+  delete_node(start_index_term);
+  delete_node(end_index_term);
 }
 
 std::string SubString::str() const {
@@ -1456,7 +1462,7 @@ ToUpper_ptr ToUpper::clone() const {
 }
 
 ToUpper::~ToUpper() {
-  delete subject_term;
+  delete_node(subject_term);
 }
 
 std::string ToUpper::str() const {
@@ -1486,7 +1492,7 @@ ToLower_ptr ToLower::clone() const {
 }
 
 ToLower::~ToLower() {
-  delete subject_term;
+  delete_node(subject_term);
 }
 
 std::string ToLower::str() const {
@@ -1516,7 +1522,7 @@ Trim_ptr Trim::clone() const {
 }
 
 Trim::~Trim() {
-  delete subject_term;
+  delete_node(subject_term);
 }
 
 std::string Trim::str() const {
@@ -1546,7 +1552,7 @@ ToString_ptr ToString::clone() const {
 }
 
 ToString::~ToString() {
-  delete subject_term;
+  delete_node(subject_term);
 }
 
 std::string ToString::str() const {
@@ -1576,7 +1582,7 @@ ToInt_ptr ToInt::clone() const {
 }
 
 ToInt::~ToInt() {
-  delete subject_term;
+  delete_node(subject_term);
 }
 
 std::string ToInt::str() const {
@@ -1610,9 +1616,9 @@ Replace_ptr Replace::clone() const {
 }
 
 Replace::~Replace() {
-  delete subject_term;
-  delete search_term;
-  delete replace_term;
+  delete_node(subject_term);
+  delete_node(search_term);
+  delete_node(replace_term);
 }
 
 std::string Replace::str() const {
@@ -1646,8 +1652,8 @@ Count_ptr Count::clone() const {
 }
 
 Count::~Count() {
-  delete subject_term;
-  delete bound_term;
+  delete_node(subject_term);
+  delete_node(bound_term);
 }
 
 std::string Count::str() const {
@@ -1682,9 +1688,9 @@ Ite_ptr Ite::clone() const {
 }
 
 Ite::~Ite() {
-  delete cond;
-  delete then_branch;
-  delete else_branch;
+  delete_node(cond);
+  delete_node(then_branch);
+  delete_node(else_branch);
 }
 
 std::string Ite::str() const {
@@ -1818,7 +1824,7 @@ ReStar_ptr ReStar::clone() const {
 }
 
 ReStar::~ReStar() {
-  delete term;
+  delete_node(term);
 }
 
 std::string ReStar::str() const {
@@ -1848,7 +1854,7 @@ RePlus_ptr RePlus::clone() const {
 }
 
 RePlus::~RePlus() {
-  delete term;
+  delete_node(term);
 }
 
 std::string RePlus::str() const {
@@ -1878,7 +1884,7 @@ ReOpt_ptr ReOpt::clone() const {
 }
 
 ReOpt::~ReOpt() {
-  delete term;
+  delete_node(term);
 }
 
 std::string ReOpt::str() const {
@@ -1908,7 +1914,7 @@ ToRegex_ptr ToRegex::clone() const {
 }
 
 ToRegex::~ToRegex() {
-  delete term;
+  delete_node(term);
 }
 
 std::string ToRegex::str() const {
@@ -1943,7 +1949,7 @@ UnknownTerm* UnknownTerm::clone() const {
 }
 
 UnknownTerm::~UnknownTerm() {
-  delete term;
+  delete_node(term);
   deallocate_list(term_list);
   delete term_list;
 }
@@ -1978,8 +1984,8 @@ AsQualIdentifier_ptr AsQualIdentifier::clone() const {
 }
 
 AsQualIdentifier::~AsQualIdentifier() {
-  delete identifier;
-  delete sort;
+  delete_node(identifier);
+  delete_node(sort);
 }
 
 std::string AsQualIdentifier::str() const {
@@ -2010,7 +2016,7 @@ QualIdentifier_ptr QualIdentifier::clone() const {
 }
 
 QualIdentifier::~QualIdentifier() {
-  delete identifier;
+  delete_node(identifier);
 }
 
 std::string QualIdentifier::str() const {
@@ -2043,7 +2049,7 @@ TermConstant_ptr TermConstant::clone() const {
 }
 
 TermConstant::~TermConstant() {
-  delete primitive;
+  delete_node(primitive);
 }
 
 std::string TermConstant::str() const {
@@ -2103,10 +2109,10 @@ Sort_ptr Sort::clone() const {
   return new Sort(*this);
 }
 Sort::~Sort() {
-  delete identifier;
+  delete_node(identifier);
   deallocate_list(sort_list);
   delete sort_list;
-  delete var_type;
+  delete_node(var_type);
 }
 
 void Sort::accept(Visitor_ptr v) {
@@ -2148,8 +2154,8 @@ SortedVar_ptr SortedVar::clone() const {
   return new SortedVar(*this);
 }
 SortedVar::~SortedVar() {
-  delete symbol;
-  delete sort;
+  delete_node(symbol);
+  delete_node(sort);
 }
 
 void SortedVar::accept(Visitor_ptr v) {
@@ -2173,8 +2179,8 @@ VarBinding_ptr VarBinding::clone() const {
   return new VarBinding(*this);
 }
 VarBinding::~VarBinding() {
-  delete symbol;
-  delete term;
+  delete_node(symbol);
+  delete_node(term);
 }
 
 void VarBinding::accept(Visitor_ptr v) {
@@ -2218,8 +2224,8 @@ Identifier_ptr Identifier::clone() const {
   return new Identifier(*this);
 }
 Identifier::~Identifier() {
-  delete underscore;
-  delete symbol;
+  delete_node(underscore);
+  delete_node(symbol);
   deallocate_list(numeral_list);
   delete numeral_list;
 
@@ -0,0 +1,199 @@
+/*
+ * AlphabetPartitioner.cpp
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "AlphabetPartitioner.h"
+
+namespace Vlab {
+namespace Solver {
+
+using namespace SMT;
+
+const int AlphabetPartitioner::VLOG_LEVEL = 19;
+
+AlphabetPartitioner::AlphabetPartitioner(Script_ptr script, SymbolTable_ptr symbol_table)
+    : AstTraverser(script),
+      symbol_table_(symbol_table),
+      is_compressible_(true),
+      encoding_(Option::Theory::CHARACTER_WIDTH) {
+  setCallbacks();
+}
+
+AlphabetPartitioner::~AlphabetPartitioner() {
+}
+
+void AlphabetPartitioner::start() {
+  DVLOG(VLOG_LEVEL) << "start";
+  visitScript(root_);
+  end();
+}
+
+void AlphabetPartitioner::end() {
+  if (is_compressible_) {
+    encoding_.Build();
+    is_compressible_ = not encoding_.is_identity();
+  }
+  DVLOG(VLOG_LEVEL) << "end, compressible: " << std::boolalpha << is_compressible_ << ", " << encoding_.str();
+}
+
+void AlphabetPartitioner::setCallbacks() {
+  auto term_callback = [this] (Term_ptr term) -> bool {
+    if (not is_compressible_) {
+      return false;
+    }
+    switch (term->type()) {
+      case Term::Type::TERMCONSTANT: {
+        auto term_constant = dynamic_cast<TermConstant_ptr>(term);
+        if (Primitive::Type::STRING == term_constant->getValueType()) {
+          encoding_.AddString(term_constant->getValue());
+        } else if (Primitive::Type::REGEX == term_constant->getValueType()) {
+          Util::RegularExpression regular_expression (term_constant->getValue());
+          encoding_.AddRegularExpression(&regular_expression);
+        }
+        return false;
+      }
+      case Term::Type::TOUPPER:
+      case Term::Type::TOLOWER:
+      case Term::Type::TRIM:
+      case Term::Type::TOSTRING:
+      case Term::Type::TOINT:
+      case Term::Type::COUNT:
+      case Term::Type::UNKNOWN: {
+        DVLOG(VLOG_LEVEL) << "not compressible: " << *term;
+        is_compressible_ = false;
+        return false;
+      }
+      case Term::Type::GT:
+      case Term::Type::GE:
+      case Term::Type::LT:
+      case Term::Type::LE: {
+        // lexicographic comparisons depend on the character order
+        Term_ptr left_term = nullptr, right_term = nullptr;
+        if (auto gt_term = dynamic_cast<Gt_ptr>(term)) {
+          left_term = gt_term->left_term; right_term = gt_term->right_term;
+        } else if (auto ge_term = dynamic_cast<Ge_ptr>(term)) {
+          left_term = ge_term->left_term; right_term = ge_term->right_term;
+        } else if (auto lt_term = dynamic_cast<Lt_ptr>(term)) {
+          left_term = lt_term->left_term; right_term = lt_term->right_term;
+        } else if (auto le_term = dynamic_cast<Le_ptr>(term)) {
+          left_term = le_term->left_term; right_term = le_term->right_term;
+        }
+        if (is_string_term(left_term) or is_string_term(right_term)) {
+          DVLOG(VLOG_LEVEL) << "not compressible: " << *term;
+          is_compressible_ = false;
+          return false;
+        }
+        return true;
+      }
+      case Term::Type::EQ:
+      case Term::Type::NOTEQ:
+      case Term::Type::BEGINS:
+      case Term::Type::NOTBEGINS:
+      case Term::Type::ENDS:
+      case Term::Type::NOTENDS:
+      case Term::Type::CONTAINS:
+      case Term::Type::NOTCONTAINS: {
+        Term_ptr left_term = nullptr, right_term = nullptr;
+        if (auto eq_term = dynamic_cast<Eq_ptr>(term)) {
+          left_term = eq_term->left_term; right_term = eq_term->right_term;
+        } else if (auto not_eq_term = dynamic_cast<NotEq_ptr>(term)) {
+          left_term = not_eq_term->left_term; right_term = not_eq_term->right_term;
+        } else if (auto begins_term = dynamic_cast<Begins_ptr>(term)) {
+          left_term = begins_term->subject_term; right_term = begins_term->search_term;
+        } else if (auto not_begins_term = dynamic_cast<NotBegins_ptr>(term)) {
+          left_term = not_begins_term->subject_term; right_term = not_begins_term->search_term;
+        } else if (auto ends_term = dynamic_cast<Ends_ptr>(term)) {
+          left_term = ends_term->subject_term; right_term = ends_term->search_term;
+        } else if (auto not_ends_term = dynamic_cast<NotEnds_ptr>(term)) {
+          left_term = not_ends_term->subject_term; right_term = not_ends_term->search_term;
+        } else if (auto contains_term = dynamic_cast<Contains_ptr>(term)) {
+          left_term = contains_term->subject_term; right_term = contains_term->search_term;
+        } else if (auto not_contains_term = dynamic_cast<NotContains_ptr>(term)) {
+          left_term = not_contains_term->subject_term; right_term = not_contains_term->search_term;
+        }
+        if (Option::Solver::USE_MULTITRACK_AUTO and is_relational(left_term, right_term)) {
+          DVLOG(VLOG_LEVEL) << "not compressible, relates characters of two tracks: " << *term;
+          is_compressible_ = false;
+          return false;
+        }
+        return true;
+      }
+      default:
+        return true;
+    }
+  };
+
+  auto command_callback = [](Command_ptr command) -> bool {
+    if (Command::Type::ASSERT == command->getType()) {
+      return true;
+    }
+    return false;
+  };
+
+  setCommandPreCallback(command_callback);
+  setTermPreCallback(term_callback);
+}
+
+bool AlphabetPartitioner::is_compressible() const {
+  return is_compressible_;
+}
+
+const Theory::StringEncoding& AlphabetPartitioner::get_encoding() const {
+  return encoding_;
+}
+
+bool AlphabetPartitioner::is_string_term(Term_ptr term) {
+  switch (term->type()) {
+    case Term::Type::TERMCONSTANT:
+      return Primitive::Type::STRING == dynamic_cast<TermConstant_ptr>(term)->getValueType();
+    case Term::Type::QUALIDENTIFIER: {
+      // unknown names are local, assume the worst
+      auto variable = symbol_table_->get_variable_unsafe(dynamic_cast<QualIdentifier_ptr>(term)->getVarName());
+      return variable == nullptr or Variable::Type::STRING == variable->getType();
+    }
+    case Term::Type::ITE:
+    case Term::Type::CONCAT:
+    case Term::Type::CHARAT:
+    case Term::Type::SUBSTRING:
+    case Term::Type::TOUPPER:
+    case Term::Type::TOLOWER:
+    case Term::Type::TRIM:
+    case Term::Type::TOSTRING:
+    case Term::Type::REPLACE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool AlphabetPartitioner::has_string_variable(Term_ptr term) {
+  bool has_variable = false;
+  AstTraverser variable_finder (root_);
+  variable_finder.setTermPreCallback([this, &has_variable](Term_ptr sub_term) -> bool {
+    if (has_variable) {
+      return false;
+    } else if (Term::Type::QUALIDENTIFIER == sub_term->type()) {
+      // unknown names are local, assume the worst
+      auto variable = symbol_table_->get_variable_unsafe(dynamic_cast<QualIdentifier_ptr>(sub_term)->getVarName());
+      has_variable = (variable == nullptr or Variable::Type::STRING == variable->getType());
+      return false;
+    }
+    // lengths and indexes do not relate characters
+    return Term::Type::LEN != sub_term->type() and Term::Type::INDEXOF != sub_term->type()
+        and Term::Type::LASTINDEXOF != sub_term->type();
+  });
+  variable_finder.visit(term);
+  return has_variable;
+}
+
+bool AlphabetPartitioner::is_relational(Term_ptr left_term, Term_ptr right_term) {
+  return (is_string_term(left_term) or is_string_term(right_term)) and has_string_variable(left_term)
+      and has_string_variable(right_term);
+}
+
+} /* namespace Solver */
+} /* namespace Vlab */
@@ -0,0 +1,65 @@
+/*
+ * AlphabetPartitioner.h
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef SRC_SOLVER_ALPHABETPARTITIONER_H_
+#define SRC_SOLVER_ALPHABETPARTITIONER_H_
+
+#include <string>
+
+#include <glog/logging.h>
+
+#include "../smt/ast.h"
+#include "../smt/typedefs.h"
+#include "../theory/options/Theory.h"
+#include "../theory/StringEncoding.h"
+#include "../utils/RegularExpression.h"
+#include "AstTraverser.h"
+#include "options/Solver.h"
+#include "SymbolTable.h"
+
+namespace Vlab {
+namespace Solver {
+
+/**
+ * Computes the character classes that the string constants and regular expressions of a script distinguish.
+ * Operations that look at characters beyond these sets (case conversions, trimming, integer conversions,
+ * lexicographic comparisons, unknown functions) make the script incompressible.
+ * With multitrack automata, predicates that relate two string terms with variables make the script
+ * incompressible as well: a track holds a code, two tracks with the same code may or may not carry the same
+ * character, so neither the product nor the diagonal of class sizes counts such transitions exactly.
+ */
+class AlphabetPartitioner: public AstTraverser {
+ public:
+  AlphabetPartitioner(SMT::Script_ptr, SymbolTable_ptr);
+  virtual ~AlphabetPartitioner();
+
+  void start() override;
+  void end() override;
+
+  void setCallbacks();
+
+  bool is_compressible() const;
+  const Theory::StringEncoding& get_encoding() const;
+
+ protected:
+  bool is_string_term(SMT::Term_ptr term);
+  bool has_string_variable(SMT::Term_ptr term);
+  bool is_relational(SMT::Term_ptr left_term, SMT::Term_ptr right_term);
+
+  SymbolTable_ptr symbol_table_;
+  bool is_compressible_;
+  Theory::StringEncoding encoding_;
+
+ private:
+  static const int VLOG_LEVEL;
+};
+
+} /* namespace Solver */
+} /* namespace Vlab */
+
+#endif /* SRC_SOLVER_ALPHABETPARTITIONER_H_ */
@@ -48,6 +48,11 @@ void ArithmeticConstraintSolver::end() {
 
 void ArithmeticConstraintSolver::collect_arithmetic_constraint_info() {
   arithmetic_formula_generator_.start();
+  if (Option::Solver::ENABLE_ARITHMETIC_QUANTIFIER_SCHEDULING) {
+    // occurrence counts tell which variables are local to arithmetic conjuncts
+    Counter counter(root_, symbol_table_);
+    counter.start();
+  }
   string_terms_map_ = arithmetic_formula_generator_.get_string_terms_map();
 }
 
@@ -128,6 +133,7 @@ void ArithmeticConstraintSolver::visitAnd(And_ptr and_term) {
   std::string group_name = arithmetic_formula_generator_.get_term_group_name(and_term);
   Value_ptr and_value = nullptr;
 
+  std::set<std::string> constrained_variables;
   auto& variable_value_map = symbol_table_->get_values_at_scope(symbol_table_->top_scope());
 	for (auto iter = variable_value_map.begin(); iter != variable_value_map.end();) {
 		if(Value::Type::INT_CONSTANT == iter->second->getType() || Value::Type::BOOL_CONSTANT == iter->second->getType()) {
@@ -146,6 +152,7 @@ void ArithmeticConstraintSolver::visitAnd(And_ptr and_term) {
 			}
 			auto bin_auto = BinaryIntAutomaton::MakeAutomaton(constant,iter->first->getName(),group_formula->clone(),not use_unsigned_integers_);
 			auto bin_value = new Value(bin_auto);
+			constrained_variables.insert(iter->first->getName());
 //			LOG(INFO) << "Before value: " << symbol_table_->get_value(variable_group)->is_satisfiable();
 			symbol_table_->IntersectValue(variable_group,bin_value);
 //			LOG(INFO) << "After value: " << symbol_table_->get_value(variable_group)->is_satisfiable();
@@ -159,34 +166,39 @@ void ArithmeticConstraintSolver::visitAnd(And_ptr and_term) {
 		}
 	}
 
-	for (auto term : *(and_term->term_list)) {
-		auto formula = arithmetic_formula_generator_.get_term_formula(term);
-		// Do not visit child or terms here, handle them in POSTVISIT AND
-		if (formula != nullptr and (dynamic_cast<Or_ptr>(term) == nullptr)) {
-			has_arithmetic_formula = true;
-			visit(term);
-			auto param = get_term_value(term);
-			is_satisfiable = param->is_satisfiable();
-			if (is_satisfiable) {
-//        if (and_value == nullptr) {
-//          and_value = param->clone();
-//        } else {
-//          auto old_value = and_value;
-//          and_value = and_value->Intersect(param);
-//          delete old_value;
-//          is_satisfiable = and_value->is_satisfiable();
-//        }
-				auto term_group_name = arithmetic_formula_generator_.get_term_group_name(term);
-				if(term_group_name.empty()) {
-					LOG(FATAL) << "Term has no group!";
+	if (Option::Solver::ENABLE_ARITHMETIC_QUANTIFIER_SCHEDULING) {
+		has_arithmetic_formula = true;
+		is_satisfiable = is_satisfiable and visit_scheduled_conjuncts(and_term, constrained_variables);
+	} else {
+		for (auto term : *(and_term->term_list)) {
+			auto formula = arithmetic_formula_generator_.get_term_formula(term);
+			// Do not visit child or terms here, handle them in POSTVISIT AND
+			if (formula != nullptr and (dynamic_cast<Or_ptr>(term) == nullptr)) {
+				has_arithmetic_formula = true;
+				visit(term);
+				auto param = get_term_value(term);
+				is_satisfiable = param->is_satisfiable();
+				if (is_satisfiable) {
+	//        if (and_value == nullptr) {
+	//          and_value = param->clone();
+	//        } else {
+	//          auto old_value = and_value;
+	//          and_value = and_value->Intersect(param);
+	//          delete old_value;
+	//          is_satisfiable = and_value->is_satisfiable();
+	//        }
+					auto term_group_name = arithmetic_formula_generator_.get_term_group_name(term);
+					if(term_group_name.empty()) {
+						LOG(FATAL) << "Term has no group!";
+					}
+					//LOG(INFO) << "------------ " << *term << " has group name " << term_group_name;
+					symbol_table_->IntersectValue(term_group_name,param);
+					is_satisfiable = symbol_table_->get_value(term_group_name)->is_satisfiable();
+				}
+				clear_term_value(term);
+				if (not is_satisfiable) {
+					break;
 				}
-				//LOG(INFO) << "------------ " << *term << " has group name " << term_group_name;
-				symbol_table_->IntersectValue(term_group_name,param);
-				is_satisfiable = symbol_table_->get_value(term_group_name)->is_satisfiable();
-			}
-			clear_term_value(term);
-			if (not is_satisfiable) {
-				break;
 			}
 		}
 	}
@@ -227,6 +239,147 @@ void ArithmeticConstraintSolver::visitAnd(And_ptr and_term) {
   DVLOG(VLOG_LEVEL) << "post visit component end: " << *and_term << "@" << and_term;
 }
 
+/**
+ * Solves arithmetic conjuncts of a component group by group. Conjuncts are intersected in the order
+ * of their variable overlap with the partial product, and a variable that is local to the conjuncts of
+ * the component is existentially projected right after its last conjunct. A variable is local if the
+ * solver introduced it and it does not appear anywhere else in the script, in a string term or in a
+ * constant propagated into the group; variables declared by the script can be queried and are kept.
+ * A projected variable is fixed to zero afterwards; its track stays in the group automaton but does
+ * not multiply the number of solutions.
+ */
+bool ArithmeticConstraintSolver::visit_scheduled_conjuncts(And_ptr and_term,
+                                                           const std::set<std::string>& constrained_variables) {
+  struct Conjunct {
+    Term_ptr term;
+    std::set<std::string> variables;
+  };
+
+  std::vector<std::string> group_names;
+  std::map<std::string, std::vector<Conjunct>> group_conjuncts;
+  std::map<std::string, int> remaining_counts;
+  std::set<std::string> pinned_variables(constrained_variables);
+  if (symbol_table_->has_count_variable()) {
+    pinned_variables.insert(symbol_table_->get_count_variable()->getName());
+  }
+
+  for (auto term : *(and_term->term_list)) {
+    auto formula = arithmetic_formula_generator_.get_term_formula(term);
+    if (formula == nullptr or dynamic_cast<Or_ptr>(term) != nullptr) {
+      continue;
+    }
+    auto term_group_name = arithmetic_formula_generator_.get_term_group_name(term);
+    if (term_group_name.empty()) {
+      LOG(FATAL) << "Term has no group!";
+    }
+    Conjunct conjunct { term, { } };
+    for (const auto& el : formula->GetVariableCoefficientMap()) {
+      if (el.second != 0) {
+        conjunct.variables.insert(el.first);
+        ++remaining_counts[el.first];
+        if (formula->HasRelationToMixedTerm(el.first) or has_string_terms(term)) {
+          pinned_variables.insert(el.first);
+        }
+      }
+    }
+    for (const auto& el : formula->GetBooleans()) {
+      pinned_variables.insert(el.first);
+    }
+    if (group_conjuncts.find(term_group_name) == group_conjuncts.end()) {
+      group_names.push_back(term_group_name);
+    }
+    group_conjuncts[term_group_name].push_back(conjunct);
+  }
+
+  std::set<std::string> local_variables;
+  for (const auto& el : remaining_counts) {
+    if (pinned_variables.find(el.first) != pinned_variables.end()) {
+      continue;
+    }
+    auto variable = symbol_table_->get_variable_unsafe(el.first);
+    if (variable != nullptr and symbol_table_->is_internal_variable(variable)
+        and symbol_table_->get_total_count(variable) == el.second) {
+      local_variables.insert(el.first);
+    }
+  }
+
+  for (const auto& group_name : group_names) {
+    auto& conjuncts = group_conjuncts[group_name];
+    std::vector<bool> is_scheduled(conjuncts.size(), false);
+    std::set<std::string> product_variables;
+    Value_ptr product = nullptr;
+    bool is_satisfiable = true;
+
+    for (std::size_t n = 0; n < conjuncts.size() and is_satisfiable; ++n) {
+      // prefers conjuncts that complete local variables, then the ones sharing most variables with the product
+      std::size_t next = 0;
+      std::tuple<int, int, int> best_rank;
+      bool has_candidate = false;
+      for (std::size_t i = 0; i < conjuncts.size(); ++i) {
+        if (is_scheduled[i]) {
+          continue;
+        }
+        int num_of_completed = 0, num_of_shared = 0;
+        for (const auto& var_name : conjuncts[i].variables) {
+          if (remaining_counts[var_name] == 1 and local_variables.find(var_name) != local_variables.end()) {
+            ++num_of_completed;
+          }
+          if (product_variables.find(var_name) != product_variables.end()) {
+            ++num_of_shared;
+          }
+        }
+        int num_of_new = static_cast<int>(conjuncts[i].variables.size()) - num_of_shared;
+        auto rank = std::make_tuple(num_of_completed, num_of_shared, -num_of_new);
+        if (not has_candidate or rank > best_rank) {
+          best_rank = rank;
+          next = i;
+          has_candidate = true;
+        }
+      }
+      is_scheduled[next] = true;
+
+      auto term = conjuncts[next].term;
+      visit(term);
+      auto param = get_term_value(term);
+      if (product == nullptr) {
+        product = param->clone();
+      } else {
+        auto old_product = product;
+        product = product->intersect(param);
+        delete old_product;
+      }
+      clear_term_value(term);
+      is_satisfiable = product->is_satisfiable();
+
+      for (const auto& var_name : conjuncts[next].variables) {
+        product_variables.insert(var_name);
+        if (--remaining_counts[var_name] == 0 and local_variables.find(var_name) != local_variables.end()
+            and is_satisfiable and Value::Type::BINARYINT_AUTOMATON == product->getType()) {
+          DVLOG(VLOG_LEVEL) << "project local variable: " << var_name << " in group: " << group_name;
+          auto binary_auto = product->getBinaryIntAutomaton();
+          auto exists_auto = binary_auto->Exists(var_name);
+          auto zero_auto = BinaryIntAutomaton::MakeAutomaton(0, var_name, exists_auto->GetFormula()->clone(),
+                                                             not use_unsigned_integers_);
+          auto projected_auto = exists_auto->Intersect(zero_auto);
+          delete exists_auto;
+          delete zero_auto;
+          delete product;
+          product = new Value(projected_auto);
+          product_variables.erase(var_name);
+        }
+      }
+    }
+
+    symbol_table_->IntersectValue(group_name, product);
+    delete product;
+    if (not symbol_table_->get_value(group_name)->is_satisfiable()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 /**
  * 1) Update group value at each scope
  * 2) Update result (union of scopes) after all
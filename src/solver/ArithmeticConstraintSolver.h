@@ -10,8 +10,11 @@
 
 #include <iostream>
 #include <map>
+#include <set>
 #include <string>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 #include <glog/logging.h>
 
@@ -23,6 +26,8 @@
 #include "ArithmeticFormulaGenerator.h"
 #include "AstTraverser.h"
 #include "ConstraintInformation.h"
+#include "Counter.h"
+#include "options/Solver.h"
 #include "SymbolTable.h"
 #include "Value.h"
 
@@ -61,6 +66,7 @@ class ArithmeticConstraintSolver : public AstTraverser {
 
  protected:
   void visitOr(SMT::Or_ptr);
+  bool visit_scheduled_conjuncts(SMT::And_ptr, const std::set<std::string>& constrained_variables);
 
   bool use_unsigned_integers_;
   SymbolTable_ptr symbol_table_;
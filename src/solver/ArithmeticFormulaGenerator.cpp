@@ -266,7 +266,7 @@ void ArithmeticFormulaGenerator::visitPlus(Plus_ptr plus_term) {
  */
 void ArithmeticFormulaGenerator::visitTimes(Times_ptr times_term) {
   DVLOG(VLOG_LEVEL) << "visit children start: " << *times_term << "@" << times_term;
-  int multiplicant = 1;
+  Theory::BigInteger multiplicant = 1;
   ArithmeticFormula_ptr times_formula = nullptr;
   for (auto term_ptr : *(times_term->term_list)) {
     visit(term_ptr);
@@ -611,7 +611,7 @@ void ArithmeticFormulaGenerator::visitTermConstant(TermConstant_ptr term_constan
 
   switch (term_constant->getValueType()) {
     case Primitive::Type::NUMERAL: {
-      int constant = std::stoi(term_constant->getValue());
+      Theory::BigInteger constant(term_constant->getValue());
       //if(constant <= 300) {
         auto formula = new ArithmeticFormula();
         formula->SetConstant(constant);
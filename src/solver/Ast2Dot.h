@@ -26,12 +26,12 @@ namespace Solver {
 class Ast2Dot: public SMT::Visitor {
 public:
   Ast2Dot(std::ostream* out = &std::cout);
-  ~Ast2Dot();
+  virtual ~Ast2Dot();
 
   void add_edge(u_int64_t p, u_int64_t c);
   void add_node(u_int64_t c, std::string label);
-  void draw(std::string label, SMT::Visitable_ptr p);
-  void draw_terminal(std::string label);
+  virtual void draw(std::string label, SMT::Visitable_ptr p);
+  virtual void draw_terminal(std::string label);
 
   void start(SMT::Visitable_ptr);
   void start() override;
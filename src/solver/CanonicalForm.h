@@ -0,0 +1,103 @@
+/*
+ * CanonicalForm.h
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef SRC_SOLVER_CANONICALFORM_H_
+#define SRC_SOLVER_CANONICALFORM_H_
+
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace Vlab {
+namespace Solver {
+
+/**
+ * 128 bit structural hash, stable across runs and platforms
+ */
+struct CanonicalHash {
+  uint64_t high;
+  uint64_t low;
+
+  CanonicalHash()
+      : high { 0 },
+        low { 0 } {
+  }
+
+  CanonicalHash(uint64_t high, uint64_t low)
+      : high { high },
+        low { low } {
+  }
+
+  bool operator==(const CanonicalHash& other) const {
+    return high == other.high and low == other.low;
+  }
+
+  bool operator!=(const CanonicalHash& other) const {
+    return not (*this == other);
+  }
+
+  bool operator<(const CanonicalHash& other) const {
+    return (high < other.high) or (high == other.high and low < other.low);
+  }
+
+  std::string str() const {
+    std::stringstream ss;
+    ss << std::hex << std::setfill('0') << std::setw(16) << high << std::setw(16) << low;
+    return ss.str();
+  }
+
+  /**
+   * Combines a node label with the hashes of its children in order.
+   */
+  static CanonicalHash Of(const std::string& label, const std::vector<CanonicalHash>& children) {
+    uint64_t h1 = 0xcbf29ce484222325ULL, h2 = 0x84222325cbf29ce4ULL;
+    auto feed = [&h1, &h2](uint8_t byte) {
+      h1 = (h1 ^ byte) * 0x100000001b3ULL;
+      h2 = (h2 ^ byte) * 0x100000001b3ULL + 0x9e3779b97f4a7c15ULL;
+    };
+    for (auto c : label) {
+      feed(static_cast<uint8_t>(c));
+    }
+    feed(0xff);
+    for (auto& child : children) {
+      for (int shift = 0; shift < 64; shift += 8) {
+        feed(static_cast<uint8_t>(child.high >> shift));
+        feed(static_cast<uint8_t>(child.low >> shift));
+      }
+    }
+    return CanonicalHash(Mix(h1 ^ Mix(h2)), Mix(h2 + children.size()));
+  }
+
+  static uint64_t Mix(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+};
+
+/**
+ * Alpha renaming invariant form of a script or a term.
+ * Two terms with the same hash are identical up to variable renaming and the order of
+ * commutative operands; renaming maps the original variable names to the canonical ones.
+ */
+struct CanonicalForm {
+  CanonicalHash hash;
+  std::map<std::string, std::string> renaming;
+  /**
+   * Original variable names in canonical order, i'th variable is renamed to the i'th canonical name
+   */
+  std::vector<std::string> variables;
+};
+
+} /* namespace Solver */
+} /* namespace Vlab */
+
+#endif /* SRC_SOLVER_CANONICALFORM_H_ */
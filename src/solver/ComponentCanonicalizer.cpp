@@ -0,0 +1,219 @@
+/*
+ * ComponentCanonicalizer.cpp
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "ComponentCanonicalizer.h"
+
+namespace Vlab {
+namespace Solver {
+
+using namespace SMT;
+
+const int ComponentCanonicalizer::VLOG_LEVEL = 20;
+
+ComponentCanonicalizer::ComponentCanonicalizer(Script_ptr script, SymbolTable_ptr symbol_table,
+                                               ConstraintInformation_ptr constraint_information)
+    : root_(script),
+      symbol_table_(symbol_table),
+      constraint_information_(constraint_information) {
+}
+
+ComponentCanonicalizer::~ComponentCanonicalizer() {
+}
+
+void ComponentCanonicalizer::start() {
+  DVLOG(VLOG_LEVEL) << "Starting the Component Canonicalizer";
+  for (auto component : GetTopLevelComponents(root_, constraint_information_)) {
+    constraint_information_->set_canonical_form(component, canonicalize(component));
+  }
+  end();
+}
+
+void ComponentCanonicalizer::end() {
+#ifndef NDEBUG
+  if (VLOG_IS_ON(VLOG_LEVEL)) {
+    for (auto& entry : constraint_information_->get_canonical_forms()) {
+      DVLOG(VLOG_LEVEL) << "component@" << entry.first << " canonical hash: " << entry.second.hash.str()
+                        << " #vars: " << entry.second.variables.size();
+    }
+  }
+#endif
+}
+
+CanonicalForm ComponentCanonicalizer::canonicalize(Visitable_ptr term) {
+  CanonicalForm form;
+  Hasher hasher(symbol_table_, &form);
+  form.hash = hasher.hash(term);
+  return form;
+}
+
+std::vector<Visitable_ptr> ComponentCanonicalizer::GetTopLevelComponents(Script_ptr script,
+                                                                         ConstraintInformation_ptr constraint_information) {
+  std::vector<Visitable_ptr> components;
+  if (script->command_list->size() != 1) {
+    // assertions are merged into one conjunction before slicing, components of separate assertions may share variables
+    return components;
+  }
+  Assert_ptr assert_command = dynamic_cast<Assert_ptr>(script->command_list->front());
+  if (assert_command == nullptr or assert_command->term == nullptr) {
+    return components;
+  }
+  Term_ptr root_term = assert_command->term;
+  And_ptr and_term = dynamic_cast<And_ptr>(root_term);
+  if (and_term != nullptr and not constraint_information->is_component(and_term)) {
+    for (auto term : *and_term->term_list) {
+      if (not constraint_information->is_component(term)) {
+        // conjuncts that are not components may share variables
+        components.clear();
+        return components;
+      }
+      components.push_back(term);
+    }
+  } else {
+    components.push_back(root_term);
+  }
+  return components;
+}
+
+ComponentCanonicalizer::Hasher::Hasher(SymbolTable_ptr symbol_table, CanonicalForm* form)
+    : Ast2Dot(nullptr),
+      symbol_table_ { symbol_table },
+      form_ { form } {
+}
+
+ComponentCanonicalizer::Hasher::~Hasher() {
+}
+
+CanonicalHash ComponentCanonicalizer::Hasher::hash(Visitable_ptr node) {
+  frames_.clear();
+  frames_.push_back(std::vector<CanonicalHash>());
+  visit(node);
+  auto& root = frames_.back();
+  if (root.size() == 1) {
+    return root.front();
+  }
+  return CanonicalHash::Of("Partial", root);
+}
+
+void ComponentCanonicalizer::Hasher::draw(std::string label, Visitable_ptr p) {
+  frames_.push_back(std::vector<CanonicalHash>());
+  if (p != nullptr) {
+    visit_children_of(p);
+  }
+  auto result = CanonicalHash::Of(label, frames_.back());
+  frames_.pop_back();
+  frames_.back().push_back(result);
+}
+
+void ComponentCanonicalizer::Hasher::draw_terminal(std::string label) {
+  frames_.back().push_back(CanonicalHash::Of(label, std::vector<CanonicalHash>()));
+}
+
+/**
+ * Declarations carry the original variable names; only the asserted terms are hashed
+ */
+void ComponentCanonicalizer::Hasher::visitScript(Script_ptr script) {
+  TermList assertions;
+  for (auto command : *script->command_list) {
+    if (Assert_ptr assert_command = dynamic_cast<Assert_ptr>(command)) {
+      assertions.push_back(assert_command->term);
+    }
+  }
+  draw_commutative("Script", assertions);
+}
+
+void ComponentCanonicalizer::Hasher::visitAnd(And_ptr and_term) {
+  draw_commutative(and_term->str(), *and_term->term_list);
+}
+
+void ComponentCanonicalizer::Hasher::visitOr(Or_ptr or_term) {
+  draw_commutative(or_term->str(), *or_term->term_list);
+}
+
+void ComponentCanonicalizer::Hasher::visitPlus(Plus_ptr plus_term) {
+  draw_commutative(plus_term->str(), *plus_term->term_list);
+}
+
+void ComponentCanonicalizer::Hasher::visitTimes(Times_ptr times_term) {
+  draw_commutative(times_term->str(), *times_term->term_list);
+}
+
+void ComponentCanonicalizer::Hasher::visitEq(Eq_ptr eq_term) {
+  draw_commutative(eq_term->str(), TermList { eq_term->left_term, eq_term->right_term });
+}
+
+void ComponentCanonicalizer::Hasher::visitNotEq(NotEq_ptr not_eq_term) {
+  draw_commutative(not_eq_term->str(), TermList { not_eq_term->left_term, not_eq_term->right_term });
+}
+
+void ComponentCanonicalizer::Hasher::visitReUnion(ReUnion_ptr re_union_term) {
+  draw_commutative(re_union_term->str(), *re_union_term->term_list);
+}
+
+void ComponentCanonicalizer::Hasher::visitReInter(ReInter_ptr re_inter_term) {
+  draw_commutative(re_inter_term->str(), *re_inter_term->term_list);
+}
+
+/**
+ * Free variables are renamed by their first occurrence, other identifiers are kept as they are
+ */
+void ComponentCanonicalizer::Hasher::visitQualIdentifier(QualIdentifier_ptr qi_term) {
+  const std::string name = qi_term->getVarName();
+  Variable_ptr variable = symbol_table_->get_variable_unsafe(name);
+  if (variable == nullptr) {
+    visitTerm(qi_term);
+    return;
+  }
+
+  std::stringstream label;
+  label << "var:" << static_cast<int>(variable->getType());
+  if (form_ not_eq nullptr) {
+    auto it = form_->renaming.find(name);
+    if (it == form_->renaming.end()) {
+      std::string canonical_name = "v" + std::to_string(form_->variables.size());
+      it = form_->renaming.insert(std::make_pair(name, canonical_name)).first;
+      form_->variables.push_back(name);
+    }
+    label << ":" << it->second;
+  }
+  draw_terminal(label.str());
+}
+
+/**
+ * Without a renaming map operand hashes are simply sorted. With a renaming map operands are
+ * visited in the order of their renaming invariant hashes so that variables get the same names
+ * regardless of how the operands were written.
+ */
+void ComponentCanonicalizer::Hasher::draw_commutative(std::string label, const TermList& operands) {
+  if (form_ == nullptr) {
+    frames_.push_back(std::vector<CanonicalHash>());
+    for (auto operand : operands) {
+      visit(operand);
+    }
+    std::sort(frames_.back().begin(), frames_.back().end());
+  } else {
+    std::vector<std::pair<CanonicalHash, Term_ptr>> ordered_operands;
+    for (auto operand : operands) {
+      Hasher invariant_hasher(symbol_table_, nullptr);
+      ordered_operands.push_back(std::make_pair(invariant_hasher.hash(operand), operand));
+    }
+    std::stable_sort(ordered_operands.begin(), ordered_operands.end(),
+                     [](const std::pair<CanonicalHash, Term_ptr>& x, const std::pair<CanonicalHash, Term_ptr>& y) {
+      return x.first < y.first;
+    });
+    frames_.push_back(std::vector<CanonicalHash>());
+    for (auto& operand : ordered_operands) {
+      visit(operand.second);
+    }
+  }
+  auto result = CanonicalHash::Of(label, frames_.back());
+  frames_.pop_back();
+  frames_.back().push_back(result);
+}
+
+} /* namespace Solver */
+} /* namespace Vlab */
@@ -0,0 +1,107 @@
+/*
+ * ComponentCanonicalizer.h
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef SRC_SOLVER_COMPONENTCANONICALIZER_H_
+#define SRC_SOLVER_COMPONENTCANONICALIZER_H_
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "../smt/ast.h"
+#include "../smt/typedefs.h"
+#include "Ast2Dot.h"
+#include "CanonicalForm.h"
+#include "ConstraintInformation.h"
+#include "SymbolTable.h"
+
+namespace Vlab {
+namespace Solver {
+
+/**
+ * Computes an alpha renaming invariant canonical form for each top level component found by the
+ * dependency slicer, two scripts that share a component get the same form for it.
+ *
+ * Operands of commutative terms are ordered by a hash that ignores variable names, variables are
+ * then renamed by their first occurrence in that order and the renamed component is hashed.
+ * Ties between operands that only differ in variable names keep their original order, they may
+ * cause a cache miss but never a wrong match.
+ *
+ * Runs right after the dependency slicer. The passes after it rewrite a component in place using
+ * only the component itself, hence the form taken here still identifies the rewritten component.
+ */
+class ComponentCanonicalizer {
+ public:
+  ComponentCanonicalizer(SMT::Script_ptr, SymbolTable_ptr, ConstraintInformation_ptr);
+  virtual ~ComponentCanonicalizer();
+
+  void start();
+  void end();
+
+  /**
+   * Canonicalizes a term, or the conjunction of all assertions when given the script.
+   * Variables are looked up in the symbol table.
+   */
+  CanonicalForm canonicalize(SMT::Visitable_ptr term);
+
+  /**
+   * Top level components of a sliced script: the children of a root conjunction split into
+   * components, otherwise the root term itself. Empty when the script has several assertions.
+   */
+  static std::vector<SMT::Visitable_ptr> GetTopLevelComponents(SMT::Script_ptr, ConstraintInformation_ptr);
+
+ protected:
+  /**
+   * Reuses Ast2Dot labels and hashes nodes bottom up instead of printing them.
+   * Without a renaming map all variables of the same type hash the same.
+   */
+  class Hasher : public Ast2Dot {
+   public:
+    Hasher(SymbolTable_ptr symbol_table, CanonicalForm* form);
+    virtual ~Hasher();
+
+    CanonicalHash hash(SMT::Visitable_ptr node);
+
+    void draw(std::string label, SMT::Visitable_ptr p) override;
+    void draw_terminal(std::string label) override;
+
+    void visitScript(SMT::Script_ptr) override;
+    void visitAnd(SMT::And_ptr) override;
+    void visitOr(SMT::Or_ptr) override;
+    void visitPlus(SMT::Plus_ptr) override;
+    void visitTimes(SMT::Times_ptr) override;
+    void visitEq(SMT::Eq_ptr) override;
+    void visitNotEq(SMT::NotEq_ptr) override;
+    void visitReUnion(SMT::ReUnion_ptr) override;
+    void visitReInter(SMT::ReInter_ptr) override;
+    void visitQualIdentifier(SMT::QualIdentifier_ptr) override;
+
+   protected:
+    void draw_commutative(std::string label, const SMT::TermList& operands);
+
+    SymbolTable_ptr symbol_table_;
+    CanonicalForm* form_;
+    std::vector<std::vector<CanonicalHash>> frames_;
+  };
+
+  SMT::Script_ptr root_;
+  SymbolTable_ptr symbol_table_;
+  ConstraintInformation_ptr constraint_information_;
+
+ private:
+  static const int VLOG_LEVEL;
+};
+
+} /* namespace Solver */
+} /* namespace Vlab */
+
+#endif /* SRC_SOLVER_COMPONENTCANONICALIZER_H_ */
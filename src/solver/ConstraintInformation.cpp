@@ -45,6 +45,7 @@ void ConstraintInformation::add_component(const Visitable_ptr node) {
 
 void ConstraintInformation::remove_component(const Visitable_ptr node) {
   components_.erase(node);
+  canonical_forms_.erase(node);
 }
 
 const std::set<Visitable_ptr> ConstraintInformation::get_components() const {
@@ -75,6 +76,22 @@ void ConstraintInformation::add_mixed_constraint(const SMT::Visitable_ptr node)
   mixed_constraints_.insert(node);
 }
 
+bool ConstraintInformation::has_canonical_form(const SMT::Visitable_ptr node) const {
+  return (canonical_forms_.find(node) not_eq canonical_forms_.end());
+}
+
+const CanonicalForm& ConstraintInformation::get_canonical_form(const SMT::Visitable_ptr node) const {
+  return canonical_forms_.at(node);
+}
+
+void ConstraintInformation::set_canonical_form(const SMT::Visitable_ptr node, const CanonicalForm& form) {
+  canonical_forms_[node] = form;
+}
+
+const std::map<SMT::Visitable_ptr, CanonicalForm>& ConstraintInformation::get_canonical_forms() const {
+  return canonical_forms_;
+}
+
 bool ConstraintInformation::var_has_formula(std::string var_name) {
 	return string_formulas.find(var_name) != string_formulas.end();
 }
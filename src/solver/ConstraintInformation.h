@@ -17,6 +17,7 @@
 
 #include "../smt/typedefs.h"
 #include "../theory/StringFormula.h"
+#include "CanonicalForm.h"
 
 namespace Vlab {
 namespace Solver {
@@ -40,6 +41,14 @@ class ConstraintInformation {
   bool has_mixed_constraint(const SMT::Visitable_ptr) const;
   void add_mixed_constraint(const SMT::Visitable_ptr);
 
+  /**
+   * Canonical forms of the top level components, taken right after dependency slicing
+   */
+  bool has_canonical_form(const SMT::Visitable_ptr) const;
+  const CanonicalForm& get_canonical_form(const SMT::Visitable_ptr) const;
+  void set_canonical_form(const SMT::Visitable_ptr, const CanonicalForm&);
+  const std::map<SMT::Visitable_ptr, CanonicalForm>& get_canonical_forms() const;
+
   bool var_has_formula(std::string);
   Theory::StringFormula_ptr get_var_formula(std::string);
   void set_var_formula(std::string,Theory::StringFormula_ptr);
@@ -58,6 +67,7 @@ class ConstraintInformation {
   std::set<SMT::Visitable_ptr> arithmetic_constraints_;
   std::set<SMT::Visitable_ptr> string_constraints_;
   std::set<SMT::Visitable_ptr> mixed_constraints_;
+  std::map<SMT::Visitable_ptr, CanonicalForm> canonical_forms_;
 };
 
 using ConstraintInformation_ptr = ConstraintInformation*;
@@ -13,41 +13,53 @@ namespace Solver {
 using namespace SMT;
 using namespace Theory;
 
+const int ConstraintSolver::MAX_VISITS_PER_CONJUNCT = 32;
 const int ConstraintSolver::VLOG_LEVEL = 11;
 
 ConstraintSolver::ConstraintSolver(Script_ptr script, SymbolTable_ptr symbol_table,
                                    ConstraintInformation_ptr constraint_information)
-    : iteration_count_ { 0 },
+    : num_of_propagations_ { 0 },
       root_(script),
       symbol_table_(symbol_table),
       constraint_information_(constraint_information),
       arithmetic_constraint_solver_(script, symbol_table, constraint_information,
                                     Option::Solver::USE_SIGNED_INTEGERS),
-      string_constraint_solver_(script, symbol_table, constraint_information) {
+      string_constraint_solver_(script, symbol_table, constraint_information),
+      satisfiability_only_ { false },
+      is_exact_ { true } {
 	Automaton::SetCountBoundExact(Option::Solver::COUNT_BOUND_EXACT);
 }
 
 ConstraintSolver::~ConstraintSolver() {
+  // term values are left behind when solving is stopped by the budget of the query
+  end();
+  clear_integer_conversions();
 }
 
 void ConstraintSolver::start() {
   DVLOG(VLOG_LEVEL) << "start";
   arithmetic_constraint_solver_.collect_arithmetic_constraint_info();
   string_constraint_solver_.collect_string_constraint_info();
+  if (satisfiability_only_) {
+    collect_unrefined_variables();
+  }
   visit(root_);
 
   end();
 }
 
-void ConstraintSolver::start(int iteration_count) {
-  DVLOG(VLOG_LEVEL) << "start" << iteration_count;
-  arithmetic_constraint_solver_.collect_arithmetic_constraint_info();
-  string_constraint_solver_.collect_string_constraint_info();
-  iteration_count_ = iteration_count;
-  for (iteration_count_ = 0; iteration_count_ < iteration_count; ++iteration_count_) {
-    visit(root_);
-  }
-  end();
+int ConstraintSolver::get_num_of_propagations() const {
+  return num_of_propagations_;
+}
+
+void ConstraintSolver::set_satisfiability_only(const bool satisfiability_only,
+                                               const std::set<std::string>& requested_variables) {
+  satisfiability_only_ = satisfiability_only;
+  requested_variables_ = requested_variables;
+}
+
+bool ConstraintSolver::is_exact() const {
+  return is_exact_;
 }
 
 void ConstraintSolver::end() {
@@ -62,7 +74,17 @@ void ConstraintSolver::end() {
 
 void ConstraintSolver::visitScript(Script_ptr script) {
   symbol_table_->push_scope(script);
-  Visitor::visit_children_of(script);
+  if (satisfiability_only_) {
+    for (auto command : *(script->command_list)) {
+      visit(command);
+      if (not symbol_table_->isSatisfiable()) {
+        DVLOG(VLOG_LEVEL) << "unsatisfiable assertion, remaining assertions are skipped";
+        break;
+      }
+    }
+  } else {
+    Visitor::visit_children_of(script);
+  }
   symbol_table_->pop_scope();  // global scope, it is reachable via script pointer all the time
 }
 
@@ -72,6 +94,8 @@ void ConstraintSolver::visitCommand(Command_ptr command) {
 
 void ConstraintSolver::visitAssert(Assert_ptr assert_command) {
   DVLOG(VLOG_LEVEL) << "visit: " << *assert_command;
+  // values of earlier assertions are owned by the solver, a stopped query unwinds from here
+  Util::Budget::Check();
 
   check_and_visit(assert_command->term);
 
@@ -163,23 +187,7 @@ void ConstraintSolver::visitAnd(And_ptr and_term) {
 
   //if (is_satisfiable and (constraint_information_->has_mixed_constraint(and_term) or (not is_component))) {
   if (is_satisfiable) {
-    for (auto& term : *(and_term->term_list)) {
-      is_satisfiable = check_and_visit(term) and is_satisfiable;
-      if (not is_satisfiable) {
-      	clearTermValuesAndLocalLetVars();
-      	variable_path_table_.clear();
-      	break;
-      }
-      if (dynamic_cast<Or_ptr>(term) == nullptr) {
-        if (is_satisfiable) {
-          is_satisfiable = update_variables();
-          if(not is_satisfiable) {
-          	break;
-          }
-        }
-        clearTermValuesAndLocalLetVars();
-      }
-    }
+    is_satisfiable = solve_conjuncts(and_term);
   }
 
   DVLOG(VLOG_LEVEL) << "visit children end: " << *and_term << "@" << and_term;
@@ -200,6 +208,62 @@ void ConstraintSolver::visitAnd(And_ptr and_term) {
   setTermValue(and_term, result);
 }
 
+/**
+ * Solves conjuncts in order once, then solves again only the conjuncts that mention a variable
+ * shrunk by another conjunct until values of variables do not change.
+ * Variables updated by a conjunct are registered in constraint information as the conjunct is solved.
+ * A conjunct is solved at most MAX_VISITS_PER_CONJUNCT times, values may shrink indefinitely otherwise.
+ */
+bool ConstraintSolver::solve_conjuncts(And_ptr and_term) {
+  std::deque<Term_ptr> worklist(and_term->term_list->begin(), and_term->term_list->end());
+  std::set<Term_ptr> conjuncts(worklist.begin(), worklist.end());
+  std::set<Term_ptr> is_queued(conjuncts);
+  std::map<Term_ptr, int> num_of_visits;
+
+  while (not worklist.empty()) {
+    Util::Budget::Check();
+    auto term = worklist.front();
+    worklist.pop_front();
+    is_queued.erase(term);
+    ++num_of_visits[term];
+    mentioned_variables_.clear();
+    updated_variables_.clear();
+
+    if (not check_and_visit(term)) {
+      clearTermValuesAndLocalLetVars();
+      variable_path_table_.clear();
+      return false;
+    }
+    if (dynamic_cast<Or_ptr>(term) != nullptr) {
+      continue;
+    }
+    if (not update_variables()) {
+      return false;
+    }
+    clearTermValuesAndLocalLetVars();
+
+    for (auto variable : mentioned_variables_) {
+      constraint_information_->add_var_constraint(variable, term);
+    }
+    std::set<Variable_ptr> updated_variables;
+    std::swap(updated_variables, updated_variables_);
+    for (auto variable : updated_variables) {
+      for (auto dependent_term : constraint_information_->get_var_constraints(variable)) {
+        if (dependent_term == term or conjuncts.find(dependent_term) == conjuncts.end()
+            or is_queued.find(dependent_term) != is_queued.end()
+            or num_of_visits[dependent_term] >= MAX_VISITS_PER_CONJUNCT) {
+          continue;
+        }
+        DVLOG(VLOG_LEVEL) << "propagate " << variable->getName() << " to: " << *dependent_term << "@" << dependent_term;
+        worklist.push_back(dependent_term);
+        is_queued.insert(dependent_term);
+        ++num_of_propagations_;
+      }
+    }
+  }
+  return true;
+}
+
 /**
  * 1) Solve arithmetic constraints
  * 2) Solve relational string constraints
@@ -227,6 +291,7 @@ void ConstraintSolver::visitOr(Or_ptr or_term) {
 
   DVLOG(VLOG_LEVEL) << "visit children start: " << *or_term << "@" << or_term;
 
+  const bool stops_at_witness = satisfiability_only_ and is_witness_local(or_term);
   //if (constraint_information_->has_mixed_constraint(or_term)) {
   if(true) {
     for (auto& term : *(or_term->term_list)) {
@@ -243,6 +308,10 @@ void ConstraintSolver::visitOr(Or_ptr or_term) {
       }
       is_satisfiable = is_satisfiable or is_scope_satisfiable;
       symbol_table_->pop_scope();
+      if (stops_at_witness and is_scope_satisfiable) {
+        DVLOG(VLOG_LEVEL) << "satisfiable disjunct, remaining disjuncts are skipped: " << *or_term << "@" << or_term;
+        break;
+      }
     }
   }
 
@@ -286,6 +355,7 @@ void ConstraintSolver::visitNot(Not_ptr not_term) {
         result = param->complement();
       } else {
         result = param->clone();
+        is_exact_ = false;
       }
       break;
     }
@@ -295,6 +365,7 @@ void ConstraintSolver::visitNot(Not_ptr not_term) {
         result = param->complement();
       } else {
         result = param->clone();
+        is_exact_ = false;
       }
       break;
     }
@@ -403,6 +474,9 @@ void ConstraintSolver::visitEq(Eq_ptr eq_term) {
   } else if (Value::Type::INT_CONSTANT == param_left->getType()
       and Value::Type::INT_CONSTANT == param_right->getType()) {
     result = new Value(param_left->getIntConstant() == param_right->getIntConstant());
+  } else if (Value::Type::STRING_AUTOMATON == param_left->getType()
+      and Value::Type::STRING_AUTOMATON == param_right->getType() and is_emptiness_check(eq_term)) {
+    result = new Value(not param_left->getStringAutomaton()->IsIntersectionEmpty(param_right->getStringAutomaton()));
   } else {
 //    LOG(INFO) << "Before Intersect!";
 //    std::cin.get();
@@ -468,6 +542,7 @@ void ConstraintSolver::visitNotEq(NotEq_ptr not_eq_term) {
       delete intersection;
     } else {
       result = intersection;
+      is_exact_ = false;
     }
   }
 
@@ -629,7 +704,11 @@ void ConstraintSolver::visitIn(In_ptr in_term) {
 
   if (Value::Type::STRING_AUTOMATON == param_left->getType()
       and Value::Type::STRING_AUTOMATON == param_right->getType()) {
-    result = param_left->intersect(param_right);
+    if (is_emptiness_check(in_term)) {
+      result = new Value(not param_left->getStringAutomaton()->IsIntersectionEmpty(param_right->getStringAutomaton()));
+    } else {
+      result = param_left->intersect(param_right);
+    }
   } else {
     LOG(FATAL)<< "unexpected parameter(s) of '" << *in_term << "' term";  // handle cases in a better way
   }
@@ -719,6 +798,7 @@ void ConstraintSolver::visitNotContains(NotContains_ptr not_contains_term) {
     // TODO if param_subject is a suffix automaton (all the strings accepted is actually substrings of largest length string),
     // there can be a more precise calculation instead of just cloning the subject
     result = param_subject->clone();
+    is_exact_ = false;
   }
 
   setTermValue(not_contains_term, result);
@@ -763,6 +843,7 @@ void ConstraintSolver::visitNotBegins(NotBegins_ptr not_begins_term) {
     difference_auto = nullptr;
   } else {
     result = param_subject->clone();
+    is_exact_ = false;
   }
 
   setTermValue(not_begins_term, result);
@@ -807,6 +888,7 @@ void ConstraintSolver::visitNotEnds(NotEnds_ptr not_ends_term) {
     difference_auto = nullptr;
   } else {
     result = param_subject->clone();
+    is_exact_ = false;
   }
 
   setTermValue(not_ends_term, result);
@@ -986,6 +1068,9 @@ void ConstraintSolver::visitSubString(SubString_ptr sub_string_term) {
 }
 
 void ConstraintSolver::visitToUpper(ToUpper_ptr to_upper_term) {
+  if (visit_transformation_chain(to_upper_term)) {
+    return;
+  }
   visit_children_of(to_upper_term);
   DVLOG(VLOG_LEVEL) << "visit: " << *to_upper_term;
 
@@ -996,6 +1081,9 @@ void ConstraintSolver::visitToUpper(ToUpper_ptr to_upper_term) {
 }
 
 void ConstraintSolver::visitToLower(ToLower_ptr to_lower_term) {
+  if (visit_transformation_chain(to_lower_term)) {
+    return;
+  }
   visit_children_of(to_lower_term);
   DVLOG(VLOG_LEVEL) << "visit: " << *to_lower_term;
 
@@ -1006,6 +1094,9 @@ void ConstraintSolver::visitToLower(ToLower_ptr to_lower_term) {
 }
 
 void ConstraintSolver::visitTrim(Trim_ptr trim_term) {
+  if (visit_transformation_chain(trim_term)) {
+    return;
+  }
   visit_children_of(trim_term);
   DVLOG(VLOG_LEVEL) << "visit: " << *trim_term;
 
@@ -1027,10 +1118,14 @@ void ConstraintSolver::visitToString(ToString_ptr to_string_term) {
     ss << param->getIntConstant();
     result = new Value(StringAutomaton::MakeString(ss.str()));
   } else {
-    auto unary_auto = param->getIntAutomaton()->toUnaryAutomaton();
-    auto str_auto = unary_auto->toStringAutomaton();
+    // canonical decimal strings of the values, built from the binary encoding instead of enumerating unary values
+    auto formula = new Theory::ArithmeticFormula();
+    formula->AddVariable("x", 1);
+    formula->SetType(Theory::ArithmeticFormula::Type::INTERSECT);
+    auto binary_auto = param->getIntAutomaton()->toBinaryIntAutomaton("x", formula);
+    auto str_auto = StringAutomaton::MakeDecimalStrings(binary_auto, false);
 
-    delete unary_auto;
+    delete binary_auto;
 
     // if param has negative one, then also return empty string
     if(param->getIntAutomaton()->hasNegative1()) {
@@ -1073,6 +1168,9 @@ void ConstraintSolver::visitToInt(ToInt_ptr to_int_term) {
 }
 
 void ConstraintSolver::visitReplace(Replace_ptr replace_term) {
+  if (visit_transformation_chain(replace_term)) {
+    return;
+  }
   visit_children_of(replace_term);
   DVLOG(VLOG_LEVEL) << "visit: " << *replace_term;
 
@@ -1125,6 +1223,7 @@ void ConstraintSolver::visitUnknownTerm(Unknown_ptr unknown_term) {
   }
   path_trace_.pop_back();
   Value_ptr result = new Value(Theory::StringAutomaton::MakeAnyString());
+  is_exact_ = false;
 
   setTermValue(unknown_term, result);
 }
@@ -1147,7 +1246,7 @@ void ConstraintSolver::visitQualIdentifier(QualIdentifier_ptr qi_term) {
     auto var_auto = variable_value->getBinaryIntAutomaton()->GetBinaryAutomatonFor(qi_term->getVarName());
     auto positive_var_auto = var_auto->GetPositiveValuesFor(qi_term->getVarName());
     auto unary_auto = positive_var_auto->ToUnaryAutomaton();
-    result = new Value(unary_auto->toIntAutomaton(8,var_auto->HasNegative1()));
+    result = new Value(unary_auto->toIntAutomaton(Theory::IntAutomaton::DEFAULT_NUM_OF_VARIABLES,var_auto->HasNegative1()));
     delete var_auto;
     delete positive_var_auto;
     delete unary_auto;
@@ -1251,6 +1350,9 @@ Value_ptr ConstraintSolver::getTermValue(Term_ptr term) {
 }
 
 bool ConstraintSolver::setTermValue(Term_ptr term, Value_ptr value) {
+  if (Option::Solver::APPROXIMATION_STATE_LIMIT > 0) {
+    widen(value);
+  }
   auto result = term_values_.insert(std::make_pair(term, value));
   if (result.second == false) {
     LOG(FATAL)<< "value is already computed for term: " << *term;
@@ -1258,6 +1360,33 @@ bool ConstraintSolver::setTermValue(Term_ptr term, Value_ptr value) {
   return result.second;
 }
 
+void ConstraintSolver::widen(Value_ptr value) {
+  if (Value::Type::STRING_AUTOMATON != value->getType()) {
+    return;
+  }
+  auto string_auto = value->getStringAutomaton();
+  const int number_of_states = string_auto->get_number_of_states();
+  if (number_of_states <= Option::Solver::APPROXIMATION_STATE_LIMIT or string_auto->GetNumTracks() != 1) {
+    return;
+  }
+
+  auto widened_auto = string_auto->WidenToLengths();
+  if (widened_auto->get_number_of_states() > Option::Solver::APPROXIMATION_STATE_LIMIT) {
+    // lengths alone need too many states
+    auto any_string_auto = Theory::StringAutomaton::MakeAnyString(widened_auto->get_number_of_bdd_variables());
+    if (widened_auto->GetFormula() != nullptr) {
+      any_string_auto->SetFormula(widened_auto->GetFormula()->clone());
+    }
+    delete widened_auto;
+    widened_auto = any_string_auto;
+  }
+  DVLOG(VLOG_LEVEL) << "widened: " << number_of_states << " -> " << widened_auto->get_number_of_states() << " states";
+
+  delete string_auto;
+  value->setData(widened_auto);
+  is_exact_ = false;
+}
+
 void ConstraintSolver::clearTermValue(SMT::Term_ptr term) {
   auto pair = term_values_.find(term);
   if (pair != term_values_.end()) {
@@ -1286,19 +1415,123 @@ bool ConstraintSolver::update_variables() {
   if (variable_path_table_.size() == 0) {
     return true;
   }
-  VariableValueComputer value_updater(symbol_table_, variable_path_table_, term_values_);
+  for (auto& path : variable_path_table_) {
+    auto qi_term = dynamic_cast<QualIdentifier_ptr>(path.front());
+    if (qi_term != nullptr) {
+      mentioned_variables_.insert(symbol_table_->get_variable(qi_term->getVarName()));
+    }
+  }
+  if (satisfiability_only_) {
+    // a variable that occurs once constrains nothing else, its refined value is not needed to decide satisfiability
+    auto is_unrefined = [this](const std::vector<Term_ptr>& path) {
+      auto qi_term = dynamic_cast<QualIdentifier_ptr>(path.front());
+      return qi_term != nullptr
+          and unrefined_variables_.find(symbol_table_->get_variable(qi_term->getVarName())) != unrefined_variables_.end();
+    };
+    variable_path_table_.erase(std::remove_if(variable_path_table_.begin(), variable_path_table_.end(), is_unrefined),
+                               variable_path_table_.end());
+    if (variable_path_table_.empty()) {
+      return true;
+    }
+  }
+  VariableValueComputer value_updater(symbol_table_, variable_path_table_, term_values_, &pre_image_cache_,
+                                      &transducer_cache_);
   value_updater.start();
   auto is_satisfiable = value_updater.is_satisfiable();
+  updated_variables_.insert(value_updater.get_updated_variables().begin(), value_updater.get_updated_variables().end());
   variable_path_table_.clear();
   // TODO should we delete term_values ???
   // TODO refactor relation - single interaction
   return is_satisfiable;
 }
 
+/**
+ * Variables that occur once, are not requested and do not share a value with other variables
+ */
+void ConstraintSolver::collect_unrefined_variables() {
+  unrefined_variables_.clear();
+  Counter counter(root_, symbol_table_);
+  counter.start();
+  for (auto& el : symbol_table_->get_variables()) {
+    auto variable = el.second;
+    if (requested_variables_.find(el.first) != requested_variables_.end()
+        or symbol_table_->get_total_count(variable) != 1
+        or symbol_table_->get_group_variable_of(variable) != variable
+        or symbol_table_->get_representative_variable_of_at_scope(root_, variable) != variable) {
+      continue;
+    }
+    unrefined_variables_.insert(variable);
+  }
+  DVLOG(VLOG_LEVEL) << unrefined_variables_.size() << " variables are not refined";
+}
+
+bool ConstraintSolver::is_emptiness_check(Term_ptr term) const {
+  // the term is a constraint itself and all the variable paths collected so far start under it
+  if (not satisfiability_only_ or not path_trace_.empty()) {
+    return false;
+  }
+  for (auto& path : variable_path_table_) {
+    auto qi_term = dynamic_cast<QualIdentifier_ptr>(path.front());
+    if (qi_term == nullptr
+        or unrefined_variables_.find(symbol_table_->get_variable(qi_term->getVarName())) == unrefined_variables_.end()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ConstraintSolver::is_witness_local(Or_ptr or_term) {
+  // occurrences under the disjunction, the total counts are collected before solving
+  std::map<Variable_ptr, int> counts;
+  AstTraverser traverser(root_);
+  traverser.setTermPreCallback([this, &counts](Term_ptr term) -> bool {
+    if (auto qi_term = dynamic_cast<QualIdentifier_ptr>(term)) {
+      ++counts[symbol_table_->get_variable(qi_term->getVarName())];
+      return false;
+    }
+    return Term::Type::TERMCONSTANT != term->type();
+  });
+  Term_ptr term = or_term;
+  traverser.visit(term);
+  for (auto& el : counts) {
+    if (requested_variables_.find(el.first->getName()) != requested_variables_.end()
+        or symbol_table_->get_total_count(el.first) != el.second) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ConstraintSolver::visit_transformation_chain(Term_ptr term) {
+  TransformationChain chain (term);
+  if (chain.size() < 2) {
+    return false;
+  }
+  DVLOG(VLOG_LEVEL) << "visit chain of " << chain.size() << ": " << *term;
+
+  // intermediate terms are skipped, variable paths go from the term to the subject directly
+  path_trace_.push_back(term);
+  visit(chain.get_subject());
+  path_trace_.pop_back();
+
+  Value_ptr param = getTermValue(chain.get_subject());
+  Value_ptr result = new Value(param->getStringAutomaton()->Transduce(chain.get_transducer(transducer_cache_)));
+
+  setTermValue(term, result);
+  return true;
+}
+
 void ConstraintSolver::visit_children_of(Term_ptr term) {
   path_trace_.push_back(term);
   Visitor::visit_children_of(term);
   path_trace_.pop_back();
+  if (Util::Trace::is_recording()) {
+    // operations that follow belong to the term, not to its last child; the address tells apart terms with
+    // the same operator, as in the debug logs
+    std::stringstream term_id;
+    term_id << *term << "@" << term;
+    Util::Trace::set_term(term_id.str());
+  }
 }
 
 bool ConstraintSolver::check_and_visit(Term_ptr term) {
@@ -1333,12 +1566,25 @@ bool ConstraintSolver::process_mixed_integer_string_constraints_in(Term_ptr term
   // get term value returns result from the symbol table (should return)
   auto arithmetic_result = arithmetic_constraint_solver_.get_term_value(term);
   for (auto& string_term : arithmetic_constraint_solver_.get_string_terms_in(term)) {
-    visit(string_term);
+    std::string string_term_var_name = symbol_table_->get_var_name_for_expression(string_term, Variable::Type::INT);
+    const bool is_integer_conversion = (Term::Type::TOINT == string_term->type());
+    if (is_integer_conversion) {
+      // decimal strings are converted to binary integers directly, the term keeps its binary track as value
+      visit_children_of(string_term);
+      auto subject_auto = getTermValue(dynamic_cast<ToInt_ptr>(string_term)->subject_term)->getStringAutomaton();
+      string_term_binary_auto = subject_auto->ParseToBinaryIntAutomaton(string_term_var_name,
+          arithmetic_result->getBinaryIntAutomaton()->GetFormula()->clone());
+      clearTermValue(string_term);
+      setTermValue(string_term, new Value(string_term_binary_auto->GetBinaryAutomatonFor(string_term_var_name)));
+    } else {
+      visit(string_term);
+    }
 
     auto string_term_result = getTermValue(string_term);
     is_satisfiable = string_term_result->is_satisfiable();
     
     if (not is_satisfiable) {
+      delete string_term_binary_auto;
       auto binary_auto = arithmetic_result->getBinaryIntAutomaton();
       arithmetic_result = new Value(
           BinaryIntAutomaton::MakePhi(binary_auto->GetFormula()->clone(), binary_auto->is_natural_number()));
@@ -1346,16 +1592,13 @@ bool ConstraintSolver::process_mixed_integer_string_constraints_in(Term_ptr term
       break;
     }
 
-    std::string string_term_var_name = symbol_table_->get_var_name_for_expression(string_term, Variable::Type::INT);
-    if (Value::Type::INT_AUTOMATON == string_term_result->getType()) {
+    if (is_integer_conversion) {
+      DVLOG(VLOG_LEVEL) << "decimal string to binary integer: " << *string_term;
+    } else if (Value::Type::INT_AUTOMATON == string_term_result->getType()) {
       has_minus_one = string_term_result->getIntAutomaton()->hasNegative1();
       number_of_variables_for_int_auto = string_term_result->getIntAutomaton()->get_number_of_bdd_variables();
-      // first convert integer result to unary, then unary to binary
-      string_term_unary_auto = string_term_result->getIntAutomaton()->toUnaryAutomaton();
-      string_term_binary_auto = string_term_unary_auto->toBinaryIntAutomaton(
-          string_term_var_name, arithmetic_result->getBinaryIntAutomaton()->GetFormula()->clone(), has_minus_one);
-      delete string_term_unary_auto;
-      string_term_unary_auto = nullptr;
+      string_term_binary_auto = get_binary_int_auto_for(string_term, string_term_result->getIntAutomaton(),
+          string_term_var_name, arithmetic_result->getBinaryIntAutomaton()->GetFormula());
     } else if (Value::Type::INT_CONSTANT == string_term_result->getType()) {
       int value = string_term_result->getIntConstant();
       has_minus_one = (value < 0);
@@ -1386,22 +1629,36 @@ bool ConstraintSolver::process_mixed_integer_string_constraints_in(Term_ptr term
     // numbers >= -1 (values a string constraint can return as an integer)
     string_term_binary_auto = updated_arith_auto->GetBinaryAutomatonFor(string_term_var_name);
 
-    if (has_minus_one) {
-      has_minus_one = string_term_binary_auto->HasNegative1();
-      BinaryIntAutomaton_ptr positive_values_auto = string_term_binary_auto->GetPositiveValuesFor(string_term_var_name);
+    // string term result is kept as it is if arithmetic constraints do not restrict it
+    if (is_integer_conversion) {
+      if (string_term_binary_auto->IsEqual(string_term_result->getBinaryIntAutomaton())) {
+        delete string_term_binary_auto;
+      } else {
+        clearTermValue(string_term);
+        setTermValue(string_term, new Value(string_term_binary_auto));
+      }
+      string_term_binary_auto = nullptr;
+    } else if (is_binary_int_auto_unchanged(string_term, string_term_binary_auto)) {
       delete string_term_binary_auto;
-      string_term_binary_auto = positive_values_auto;
-    }
+      string_term_binary_auto = nullptr;
+    } else {
+      if (has_minus_one) {
+        has_minus_one = string_term_binary_auto->HasNegative1();
+        BinaryIntAutomaton_ptr positive_values_auto = string_term_binary_auto->GetPositiveValuesFor(string_term_var_name);
+        delete string_term_binary_auto;
+        string_term_binary_auto = positive_values_auto;
+      }
 
-    string_term_unary_auto = string_term_binary_auto->ToUnaryAutomaton();
-    delete string_term_binary_auto;
-    string_term_binary_auto = nullptr;
-    updated_int_auto = string_term_unary_auto->toIntAutomaton(number_of_variables_for_int_auto, has_minus_one);
-    delete string_term_unary_auto;
-    string_term_unary_auto = nullptr;
-    clearTermValue(string_term);
-    string_term_result = new Value(updated_int_auto);
-    setTermValue(string_term, string_term_result);
+      string_term_unary_auto = string_term_binary_auto->ToUnaryAutomaton();
+      delete string_term_binary_auto;
+      string_term_binary_auto = nullptr;
+      updated_int_auto = string_term_unary_auto->toIntAutomaton(number_of_variables_for_int_auto, has_minus_one);
+      delete string_term_unary_auto;
+      string_term_unary_auto = nullptr;
+      clearTermValue(string_term);
+      string_term_result = new Value(updated_int_auto);
+      setTermValue(string_term, string_term_result);
+    }
 
     // 3 - update variables involved in string term
     is_satisfiable = update_variables();
@@ -1421,5 +1678,54 @@ bool ConstraintSolver::process_mixed_integer_string_constraints_in(Term_ptr term
   return is_satisfiable;
 }
 
+/**
+ * Binary encoding of the integer result of a string term, reuses the encoding of the previous
+ * iteration if the result is not changed since then
+ */
+BinaryIntAutomaton_ptr ConstraintSolver::get_binary_int_auto_for(Term_ptr string_term, IntAutomaton_ptr int_auto,
+                                                                 std::string var_name, ArithmeticFormula_ptr formula) {
+  auto it = integer_conversions_.find(string_term);
+  if (it != integer_conversions_.end()) {
+    auto cached_formula = it->second.binary_auto->GetFormula();
+    if (cached_formula->GetNumberOfVariables() == formula->GetNumberOfVariables()
+        and cached_formula->GetVariableIndex(var_name) == formula->GetVariableIndex(var_name)
+        and int_auto->hasNegative1() == it->second.int_auto->hasNegative1() and int_auto->IsEqual(it->second.int_auto)) {
+      DVLOG(VLOG_LEVEL) << "reuse binary encoding of: " << *string_term << "@" << string_term;
+      auto binary_auto = it->second.binary_auto->clone();
+      binary_auto->SetFormula(formula->clone());
+      return binary_auto;
+    }
+    delete it->second.int_auto;
+    delete it->second.binary_auto;
+    delete it->second.single_track_auto;
+    integer_conversions_.erase(it);
+  }
+
+  auto binary_auto = int_auto->toBinaryIntAutomaton(var_name, formula->clone());
+  IntegerConversion conversion { int_auto->clone(), binary_auto->clone(), binary_auto->GetBinaryAutomatonFor(var_name) };
+  integer_conversions_[string_term] = conversion;
+  return binary_auto;
+}
+
+/**
+ * Checks if the values of a string term in the arithmetic result are the values the string term had
+ */
+bool ConstraintSolver::is_binary_int_auto_unchanged(Term_ptr string_term, BinaryIntAutomaton_ptr single_track_auto) {
+  auto it = integer_conversions_.find(string_term);
+  if (it == integer_conversions_.end()) {
+    return false;
+  }
+  return single_track_auto->IsEqual(it->second.single_track_auto);
+}
+
+void ConstraintSolver::clear_integer_conversions() {
+  for (auto& entry : integer_conversions_) {
+    delete entry.second.int_auto;
+    delete entry.second.binary_auto;
+    delete entry.second.single_track_auto;
+  }
+  integer_conversions_.clear();
+}
+
 } /* namespace Solver */
 } /* namespace Vlab */
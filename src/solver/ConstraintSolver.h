@@ -8,7 +8,10 @@
 #ifndef SOLVER_CONSTRAINTSOLVER_H_
 #define SOLVER_CONSTRAINTSOLVER_H_
 
+#include <algorithm>
+#include <deque>
 #include <map>
+#include <set>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -26,13 +29,17 @@
 #include "../theory/StringFormula.h"
 #include "../theory/UnaryAutomaton.h"
 #include "../theory/Formula.h"
+#include "../utils/Budget.h"
 #include "optimization/ConstraintQuerier.h"
 #include "ArithmeticConstraintSolver.h"
+#include "AstTraverser.h"
 #include "ConstraintInformation.h"
+#include "Counter.h"
 #include "options/Solver.h"
 #include "StringConstraintSolver.h"
 #include "StringFormulaGenerator.h"
 #include "SymbolTable.h"
+#include "TransformationChain.h"
 #include "Value.h"
 #include "VariableValueComputer.h"
 
@@ -42,13 +49,36 @@ namespace Solver {
 class ConstraintSolver: public SMT::Visitor {
   typedef std::map<SMT::Term_ptr, Value_ptr> TermValueMap;
   typedef std::vector<std::vector<SMT::Term_ptr>> VariablePathTable;
+  /**
+   * Binary encoding of the integer result of a string term in a mixed constraint
+   */
+  struct IntegerConversion {
+    Theory::IntAutomaton_ptr int_auto;
+    Theory::BinaryIntAutomaton_ptr binary_auto;
+    Theory::BinaryIntAutomaton_ptr single_track_auto;
+  };
  public:
   ConstraintSolver(SMT::Script_ptr, SymbolTable_ptr, ConstraintInformation_ptr);
   virtual ~ConstraintSolver();
 
   void start() override;
-  void start(int iteration_count);
   void end() override;
+  int get_num_of_propagations() const;
+  /**
+   * Only decides satisfiability: variables that occur once and are not requested are not refined, their
+   * constraints are checked with lazy products, a disjunction whose variables occur nowhere else stops at its
+   * first satisfiable disjunct, and solving stops at the first unsatisfiable assertion.
+   * Values of the other variables are over-approximations, solve again without the mode for exact values.
+   */
+  void set_satisfiability_only(const bool satisfiability_only,
+                               const std::set<std::string>& requested_variables = std::set<std::string>());
+  /**
+   * False if a value was widened or one of the recorded over-approximations was applied while solving (negations
+   * of non-singletons, not-equal between non-singletons, fallbacks of not-contains/begins/ends, unknown
+   * operations); values of variables are then over-approximations and their counts are upper bounds.
+   * True only means that none of these was applied
+   */
+  bool is_exact() const;
 
   void visitScript(SMT::Script_ptr) override;
   void visitCommand(SMT::Command_ptr) override;
@@ -124,11 +154,39 @@ class ConstraintSolver: public SMT::Visitor {
   void clearTermValuesAndLocalLetVars();
   void setVariablePath(SMT::QualIdentifier_ptr qi_term);
   bool update_variables();
+  bool solve_conjuncts(SMT::And_ptr and_term);
   void visit_children_of(SMT::Term_ptr term);
   bool check_and_visit(SMT::Term_ptr term);
+  /**
+   * Applies a chain of nested string transformations with a single composed transducer
+   * @return false if the term does not start a chain of at least two transformations
+   */
+  bool visit_transformation_chain(SMT::Term_ptr term);
   bool process_mixed_integer_string_constraints_in(SMT::Term_ptr term);
-
-  int iteration_count_;
+  Theory::BinaryIntAutomaton_ptr get_binary_int_auto_for(SMT::Term_ptr string_term, Theory::IntAutomaton_ptr int_auto,
+                                                         std::string var_name, Theory::ArithmeticFormula_ptr formula);
+  bool is_binary_int_auto_unchanged(SMT::Term_ptr string_term, Theory::BinaryIntAutomaton_ptr single_track_auto);
+  void clear_integer_conversions();
+  void collect_unrefined_variables();
+  /**
+   * @return true if the constraint being visited only needs an emptiness check, none of its variables is refined
+   */
+  bool is_emptiness_check(SMT::Term_ptr term) const;
+  /**
+   * @return true if a satisfiable disjunct is a witness for the disjunction, none of its variables is requested
+   *         or occurs outside of it
+   */
+  bool is_witness_local(SMT::Or_ptr or_term);
+  /**
+   * Widens a string value with more states than the approximation limit to the strings with its lengths
+   */
+  void widen(Value_ptr value);
+
+  // number of conjuncts solved again after a variable they mention is shrunk
+  int num_of_propagations_;
+  // variables reached and shrunk by variable updates since the last conjunct
+  std::set<SMT::Variable_ptr> mentioned_variables_;
+  std::set<SMT::Variable_ptr> updated_variables_;
   SMT::Script_ptr root_;
   SymbolTable_ptr symbol_table_;
   ConstraintInformation_ptr constraint_information_;
@@ -143,7 +201,21 @@ class ConstraintSolver: public SMT::Visitor {
 
   // for relational variables that need to be updated
   std::vector<SMT::Variable_ptr> tagged_variables;
+
+  // conversions of string term results are reused across iterations
+  std::map<SMT::Term_ptr, IntegerConversion> integer_conversions_;
+  // pre-images are reused across variable updates
+  PreImageCache pre_image_cache_;
+  // transducers of transformation chains are composed once
+  TransducerCache transducer_cache_;
+
+  bool satisfiability_only_;
+  std::set<std::string> requested_variables_;
+  // variables whose values are not refined in satisfiability-only mode
+  std::set<SMT::Variable_ptr> unrefined_variables_;
+  bool is_exact_;
  private:
+  static const int MAX_VISITS_PER_CONJUNCT;
   static const int VLOG_LEVEL;
 };
 
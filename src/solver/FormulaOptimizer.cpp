@@ -114,26 +114,7 @@ void FormulaOptimizer::visitEq(Eq_ptr eq_term) {
 		}
 	}
 
-  const std::string left_expr = Ast2Dot::toString(eq_term->left_term);
-  const std::string right_expr = Ast2Dot::toString(eq_term->right_term);
-
-  std::stringstream ss;
-  ss << *eq_term;
-  if (right_expr < left_expr) {
-//    Term_ptr tmp = eq_term->left_term;
-//    eq_term->left_term = eq_term->right_term;
-//    eq_term->right_term = tmp;
-    ss << right_expr << left_expr;
-  } else {
-    ss << left_expr << right_expr;
-  }
-
-  const std::string term_expr = ss.str();
-
-  if (term_strs_[term_expr]) {
-    delete_term_ = true;
-  }
-  term_strs_[term_expr] = true;
+  check_duplicate(eq_term, eq_term->left_term, eq_term->right_term, true);
 }
 
 void FormulaOptimizer::visitNotEq(NotEq_ptr not_eq_term) {
@@ -167,195 +148,73 @@ void FormulaOptimizer::visitNotEq(NotEq_ptr not_eq_term) {
 		}
 	}
 
-  const std::string left_expr = Ast2Dot::toString(not_eq_term->left_term);
-  const std::string right_expr = Ast2Dot::toString(not_eq_term->right_term);
-
-  std::stringstream ss;
-  ss << *not_eq_term;
-  if (right_expr < left_expr) {
-//    Term_ptr tmp = not_eq_term->left_term;
-//    not_eq_term->left_term = not_eq_term->right_term;
-//    not_eq_term->right_term = tmp;
-    ss << right_expr << left_expr;
-  } else {
-    ss << left_expr << right_expr;
-  }
-
-
-  const std::string term_expr = ss.str();
-
-  if (term_strs_[term_expr]) {
-    delete_term_ = true;
-  }
-  term_strs_[term_expr] = true;
+  check_duplicate(not_eq_term, not_eq_term->left_term, not_eq_term->right_term, true);
 }
 
 void FormulaOptimizer::visitGt(Gt_ptr gt_term) {
-  const std::string left_expr = Ast2Dot::toString(gt_term->left_term);
-  const std::string right_expr = Ast2Dot::toString(gt_term->right_term);
-
-  std::stringstream ss;
-  ss << *gt_term << left_expr << right_expr;
-  const std::string term_expr = ss.str();
-
-  if (term_strs_[term_expr]) {
-    delete_term_ = true;
-  }
-  term_strs_[term_expr] = true;
+  check_duplicate(gt_term, gt_term->left_term, gt_term->right_term, false);
 }
 
 void FormulaOptimizer::visitGe(Ge_ptr ge_term) {
-  const std::string left_expr = Ast2Dot::toString(ge_term->left_term);
-  const std::string right_expr = Ast2Dot::toString(ge_term->right_term);
-
-  std::stringstream ss;
-  ss << *ge_term << left_expr << right_expr;
-  const std::string term_expr = ss.str();
-
-  if (term_strs_[term_expr]) {
-    delete_term_ = true;
-  }
-  term_strs_[term_expr] = true;
+  check_duplicate(ge_term, ge_term->left_term, ge_term->right_term, false);
 }
 
 void FormulaOptimizer::visitLt(Lt_ptr lt_term) {
-  const std::string left_expr = Ast2Dot::toString(lt_term->left_term);
-  const std::string right_expr = Ast2Dot::toString(lt_term->right_term);
-
-  std::stringstream ss;
-  ss << *lt_term << left_expr << right_expr;
-  const std::string term_expr = ss.str();
-
-  if (term_strs_[term_expr]) {
-    delete_term_ = true;
-  }
-  term_strs_[term_expr] = true;
+  check_duplicate(lt_term, lt_term->left_term, lt_term->right_term, false);
 }
 
 void FormulaOptimizer::visitLe(Le_ptr le_term) {
-  const std::string left_expr = Ast2Dot::toString(le_term->left_term);
-  const std::string right_expr = Ast2Dot::toString(le_term->right_term);
-
-  std::stringstream ss;
-  ss << *le_term << left_expr << right_expr;
-  const std::string term_expr = ss.str();
-
-  if (term_strs_[term_expr]) {
-    delete_term_ = true;
-  }
-  term_strs_[term_expr] = true;
+  check_duplicate(le_term, le_term->left_term, le_term->right_term, false);
 }
 
 void FormulaOptimizer::visitIn(In_ptr in_term) {
-  const std::string left_expr = Ast2Dot::toString(in_term->left_term);
-  const std::string right_expr = Ast2Dot::toString(in_term->right_term);
-
-  std::stringstream ss;
-  ss << *in_term << left_expr << right_expr;
-  const std::string term_expr = ss.str();
-
-  if (term_strs_[term_expr]) {
-    delete_term_ = true;
-  }
-  term_strs_[term_expr] = true;
+  check_duplicate(in_term, in_term->left_term, in_term->right_term, false);
 }
 
 void FormulaOptimizer::visitNotIn(NotIn_ptr not_in_term) {
-  const std::string left_expr = Ast2Dot::toString(not_in_term->left_term);
-  const std::string right_expr = Ast2Dot::toString(not_in_term->right_term);
-
-  std::stringstream ss;
-  ss << *not_in_term << left_expr << right_expr;
-  const std::string term_expr = ss.str();
-
-  if (term_strs_[term_expr]) {
-    delete_term_ = true;
-  }
-  term_strs_[term_expr] = true;
+  check_duplicate(not_in_term, not_in_term->left_term, not_in_term->right_term, false);
 }
 
 void FormulaOptimizer::visitContains(Contains_ptr contains_term) {
-  const std::string left_expr = Ast2Dot::toString(contains_term->subject_term);
-  const std::string right_expr = Ast2Dot::toString(contains_term->search_term);
-
-  std::stringstream ss;
-  ss << *contains_term << left_expr << right_expr;
-  const std::string term_expr = ss.str();
-
-  if (term_strs_[term_expr]) {
-    delete_term_ = true;
-  }
-  term_strs_[term_expr] = true;
+  check_duplicate(contains_term, contains_term->subject_term, contains_term->search_term, false);
 }
 
 void FormulaOptimizer::visitNotContains(NotContains_ptr not_contains_term) {
-  const std::string left_expr = Ast2Dot::toString(not_contains_term->subject_term);
-  const std::string right_expr = Ast2Dot::toString(not_contains_term->search_term);
-
-  std::stringstream ss;
-  ss << *not_contains_term << left_expr << right_expr;
-  const std::string term_expr = ss.str();
-
-  if (term_strs_[term_expr]) {
-    delete_term_ = true;
-  }
-  term_strs_[term_expr] = true;
+  check_duplicate(not_contains_term, not_contains_term->subject_term, not_contains_term->search_term, false);
 }
 
 void FormulaOptimizer::visitBegins(Begins_ptr begins_term) {
-  const std::string left_expr = Ast2Dot::toString(begins_term->subject_term);
-  const std::string right_expr = Ast2Dot::toString(begins_term->search_term);
-
-  std::stringstream ss;
-  ss << *begins_term << left_expr << right_expr;
-  const std::string term_expr = ss.str();
-
-  if (term_strs_[term_expr]) {
-    delete_term_ = true;
-  }
-  term_strs_[term_expr] = true;
+  check_duplicate(begins_term, begins_term->subject_term, begins_term->search_term, false);
 }
 
 void FormulaOptimizer::visitNotBegins(NotBegins_ptr not_begins_term) {
-  const std::string left_expr = Ast2Dot::toString(not_begins_term->subject_term);
-  const std::string right_expr = Ast2Dot::toString(not_begins_term->search_term);
-
-  std::stringstream ss;
-  ss << *not_begins_term << left_expr << right_expr;
-  const std::string term_expr = ss.str();
-
-  if (term_strs_[term_expr]) {
-    delete_term_ = true;
-  }
-  term_strs_[term_expr] = true;
+  check_duplicate(not_begins_term, not_begins_term->subject_term, not_begins_term->search_term, false);
 }
 
 void FormulaOptimizer::visitEnds(Ends_ptr ends_term) {
-  const std::string left_expr = Ast2Dot::toString(ends_term->subject_term);
-  const std::string right_expr = Ast2Dot::toString(ends_term->search_term);
-
-  std::stringstream ss;
-  ss << *ends_term << left_expr << right_expr;
-  const std::string term_expr = ss.str();
-
-  if (term_strs_[term_expr]) {
-    delete_term_ = true;
-  }
-  term_strs_[term_expr] = true;
+  check_duplicate(ends_term, ends_term->subject_term, ends_term->search_term, false);
 }
 
 void FormulaOptimizer::visitNotEnds(NotEnds_ptr not_ends_term) {
-  const std::string left_expr = Ast2Dot::toString(not_ends_term->subject_term);
-  const std::string right_expr = Ast2Dot::toString(not_ends_term->search_term);
+  check_duplicate(not_ends_term, not_ends_term->subject_term, not_ends_term->search_term, false);
+}
 
+/**
+ * Marks the term for deletion if a structurally identical one is already seen in the enclosing
+ * conjunction or disjunction; operands of commutative terms are compared in either order.
+ */
+void FormulaOptimizer::check_duplicate(Term_ptr term, Term_ptr left_term, Term_ptr right_term,
+                                       bool is_commutative) {
+  std::string left_expr = Ast2Dot::toString(left_term);
+  std::string right_expr = Ast2Dot::toString(right_term);
+  if (is_commutative and right_expr < left_expr) {
+    std::swap(left_expr, right_expr);
+  }
   std::stringstream ss;
-  ss << *not_ends_term << left_expr << right_expr;
-  const std::string term_expr = ss.str();
-
-  if (term_strs_[term_expr]) {
+  ss << *term << left_expr << right_expr;
+  if (not term_strs_.insert(ss.str()).second) {
     delete_term_ = true;
   }
-  term_strs_[term_expr] = true;
 }
 
 } /* namespace Solver */
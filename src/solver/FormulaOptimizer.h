@@ -55,9 +55,11 @@ public:
   void visitNotEnds(SMT::NotEnds_ptr) override;
 
 protected:
+  void check_duplicate(SMT::Term_ptr term, SMT::Term_ptr left_term, SMT::Term_ptr right_term, bool is_commutative);
+
   SymbolTable_ptr symbol_table_;
   bool delete_term_;
-  std::map<std::string, bool> term_strs_;
+  std::set<std::string> term_strs_;
 private:
   static const int VLOG_LEVEL;
 };
@@ -287,7 +287,7 @@ void ImplicationRunner::CollectHeuristicInfo(Eq_ptr eq_term) {
 				auto var_coeffs = f->GetVariableCoefficientMap();
 				if(TermConstant_ptr term_constant = dynamic_cast<TermConstant_ptr>(iter)) {
 					// if constant, add to current constant (if no constant in formula yet, GetConstant returns 0)
-					int constant = term_constant->getValue().length() + f->GetConstant();
+					Theory::BigInteger constant = term_constant->getValue().length() + f->GetConstant();
 					f->SetConstant(constant);
 				} else if(QualIdentifier_ptr last_var = dynamic_cast<QualIdentifier_ptr>(iter)) {
 					// add variable, to formula
@@ -445,12 +445,14 @@ void ImplicationRunner::AddLengthHeuristic(And_ptr and_term) {
 			}
 
 
-			if(coeff_iter.second < 0) {
-				TermConstant_ptr term_constant = new TermConstant(new Primitive(std::to_string(coeff_iter.second*(-1)),Primitive::Type::NUMERAL));
+			// the int coefficient map saturates, the term is written with the exact coefficient
+			Theory::BigInteger coeff = variable_formulas[iter]->GetExactCoefficient(coeff_iter.first);
+			if(coeff < 0) {
+				TermConstant_ptr term_constant = new TermConstant(new Primitive(Theory::BigInteger(-coeff).str(),Primitive::Type::NUMERAL));
 				UMinus_ptr uminus_term = new UMinus(term_constant);
 				inner_term_list->push_back(uminus_term);
 			} else {
-				TermConstant_ptr term_constant = new TermConstant(new Primitive(std::to_string(coeff_iter.second),Primitive::Type::NUMERAL));
+				TermConstant_ptr term_constant = new TermConstant(new Primitive(coeff.str(),Primitive::Type::NUMERAL));
 				inner_term_list->push_back(term_constant);
 			}
 
@@ -458,13 +460,13 @@ void ImplicationRunner::AddLengthHeuristic(And_ptr and_term) {
 			term_list->push_back(times_term);
 		}
 
-		int constant = variable_formulas[iter]->GetConstant();
+		Theory::BigInteger constant = variable_formulas[iter]->GetConstant();
 		if(constant < 0) {
-			TermConstant_ptr term_constant = new TermConstant(new Primitive(std::to_string(constant*(-1)),Primitive::Type::NUMERAL));
+			TermConstant_ptr term_constant = new TermConstant(new Primitive(Theory::BigInteger(-constant).str(),Primitive::Type::NUMERAL));
 			UMinus_ptr uminus_term = new UMinus(term_constant);
 			term_list->push_back(uminus_term);
 		} else if (constant > 0){
-			TermConstant_ptr term_constant = new TermConstant(new Primitive(std::to_string(constant),Primitive::Type::NUMERAL));
+			TermConstant_ptr term_constant = new TermConstant(new Primitive(constant.str(),Primitive::Type::NUMERAL));
 			term_list->push_back(term_constant);
 		}
 
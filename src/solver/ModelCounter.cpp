@@ -41,6 +41,12 @@ void ModelCounter::add_symbolic_counter(const Theory::SymbolicCounter& counter)
   symbolic_counters_.push_back(counter);
 }
 
+void ModelCounter::add_model_counter(const ModelCounter& model_counter) {
+  constant_ints_.insert(constant_ints_.end(), model_counter.constant_ints_.begin(), model_counter.constant_ints_.end());
+  symbolic_counters_.insert(symbolic_counters_.end(), model_counter.symbolic_counters_.begin(),
+                            model_counter.symbolic_counters_.end());
+}
+
 
 Theory::BigInteger ModelCounter::CountInts(const unsigned long bound) {
   Theory::BigInteger result(1);
@@ -98,16 +104,17 @@ Theory::BigInteger ModelCounter::CountStrs(const unsigned long bound) {
   }
 
   if (unconstraint_str_vars_ > 0) {
+  	const Theory::BigInteger alphabet_size = Theory::StringAutomaton::GetEncoding().get_alphabet_size();
   	if(count_bound_exact_) {
   		Theory::BigInteger single_unconstraint_str_count = (boost::multiprecision::pow(
-				boost::multiprecision::cpp_int(256), bound));
+				alphabet_size, bound));
 			result = result
 			 * boost::multiprecision::pow(single_unconstraint_str_count,
 																		unconstraint_str_vars_);
   	} else {
 			Theory::BigInteger single_unconstraint_str_count = (boost::multiprecision::pow(
-				boost::multiprecision::cpp_int(256), (bound + 1)) - 1)
-						/ 255;
+				alphabet_size, (bound + 1)) - 1)
+						/ (alphabet_size - 1);
 			result = result
 			 * boost::multiprecision::pow(single_unconstraint_str_count,
 																		unconstraint_str_vars_);
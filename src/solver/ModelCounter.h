@@ -17,12 +17,23 @@
 #include <glog/logging.h>
 
 #include "../cereal/types/vector.hpp"
+#include "../theory/StringAutomaton.h"
 #include "../theory/SymbolicCounter.h"
 #include "../utils/Serialize.h"
 
 namespace Vlab {
 namespace Solver {
 
+/**
+ * Lower and upper bounds of a count, they are equal when the count is exact. An inexact count has a lower
+ * bound of 0, no under-approximation is computed
+ */
+struct CountBounds {
+  Theory::BigInteger lower;
+  Theory::BigInteger upper;
+  bool is_exact;
+};
+
 class ModelCounter {
  public:
   ModelCounter();
@@ -33,6 +44,10 @@ class ModelCounter {
   void set_num_of_unconstraint_str_vars(int n);
   void add_constant(int c);
   void add_symbolic_counter(const Theory::SymbolicCounter& counter);
+  /**
+   * Adds the constants and symbolic counters of another counter, its unconstrained variables are not added
+   */
+  void add_model_counter(const ModelCounter& model_counter);
   Theory::BigInteger CountInts(const unsigned long bound);
   Theory::BigInteger CountStrs(const unsigned long bound);
   Theory::BigInteger Count(const unsigned long int_bound, const unsigned long str_bound);
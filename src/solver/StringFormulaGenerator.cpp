@@ -1418,6 +1418,9 @@ void StringFormulaGenerator::delete_term_formula(Term_ptr term) {
 
 void StringFormulaGenerator::set_group_mappings() {
   DVLOG(VLOG_LEVEL)<< "start setting string group for components";
+  if (Option::Solver::ENABLE_TRACK_ORDERING) {
+    set_track_orders();
+  }
   for (auto& el : term_group_map_) {
   	//LOG(INFO) << *el.first << "@" << el.first;
   	// only subgroups have formulas
@@ -1457,5 +1460,94 @@ void StringFormulaGenerator::set_group_mappings() {
   //std::cin.get();
 }
 
+/**
+ * Bits of the tracks of a multitrack automaton are interleaved, a relation between two tracks
+ * keeps the bits of the tracks in between in its bdds. Orders the tracks of each group
+ * so that related variables get close tracks; formulas of the group inherit the order of the group formula.
+ */
+void StringFormulaGenerator::set_track_orders() {
+  std::map<std::string, std::map<std::pair<std::string, std::string>, int>> group_relations;
+  for (auto& el : term_group_map_) {
+    if (subgroups_.find(el.second) != subgroups_.end()) {
+      continue;
+    }
+    auto formula = get_term_formula(el.first);
+    if (formula == nullptr) {
+      continue;
+    }
+    std::vector<std::string> related_variables;
+    for (const auto& var_entry : formula->GetVariableCoefficientMap()) {
+      if (var_entry.second != 0) {
+        related_variables.push_back(var_entry.first);
+      }
+    }
+    for (std::size_t i = 0; i < related_variables.size(); ++i) {
+      for (std::size_t j = i + 1; j < related_variables.size(); ++j) {
+        ++group_relations[el.second][std::make_pair(related_variables[i], related_variables[j])];
+      }
+    }
+  }
+
+  for (auto& el : group_formula_) {
+    auto group_formula = el.second;
+    // with two tracks relations are between neighbours already
+    if (group_formula == nullptr or group_formula->GetNumberOfVariables() < 3
+        or group_relations.find(el.first) == group_relations.end()) {
+      continue;
+    }
+    std::vector<std::string> tracks;
+    for (const auto& var_entry : group_formula->GetVariableCoefficientMap()) {
+      tracks.push_back(var_entry.first);
+    }
+    auto track_order = sift_track_order(tracks, group_relations[el.first]);
+    if (track_order != tracks) {
+      group_formula->SetTrackOrder(track_order);
+      DVLOG(VLOG_LEVEL) << "track order of " << el.first << ": " << group_formula->str();
+    }
+  }
+}
+
+/**
+ * Sifting on the track order: each variable in turn is moved to the position that minimizes the
+ * total distance between related tracks, until no move improves it. Starts from the given order
+ * and never makes it worse.
+ */
+std::vector<std::string> StringFormulaGenerator::sift_track_order(std::vector<std::string> tracks,
+    const std::map<std::pair<std::string, std::string>, int>& relations) {
+  auto cost = [&relations](const std::vector<std::string>& order) {
+    std::map<std::string, int> positions;
+    for (std::size_t i = 0; i < order.size(); ++i) {
+      positions[order[i]] = i;
+    }
+    int total = 0;
+    for (auto& relation : relations) {
+      total += relation.second * std::abs(positions[relation.first.first] - positions[relation.first.second]);
+    }
+    return total;
+  };
+
+  int best_cost = cost(tracks);
+  bool improved = true;
+  for (std::size_t pass = 0; improved and pass < tracks.size(); ++pass) {
+    improved = false;
+    const auto variables = tracks;
+    for (auto& variable : variables) {
+      auto sifted = tracks;
+      sifted.erase(std::find(sifted.begin(), sifted.end(), variable));
+      for (std::size_t position = 0; position <= sifted.size(); ++position) {
+        auto candidate = sifted;
+        candidate.insert(candidate.begin() + position, variable);
+        const int candidate_cost = cost(candidate);
+        if (candidate_cost < best_cost) {
+          best_cost = candidate_cost;
+          tracks = candidate;
+          improved = true;
+        }
+      }
+    }
+  }
+  return tracks;
+}
+
 } /* namespace Solver */
 } /* namespace Vlab */
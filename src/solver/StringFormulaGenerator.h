@@ -8,6 +8,8 @@
 #ifndef SRC_SOLVER_STRINGFORMULAGENERATOR_H_
 #define SRC_SOLVER_STRINGFORMULAGENERATOR_H_
 
+#include <algorithm>
+#include <cstdlib>
 #include <map>
 #include <iostream>
 #include <string>
@@ -127,6 +129,9 @@ protected:
   bool set_term_formula(SMT::Term_ptr term, Theory::StringFormula_ptr formula);
   void delete_term_formula(SMT::Term_ptr);
   void set_group_mappings();
+  void set_track_orders();
+  std::vector<std::string> sift_track_order(std::vector<std::string> tracks,
+      const std::map<std::pair<std::string, std::string>, int>& relations);
 
   SMT::Script_ptr root_;
   SymbolTable_ptr symbol_table_;
@@ -14,6 +14,8 @@ using namespace SMT;
 
 const int SymbolTable::VLOG_LEVEL = 10;
 
+static const std::string INTERNAL_NAME_PREFIX = "__vlab__";
+
 SymbolTable::SymbolTable()
   : global_assertion_result_(true) {
   count_symbol_ = nullptr;
@@ -133,6 +135,10 @@ int SymbolTable::get_num_of_variables(Variable::Type type) {
   return count;
 }
 
+bool SymbolTable::is_internal_variable(Variable_ptr variable) const {
+  return variable->isLocalLetVar() or variable->getName().find(INTERNAL_NAME_PREFIX) == 0;
+}
+
 void SymbolTable::push_scope(Visitable_ptr key, bool save_scope) {
   scope_stack_.push_back(key);
   if (save_scope) {
@@ -696,7 +702,7 @@ void SymbolTable::reset_variable_usage() {
 
 std::string SymbolTable::generate_internal_name(std::string name, Variable::Type type) {
   std::stringstream ss;
-  ss << "__vlab__";
+  ss << INTERNAL_NAME_PREFIX;
   switch (type) {
   case Variable::Type::BOOL:
     ss << "bool";
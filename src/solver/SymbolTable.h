@@ -61,6 +61,10 @@ public:
   SMT::Variable_ptr get_variable_unsafe(std::string name);
   VariableMap& get_variables();
   int get_num_of_variables(SMT::Variable::Type type);
+  /**
+   * True for variables introduced by the solver, they are not declared by the script and are never queried
+   */
+  bool is_internal_variable(SMT::Variable_ptr variable) const;
 
   void push_scope(SMT::Visitable_ptr, bool save_scope = true);
   SMT::Visitable_ptr top_scope();
@@ -0,0 +1,106 @@
+/*
+ * TransformationChain.cpp
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "TransformationChain.h"
+
+namespace Vlab {
+namespace Solver {
+
+using namespace SMT;
+
+const int TransformationChain::VLOG_LEVEL = 11;
+
+TransformationChain::TransformationChain(Term_ptr term)
+    : subject_ { term } {
+  Term_ptr subject = get_subject_of(term);
+  while (subject not_eq nullptr) {
+    terms_.push_back(subject_);
+    subject_ = subject;
+    subject = get_subject_of(subject_);
+  }
+  DVLOG(VLOG_LEVEL) << "transformation chain of size " << terms_.size() << " for: " << *term;
+}
+
+TransformationChain::~TransformationChain() {
+}
+
+std::size_t TransformationChain::size() const {
+  return terms_.size();
+}
+
+Term_ptr TransformationChain::get_subject() const {
+  return subject_;
+}
+
+Theory::Transducer TransformationChain::get_transducer() const {
+  CHECK(not terms_.empty());
+  Theory::Transducer transducer = get_transducer_of(terms_.back());
+  for (auto it = terms_.rbegin() + 1; it != terms_.rend(); ++it) {
+    transducer = transducer.Compose(get_transducer_of(*it));
+  }
+  return transducer;
+}
+
+const Theory::Transducer& TransformationChain::get_transducer(TransducerCache& cache) const {
+  CHECK(not terms_.empty());
+  auto it = cache.find(terms_.front());
+  if (it == cache.end()) {
+    it = cache.emplace(terms_.front(), get_transducer()).first;
+  } else {
+    DVLOG(VLOG_LEVEL) << "reusing transducer of: " << *terms_.front();
+  }
+  return it->second;
+}
+
+Term_ptr TransformationChain::get_subject_of(Term_ptr term) {
+  switch (term->type()) {
+    case Term::Type::TOUPPER:
+      return dynamic_cast<ToUpper_ptr>(term)->subject_term;
+    case Term::Type::TOLOWER:
+      return dynamic_cast<ToLower_ptr>(term)->subject_term;
+    case Term::Type::TRIM:
+      return dynamic_cast<Trim_ptr>(term)->subject_term;
+    case Term::Type::REPLACE: {
+      Replace_ptr replace_term = dynamic_cast<Replace_ptr>(term);
+      TermConstant_ptr search_term = dynamic_cast<TermConstant_ptr>(replace_term->search_term);
+      TermConstant_ptr replace_with_term = dynamic_cast<TermConstant_ptr>(replace_term->replace_term);
+      if (search_term not_eq nullptr and replace_with_term not_eq nullptr
+          and Primitive::Type::STRING == search_term->getValueType()
+          and Primitive::Type::STRING == replace_with_term->getValueType()
+          and not search_term->getValue().empty()) {
+        return replace_term->subject_term;
+      }
+      return nullptr;
+    }
+    default:
+      return nullptr;
+  }
+}
+
+Theory::Transducer TransformationChain::get_transducer_of(Term_ptr term) {
+  switch (term->type()) {
+    case Term::Type::TOUPPER:
+      return Theory::StringAutomaton::MakeToUpperCaseTransducer();
+    case Term::Type::TOLOWER:
+      return Theory::StringAutomaton::MakeToLowerCaseTransducer();
+    case Term::Type::TRIM:
+      return Theory::StringAutomaton::MakeTrimTransducer();
+    case Term::Type::REPLACE: {
+      Replace_ptr replace_term = dynamic_cast<Replace_ptr>(term);
+      return Theory::StringAutomaton::MakeReplaceTransducer(
+          dynamic_cast<TermConstant_ptr>(replace_term->search_term)->getValue(),
+          dynamic_cast<TermConstant_ptr>(replace_term->replace_term)->getValue());
+    }
+    default:
+      LOG(FATAL) << "not a transformation: " << *term;
+      return Theory::StringAutomaton::MakeTrimTransducer();
+  }
+}
+
+} /* namespace Solver */
+} /* namespace Vlab */
@@ -0,0 +1,75 @@
+/*
+ * TransformationChain.h
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef SRC_SOLVER_TRANSFORMATIONCHAIN_H_
+#define SRC_SOLVER_TRANSFORMATIONCHAIN_H_
+
+#include <map>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "../smt/ast.h"
+#include "../smt/typedefs.h"
+#include "../theory/StringAutomaton.h"
+#include "../theory/Transducer.h"
+
+namespace Vlab {
+namespace Solver {
+
+/**
+ * Composed transducers of chains, keyed by the outermost term of a chain
+ */
+using TransducerCache = std::map<SMT::Term_ptr, Theory::Transducer>;
+
+/**
+ * Nested string transformations (toUpper, toLower, trim and replace with constant strings) over a single
+ * subject term. A chain is applied with the composition of the transducers of its terms, intermediate
+ * terms are not materialized.
+ */
+class TransformationChain {
+ public:
+  TransformationChain(SMT::Term_ptr term);
+  virtual ~TransformationChain();
+
+  std::size_t size() const;
+
+  /**
+   * @return innermost term that is not part of the chain
+   */
+  SMT::Term_ptr get_subject() const;
+
+  /**
+   * @return transducer of the chain, the innermost transformation is applied first
+   */
+  Theory::Transducer get_transducer() const;
+
+  /**
+   * @return transducer of the chain, composed only on the first request for the outermost term of the chain
+   */
+  const Theory::Transducer& get_transducer(TransducerCache& cache) const;
+
+ protected:
+  /**
+   * @return subject of the term if it is a transformation that can be chained, nullptr otherwise
+   */
+  static SMT::Term_ptr get_subject_of(SMT::Term_ptr term);
+  static Theory::Transducer get_transducer_of(SMT::Term_ptr term);
+
+  // outermost term first
+  std::vector<SMT::Term_ptr> terms_;
+  SMT::Term_ptr subject_;
+
+ private:
+  static const int VLOG_LEVEL;
+};
+
+} /* namespace Solver */
+} /* namespace Vlab */
+
+#endif /* SRC_SOLVER_TRANSFORMATIONCHAIN_H_ */
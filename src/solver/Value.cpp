@@ -469,6 +469,65 @@ bool Value::is_satisfiable() {
   return is_satisfiable;
 }
 
+/**
+ * Checks if both values have the same type and represent the same set of values
+ */
+bool Value::is_equal(Value_ptr other_value) const {
+  if (type != other_value->type) {
+    return false;
+  }
+  bool is_equal = false;
+  switch (type) {
+    case Type::NONE:
+      is_equal = true;
+      break;
+    case Type::BOOL_CONSTANT:
+      is_equal = (bool_constant == other_value->bool_constant);
+      break;
+    case Type::INT_CONSTANT:
+      is_equal = (int_constant == other_value->int_constant);
+      break;
+    case Type::INT_AUTOMATON:
+      is_equal = (int_automaton->hasNegative1() == other_value->int_automaton->hasNegative1())
+          and int_automaton->IsEqual(other_value->int_automaton);
+      break;
+    case Type::BINARYINT_AUTOMATON:
+      is_equal = binaryint_automaton->IsEqual(other_value->binaryint_automaton);
+      break;
+    case Type::STRING_AUTOMATON:
+      is_equal = string_automaton->IsEqual(other_value->string_automaton);
+      break;
+    default:
+      LOG(FATAL) << "value type is not supported";
+      break;
+  }
+  return is_equal;
+}
+
+std::size_t Value::fingerprint() const {
+  std::size_t result = static_cast<std::size_t>(type) << 56;
+  switch (type) {
+    case Type::BOOL_CONSTANT:
+      result ^= std::hash<bool>()(bool_constant);
+      break;
+    case Type::INT_CONSTANT:
+      result ^= std::hash<int>()(int_constant);
+      break;
+    case Type::INT_AUTOMATON:
+      result ^= int_automaton->Fingerprint() ^ int_automaton->hasNegative1();
+      break;
+    case Type::BINARYINT_AUTOMATON:
+      result ^= binaryint_automaton->Fingerprint();
+      break;
+    case Type::STRING_AUTOMATON:
+      result ^= string_automaton->Fingerprint();
+      break;
+    default:
+      break;
+  }
+  return result;
+}
+
 bool Value::isSingleValue() {
   bool is_single_value = false;
   switch (type) {
@@ -81,6 +81,8 @@ class Value {
   Value_ptr minus(Value_ptr other_value) const;
 
   bool is_satisfiable();bool isSingleValue();
+  bool is_equal(Value_ptr other_value) const;
+  std::size_t fingerprint() const;
   std::string getASatisfyingExample();
 
   class Name {
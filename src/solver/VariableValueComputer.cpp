@@ -13,10 +13,68 @@ namespace Solver {
 using namespace SMT;
 
 const int VariableValueComputer::VLOG_LEVEL = 12;
+
+PreImageCache::PreImageCache() {
+}
+
+PreImageCache::~PreImageCache() {
+  clear();
+}
+
+Value_ptr PreImageCache::get(Term_ptr parent_term, Term_ptr child_term, const std::vector<Value_ptr>& inputs) const {
+  auto it = entries_.find(std::make_pair(parent_term, child_term));
+  if (it == entries_.end() or it->second.inputs.size() != inputs.size()) {
+    return nullptr;
+  }
+  const Entry& entry = it->second;
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    if (entry.fingerprints[i] != inputs[i]->fingerprint()) {
+      return nullptr;
+    }
+  }
+  // fingerprints only filter, values must be the same
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    if (not entry.inputs[i]->is_equal(inputs[i])) {
+      return nullptr;
+    }
+  }
+  return entry.pre_image;
+}
+
+void PreImageCache::set(Term_ptr parent_term, Term_ptr child_term, const std::vector<Value_ptr>& inputs, const Value_ptr pre_image) {
+  Entry& entry = entries_[std::make_pair(parent_term, child_term)];
+  clear(entry);
+  for (auto input : inputs) {
+    entry.fingerprints.push_back(input->fingerprint());
+    entry.inputs.push_back(input->clone());
+  }
+  entry.pre_image = pre_image->clone();
+}
+
+void PreImageCache::clear() {
+  for (auto& it : entries_) {
+    clear(it.second);
+  }
+  entries_.clear();
+}
+
+void PreImageCache::clear(Entry& entry) {
+  for (auto input : entry.inputs) {
+    delete input;
+  }
+  entry.inputs.clear();
+  entry.fingerprints.clear();
+  delete entry.pre_image;
+  entry.pre_image = nullptr;
+}
+
 // TODO Intersect with result post
-VariableValueComputer::VariableValueComputer(SymbolTable_ptr symbol_table, VariablePathTable& variable_path_table, const TermValueMap& post_images)
+VariableValueComputer::VariableValueComputer(SymbolTable_ptr symbol_table, VariablePathTable& variable_path_table,
+                                             const TermValueMap& post_images, PreImageCache_ptr pre_image_cache,
+                                             TransducerCache* transducer_cache)
         : is_satisfiable_{true}, symbol_table(symbol_table), variable_path_table (variable_path_table),
-          post_images (post_images), current_path (nullptr) {
+          post_images (post_images), current_path (nullptr), pre_image_cache_ (pre_image_cache),
+          transducer_cache_ (transducer_cache) {
 }
 
 VariableValueComputer::~VariableValueComputer() {
@@ -122,7 +180,7 @@ void VariableValueComputer::visitLet(Let_ptr let_term) {
   symbol_table->pop_scope();
 
   if (value_to_move_upper_scope) {
-    symbol_table->IntersectValue(variable_to_update, value_to_move_upper_scope);
+    update_variable_value(variable_to_update, value_to_move_upper_scope);
   }
 
 }
@@ -588,6 +646,14 @@ void VariableValueComputer::visitConcat(Concat_ptr concat_term) {
   }
   Value_ptr term_value = getTermPreImage(concat_term);
   Value_ptr child_post_value = getTermPostImage(child_term);
+  std::vector<Value_ptr> inputs { term_value };
+  for (auto& term_ptr : *(concat_term->term_list)) {
+    inputs.push_back(getTermPostImage(term_ptr));
+  }
+  if (reuse_pre_image(concat_term, child_term, inputs)) {
+    visit(child_term);
+    return;
+  }
 
   // Figure out position of the variable in concat list
   Theory::StringAutomaton_ptr left_of_child = nullptr;
@@ -635,6 +701,7 @@ void VariableValueComputer::visitConcat(Concat_ptr concat_term) {
   child_value = new Value(child_post_value->getStringAutomaton()->Intersect(child_result_auto));
   delete child_result_auto; child_result_auto = nullptr;
   setTermPreImage(child_term, child_value);
+  cache_pre_image(concat_term, child_term, inputs);
   visit(child_term);
 }
 
@@ -1160,6 +1227,9 @@ void VariableValueComputer::visitSubString(SubString_ptr sub_string_term) {
 void VariableValueComputer::visitToUpper(ToUpper_ptr to_upper_term) {
   DVLOG(VLOG_LEVEL) << "pop: " << *to_upper_term;
   popTerm(to_upper_term);
+  if (visit_transformation_chain(to_upper_term)) {
+    return;
+  }
   Term_ptr child_term = current_path->back();
   Value_ptr child_value = getTermPreImage(child_term);
   if (child_value not_eq nullptr) {
@@ -1169,16 +1239,26 @@ void VariableValueComputer::visitToUpper(ToUpper_ptr to_upper_term) {
 
   Value_ptr term_value = getTermPreImage(to_upper_term);
   Value_ptr child_post_value = getTermPostImage(child_term);
+  std::vector<Value_ptr> inputs { term_value, child_post_value };
+  if (reuse_pre_image(to_upper_term, child_term, inputs)) {
+    visit(child_term);
+    return;
+  }
+
   Theory::StringAutomaton_ptr child_pre_auto = term_value->getStringAutomaton()
       ->PreToUpperCase(child_post_value->getStringAutomaton());
   child_value = new Value(child_pre_auto);
   setTermPreImage(child_term, child_value);
+  cache_pre_image(to_upper_term, child_term, inputs);
   visit(child_term);
 }
 
 void VariableValueComputer::visitToLower(ToLower_ptr to_lower_term) {
   DVLOG(VLOG_LEVEL) << "pop: " << *to_lower_term;
   popTerm(to_lower_term);
+  if (visit_transformation_chain(to_lower_term)) {
+    return;
+  }
   Term_ptr child_term = current_path->back();
   Value_ptr child_value = getTermPreImage(child_term);
   if (child_value not_eq nullptr) {
@@ -1188,16 +1268,26 @@ void VariableValueComputer::visitToLower(ToLower_ptr to_lower_term) {
 
   Value_ptr term_value = getTermPreImage(to_lower_term);
   Value_ptr child_post_value = getTermPostImage(child_term);
+  std::vector<Value_ptr> inputs { term_value, child_post_value };
+  if (reuse_pre_image(to_lower_term, child_term, inputs)) {
+    visit(child_term);
+    return;
+  }
+
   Theory::StringAutomaton_ptr child_pre_auto = term_value->getStringAutomaton()
       ->PreToLowerCase(child_post_value->getStringAutomaton());
   child_value = new Value(child_pre_auto);
   setTermPreImage(child_term, child_value);
+  cache_pre_image(to_lower_term, child_term, inputs);
   visit(child_term);
 }
 
 void VariableValueComputer::visitTrim(Trim_ptr trim_term) {
   DVLOG(VLOG_LEVEL) << "pop: " << *trim_term;
   popTerm(trim_term);
+  if (visit_transformation_chain(trim_term)) {
+    return;
+  }
   Term_ptr child_term = current_path->back();
   Value_ptr child_value = getTermPreImage(child_term);
   if (child_value not_eq nullptr) {
@@ -1207,10 +1297,17 @@ void VariableValueComputer::visitTrim(Trim_ptr trim_term) {
 
   Value_ptr term_value = getTermPreImage(trim_term);
   Value_ptr child_post_value = getTermPostImage(child_term);
+  std::vector<Value_ptr> inputs { term_value, child_post_value };
+  if (reuse_pre_image(trim_term, child_term, inputs)) {
+    visit(child_term);
+    return;
+  }
+
   Theory::StringAutomaton_ptr child_pre_auto = term_value->getStringAutomaton()
       ->PreTrim(child_post_value->getStringAutomaton());
   child_value = new Value(child_pre_auto);
   setTermPreImage(child_term, child_value);
+  cache_pre_image(trim_term, child_term, inputs);
   visit(child_term);
 }
 
@@ -1278,6 +1375,15 @@ void VariableValueComputer::visitToInt(ToInt_ptr to_int_term) {
       delete regex_auto;
       delete concat_auto;
     }
+  } else if (Value::Type::BINARYINT_AUTOMATON == term_value->getType()) {
+    // if -1, then we can't refine child term (anything non-numeric maps to -1)
+    if (term_value->getBinaryIntAutomaton()->HasNegative1()) {
+      child_pre_auto = Theory::StringAutomaton::MakeAnyString();
+    } else {
+      auto decimal_auto = Theory::StringAutomaton::MakeDecimalStrings(term_value->getBinaryIntAutomaton(), true);
+      child_pre_auto = child_post_value->getStringAutomaton()->Intersect(decimal_auto);
+      delete decimal_auto;
+    }
   } else {
     // if -1, then we can't refine child term (anything non-numeric maps to -1)
     if(term_value->getIntAutomaton()->hasNegative1()) {
@@ -1307,6 +1413,9 @@ void VariableValueComputer::visitToInt(ToInt_ptr to_int_term) {
 void VariableValueComputer::visitReplace(Replace_ptr replace_term) {
   DVLOG(VLOG_LEVEL) << "pop: " << *replace_term;
   popTerm(replace_term);
+  if (visit_transformation_chain(replace_term)) {
+    return;
+  }
   Term_ptr child_term = current_path->back();
   Value_ptr child_value = getTermPreImage(child_term);
   if (child_value not_eq nullptr) {
@@ -1318,8 +1427,13 @@ void VariableValueComputer::visitReplace(Replace_ptr replace_term) {
   Value_ptr child_post_value = getTermPostImage(child_term);
   Value_ptr search_auto_value = getTermPostImage(replace_term->search_term);
   Value_ptr replace_auto_value = getTermPostImage(replace_term->replace_term);
+  std::vector<Value_ptr> inputs { term_value, child_post_value, search_auto_value, replace_auto_value };
+  if (reuse_pre_image(replace_term, child_term, inputs)) {
+    visit(child_term);
+    return;
+  }
 
-  if (child_term == replace_term->replace_term) {
+  if (child_term == replace_term->subject_term) {
     Theory::StringAutomaton_ptr child_pre_auto =
     		term_value->getStringAutomaton()->PreReplace(search_auto_value->getStringAutomaton(),
             																				 replace_auto_value->getStringAutomaton()->GetAnAcceptingString(),
@@ -1330,6 +1444,7 @@ void VariableValueComputer::visitReplace(Replace_ptr replace_term) {
   }
 
   setTermPreImage(child_term, child_value);
+  cache_pre_image(replace_term, child_term, inputs);
   visit(child_term);
 }
 
@@ -1457,7 +1572,7 @@ void VariableValueComputer::visitQualIdentifier(QualIdentifier_ptr qi_term) {
       break;
   }
 
-  is_satisfiable_ = symbol_table->IntersectValue(qi_term->getVarName(), term_pre_value) and is_satisfiable_;
+  is_satisfiable_ = update_variable_value(symbol_table->get_variable(qi_term->getVarName()), term_pre_value) and is_satisfiable_;
 }
 
 void VariableValueComputer::visitTermConstant(TermConstant_ptr term_constant) {
@@ -1500,6 +1615,61 @@ bool VariableValueComputer::is_satisfiable() {
   return is_satisfiable_;
 }
 
+const std::set<Variable_ptr>& VariableValueComputer::get_updated_variables() const {
+  return updated_variables_;
+}
+
+/**
+ * Intersects value of the variable with the given value, keeps track of the variables that are shrunk
+ */
+bool VariableValueComputer::update_variable_value(Variable_ptr variable, Value_ptr value) {
+  Value_ptr old_value = symbol_table->get_value(variable);
+  Value_ptr new_value = nullptr;
+  if (old_value == nullptr) {
+    new_value = value->clone();
+    updated_variables_.insert(variable);
+  } else {
+    new_value = old_value->intersect(value);
+    if (not new_value->is_equal(old_value)) {
+      updated_variables_.insert(variable);
+    }
+  }
+  bool result = symbol_table->set_value(variable, new_value);
+  delete new_value;
+  return result;
+}
+
+/**
+ * Sets pre-image of the child term without computing it when
+ * 1) pre-image of the parent term is its post-image, child term cannot be refined either, or
+ * 2) it is computed in an earlier variable value computation from the same values
+ */
+bool VariableValueComputer::reuse_pre_image(Term_ptr parent_term, Term_ptr child_term, const std::vector<Value_ptr>& inputs) {
+  Value_ptr child_value = nullptr;
+  if (getTermPreImage(parent_term)->is_equal(getTermPostImage(parent_term))) {
+    DVLOG(VLOG_LEVEL) << "not refined: " << *parent_term;
+    child_value = getTermPostImage(child_term)->clone();
+  } else if (pre_image_cache_ != nullptr) {
+    auto cached_value = pre_image_cache_->get(parent_term, child_term, inputs);
+    if (cached_value != nullptr) {
+      DVLOG(VLOG_LEVEL) << "reuse pre image: " << *child_term;
+      child_value = cached_value->clone();
+    }
+  }
+
+  if (child_value == nullptr) {
+    return false;
+  }
+  setTermPreImage(child_term, child_value);
+  return true;
+}
+
+void VariableValueComputer::cache_pre_image(Term_ptr parent_term, Term_ptr child_term, const std::vector<Value_ptr>& inputs) {
+  if (pre_image_cache_ != nullptr) {
+    pre_image_cache_->set(parent_term, child_term, inputs, getTermPreImage(child_term));
+  }
+}
+
 Value_ptr VariableValueComputer::getTermPostImage(Term_ptr term) {
   auto iter = post_images.find(term);
   if (iter == post_images.end()) {
@@ -1524,6 +1694,42 @@ bool VariableValueComputer::setTermPreImage(Term_ptr term, Value_ptr value) {
   return result.second;
 }
 
+bool VariableValueComputer::visit_transformation_chain(Term_ptr term) {
+  TransformationChain chain (term);
+  if (chain.size() < 2) {
+    return false;
+  }
+  Term_ptr child_term = current_path->back();
+  CHECK_EQ(chain.get_subject(), child_term);
+  Value_ptr child_value = getTermPreImage(child_term);
+  if (child_value not_eq nullptr) {
+    visit(child_term);
+    return true;
+  }
+
+  Value_ptr term_value = getTermPreImage(term);
+  Value_ptr child_post_value = getTermPostImage(child_term);
+  std::vector<Value_ptr> inputs { term_value, child_post_value };
+  if (reuse_pre_image(term, child_term, inputs)) {
+    visit(child_term);
+    return true;
+  }
+
+  Theory::StringAutomaton_ptr child_pre_auto = nullptr;
+  if (transducer_cache_ != nullptr) {
+    child_pre_auto = term_value->getStringAutomaton()->PreTransduce(chain.get_transducer(*transducer_cache_),
+                                                                    child_post_value->getStringAutomaton());
+  } else {
+    child_pre_auto = term_value->getStringAutomaton()->PreTransduce(chain.get_transducer(),
+                                                                    child_post_value->getStringAutomaton());
+  }
+  child_value = new Value(child_pre_auto);
+  setTermPreImage(child_term, child_value);
+  cache_pre_image(term, child_term, inputs);
+  visit(child_term);
+  return true;
+}
+
 void VariableValueComputer::popTerm(Term_ptr term) {
   if (current_path->back() == term) {
     current_path->pop_back();
@@ -10,6 +10,7 @@
 
 #include <map>
 #include <iterator>
+#include <set>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -24,17 +25,46 @@
 #include "../theory/StringAutomaton.h"
 #include "../theory/UnaryAutomaton.h"
 #include "SymbolTable.h"
+#include "TransformationChain.h"
 #include "Value.h"
 
 
 namespace Vlab {
 namespace Solver {
 
+/**
+ * Pre-images of child terms computed by earlier variable value computations.
+ * An entry is reused while the pre-image of the parent and the post-images of the
+ * operands it is computed from stay the same.
+ */
+class PreImageCache {
+ public:
+  PreImageCache();
+  virtual ~PreImageCache();
+
+  Value_ptr get(SMT::Term_ptr parent_term, SMT::Term_ptr child_term, const std::vector<Value_ptr>& inputs) const;
+  void set(SMT::Term_ptr parent_term, SMT::Term_ptr child_term, const std::vector<Value_ptr>& inputs, const Value_ptr pre_image);
+  void clear();
+
+ protected:
+  struct Entry {
+    std::vector<std::size_t> fingerprints;
+    std::vector<Value_ptr> inputs;
+    Value_ptr pre_image;
+  };
+  void clear(Entry& entry);
+
+  std::map<std::pair<SMT::Term_ptr, SMT::Term_ptr>, Entry> entries_;
+};
+
+using PreImageCache_ptr = PreImageCache*;
+
 class VariableValueComputer: public SMT::Visitor {
   typedef std::map<SMT::Term_ptr, Value_ptr> TermValueMap;
   typedef std::vector<std::vector<SMT::Term_ptr>> VariablePathTable;
 public:
-  VariableValueComputer(SymbolTable_ptr, VariablePathTable& variable_path_table, const TermValueMap& post_images );
+  VariableValueComputer(SymbolTable_ptr, VariablePathTable& variable_path_table, const TermValueMap& post_images,
+                        PreImageCache_ptr pre_image_cache = nullptr, TransducerCache* transducer_cache = nullptr);
   virtual ~VariableValueComputer();
 
   void start() override;
@@ -108,11 +138,20 @@ public:
   void visitVariable(SMT::Variable_ptr) override;
 
   bool is_satisfiable();
+  const std::set<SMT::Variable_ptr>& get_updated_variables() const;
 protected:
   Value_ptr getTermPostImage(SMT::Term_ptr term);
   Value_ptr getTermPreImage(SMT::Term_ptr term);
   bool setTermPreImage(SMT::Term_ptr term, Value_ptr value);
   void popTerm(SMT::Term_ptr);
+  bool update_variable_value(SMT::Variable_ptr variable, Value_ptr value);
+  bool reuse_pre_image(SMT::Term_ptr parent_term, SMT::Term_ptr child_term, const std::vector<Value_ptr>& inputs);
+  void cache_pre_image(SMT::Term_ptr parent_term, SMT::Term_ptr child_term, const std::vector<Value_ptr>& inputs);
+  /**
+   * Pre image of a chain of string transformations that is solved with a single transducer
+   * @return false if the term does not start a chain of at least two transformations
+   */
+  bool visit_transformation_chain(SMT::Term_ptr term);
 
   bool is_satisfiable_;
   SymbolTable_ptr symbol_table;
@@ -120,6 +159,10 @@ protected:
   const TermValueMap& post_images;
   TermValueMap pre_images;
   std::vector<SMT::Term_ptr>* current_path;
+  // variables whose values are shrunk
+  std::set<SMT::Variable_ptr> updated_variables_;
+  PreImageCache_ptr pre_image_cache_;
+  TransducerCache* transducer_cache_;
 
 
 private:
@@ -25,5 +25,15 @@ bool Solver::COUNT_BOUND_EXACT = false;
 
 std::string Solver::OUTPUT_PATH         = ".";
 std::string Solver::SCRIPT_PATH         = ".";
+std::string Solver::CACHE_FILE          = "";
+int Solver::CACHE_MAX_SIZE              = 256;
+bool Solver::ENABLE_ARITHMETIC_QUANTIFIER_SCHEDULING = false;
+bool Solver::ENABLE_ALPHABET_COMPRESSION = false;
+bool Solver::ENABLE_TRACK_ORDERING = false;
+int Solver::TIME_LIMIT = 0;
+int Solver::STATE_LIMIT = 0;
+int Solver::BDD_NODE_LIMIT = 0;
+int Solver::APPROXIMATION_STATE_LIMIT = 0;
+bool Solver::ENABLE_SATISFIABILITY_ONLY = false;
 } /* namespace Option */
 } /* namespace Vlab */
@@ -34,7 +34,24 @@ enum class Name: int {
 	COUNT_BOUND_EXACT,
   REGEX_FLAG,
   OUTPUT_PATH,
-  SCRIPT_PATH
+  SCRIPT_PATH,
+  CACHE_FILE,
+  CACHE_MAX_SIZE,
+  ENABLE_ARITHMETIC_QUANTIFIER_SCHEDULING,
+  DISABLE_ARITHMETIC_QUANTIFIER_SCHEDULING,
+  ENABLE_ALPHABET_COMPRESSION,
+  DISABLE_ALPHABET_COMPRESSION,
+  CHARACTER_WIDTH,
+  ENABLE_TRACK_ORDERING,
+  DISABLE_TRACK_ORDERING,
+  INTEGER_WIDTH,
+  TIME_LIMIT,
+  STATE_LIMIT,
+  BDD_NODE_LIMIT,
+  APPROXIMATION_STATE_LIMIT,
+  TRACE_FILE,
+  ENABLE_SATISFIABILITY_ONLY,
+  DISABLE_SATISFIABILITY_ONLY
 };
 
 class Solver {
@@ -50,6 +67,56 @@ public:
   static bool COUNT_BOUND_EXACT;
   static std::string OUTPUT_PATH;
   static std::string SCRIPT_PATH;
+  /**
+   * Persistent result cache file, empty disables caching
+   */
+  static std::string CACHE_FILE;
+  /**
+   * Size limit of the cache file in megabytes
+   */
+  static int CACHE_MAX_SIZE;
+  /**
+   * Orders arithmetic conjuncts by variable overlap and projects away variables the solver introduced
+   * once their last conjunct is solved; variables declared by the script are never projected
+   */
+  static bool ENABLE_ARITHMETIC_QUANTIFIER_SCHEDULING;
+  /**
+   * Encodes characters that string constants and regular expressions do not distinguish with a shared code;
+   * counts are weighted with class sizes and models use a representative character of each class.
+   * With multitrack automata, scripts that relate the characters of two string variables (equalities,
+   * prefix, suffix and containment of variable terms) keep one code per character
+   */
+  static bool ENABLE_ALPHABET_COMPRESSION;
+  /**
+   * Orders the tracks of multitrack string automata so that variables related by a constraint get close tracks;
+   * off by default, its effect has not been measured yet (see make benchmark-track-order)
+   */
+  static bool ENABLE_TRACK_ORDERING;
+  /**
+   * Wall time limit of a single solve, count or model query in milliseconds, 0 means no limit.
+   * A single MONA operation (dfaProduct, dfaMinimize, dfaProject) cannot be interrupted, the limit is checked
+   * once it returns
+   */
+  static int TIME_LIMIT;
+  /**
+   * Limit on the number of states of an automaton built by a query, 0 means no limit.
+   * Automata built by a single MONA operation are checked once it returns
+   */
+  static int STATE_LIMIT;
+  /**
+   * Limit on the number of bdd nodes of an automaton built by a query, 0 means no limit
+   */
+  static int BDD_NODE_LIMIT;
+  /**
+   * Values of string terms with more states are widened to an over-approximation, counts are then upper bounds;
+   * 0 solves exactly
+   */
+  static int APPROXIMATION_STATE_LIMIT;
+  /**
+   * Java isSatisfiable calls only decide satisfiability (see Driver::SolveSatisfiability), off by default;
+   * values are solved exactly once they are queried
+   */
+  static bool ENABLE_SATISFIABILITY_ONLY;
 };
 
 } /* namespace Option */
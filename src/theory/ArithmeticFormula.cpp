@@ -25,7 +25,8 @@ ArithmeticFormula::~ArithmeticFormula() {
 ArithmeticFormula::ArithmeticFormula(const ArithmeticFormula& other)
     : Formula(other),
     	type_(other.type_),
-      constant_(other.constant_) {
+      constant_(other.constant_),
+      big_coefficients_(other.big_coefficients_) {
   this->variable_coefficient_map_ = other.variable_coefficient_map_;
   this->boolean_variable_value_map_ = other.boolean_variable_value_map_;
   this->mixed_terms_ = other.mixed_terms_;
@@ -39,7 +40,7 @@ std::string ArithmeticFormula::str() const {
   std::stringstream ss;
 
   for (auto& el : variable_coefficient_map_) {
-    const int coefficient = el.second;
+    const BigInteger coefficient = GetExactCoefficient(el.first);
     if (coefficient > 0) {
       ss << " + ";
       if (coefficient > 1) {
@@ -49,7 +50,7 @@ std::string ArithmeticFormula::str() const {
     } else if (coefficient < 0) {
       ss << " - ";
       if (coefficient < -1) {
-        ss << std::abs(coefficient);
+        ss << boost::multiprecision::abs(coefficient);
       }
       ss << el.first;
     } else {
@@ -62,7 +63,7 @@ std::string ArithmeticFormula::str() const {
   if (constant_ > 0) {
     ss << " + " << constant_;
   } else if (constant_ < 0) {
-    ss << " - " << std::abs(constant_);
+    ss << " - " << boost::multiprecision::abs(constant_);
   }
 
   ss << " ";
@@ -165,14 +166,60 @@ ArithmeticFormula::Type ArithmeticFormula::GetType() const {
   return type_;
 }
 
-int ArithmeticFormula::GetConstant() const {
+BigInteger ArithmeticFormula::GetConstant() const {
   return constant_;
 }
 
-void ArithmeticFormula::SetConstant(int constant) {
+void ArithmeticFormula::SetConstant(const BigInteger& constant) {
   this->constant_ = constant;
 }
 
+BigInteger ArithmeticFormula::GetExactCoefficient(const std::string var_name) const {
+  const int coeff = GetVariableCoefficient(var_name);
+  if (coeff == std::numeric_limits<int>::max() or coeff == std::numeric_limits<int>::min()) {
+    auto it = big_coefficients_.find(var_name);
+    if (it != big_coefficients_.end()) {
+      return it->second;
+    }
+  }
+  return coeff;
+}
+
+std::vector<BigInteger> ArithmeticFormula::GetExactCoefficients() const {
+  std::vector<BigInteger> coefficients;
+  for (const auto& el : variable_coefficient_map_) {
+    coefficients.push_back(GetExactCoefficient(el.first));
+  }
+  return coefficients;
+}
+
+void ArithmeticFormula::SetExactCoefficient(const std::string var_name, const BigInteger& coeff) {
+  if (coeff > std::numeric_limits<int>::max()) {
+    variable_coefficient_map_[var_name] = std::numeric_limits<int>::max();
+    big_coefficients_[var_name] = coeff;
+  } else if (coeff < std::numeric_limits<int>::min()) {
+    variable_coefficient_map_[var_name] = std::numeric_limits<int>::min();
+    big_coefficients_[var_name] = coeff;
+  } else {
+    variable_coefficient_map_[var_name] = coeff.convert_to<int>();
+    big_coefficients_.erase(var_name);
+  }
+}
+
+bool ArithmeticFormula::HasIntCoefficients() const {
+  const BigInteger int_max = std::numeric_limits<int>::max(), int_min = std::numeric_limits<int>::min();
+  BigInteger positive_sum = 0, negative_sum = 0;
+  for (const auto& el : variable_coefficient_map_) {
+    const BigInteger coefficient = GetExactCoefficient(el.first);
+    if (coefficient > 0) {
+      positive_sum += coefficient;
+    } else {
+      negative_sum += coefficient;
+    }
+  }
+  return positive_sum <= int_max and negative_sum >= int_min and constant_ <= int_max and constant_ >= int_min;
+}
+
 bool ArithmeticFormula::IsConstant() const {
   for (const auto& el : variable_coefficient_map_) {
     if (el.second != 0) {
@@ -226,9 +273,9 @@ ArithmeticFormula_ptr ArithmeticFormula::Add(ArithmeticFormula_ptr other_formula
   for (const auto& el : other_formula->variable_coefficient_map_) {
     auto it = result->variable_coefficient_map_.find(el.first);
     if (it != result->variable_coefficient_map_.end()) {
-      it->second = it->second + el.second;
+      result->SetExactCoefficient(el.first, result->GetExactCoefficient(el.first) + other_formula->GetExactCoefficient(el.first));
     } else {
-      result->variable_coefficient_map_.insert(el);
+      result->SetExactCoefficient(el.first, other_formula->GetExactCoefficient(el.first));
     }
   }
   result->constant_ = result->constant_ + other_formula->constant_;
@@ -247,9 +294,9 @@ ArithmeticFormula_ptr ArithmeticFormula::Subtract(ArithmeticFormula_ptr other_fo
   for (const auto& el : other_formula->variable_coefficient_map_) {
     auto it = result->variable_coefficient_map_.find(el.first);
     if (it != result->variable_coefficient_map_.end()) {
-      it->second = it->second - el.second;
+      result->SetExactCoefficient(el.first, result->GetExactCoefficient(el.first) - other_formula->GetExactCoefficient(el.first));
     } else {
-      result->variable_coefficient_map_[el.first] = -el.second;
+      result->SetExactCoefficient(el.first, -other_formula->GetExactCoefficient(el.first));
     }
   }
 
@@ -259,10 +306,10 @@ ArithmeticFormula_ptr ArithmeticFormula::Subtract(ArithmeticFormula_ptr other_fo
   return result;
 }
 
-ArithmeticFormula_ptr ArithmeticFormula::Multiply(int value) {
+ArithmeticFormula_ptr ArithmeticFormula::Multiply(const BigInteger& value) {
   auto result = new ArithmeticFormula(*this);
-  for (auto& coeff : result->variable_coefficient_map_) {
-    coeff.second = value * coeff.second;
+  for (const auto& el : variable_coefficient_map_) {
+    result->SetExactCoefficient(el.first, value * GetExactCoefficient(el.first));
   }
   result->constant_ = value * constant_;
   return result;
@@ -312,10 +359,9 @@ bool ArithmeticFormula::Simplify() {
     return true;
   }
 
-  int gcd_value = variable_coefficient_map_.begin()->second;
-
+  BigInteger gcd_value = 0;
   for (const auto& el : variable_coefficient_map_) {
-    gcd_value = Util::Math::gcd(gcd_value, el.second);
+    gcd_value = boost::multiprecision::gcd(gcd_value, GetExactCoefficient(el.first));
   }
 
   if (gcd_value == 0) {
@@ -336,7 +382,7 @@ bool ArithmeticFormula::Simplify() {
       if (constant_ >= 0) {
         constant_ = constant_ / gcd_value;
       } else {
-        constant_ = std::floor((double) constant_ / gcd_value);
+        constant_ = (constant_ - gcd_value + 1) / gcd_value;
       }
       break;
     }
@@ -345,8 +391,8 @@ bool ArithmeticFormula::Simplify() {
       break;
     }
 
-  for (auto& c : variable_coefficient_map_) {
-    c.second = c.second / gcd_value;
+  for (const auto& el : GetVariableCoefficientMap()) {
+    SetExactCoefficient(el.first, GetExactCoefficient(el.first) / gcd_value);
   }
 
   return true;
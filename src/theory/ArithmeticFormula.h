@@ -10,6 +10,7 @@
 
 #include <cmath>
 #include <cstdlib>
+#include <limits>
 #include <locale>
 #include <map>
 #include <sstream>
@@ -51,10 +52,24 @@ public:
 
   void SetType(Type type);
   ArithmeticFormula::Type GetType() const;
-  int GetConstant() const;
-  void SetConstant(int constant);
+  BigInteger GetConstant() const;
+  void SetConstant(const BigInteger& constant);
   bool IsConstant() const;
 
+  /**
+   * Exact coefficients; coefficients that do not fit into an int are kept saturated at the int limits
+   * in the variable coefficient map of the formula.
+   */
+  BigInteger GetExactCoefficient(const std::string var_name) const;
+  std::vector<BigInteger> GetExactCoefficients() const;
+  void SetExactCoefficient(const std::string var_name, const BigInteger& coeff);
+  /**
+   * True if the constant and the sums of the positive and of the negative coefficients fit into an int.
+   * Consumers of the int coefficient map that compute with coefficients, such as GetCoefficients and
+   * CountOnes, are only valid then.
+   */
+  bool HasIntCoefficients() const;
+
   bool HasRelationToMixedTerm(const std::string var_name) const;
   void AddRelationToMixedTerm(const std::string var_name, const ArithmeticFormula::Type relation, const SMT::Term_ptr term);
   std::pair<ArithmeticFormula::Type, SMT::Term_ptr> GetRelationToMixedTerm(const std::string var_name) const;
@@ -62,7 +77,7 @@ public:
 
   ArithmeticFormula_ptr Add(ArithmeticFormula_ptr);
   ArithmeticFormula_ptr Subtract(ArithmeticFormula_ptr);
-  ArithmeticFormula_ptr Multiply(int value);
+  ArithmeticFormula_ptr Multiply(const BigInteger& value);
   ArithmeticFormula_ptr negate();
 
   bool Simplify() override;
@@ -76,7 +91,8 @@ protected:
 
   ArithmeticFormula::Type type_;
   std::map<std::string, bool> boolean_variable_value_map_;
-  int constant_;
+  BigInteger constant_;
+  std::map<std::string, BigInteger> big_coefficients_;
 
   // TODO a quick solution for a restricted set of cases in mixed constraints
   // generalize it as much as possible
@@ -32,7 +32,16 @@ Automaton::Automaton(Automaton::Type type)
 }
 
 Automaton::Automaton(Automaton::Type type, DFA_ptr dfa, int num_of_variables)
-        : type_(type), is_counter_cached_{false}, dfa_(dfa), num_of_bdd_variables_(num_of_variables), id_(Automaton::next_id++) { }
+        : type_(type), is_counter_cached_{false}, dfa_(dfa), num_of_bdd_variables_(num_of_variables), id_(Automaton::next_id++) {
+  // every construction ends here, an automaton over the budget of the query stops the query at its next check
+  if (Util::Budget::is_active() and dfa_ != nullptr) {
+    Util::Budget::IsExceededByAutomaton(dfa_->ns, bdd_size(dfa_->bddm));
+  }
+  if (dfa_ != nullptr) {
+    Util::Metrics::Increment(Util::Metrics::Counter::AUTOMATA);
+    Util::Metrics::UpdateMaximum(Util::Metrics::Maximum::DFA_STATES, dfa_->ns);
+  }
+}
 
 Automaton::Automaton(const Automaton& other)
         : type_(other.type_), is_counter_cached_{false}, dfa_(nullptr), num_of_bdd_variables_(other.num_of_bdd_variables_), id_(Automaton::next_id++) {
@@ -92,6 +101,17 @@ int Automaton::get_number_of_bdd_variables() {
   return num_of_bdd_variables_;
 }
 
+int Automaton::get_number_of_states() const {
+  return dfa_->ns;
+}
+
+void Automaton::TraceResult(Util::Trace::Event& event, const DFA_ptr dfa) {
+  if (event.is_recording()) {
+    event.AddArg("out_states", dfa->ns);
+    event.AddArg("bdd_nodes", bdd_size(dfa->bddm));
+  }
+}
+
 bool Automaton::IsEmptyLanguage() const {
   bool result = DFAIsMinimizedEmtpy(this->dfa_);
   DVLOG(VLOG_LEVEL) << "[" << this->id_ << "]->IsEmptyLanguage() " << std::boolalpha << result;
@@ -137,6 +157,52 @@ bool Automaton::IsEqual(const Automaton_ptr other_automaton) const {
   return result;
 }
 
+bool Automaton::IsIntersectionEmpty(const Automaton_ptr other_automaton) const {
+  CHECK_EQ(this->num_of_bdd_variables_, other_automaton->num_of_bdd_variables_);
+  Util::Trace::Event event("is_intersection_empty", "automaton");
+  event.AddArg("left_states", dfa_->ns);
+  event.AddArg("right_states", other_automaton->dfa_->ns);
+  bool result = Automaton::DFAIsIntersectionEmpty(this->dfa_, other_automaton->dfa_, this->num_of_bdd_variables_);
+  DVLOG(VLOG_LEVEL) << "[" << this->id_ << "]->IsIntersectionEmpty(" << other_automaton->id_ << ")" << std::boolalpha
+                    << result;
+  return result;
+}
+
+std::size_t Automaton::Fingerprint() const {
+  std::size_t seed = 0;
+  auto combine = [](std::size_t& seed, const std::size_t value) {
+    seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  };
+  // bdd nodes are hashed by structure, node ids differ among automata
+  std::unordered_map<unsigned, std::size_t> node_hashes;
+  std::function<std::size_t(unsigned)> hash_node = [&](unsigned p) -> std::size_t {
+    auto it = node_hashes.find(p);
+    if (it != node_hashes.end()) {
+      return it->second;
+    }
+    unsigned l, r, index;
+    LOAD_lri(&this->dfa_->bddm->node_table[p], l, r, index);
+    std::size_t node_hash = index;
+    if (index == BDD_LEAF_INDEX) {
+      combine(node_hash, l);
+    } else {
+      combine(node_hash, hash_node(l));
+      combine(node_hash, hash_node(r));
+    }
+    node_hashes[p] = node_hash;
+    return node_hash;
+  };
+
+  combine(seed, this->num_of_bdd_variables_);
+  combine(seed, this->dfa_->ns);
+  combine(seed, this->dfa_->s);
+  for (int i = 0; i < this->dfa_->ns; ++i) {
+    combine(seed, static_cast<std::size_t>(this->dfa_->f[i] + 1));
+    combine(seed, hash_node(this->dfa_->q[i]));
+  }
+  return seed;
+}
+
 int Automaton::GetInitialState() const {
   int initial_state = Automaton::DFAGetInitialState(this->dfa_);
   DVLOG(VLOG_LEVEL) << "[" << this->id_ << "]->GetInitialState() = " << initial_state;
@@ -563,7 +629,7 @@ std::map<std::string,std::vector<std::string>> Automaton::GetModelsWithinBound(i
 		std::string model;
 		int length = iter.size() / num_variables;
 		for(int k = 0; k < length; k++) {
-			unsigned char c = 0;
+			unsigned long c = 0;
 
 			// var_per_track-1 since we dont' care about the last bit, which is used for lambda
 			for(int j = 0; j < num_variables; j++) {
@@ -573,7 +639,7 @@ std::map<std::string,std::vector<std::string>> Automaton::GetModelsWithinBound(i
 				} else {
 					c |= 0;
 				}
-				if(j != 7) {
+				if(j != num_variables - 1) {
 					c <<= 1;
 				}
 			}
@@ -581,7 +647,7 @@ std::map<std::string,std::vector<std::string>> Automaton::GetModelsWithinBound(i
 //			char c_arr[4];
 //			charToAscii(c_arr,c);
 //			model += c_arr;
-			model += c;
+			model += DecodeSymbol(c);
 		}
 		printable_models.insert(model);
 	}
@@ -910,6 +976,9 @@ bool Automaton::DFAIsOneStepAway(const DFA_ptr dfa, const int from_state, const
 }
 
 bool Automaton::DFAIsEqual(const DFA_ptr dfa1, const DFA_ptr dfa2) {
+  Util::Trace::Event event("is_equal", "automaton");
+  event.AddArg("left_states", dfa1->ns);
+  event.AddArg("right_states", dfa2->ns);
   DFA_ptr impl_1 = dfaProduct(dfa1, dfa2, dfaIMPL);
   DFA_ptr impl_2 = dfaProduct(dfa2, dfa1, dfaIMPL);
   DFA_ptr result_dfa = dfaProduct(impl_1,impl_2,dfaAND);
@@ -923,6 +992,72 @@ bool Automaton::DFAIsEqual(const DFA_ptr dfa1, const DFA_ptr dfa2) {
   return result;
 }
 
+bool Automaton::DFAIsIntersectionEmpty(const DFA_ptr dfa1, const DFA_ptr dfa2, const int number_of_bdd_variables) {
+  // transitions of a state as cubes over the bdd variables, transitions to the sink state are left out
+  auto get_transitions = [number_of_bdd_variables](const DFA_ptr dfa, const int state, const int sink_state) {
+    std::vector<std::pair<std::string, int>> transitions;
+    paths state_paths = make_paths(dfa->bddm, dfa->q[state]);
+    for (paths pp = state_paths; pp; pp = pp->next) {
+      if (pp->to == (unsigned)sink_state) {
+        continue;
+      }
+      std::string cube (number_of_bdd_variables, 'X');
+      for (trace_descr tp = pp->trace; tp; tp = tp->next) {
+        cube[tp->index] = tp->value ? '1' : '0';
+      }
+      transitions.push_back(std::make_pair(cube, (int)pp->to));
+    }
+    kill_paths(state_paths);
+    return transitions;
+  };
+  auto is_overlapping = [number_of_bdd_variables](const std::string& cube1, const std::string& cube2) {
+    for (int i = 0; i < number_of_bdd_variables; ++i) {
+      if (cube1[i] != 'X' and cube2[i] != 'X' and cube1[i] != cube2[i]) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  const int sink_state1 = DFAGetSinkState(dfa1);
+  const int sink_state2 = DFAGetSinkState(dfa2);
+  std::map<int, std::vector<std::pair<std::string, int>>> transitions1, transitions2;
+  std::set<std::pair<int, int>> is_visited;
+  std::stack<std::pair<int, int>> state_pairs;
+  state_pairs.push(std::make_pair(dfa1->s, dfa2->s));
+  is_visited.insert(state_pairs.top());
+  while (not state_pairs.empty()) {
+    if (Util::Budget::IsExceededByStates(is_visited.size())) {
+      // the query is stopped, not empty is the answer that keeps the caller going
+      return false;
+    }
+    auto state_pair = state_pairs.top();
+    state_pairs.pop();
+    if (DFAIsAcceptingState(dfa1, state_pair.first) and DFAIsAcceptingState(dfa2, state_pair.second)) {
+      return false;
+    }
+    if (state_pair.first == sink_state1 or state_pair.second == sink_state2) {
+      continue;
+    }
+    if (transitions1.find(state_pair.first) == transitions1.end()) {
+      transitions1[state_pair.first] = get_transitions(dfa1, state_pair.first, sink_state1);
+    }
+    if (transitions2.find(state_pair.second) == transitions2.end()) {
+      transitions2[state_pair.second] = get_transitions(dfa2, state_pair.second, sink_state2);
+    }
+    for (auto& transition1 : transitions1[state_pair.first]) {
+      for (auto& transition2 : transitions2[state_pair.second]) {
+        auto next_pair = std::make_pair(transition1.second, transition2.second);
+        if (is_visited.find(next_pair) == is_visited.end() and is_overlapping(transition1.first, transition2.first)) {
+          is_visited.insert(next_pair);
+          state_pairs.push(next_pair);
+        }
+      }
+    }
+  }
+  return true;
+}
+
 int Automaton::DFAGetInitialState(const DFA_ptr dfa) {
   return dfa->s;
 }
@@ -981,26 +1116,40 @@ DFA_ptr Automaton::DFAMakeEmpty(const int number_of_bdd_variables) {
 }
 
 DFA_ptr Automaton::DFAComplement(const DFA_ptr dfa) {
+  Util::Trace::Event event("complement", "automaton");
+  event.AddArg("in_states", dfa->ns);
   DFA_ptr complement_dfa = dfaCopy(dfa);
   dfaNegation(complement_dfa);
+  TraceResult(event, complement_dfa);
   return complement_dfa;
 }
 
 DFA_ptr Automaton::DFAUnion(const DFA_ptr dfa1, const DFA_ptr dfa2) {
+  Util::Trace::Event event("union", "automaton");
+  event.AddArg("left_states", dfa1->ns);
+  event.AddArg("right_states", dfa2->ns);
   DFA_ptr union_dfa = dfaProduct(dfa1, dfa2, dfaOR);
+  event.AddArg("product_states", union_dfa->ns);
   DFA_ptr minimized_dfa = dfaMinimize(union_dfa);
   dfaFree(union_dfa);
+  TraceResult(event, minimized_dfa);
   return minimized_dfa;
 }
 
 DFA_ptr Automaton::DFAIntersect(const DFA_ptr dfa1, const DFA_ptr dfa2) {
+  Util::Trace::Event event("intersect", "automaton");
+  event.AddArg("left_states", dfa1->ns);
+  event.AddArg("right_states", dfa2->ns);
   DFA_ptr intersect_dfa = dfaProduct(dfa1, dfa2, dfaAND);
+  event.AddArg("product_states", intersect_dfa->ns);
   DFA_ptr minimized_dfa = dfaMinimize(intersect_dfa);
   dfaFree(intersect_dfa);
+  TraceResult(event, minimized_dfa);
   return minimized_dfa;
 }
 
 DFA_ptr Automaton::DFADifference(const DFA_ptr dfa1, DFA_ptr dfa2) {
+  Util::Trace::Event event("difference", "automaton");
   dfaNegation(dfa2); // efficient
   DFA_ptr difference_dfa = Automaton::DFAIntersect(dfa1, dfa2);
   dfaNegation(dfa2); // restore back
@@ -1008,13 +1157,20 @@ DFA_ptr Automaton::DFADifference(const DFA_ptr dfa1, DFA_ptr dfa2) {
 }
 
 DFA_ptr Automaton::DFAProjectAway(const DFA_ptr dfa, const int index) {
+  Util::Trace::Event event("project_away", "automaton");
+  event.AddArg("in_states", dfa->ns);
   DFA_ptr projected_dfa = dfaProject(dfa, (unsigned)index);
+  event.AddArg("projected_states", projected_dfa->ns);
   DFA_ptr minimized_dfa = dfaMinimize(projected_dfa);
   dfaFree(projected_dfa);
+  TraceResult(event, minimized_dfa);
   return minimized_dfa;
 }
 
 DFA_ptr Automaton::DFAProjectAway(const DFA_ptr dfa, std::vector<int> map, const std::vector<int> indices) {
+  Util::Trace::Event event("project_away", "automaton");
+  event.AddArg("in_states", dfa->ns);
+  event.AddArg("variables", indices.size());
 	DFA_ptr temp,result_dfa = dfa;
 	int flag = 0;
 
@@ -1027,10 +1183,13 @@ DFA_ptr Automaton::DFAProjectAway(const DFA_ptr dfa, std::vector<int> map, const
 		dfaFree(temp);
 	}
 	dfaReplaceIndices(result_dfa,&map[0]);
+  TraceResult(event, result_dfa);
 	return result_dfa;
 }
 
 DFA_ptr Automaton::DFAProjectAwayAndReMap(const DFA_ptr dfa, const int number_of_bdd_variables, const int index) {
+  Util::Trace::Event event("project_away", "automaton");
+  event.AddArg("in_states", dfa->ns);
   DFA_ptr projected_dfa = dfaProject(dfa, (unsigned)index);
   if (index < (unsigned)(number_of_bdd_variables - 1)) {
     int* indices_map = new int[number_of_bdd_variables];
@@ -1046,10 +1205,13 @@ DFA_ptr Automaton::DFAProjectAwayAndReMap(const DFA_ptr dfa, const int number_of
 
   DFA_ptr minimized_dfa = dfaMinimize(projected_dfa);
   dfaFree(projected_dfa);
+  TraceResult(event, minimized_dfa);
   return minimized_dfa;
 }
 
 DFA_ptr Automaton::DFAProjectTo(const DFA_ptr dfa, const int number_of_bdd_variables, const int index) {
+  Util::Trace::Event event("project_to", "automaton");
+  event.AddArg("in_states", dfa->ns);
   DFA_ptr projected_dfa = dfaCopy(dfa);
   for (int i = 0 ; i < number_of_bdd_variables; ++i) {
     if (i != index) {
@@ -1064,6 +1226,7 @@ DFA_ptr Automaton::DFAProjectTo(const DFA_ptr dfa, const int number_of_bdd_varia
   indices_map[0] = index;
   dfaReplaceIndices(projected_dfa, indices_map);
   delete[] indices_map;
+  TraceResult(event, projected_dfa);
   return projected_dfa;
 }
 
@@ -1148,8 +1311,110 @@ std::set<std::string> Automaton::DFAGetTransitionsFromTo(DFA_ptr dfa, const int
   return transitions;
 }
 
+std::string Automaton::DFASerialize(const DFA_ptr dfa, const int number_of_bdd_variables) {
+  const int* bdd_indices = GetBddVariableIndices(number_of_bdd_variables);
+  // swaps the initial state with state 0, the mapping is its own inverse
+  auto renamed = [dfa](const int state) {
+    return (state == 0) ? dfa->s : ((state == dfa->s) ? 0 : state);
+  };
+
+  std::stringstream ss;
+  ss << dfa->ns << ' ';
+  for (int i = 0; i < dfa->ns; ++i) {
+    const int status = dfa->f[renamed(i)];
+    ss << ((status == 1) ? '+' : ((status == -1) ? '-' : '0'));
+  }
+
+  for (int i = 0; i < dfa->ns; ++i) {
+    std::vector<std::pair<int, std::string>> transitions;
+    paths state_paths = make_paths(dfa->bddm, dfa->q[renamed(i)]);
+    for (paths pp = state_paths; pp; pp = pp->next) {
+      std::string exception;
+      for (int j = 0; j < number_of_bdd_variables; ++j) {
+        trace_descr tp = nullptr;
+        for (tp = pp->trace; tp && (tp->index != (unsigned)bdd_indices[j]); tp = tp->next);
+        if (tp) {
+          exception.push_back(tp->value ? '1' : '0');
+        } else {
+          exception.push_back('X');
+        }
+      }
+      transitions.push_back(std::make_pair(renamed(pp->to), exception));
+    }
+    kill_paths(state_paths);
+
+    // paths of a state are disjoint, the last one is stored as the default transition
+    ss << ' ' << transitions.size();
+    for (std::size_t k = 0; k < transitions.size(); ++k) {
+      ss << ' ' << transitions[k].first;
+      if (k + 1 < transitions.size()) {
+        ss << ' ' << transitions[k].second;
+      }
+    }
+  }
+  return ss.str();
+}
+
+DFA_ptr Automaton::DFADeserialize(const std::string& data, const int number_of_bdd_variables) {
+  std::stringstream ss(data);
+  int number_of_states = 0;
+  std::string statuses;
+  ss >> number_of_states >> statuses;
+  if (ss.fail() or number_of_states <= 0 or statuses.size() != (std::size_t)number_of_states
+      or statuses.find_first_not_of("+-0") != std::string::npos) {
+    LOG(WARNING) << "malformed dfa";
+    return nullptr;
+  }
+
+  // read fully before building, mona cannot abandon a dfa under construction
+  std::vector<std::vector<std::pair<int, std::string>>> transitions (number_of_states);
+  for (int i = 0; i < number_of_states; ++i) {
+    int number_of_transitions = 0;
+    ss >> number_of_transitions;
+    if (ss.fail() or number_of_transitions <= 0) {
+      LOG(WARNING) << "malformed dfa";
+      return nullptr;
+    }
+    for (int k = 0; k < number_of_transitions; ++k) {
+      int to = -1;
+      std::string exception;
+      ss >> to;
+      if (k + 1 < number_of_transitions) {
+        ss >> exception;
+        if (exception.size() != (std::size_t)number_of_bdd_variables
+            or exception.find_first_not_of("01X") != std::string::npos) {
+          LOG(WARNING) << "malformed dfa";
+          return nullptr;
+        }
+      }
+      if (ss.fail() or to < 0 or to >= number_of_states) {
+        LOG(WARNING) << "malformed dfa";
+        return nullptr;
+      }
+      transitions[i].push_back(std::make_pair(to, exception));
+    }
+  }
+
+  dfaSetup(number_of_states, number_of_bdd_variables, GetBddVariableIndices(number_of_bdd_variables));
+  for (auto& state_transitions : transitions) {
+    dfaAllocExceptions(state_transitions.size() - 1);
+    for (std::size_t k = 0; k + 1 < state_transitions.size(); ++k) {
+      dfaStoreException(state_transitions[k].first, &*state_transitions[k].second.begin());
+    }
+    dfaStoreState(state_transitions.back().first);
+  }
+
+  DFA_ptr dfa = dfaBuild(&*statuses.begin());
+  DFA_ptr result_dfa = dfaMinimize(dfa);
+  dfaFree(dfa);
+  return result_dfa;
+}
+
 DFA_ptr Automaton::DFAConcat(const DFA_ptr dfa1, const DFA_ptr dfa2, const int number_of_bdd_variables) {
   //LOG(FATAL) << "I'm broken, fix me! Use StringAutomaton::concat instead";
+  Util::Trace::Event event("concat", "automaton");
+  event.AddArg("left_states", dfa1->ns);
+  event.AddArg("right_states", dfa2->ns);
 
 	if (DFAIsMinimizedEmtpy(dfa1) or DFAIsMinimizedEmtpy(dfa2)) {
 		return DFAMakeEmpty(number_of_bdd_variables);
@@ -1270,8 +1535,9 @@ DFA_ptr Automaton::DFAConcat(const DFA_ptr dfa1, const DFA_ptr dfa2, const int n
 
 	kill_paths(state_paths);
 	state_paths = pp = nullptr;
+	// once the query is stopped, remaining states only go to the sink and the result is not used
 	for (i = 0; i < left_dfa->ns; i++) {
-		state_paths = pp = make_paths(left_dfa->bddm, left_dfa->q[i]);
+		state_paths = pp = Util::Budget::IsExceeded() ? nullptr : make_paths(left_dfa->bddm, left_dfa->q[i]);
 		while (pp) {
 			if (left_sink && pp->to == (unsigned)sink_state_left_auto) {
 				pp = pp->next;
@@ -1336,7 +1602,7 @@ DFA_ptr Automaton::DFAConcat(const DFA_ptr dfa1, const DFA_ptr dfa2, const int n
 	for (i = 0; i < right_dfa->ns; i++) {
 		if (i != sink_state_right_auto ) {
 			if ( i != right_dfa->s || is_start_state_reachable) {
-				state_paths = pp = make_paths(right_dfa->bddm, right_dfa->q[i]);
+				state_paths = pp = Util::Budget::IsExceeded() ? nullptr : make_paths(right_dfa->bddm, right_dfa->q[i]);
 				while (pp) {
 					if (!right_sink || pp->to != (unsigned)sink_state_right_auto) {
 						to_state = pp->to + state_id_shift_amount;
@@ -1430,6 +1696,7 @@ DFA_ptr Automaton::DFAConcat(const DFA_ptr dfa1, const DFA_ptr dfa2, const int n
 		delete tmp_dfa;
 		delete right_dfa; right_dfa = nullptr;
 	}
+  TraceResult(event, concat_dfa);
 	return concat_dfa;
 }
 
@@ -1505,6 +1772,27 @@ std::string Automaton::GetBinaryStringMSB(unsigned long number, int bit_length)
   return binary_string;
 }
 
+std::vector<std::string> Automaton::GetBinaryRangeMSB(unsigned long from, unsigned long to, int bit_length) {
+  std::vector<std::string> ranges;
+  while (from <= to) {
+    // largest aligned block that starts at from and stays in the range
+    int free_bits = 0;
+    while (free_bits < bit_length and (from & ((1UL << (free_bits + 1)) - 1)) == 0
+        and from + (1UL << (free_bits + 1)) - 1 <= to) {
+      ++free_bits;
+    }
+    std::string range = GetBinaryStringMSB(from >> free_bits, bit_length - free_bits);
+    range.insert(range.end() - 1, free_bits, 'X');
+    ranges.push_back(range);
+    const unsigned long next = from + (1UL << free_bits);
+    if (next == 0 or free_bits == bit_length) {
+      break;
+    }
+    from = next;
+  }
+  return ranges;
+}
+
 /**
  * That function replaces the getSharp1WithExtraBit 111111111 and
  * getSharp0WithExtraBit 111111110. (getSharp0WithExtraBit is not
@@ -1530,9 +1818,12 @@ std::vector<char> Automaton::getReservedWord(char last_char, int length, bool ex
 }
 
 void Automaton::Minimize() {
+  Util::Trace::Event event("minimize", "automaton");
+  event.AddArg("in_states", dfa_->ns);
   DFA_ptr tmp = this->dfa_;
   this->dfa_ = dfaMinimize(tmp);
   dfaFree(tmp);
+  TraceResult(event, dfa_);
   DVLOG(VLOG_LEVEL) << this->id_ << " = [" << this->id_ << "]->minimize()";
 }
 
@@ -1680,6 +1971,22 @@ int Automaton::getNextState(int state, std::vector<char>& exception) {
    return next_state;
 }
 
+/**
+ * Follows the symbol of a unary encoding from the initial state until a state repeats.
+ * Position i of the lasso is the state reached after reading i symbols.
+ * @return position the last position of the lasso moves back to
+ */
+int Automaton::GetUnaryLasso(std::vector<char>& symbol, std::vector<bool>& statuses) {
+  std::map<int, int> positions;
+  int state = this->dfa_->s;
+  while (positions.find(state) == positions.end()) {
+    positions[state] = statuses.size();
+    statuses.push_back(IsAcceptingState(state));
+    state = getNextState(state, symbol);
+  }
+  return positions[state];
+}
+
 /**
  * @return vector of states that are 1 walk away
  */
@@ -1803,10 +2110,13 @@ std::set<int> Automaton::getStatesReachableBy(int min_walk, int max_walk) {
 }
 
 void Automaton::SetSymbolicCounter() {
+  Util::Trace::Event event("set_symbolic_counter", "counter");
+  event.AddArg("states", dfa_->ns);
   std::vector<Eigen::Triplet<BigInteger>> entries;
   const int sink_state = GetSinkState();
   unsigned left, right, index;
   for (int s = 0; s < this->dfa_->ns; ++s) {
+    Util::Budget::Check();
     if (sink_state != s) {
       // Node is a pair<sbdd_node_id, bdd_depth>
       Node current_bdd_node {dfa_->q[s], 0}, left_node, right_node;
@@ -2444,6 +2754,10 @@ void Automaton::add_print_label(std::ostream& out) {
   return;
 }
 
+std::string Automaton::DecodeSymbol(const unsigned long symbol) const {
+  return std::string(1, static_cast<char>(symbol));
+}
+
 void Automaton::toBDD(std::ostream& out) {
   Table *table = tableInit();
 
@@ -2859,264 +3173,6 @@ int Automaton::find_sink(DFA_ptr dfa) {
   return -1;
 }
 
-/*
- * BEGIN LIBSTRANGER ToUPPER toLOWER stuff
- */
-
-void Automaton::getUpperCaseCharsHelper(char** result, char* transitions, int* indexInResult, int currentBit, int var, char* prev){
-	int i;
-	if (transitions[currentBit] == 'X')
-	{
-		transitions[currentBit] = '0';
-		getUpperCaseCharsHelper(result, transitions, indexInResult, currentBit, var, prev);
-		transitions[currentBit] = '1';
-		getUpperCaseCharsHelper(result, transitions, indexInResult, currentBit, var, prev);
-		transitions[currentBit] = 'X';
-	}
-	// things that do not contain upper case
-	else if ( (transitions[0] == '1' && currentBit == 0) ||
-			  (transitions[1] == '0' && currentBit == 1) ||
-			  (transitions[2] == '0' && currentBit == 2) ||
-			  (transitions[5] == '1' && transitions[3] == '1' && currentBit == 5) ||
-			  (transitions[7] ==  transitions[3] && currentBit == 7)
-			 )
-	{
-		result[*indexInResult] = (char*) malloc((var+2)*(sizeof (char)));
-		for (i = 0; i < var; i++){
-			result[*indexInResult][i] = transitions[i];
-		}
-		result[*indexInResult][var] = '0';//extrabit
-		result[*indexInResult][var+1] = '\0';
-		(*indexInResult)++;
-	}
-	else if ( (transitions[3] != transitions[4] && (currentBit == 4 )) ||
-			  (transitions[3] != transitions[6] && currentBit == 6 ) ||
-			  (transitions[3] != transitions[7] && currentBit == 7 ) ||
-			  (transitions[5] == '1' && transitions[3] ==  '0' && currentBit == 5)
-				 ){
-		result[*indexInResult] = (char*) malloc((var+2)*(sizeof(char)));
-		for (i = 0; i < var; i++)
-			result[*indexInResult][i] = transitions[i];
-		// only Difference between capital and small is bit number 2
-		result[*indexInResult][2] = '0';
-		// extrabit should be 1 since we may already have same small letter originally with 0
-		result[*indexInResult][var] = '1';//extrabit
-		result[*indexInResult][var+1] = '\0';
-		(*indexInResult)++;
-	}
-	else{
-		if (currentBit < (var-1)){
-			getUpperCaseCharsHelper(result, transitions, indexInResult, currentBit + 1, var, prev);
-		}
-		else
-			assert(FALSE);
-	}
-}
-
-void Automaton::getLowerUpperCaseCharsPrePostHelper(char** result, char* transitions, int* indexInResult, int currentBit, int var, char* prev, boolean lowerCase, boolean preImage){
-	int i;
-	if (transitions[currentBit] == 'X')
-	{
-		transitions[currentBit] = '0';
-		getLowerUpperCaseCharsPrePostHelper(result, transitions, indexInResult, currentBit, var, prev, lowerCase, preImage);
-		transitions[currentBit] = '1';
-		getLowerUpperCaseCharsPrePostHelper(result, transitions, indexInResult, currentBit, var, prev, lowerCase, preImage);
-		transitions[currentBit] = 'X';
-	}
-	// things that do not contain lower case
-	else if ( (transitions[0] == '1' && currentBit == 0) ||
-			  (transitions[1] == '0' && currentBit == 1) ||
-			  (currentBit == 2 && ((transitions[2] == '1' && lowerCase) || (transitions[2] == '0' && !lowerCase))) ||
-			  (transitions[5] == '1' && transitions[3] == '1' && currentBit == 5) ||
-			  (transitions[7] ==  transitions[3] && currentBit == 7)
-			 )
-	{
-		result[*indexInResult] = (char*) malloc((var+2)*(sizeof (char)));
-		for (i = 0; i < var; i++){
-			result[*indexInResult][i] = transitions[i];
-		}
-		result[*indexInResult][var] = '0';//extrabit
-		result[*indexInResult][var+1] = '\0';
-		(*indexInResult)++;
-	}
-	else if ( (transitions[3] != transitions[4] && (currentBit == 4 )) ||
-			  (transitions[3] != transitions[6] && currentBit == 6 ) ||
-			  (transitions[3] != transitions[7] && currentBit == 7 ) ||
-			  (transitions[5] == '1' && transitions[3] ==  '0' && currentBit == 5)
-				 ){
-		result[*indexInResult] = (char*) malloc((var+2)*(sizeof(char)));
-		for (i = 0; i < var; i++)
-			result[*indexInResult][i] = transitions[i];
-		// only Difference between capital and small is bit number 2
-		if (!preImage){
-			if (lowerCase)
-				result[*indexInResult][2] = '1';
-			else
-				result[*indexInResult][2] = '0';
-        }
-		// extrabit should be 1 since we may already have same small letter originally with 0
-		result[*indexInResult][var] = '1';//extrabit
-		result[*indexInResult][var+1] = '\0';
-		(*indexInResult)++;
-		if (preImage){
-			result[*indexInResult] = (char*) malloc((var+2)*(sizeof(char)));
-			for (i = 0; i < var; i++)
-				result[*indexInResult][i] = transitions[i];
-			// only Difference between capital and small is bit number 2
-			if (lowerCase)
-				result[*indexInResult][2] = '1';
-			else
-				result[*indexInResult][2] = '0';
-			// extrabit should be 1 since we may already have same small letter originally with 0
-			result[*indexInResult][var] = '1';//extrabit
-			result[*indexInResult][var+1] = '\0';
-			(*indexInResult)++;
-		}
-	}
-	else{
-			if (currentBit < (var-1)){
-				getLowerUpperCaseCharsPrePostHelper(result, transitions, indexInResult, currentBit + 1, var, prev, lowerCase, preImage);
-			}
-			else
-				assert(FALSE);
-	}
-
-}
-
-void Automaton::getLowerUpperCaseCharsPrePost(char* transitions, int var, char** result, int* pSize, boolean lowerCase, boolean preImage){
-	int indexInResult = 0;
-	char* prev = (char*) malloc(var*(sizeof(char)));
-	getLowerUpperCaseCharsPrePostHelper(result, transitions, &indexInResult, 0, var, prev, lowerCase, preImage);
-	*pSize = indexInResult;
-}
-
-DFA* Automaton::dfaPrePostToLowerUpperCaseHelper(DFA* M, int var, int* oldIndices, boolean lowerCase, boolean preImage){
-	DFA *result;
-	paths state_paths, pp;
-	trace_descr tp;
-	int i, j, n, k;
-	char *exeps;
-	int *to_states;
-	int sink;
-	long max_exeps;
-	char *statuces;
-	int len;
-	int ns = M->ns;
-
-	bool has_sink = true;
-
-	len = var + 1;
-	int* indices = allocateArbitraryIndex(len);
-
-	max_exeps = 1 << len; //maybe exponential
-
-	sink = find_sink(M);
-	if(sink < 0) {
-		has_sink = false;
-		sink = ns;
-		ns++;
-	}
-
-	char* symbol = (char *) malloc((len + 1) * sizeof(char));//len+1 since we need extra bit
-	exeps = (char *) malloc(max_exeps * (len + 1) * sizeof(char));
-	to_states = (int *) malloc(max_exeps * sizeof(int));
-	statuces = (char *) malloc((ns + 1) * sizeof(char));
-	int numOfChars = 1 << len;
-	char** charachters = (char**) malloc(numOfChars * (sizeof (char*)));
-	int size = 0;
-
-
-	dfaSetup(ns, len, indices);
-	for (i = 0; i < M->ns; i++) {
-		state_paths = pp = make_paths(M->bddm, M->q[i]);
-		k = 0;
-		while (pp) {
-			if (pp->to != sink) {
-				for (j = 0; j < var; j++) {
-					//the following for loop can be avoided if the indices are in order
-					for (tp = pp->trace; tp && (tp->index != indices[j]); tp
-							= tp->next)
-						;
-					if (tp) {
-						if (tp->value)
-							symbol[j] = '1';
-						else
-							symbol[j] = '0';
-					} else
-						symbol[j] = 'X';
-				}
-				symbol[var] = '\0';
-				// convert symbol into a list of chars where we replace each capital letter with small letter
-				getLowerUpperCaseCharsPrePost(symbol, var, charachters, &size, lowerCase, preImage);
-				for (n = 0; n < size; n++)
-				{
-//						printf("%s, ", charachters[n]);
-					to_states[k] = pp->to;
-					for (j = 0; j < len; j++)
-						exeps[k * (len + 1) + j] = charachters[n][j];
-					exeps[k * (len + 1) + len] = '\0';
-					free(charachters[n]);
-					k++;
-				}
-//					printf("\n");
-			}
-			pp = pp->next;
-		}
-		kill_paths(state_paths);
-
-		// if accept state create a self loop on lambda
-		dfaAllocExceptions(k);
-		for (k--; k >= 0; k--)
-			dfaStoreException(to_states[k], exeps + k * (len + 1));
-		dfaStoreState(sink);
-
-		if (M->f[i] == 1)
-			statuces[i] = '+';
-		else
-			statuces[i] = '-';
-	}
-
-	// create artificial sink if original dfa did not have one
-	if(not has_sink) {
-		dfaAllocExceptions(0);
-		dfaStoreState(sink);
-		statuces[sink] = '-';
-	}
-
-	statuces[ns] = '\0';
-	DFA* tmpM = dfaBuild(statuces);
-	result = dfaProject(tmpM, ((unsigned)var));
-	dfaFree(tmpM);
-	tmpM = dfaMinimize(result);
-	dfaFree(result);result = NULL;
-
-	free(exeps);
-	free(symbol);
-	free(to_states);
-	free(statuces);
-	free(indices);
-	free(charachters);
-
-	return tmpM;
-}
-
-DFA* Automaton::dfaToLowerCase(DFA* M, int var, int* indices){
-	return dfaPrePostToLowerUpperCaseHelper(M, var, indices, TRUE, FALSE);
-}
-
-DFA* Automaton::dfaToUpperCase(DFA* M, int var, int* indices){
-	return dfaPrePostToLowerUpperCaseHelper(M, var, indices, FALSE, FALSE);
-}
-
-DFA* Automaton::dfaPreToLowerCase(DFA* M, int var, int* indices){
-	return dfaPrePostToLowerUpperCaseHelper(M, var, indices, FALSE, TRUE);
-}
-
-DFA* Automaton::dfaPreToUpperCase(DFA* M, int var, int* indices){
-	return dfaPrePostToLowerUpperCaseHelper(M, var, indices, TRUE, TRUE);
-}
-
-
 /*
  * BEGIN LIBSTRANGER REPLACE STUFF
  */
@@ -3529,12 +3585,18 @@ DFA_ptr Automaton::dfa_general_replace_extrabit(DFA* M1, DFA* M2, DFA* M3, int v
 	DFA_ptr M_sharp = dfaSharpStringWithExtraBit(var, indices);
 
 	M1_bar = dfa_replace_step1_duplicate(M1, var, indices);
+	if (Util::Budget::IsExceeded()) {
+		// the query is stopped, the remaining steps are skipped and the result is not used
+		dfaFree(M1_bar);
+		dfaFree(M_sharp);
+		return dfaCopy(M1);
+	}
 
 	M2_bar = dfa_replace_step2_match_compliment(M2, var, indices);
 
 	M_inter = DFAIntersect(M1_bar, M2_bar);
 
-	if(check_intersection(M_sharp, M_inter, var, indices)>0){
+	if(not Util::Budget::IsExceeded() and check_intersection(M_sharp, M_inter, var, indices)>0){
 		//replace match patterns
 		M_rep = dfa_replace_step3_general_replace(M_inter, M3, var, indices);
 		result = dfaProject(M_rep, (unsigned) var);
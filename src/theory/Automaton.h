@@ -34,8 +34,11 @@
 #include <mona/dfa.h>
 #include <mona/mem.h>
 
+#include "../utils/Budget.h"
 #include "../utils/Cmd.h"
 #include "../utils/Math.h"
+#include "../utils/Metrics.h"
+#include "../utils/Trace.h"
 #include "../boost/multiprecision/cpp_int.hpp"
 #include "../Eigen/SparseCore"
 #include "Graph.h"
@@ -91,6 +94,7 @@ public:
 
   DFA_ptr getDFA();
   int get_number_of_bdd_variables();
+  int get_number_of_states() const;
 
   /**
    * Checks if an automaton accepts nothing
@@ -146,6 +150,20 @@ public:
    */
   bool IsEqual(const Automaton_ptr other_automaton) const;
 
+  /**
+   * Checks if the current automaton and the other automaton accept no common input, without building the product;
+   * the product is explored on the fly and the search stops at the first common input
+   * @param other_auto
+   * @return
+   */
+  bool IsIntersectionEmpty(const Automaton_ptr other_automaton) const;
+
+  /**
+   * Hash of the states and transitions, automata with the same fingerprint are likely to be equal
+   * @return
+   */
+  std::size_t Fingerprint() const;
+
   /**
    * Gets the initial state id
    * @return
@@ -234,11 +252,34 @@ public:
   int inspectBDD();
 
   friend std::ostream& operator<<(std::ostream& os, const Automaton& automaton);
+  friend class Transducer;
 
   static void CleanUp();
 
+  /**
+   * Writes a dfa as text: number of states, statuses and the bdd paths of each state,
+   * the initial state is written as state 0
+   * @param dfa
+   * @param number_of_bdd_variables
+   * @return
+   */
+  static std::string DFASerialize(const DFA_ptr dfa, const int number_of_bdd_variables);
+
+  /**
+   * Reads a dfa written by DFASerialize
+   * @param data
+   * @param number_of_bdd_variables
+   * @return minimized dfa, nullptr if the data is malformed
+   */
+  static DFA_ptr DFADeserialize(const std::string& data, const int number_of_bdd_variables);
+
 protected:
 
+  /**
+   * Adds the number of states and bdd nodes of a resulting dfa to a trace event
+   */
+  static void TraceResult(Util::Trace::Event& event, const DFA_ptr dfa);
+
   /**
    * Checks if a minimized dfa accepts nothing
    * @param dfa
@@ -300,6 +341,16 @@ protected:
    */
   static bool DFAIsEqual(const DFA_ptr dfa1, const DFA_ptr dfa2);
 
+  /**
+   * Checks if the given two dfas accept no common input, reachable state pairs are visited depth first
+   * and transitions of a state are computed once it is reached
+   * @param dfa1
+   * @param dfa2
+   * @param number_of_bdd_variables
+   * @return
+   */
+  static bool DFAIsIntersectionEmpty(const DFA_ptr dfa1, const DFA_ptr dfa2, const int number_of_bdd_variables);
+
   /**
    * Gets the initial state of the given dfa
    * @param dfa
@@ -456,6 +507,11 @@ protected:
   std::vector<char> decodeException(std::vector<char>& exception);
   virtual void add_print_label(std::ostream& out);
 
+  /**
+   * @return the text of a symbol read from a model, a byte by default
+   */
+  virtual std::string DecodeSymbol(const unsigned long symbol) const;
+
   /**
    * Uses a cache for bdd variable indices.
    * We use a fixed ordering in all automata we generate
@@ -477,6 +533,11 @@ protected:
 
   static std::string GetBinaryStringMSB(unsigned long n, int bit_length);
 
+  /**
+   * @return transitions with don't care bits that cover exactly the numbers in the range, at most two per bit
+   */
+  static std::vector<std::string> GetBinaryRangeMSB(unsigned long from, unsigned long to, int bit_length);
+
   // TODO return string instead of vector<char>
   static std::vector<char> getReservedWord(char last_char, int length, bool extra_bit = false);
   void Minimize();
@@ -489,6 +550,7 @@ protected:
   std::vector<std::pair<int,std::vector<char>>> GetNextTransitions(int state);
   int getNextState(int state, std::vector<char>& exception);
   std::set<int> getNextStates(int state);
+  int GetUnaryLasso(std::vector<char>& symbol, std::vector<bool>& statuses);
   std::vector<NextState> getNextStatesOrdered(int state, std::function<bool(unsigned& index)> next_node_heuristic = nullptr);
   std::set<int> getStatesReachableBy(int walk);
   std::set<int> getStatesReachableBy(int min_walk, int max_walk);
@@ -524,37 +586,6 @@ protected:
 
 
 
-  /*
-   * Operations for ToLower/ToUpper/PreToLower/PreToUpper
-   * TODO: currently stranger code, refactor
-   */
-
-  static void getUpperCaseCharsHelper(char** result, char* transitions, int* indexInResult, int currentBit, int var, char* prev);
-  static void getLowerUpperCaseCharsPrePostHelper(char** result, char* transitions, int* indexInResult, int currentBit, int var, char* prev, boolean lowerCase, boolean preImage);
-  /**
-   * returns same chars in transitions unless char is capital in which case it is converted into small
-   * or visa versa
-   * examples:
-   * A=01000001 -> a=[011000011]
-   * {@, A, B, C ,D, E, F, G}=01000XXX -> {@, a, b, c, d, e, f, g}=[010000000, 011000011, 0110001X1, 011001XX1]
-   * extrabit will be used. 0 for original letters, 1 for new small letters (converted from capital) to differentiate from original small chars
-   */
-  static void getLowerUpperCaseCharsPrePost(char* transitions, int var, char** result, int* pSize, boolean lowerCase, boolean preImage);
-  /**
-   * This functions models any function that changes all capital letters in a string to small ones (for example strtolower in php)
-   * M: dfa to process
-   * var: number of bits per character(for ASCII it is 8 bits)
-   * indices: the indices
-   * output: return D such that L(D) = { W_1S_1W_2S2..W_nS_n | W_1C_1W_2C2..W_nC_n element_of L(M) && W_i element_of Sigma* && S_i, C_i element_of Sigma && S_i = LowerCase(C_i)}
-   */
-  static DFA* dfaPrePostToLowerUpperCaseHelper(DFA* M, int var, int* oldIndices, boolean lowerCase, boolean preImage);
-
-  static DFA* dfaToLowerCase(DFA* M, int var, int* indices);
-  static DFA* dfaToUpperCase(DFA* M, int var, int* indices);
-  static DFA* dfaPreToLowerCase(DFA* M, int var, int* indices);
-  static DFA* dfaPreToUpperCase(DFA* M, int var, int* indices);
-
-
   /*
    * Operations for replace
    * TODO: currently stranger code, refactor
@@ -15,6 +15,14 @@ namespace Theory {
 
 const int BinaryIntAutomaton::VLOG_LEVEL = 9;
 
+const int BinaryIntAutomaton::SEMILINEAR_SET_CACHE_SIZE = 64;
+
+const int BinaryIntAutomaton::SEMILINEAR_SET_START_BITS = 20;
+
+std::unordered_multimap<std::size_t, std::pair<BinaryIntAutomaton_ptr, SemilinearSet_ptr>> BinaryIntAutomaton::semilinear_set_cache_;
+
+std::mutex BinaryIntAutomaton::semilinear_set_cache_mutex_;
+
 BinaryIntAutomaton::BinaryIntAutomaton(bool is_natural_number)
     : Automaton(Automaton::Type::BINARYINT),
       is_natural_number_ { is_natural_number },
@@ -291,6 +299,116 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeAutomaton(SemilinearSet_ptr semil
   return binary_auto;
 }
 
+/**
+ * Makes the automaton for the lengths accepted by a unary automaton given as a lasso, without computing
+ * a semilinear set. Values are encoded as in MakeAutomaton(semilinear_set, ..., true), i.e., two's complement
+ * with leading zeros.
+ * A state keeps the lasso position of the value read so far and the lasso position of the weight of the
+ * next bit. Positions beyond the lasso wrap around the cycle, hence there are finitely many states.
+ */
+BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeAutomaton(const std::vector<bool>& lasso_statuses,
+                                                         const int cycle_head, std::string var_name,
+                                                         ArithmeticFormula_ptr formula, bool add_minus_one) {
+  struct BinaryLassoState {
+    int position;
+    int weight;
+    bool is_last_bit_zero;
+    bool is_all_ones;
+    bool operator<(const BinaryLassoState& other) const {
+      return std::tie(position, weight, is_last_bit_zero, is_all_ones)
+          < std::tie(other.position, other.weight, other.is_last_bit_zero, other.is_all_ones);
+    }
+  };
+
+  const int lasso_length = lasso_statuses.size();
+  const int cycle_length = lasso_length - cycle_head;
+  auto wrap = [lasso_length, cycle_head, cycle_length](const long value) -> int {
+    return (value < lasso_length) ? value : cycle_head + (value - cycle_head) % cycle_length;
+  };
+
+  // a position is dead if no accepting position is reachable from it
+  std::vector<bool> is_live(lasso_length, false);
+  bool is_cycle_live = false;
+  for (int i = cycle_head; i < lasso_length; ++i) {
+    is_cycle_live = is_cycle_live or lasso_statuses[i];
+  }
+  bool has_accepting_after = is_cycle_live;
+  for (int i = lasso_length - 1; i >= 0; --i) {
+    has_accepting_after = has_accepting_after or lasso_statuses[i];
+    is_live[i] = (i >= cycle_head) ? is_cycle_live : has_accepting_after;
+  }
+
+  const int initial_state = 0, sink_state = 1;
+  std::vector<BinaryLassoState> states { { 0, wrap(1), false, add_minus_one }, { 0, 0, false, false } };
+  std::vector<std::pair<int, int>> transitions;
+  std::map<BinaryLassoState, int> state_indices;
+  auto get_state = [&](const BinaryLassoState& state) -> int {
+    if (not is_live[state.position] and not state.is_all_ones) {
+      return sink_state;
+    }
+    auto it = state_indices.find(state);
+    if (it != state_indices.end()) {
+      return it->second;
+    }
+    int index = states.size();
+    states.push_back(state);
+    state_indices[state] = index;
+    return index;
+  };
+
+  for (int i = 0; i < static_cast<int>(states.size()); ++i) {
+    if (i == sink_state) {
+      transitions.push_back(std::make_pair(sink_state, sink_state));
+      continue;
+    }
+    const auto current = states[i];
+    const int next_weight = wrap(2L * current.weight);
+    int zero_state = get_state( { current.position, next_weight, true, false });
+    int one_state = get_state( { wrap(static_cast<long>(current.position) + current.weight), next_weight, false,
+        current.is_all_ones });
+    transitions.push_back(std::make_pair(zero_state, one_state));
+  }
+
+  const int var_index = formula->GetVariableIndex(var_name);
+  const int number_of_variables = formula->GetNumberOfVariables();
+  const int number_of_states = states.size();
+  std::string bit_transition(number_of_variables + 1, 'X');
+  bit_transition[number_of_variables] = '\0';
+  std::string statuses(number_of_states + 1, '-');
+  statuses[number_of_states] = '\0';
+  int* indices = GetBddVariableIndices(number_of_variables);
+
+  dfaSetup(number_of_states, number_of_variables, indices);
+  for (int i = 0; i < number_of_states; ++i) {
+    if (i == sink_state) {
+      dfaAllocExceptions(0);
+      dfaStoreState(sink_state);
+      continue;
+    }
+    dfaAllocExceptions(2);
+    bit_transition[var_index] = '0';
+    dfaStoreException(transitions[i].first, &bit_transition[0]);
+    bit_transition[var_index] = '1';
+    dfaStoreException(transitions[i].second, &bit_transition[0]);
+    dfaStoreState(sink_state);
+
+    const auto& state = states[i];
+    if ((state.is_last_bit_zero and lasso_statuses[state.position]) or (i != initial_state and state.is_all_ones)) {
+      statuses[i] = '+';
+    }
+  }
+  auto binary_dfa = dfaBuild(&statuses[0]);
+
+  auto binary_auto = new BinaryIntAutomaton(dfaMinimize(binary_dfa), formula, false);
+  dfaFree(binary_dfa);
+  binary_dfa = nullptr;
+
+  DVLOG(VLOG_LEVEL) << binary_auto->getId() << " = BinaryIntAutomaton::MakeAutomaton(<lasso " << lasso_length << ", "
+                    << cycle_head << ">, " << var_name << ", " << *(binary_auto->formula_) << ", " << std::boolalpha
+                    << add_minus_one << ")";
+  return binary_auto;
+}
+
 ArithmeticFormula_ptr BinaryIntAutomaton::GetFormula() {
   return formula_;
 }
@@ -389,9 +507,20 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::Difference(BinaryIntAutomaton_ptr oth
   return difference_auto;
 }
 
+/**
+ * Existentially quantifies the variable; its track is kept as a don't care track so that
+ * the result still runs over the variables of the formula
+ */
 BinaryIntAutomaton_ptr BinaryIntAutomaton::Exists(std::string var_name) {
-  LOG(FATAL)<< "implement me";
-  return nullptr;
+  CHECK_EQ(num_of_bdd_variables_, formula_->GetNumberOfVariables())<< "number of variables is not consistent with formula";
+  int bdd_var_index = formula_->GetVariableIndex(var_name);
+  auto projected_dfa = Automaton::DFAProjectAway(this->dfa_, bdd_var_index);
+  auto projected_formula = formula_->clone();
+  projected_formula->SetExactCoefficient(var_name, 0);
+  auto exists_auto = new BinaryIntAutomaton(projected_dfa, projected_formula, is_natural_number_);
+
+  DVLOG(VLOG_LEVEL) << exists_auto->id_ << " = [" << this->id_ << "]->Exists(" << var_name << ")";
+  return exists_auto;
 }
 
 BinaryIntAutomaton_ptr BinaryIntAutomaton::GetBinaryAutomatonFor(std::string var_name) {
@@ -499,198 +628,228 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::AddLeadingZeros() {
   return leading_zero_auto;
 }
 
-/*
- *  TODO options to fix problems, works for automaton that has 1 variable
- *  Search to improve period search part to make it sound
- *
- */
 SemilinearSet_ptr BinaryIntAutomaton::GetSemilinearSet() {
-  SemilinearSet_ptr semilinear_set = nullptr, current_set = nullptr, tmp_set = nullptr;
-  BinaryIntAutomaton_ptr subject_auto = nullptr, tmp_1_auto = nullptr, tmp_2_auto = nullptr, diff_auto = nullptr;
-  std::vector<SemilinearSet_ptr> semilinears;
-  std::string var_name = this->formula_->GetVariableCoefficientMap().begin()->first;
-  int current_state = this->dfa_->s, sink_state = this->GetSinkState();
-  std::vector<int> constants, bases;
-  bool is_cyclic = false;
-  std::map<int, bool> cycle_status;
-
-  semilinear_set = new SemilinearSet();
-
-  // 1- First get the constants that are reachable by only taking an edge of a SCC that has one state inside
-
-  is_cyclic = GetCycleStatus(cycle_status);
-  GetConstants(cycle_status, constants);
-  Util::List::sort_and_remove_duplicate(constants);
-  cycle_status.clear();
-  semilinear_set->set_constants(constants);
-
-  // CASE automaton has only constants
-  if (not is_cyclic) {
-    DVLOG(VLOG_LEVEL) << *semilinear_set;
-    DVLOG(VLOG_LEVEL) << "<semilinear set> = [" << this->id_ << "]->GetSemilinearSet()";
-    return semilinear_set;
-  }
-
-  /*
-   * - Get the maximum constant and make an automaton Ac that accepts 0 <= x <= max
-   * - Make new constants equal to the numbers that are accepted by original automaton (A)
-   * intersection with Ac
-   * Delete these numbers from original automaton
-   */
-  if (semilinear_set->has_constants()) {
-
-    int max_constant = constants.back();  // it is already sorted
-    constants.clear();
-    for (int i = 0; i <= max_constant; i++) {
-      constants.push_back(i);
-    }
-    semilinear_set->set_constants(constants);
-    constants.clear();
-    tmp_1_auto = BinaryIntAutomaton::MakeAutomaton(semilinear_set, var_name, formula_->clone(), false);
-    semilinear_set->clear();
-
-    tmp_2_auto = this->Intersect(tmp_1_auto);
-    delete tmp_1_auto;
-    tmp_1_auto = nullptr;
-
-    tmp_2_auto->GetBaseConstants(constants);  // if automaton is acyclic, it will return all constants
-    Util::List::sort_and_remove_duplicate(constants);
-    semilinear_set->set_constants(constants);
-    constants.clear();
-
-    subject_auto = this->Difference(tmp_2_auto);
-    delete tmp_2_auto;
-    tmp_2_auto = nullptr;
-  } else {
-    subject_auto = this->clone();
+  const std::size_t fingerprint = this->Fingerprint();
+  {
+    std::lock_guard<std::mutex> lock(semilinear_set_cache_mutex_);
+    auto range = semilinear_set_cache_.equal_range(fingerprint);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (this->IsEqual(it->second.first)) {
+        DVLOG(VLOG_LEVEL) << "semilinear set = [" << this->id_ << "]->GetSemilinearSet() (cached)";
+        return it->second.second->clone();
+      }
+    }
   }
 
-  semilinears.push_back(semilinear_set);
-
-  unsigned i = 0;
-  int cycle_head = 0;
-  std::vector<int> tmp_periods;
-  int bound = 0;
-  while (not subject_auto->IsEmptyLanguage() and (bound++ < 5)) {
-    i = 0;
-    cycle_head = 0;
-    tmp_periods.clear();
-    semilinear_set = new SemilinearSet();
-    subject_auto->GetBaseConstants(bases);
-    Util::List::sort_and_remove_duplicate(bases);
-
-    // usually we do not need to much numbers once they are sorted, note that this is not sound
-    // to make it sound iteratively check for periods instead of deleting them
-    if (bases.size() > 10) {
-      bases.erase(bases.begin() + 10, bases.end());
-    }
-
-    if (bases.size() == 1) {
-      semilinear_set->set_period(bases[0]);
-      semilinear_set->add_periodic_constant(0);
-      semilinears.push_back(semilinear_set->clone());
-      // no need to verify period
-    } else if (bases.size() > 1) {
-      int possible_period = 0;
-
-      for (auto it = bases.begin(); it < bases.end() - 1; it++) {
-
-        cycle_head = *it;
-        bool period_found = false;
-        for (auto jt = it + 1; jt < bases.end(); jt++) {
-          possible_period = *jt - cycle_head;
-
-          bool add_me = true;
-          for (auto p : tmp_periods) {
-            if ((possible_period % p) == 0) {
-              add_me = false;
-              break;
-            }
-          }
-          if (add_me) {
-            current_set = new SemilinearSet();
-            current_set->set_cycle_head(cycle_head);
-            current_set->set_period(possible_period);
-            current_set->add_periodic_constant(0);
-
-            tmp_1_auto = BinaryIntAutomaton::MakeAutomaton(current_set, var_name, formula_->clone(), false);
-            tmp_2_auto = subject_auto->Intersect(tmp_1_auto);
-            diff_auto = tmp_1_auto->Difference(tmp_2_auto);
-            delete tmp_1_auto;
-            tmp_1_auto = nullptr;
-            delete tmp_2_auto;
-            tmp_2_auto = nullptr;
-            if (diff_auto->IsEmptyLanguage()) {
-              tmp_set = semilinear_set;
-              semilinear_set = tmp_set->Merge(current_set);
-              delete tmp_set;
-              tmp_set = nullptr;
-              semilinears.push_back(current_set);
-              tmp_periods.push_back(possible_period);
-              period_found = true;
-              delete diff_auto;
-              diff_auto = nullptr;
-              break;
-            } else {
-              delete current_set;
-            }
-            delete diff_auto;
-            diff_auto = nullptr;
-            current_set = nullptr;
-          }
-        }
+  SemilinearSet_ptr semilinear_set = ComputeSemilinearSet();
 
-        if (period_found) {
-          for (auto rt = it + 1; rt < bases.end();) {
-            possible_period = *rt - cycle_head;
-            bool remove_me = false;
-            for (auto p : tmp_periods) {
-              if ((possible_period % p) == 0) {
-                remove_me = true;
-                break;
-              }
-            }
-            if (remove_me) {
-              rt = bases.erase(rt);
-            } else {
-              rt++;
-            }
-          }
-          period_found = false;
-        }
+  {
+    std::lock_guard<std::mutex> lock(semilinear_set_cache_mutex_);
+    if (semilinear_set_cache_.size() >= static_cast<std::size_t>(SEMILINEAR_SET_CACHE_SIZE)) {
+      for (auto& entry : semilinear_set_cache_) {
+        delete entry.second.first;
+        delete entry.second.second;
       }
-    } else {
-      LOG(FATAL)<< "Automaton must have an accepting state, check base extraction algorithm";
+      semilinear_set_cache_.clear();
     }
-    tmp_1_auto = BinaryIntAutomaton::MakeAutomaton(semilinear_set, var_name, formula_->clone(), false);
-    tmp_2_auto = subject_auto;
-    subject_auto = tmp_2_auto->Difference(tmp_1_auto);
-    delete tmp_1_auto;
-    tmp_1_auto = nullptr;
-    delete tmp_2_auto;
-    tmp_2_auto = nullptr;
-    delete semilinear_set;
-    semilinear_set = nullptr;
-    bases.clear();
+    semilinear_set_cache_.insert(std::make_pair(fingerprint, std::make_pair(this->clone(), semilinear_set->clone())));
   }
 
-  delete subject_auto;
-  subject_auto = nullptr;
+  DVLOG(VLOG_LEVEL) << *semilinear_set;
+  DVLOG(VLOG_LEVEL) << "semilinear set = [" << this->id_ << "]->GetSemilinearSet()";
+  return semilinear_set;
+}
 
-  semilinear_set = new SemilinearSet();
-  for (auto s : semilinears) {
-    tmp_set = semilinear_set;
-    semilinear_set = tmp_set->Merge(s);
-    delete tmp_set;
-    delete s;
+SemilinearSet_ptr BinaryIntAutomaton::ComputeSemilinearSet() {
+  CHECK_EQ(1, num_of_bdd_variables_) << "semilinear sets are computed for single track automata";
+
+  std::vector<int> next_states;
+  std::vector<bool> accepts_zeros;
+  GetBitTransitions(next_states, accepts_zeros);
+  const ValueAutomaton value_auto = MakeValueAutomaton(next_states, accepts_zeros);
+  if (std::find(value_auto.is_accepting.begin(), value_auto.is_accepting.end(), true)
+      == value_auto.is_accepting.end()) {
+    DVLOG(VLOG_LEVEL) << "semilinear set = [" << this->id_ << "]->ComputeSemilinearSet() (empty)";
+    return new SemilinearSet();
+  }
+
+  // residuals are the states of the unary automaton of the values: they are distinct before the cycle head
+  // and repeat with the period from there on. Walking starts at a value with more bits than the automaton
+  // has states, which is in the cycle for most automata; otherwise the walk runs into the cycle head
+  const long start = 1L << std::min(static_cast<int>(value_auto.is_accepting.size()), SEMILINEAR_SET_START_BITS);
+  std::map<ValueAutomaton, long> residual_values;
+  ValueAutomaton residual = ShiftValueAutomaton(value_auto, start);
+  long value = start;
+  while (residual_values.find(residual) == residual_values.end()) {
+    residual_values[residual] = value;
+    Util::Budget::CheckStates(residual_values.size());
+    residual = ShiftValueAutomaton(residual, 1);
+    ++value;
+  }
+  long cycle_head = residual_values[residual];
+  const long period = value - cycle_head;
+
+  if (cycle_head == start) {
+    // the residuals of x and x + period are equal iff x is in the cycle
+    long low = 0, high = start;
+    while (low < high) {
+      const long middle = low + (high - low) / 2;
+      if (ShiftValueAutomaton(value_auto, middle) == ShiftValueAutomaton(value_auto, middle + period)) {
+        high = middle;
+      } else {
+        low = middle + 1;
+      }
+    }
+    cycle_head = low;
   }
+  CHECK_LE(cycle_head + period, static_cast<long>(std::numeric_limits<int>::max()));
 
-  DVLOG(VLOG_LEVEL) << *semilinear_set;
-  DVLOG(VLOG_LEVEL) << "semilinear set = [" << this->id_ << "]->GetSemilinearSet()";
+  auto is_accepted = [&value_auto](long x) {
+    int state = 0;
+    for (; x > 0; x >>= 1) {
+      state = value_auto.next_states[2 * state + (x & 1)];
+    }
+    return static_cast<bool>(value_auto.is_accepting[state]);
+  };
+
+  SemilinearSet_ptr semilinear_set = new SemilinearSet();
+  for (long x = 0; x < cycle_head; ++x) {
+    if (is_accepted(x)) {
+      semilinear_set->add_constant(x);
+    }
+  }
+  for (long i = 0; i < period; ++i) {
+    if (is_accepted(cycle_head + i)) {
+      semilinear_set->add_periodic_constant(i);
+    }
+  }
+  if (semilinear_set->get_number_of_periodic_constants() > 0) {
+    semilinear_set->set_cycle_head(cycle_head);
+    semilinear_set->set_period(period);
+  }
 
+  DVLOG(VLOG_LEVEL) << "semilinear set = [" << this->id_ << "]->ComputeSemilinearSet()";
   return semilinear_set;
 }
 
+BinaryIntAutomaton::ValueAutomaton BinaryIntAutomaton::MakeValueAutomaton(const std::vector<int>& next_states,
+                                                                          const std::vector<bool>& accepts_zeros) {
+  // a state pairs the state of the automaton with the acceptance at the last 1 bit, which is the acceptance
+  // of the value read so far
+  const int initial_state = this->dfa_->s;
+  auto key = [](const int state, const bool is_accepting) {
+    return 2 * state + (is_accepting ? 1 : 0);
+  };
+  std::vector<int> indices(2 * this->dfa_->ns, -1);
+  std::vector<std::pair<int, bool>> states { { initial_state, accepts_zeros[initial_state] } };
+  indices[key(initial_state, accepts_zeros[initial_state])] = 0;
+  std::vector<int> value_next_states;
+  std::vector<bool> is_accepting;
+  for (std::size_t i = 0; i < states.size(); ++i) {
+    const auto current = states[i];
+    for (int b = 0; b < 2; ++b) {
+      const int next_state = next_states[2 * current.first + b];
+      const bool is_next_accepting = (b == 1) ? accepts_zeros[next_state] : current.second;
+      int& index = indices[key(next_state, is_next_accepting)];
+      if (index == -1) {
+        index = states.size();
+        states.push_back(std::make_pair(next_state, is_next_accepting));
+      }
+      value_next_states.push_back(index);
+    }
+    is_accepting.push_back(current.second);
+  }
+  return MinimizeValueAutomaton(value_next_states, is_accepting);
+}
+
+BinaryIntAutomaton::ValueAutomaton BinaryIntAutomaton::ShiftValueAutomaton(const ValueAutomaton& value_auto,
+                                                                           const long offset) {
+  // a state of the adder keeps the position in the bits of the offset, the state of the value automaton and
+  // the carry; positions stop at the length of the offset since the remaining bits are zeros
+  int offset_length = 0;
+  while ((offset >> offset_length) > 0) {
+    ++offset_length;
+  }
+  const int number_of_states = value_auto.is_accepting.size();
+  auto key = [number_of_states](const int position, const int state, const int carry) {
+    return 2 * (position * number_of_states + state) + carry;
+  };
+  auto run = [&value_auto](int state, long x) {
+    for (; x > 0; x >>= 1) {
+      state = value_auto.next_states[2 * state + (x & 1)];
+    }
+    return state;
+  };
+
+  std::vector<int> indices(2 * (offset_length + 1) * number_of_states, -1);
+  std::vector<std::tuple<int, int, int>> states { std::make_tuple(0, 0, 0) };
+  indices[key(0, 0, 0)] = 0;
+  std::vector<int> shifted_next_states;
+  std::vector<bool> is_accepting;
+  for (std::size_t i = 0; i < states.size(); ++i) {
+    int position, state, carry;
+    std::tie(position, state, carry) = states[i];
+    const int offset_bit = (offset >> position) & 1;
+    for (int b = 0; b < 2; ++b) {
+      const int sum = b + offset_bit + carry;
+      const int next_position = std::min(position + 1, offset_length);
+      const int next_state = value_auto.next_states[2 * state + (sum & 1)];
+      int& index = indices[key(next_position, next_state, sum >> 1)];
+      if (index == -1) {
+        index = states.size();
+        states.push_back(std::make_tuple(next_position, next_state, sum >> 1));
+      }
+      shifted_next_states.push_back(index);
+    }
+    // the value ends here, the rest of the offset and the carry are still to be added
+    is_accepting.push_back(value_auto.is_accepting[run(state, (offset >> position) + carry)]);
+  }
+  return MinimizeValueAutomaton(shifted_next_states, is_accepting);
+}
+
+BinaryIntAutomaton::ValueAutomaton BinaryIntAutomaton::MinimizeValueAutomaton(const std::vector<int>& next_states,
+                                                                              const std::vector<bool>& is_accepting) {
+  // partitions are refined with the classes of the successors until the number of classes is stable
+  const int number_of_states = is_accepting.size();
+  std::vector<int> classes(number_of_states), next_classes(number_of_states);
+  for (int q = 0; q < number_of_states; ++q) {
+    classes[q] = is_accepting[q] ? 1 : 0;
+  }
+  std::size_t number_of_classes = std::set<int>(classes.begin(), classes.end()).size();
+  while (true) {
+    std::map<std::tuple<int, int, int>, int> signatures;
+    for (int q = 0; q < number_of_states; ++q) {
+      auto signature = std::make_tuple(classes[q], classes[next_states[2 * q]], classes[next_states[2 * q + 1]]);
+      next_classes[q] = signatures.insert(std::make_pair(signature, signatures.size())).first->second;
+    }
+    if (signatures.size() == number_of_classes) {
+      break;
+    }
+    number_of_classes = signatures.size();
+    classes.swap(next_classes);
+  }
+
+  // classes are numbered in breadth first order from the initial state
+  ValueAutomaton minimal_auto;
+  std::vector<int> class_indices(number_of_classes, -1);
+  std::vector<int> representatives { 0 };
+  class_indices[next_classes[0]] = 0;
+  for (std::size_t i = 0; i < representatives.size(); ++i) {
+    const int q = representatives[i];
+    for (int b = 0; b < 2; ++b) {
+      const int next_state = next_states[2 * q + b];
+      int& index = class_indices[next_classes[next_state]];
+      if (index == -1) {
+        index = representatives.size();
+        representatives.push_back(next_state);
+      }
+      minimal_auto.next_states.push_back(index);
+    }
+    minimal_auto.is_accepting.push_back(is_accepting[q]);
+  }
+  return minimal_auto;
+}
+
 UnaryAutomaton_ptr BinaryIntAutomaton::ToUnaryAutomaton() {
   UnaryAutomaton_ptr unary_auto = nullptr;
   BinaryIntAutomaton_ptr trimmed_auto = nullptr;
@@ -1315,6 +1474,15 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeIntGraterThanOrEqualToZero(std::v
 }
 
 BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeEquality(ArithmeticFormula_ptr formula, bool is_natural_number) {
+  // enumeration works on int carries, coefficients that do not fit are built symbolically
+  if (not Option::Theory::SYMBOLIC_ARITHMETIC_TRANSITIONS and formula->HasIntCoefficients()) {
+    if (is_natural_number) {
+      return MakeNaturalNumberEqualityByEnumeration(formula);
+    } else {
+      return MakeIntEqualityByEnumeration(formula);
+    }
+  }
+
   if (is_natural_number) {
     return MakeNaturalNumberEquality(formula);
   } else {
@@ -1323,12 +1491,231 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeEquality(ArithmeticFormula_ptr fo
 }
 
 BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeIntEquality(ArithmeticFormula_ptr formula) {
+  Util::Trace::Event event("make_int_equality", "automaton");
+  event.AddArg("variables", formula->GetNumberOfVariables());
   if (not formula->Simplify()) {
     auto equality_auto = BinaryIntAutomaton::MakePhi(formula, false);
     DVLOG(VLOG_LEVEL) << equality_auto->id_ << " = MakeIntEquality(" << *formula << ")";
     return equality_auto;
   }
 
+  const BigInteger constant = formula->GetConstant();
+  const bool is_equality = (ArithmeticFormula::Type::EQ == formula->GetType());
+  const bool needs_shift_state = (not is_equality);
+  const int sink_state = 1;
+  int shifted_initial_state = -1;
+  int num_of_states = 2;
+
+  // states are generated on demand for the reachable carries
+  std::map<BigInteger, StateIndices> carry_map;  // maps carries to state indices
+  carry_map[constant].sr = 1;
+  carry_map[constant].i = -1;
+  carry_map[constant].ir = 0;
+  std::vector<std::pair<int, BigInteger>> worklist { { 0, constant } };
+
+  // no carry interval: any bit may be the sign bit, which subtracts its weight, so carries of either
+  // sign are still distinguishable whatever the signs of the coefficients
+  TransitionBuilder builder(formula);
+  std::vector<int> roots;
+  for (std::size_t next = 0; next < worklist.size(); ++next) {
+    if (Util::Budget::IsExceededByAutomaton(num_of_states, builder.size())) {
+      // the query is stopped, the partial transitions are dropped
+      auto phi_auto = BinaryIntAutomaton::MakePhi(formula, false);
+      DVLOG(VLOG_LEVEL) << phi_auto->id_ << " = MakeIntEquality(" << *formula << "), stopped by the query budget";
+      return phi_auto;
+    }
+    const int current_state = worklist[next].first;
+    const BigInteger carry = worklist[next].second;
+    if (carry_map[carry].i == current_state) {
+      carry_map[carry].s = 2;
+    } else {
+      carry_map[carry].sr = 2;
+    }
+
+    const int root = builder.MakeTransitions(carry, sink_state, current_state == 0, [&](const BigInteger& result) {
+      if (result % 2 != 0) {
+        return sink_state;
+      }
+      const BigInteger target = result / 2;
+      auto& indices = carry_map[target];
+      int to_state;
+      if (target == carry) {
+        if (indices.s == 0) {
+          indices.s = 1;
+          indices.i = num_of_states++;
+          worklist.push_back(std::make_pair(indices.i, target));
+        }
+        to_state = indices.i;
+      } else {
+        if (indices.sr == 0) {
+          indices.sr = 1;
+          indices.ir = num_of_states++;
+          worklist.push_back(std::make_pair(indices.ir, target));
+        }
+        to_state = indices.ir;
+      }
+
+      if (needs_shift_state and to_state == 0) {
+        if (shifted_initial_state == -1) {
+          shifted_initial_state = num_of_states++;
+        }
+        to_state = shifted_initial_state;
+      }
+      return to_state;
+    });
+    roots.resize(num_of_states, -1);
+    roots[current_state] = root;
+  }
+
+  // shifted initial state has the transitions of the initial state
+  roots.resize(num_of_states, -1);
+  roots[sink_state] = builder.MakeLeaf(sink_state);
+  if (shifted_initial_state != -1) {
+    roots[shifted_initial_state] = roots[0];
+  }
+
+  //define accepting and rejecting states
+  char initial_status = '-';
+  char target_status = '+';
+  if (not is_equality) {
+    initial_status = '+';
+    target_status = '-';
+  }
+
+  std::string statuses(num_of_states, initial_status);
+  statuses[0] = '-';
+  for (auto& el : carry_map) {
+    if (el.second.s == 2) {
+      if (el.second.i == 0 and shifted_initial_state != -1) {
+        statuses[shifted_initial_state] = target_status;
+      } else {
+        statuses[el.second.i] = target_status;
+      }
+    }
+  }
+
+  auto equality_dfa = builder.Build(roots, statuses.c_str());
+  auto equality_auto = new BinaryIntAutomaton(equality_dfa, formula, false);
+  CHECK_EQ(false, equality_auto->IsInitialStateAccepting());
+
+  DVLOG(VLOG_LEVEL) << equality_auto->id_ << " = MakeIntEquality(" << *formula << ")";
+  return equality_auto;
+}
+
+BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeNaturalNumberEquality(ArithmeticFormula_ptr formula) {
+  Util::Trace::Event event("make_natural_number_equality", "automaton");
+  event.AddArg("variables", formula->GetNumberOfVariables());
+  if (not formula->Simplify()) {
+    auto equality_auto = BinaryIntAutomaton::MakePhi(formula, true);
+    DVLOG(VLOG_LEVEL) << equality_auto->id_ << " = MakeNaturalNumberEquality(" << *formula << ")";
+    return equality_auto;
+  }
+
+  const BigInteger constant = formula->GetConstant();
+  const bool is_equality = (ArithmeticFormula::Type::EQ == formula->GetType());
+  const bool needs_shift_state = ((is_equality and constant == 0) or ((not is_equality) and constant != 0));
+  const int sink_state = 1;
+  int shifted_initial_state = -1;
+  int num_of_states = 2;
+
+  // states are generated on demand for the reachable carries
+  std::map<BigInteger, StateIndices> carry_map;  // maps carries to state indices
+  carry_map[constant].s = 1;
+  carry_map[constant].i = 0;
+  std::vector<std::pair<int, BigInteger>> worklist { { 0, constant } };
+
+  TransitionBuilder builder(formula);
+  // with coefficients of one sign a nonzero carry never returns to 0, every odd sum goes to the sink state
+  bool has_positive_coefficient = false, has_negative_coefficient = false;
+  for (auto& coeff : formula->GetExactCoefficients()) {
+    has_positive_coefficient = has_positive_coefficient or coeff > 0;
+    has_negative_coefficient = has_negative_coefficient or coeff < 0;
+  }
+  if (not has_negative_coefficient) {
+    builder.SetMaxSum(1);
+  }
+  if (not has_positive_coefficient) {
+    builder.SetMinSum(-1);
+  }
+  std::vector<int> roots;
+  for (std::size_t next = 0; next < worklist.size(); ++next) {
+    if (Util::Budget::IsExceededByAutomaton(num_of_states, builder.size())) {
+      // the query is stopped, the partial transitions are dropped
+      auto phi_auto = BinaryIntAutomaton::MakePhi(formula, true);
+      DVLOG(VLOG_LEVEL) << phi_auto->id_ << " = MakeNaturalNumberEquality(" << *formula << "), stopped by the query budget";
+      return phi_auto;
+    }
+    const int current_state = worklist[next].first;
+    const BigInteger carry = worklist[next].second;
+    carry_map[carry].s = 2;
+
+    const int root = builder.MakeTransitions(carry, sink_state, current_state == 0, [&](const BigInteger& result) {
+      if (result % 2 != 0) {
+        return sink_state;
+      }
+      const BigInteger target = result / 2;
+      auto& indices = carry_map[target];
+      if (indices.s == 0) {
+        indices.s = 1;
+        indices.i = num_of_states++;
+        worklist.push_back(std::make_pair(indices.i, target));
+      }
+      // hack to avoid an accepting initial state
+      int to_state = indices.i;
+      if (needs_shift_state and to_state == 0) {
+        if (shifted_initial_state == -1) {
+          shifted_initial_state = num_of_states++;
+        }
+        to_state = shifted_initial_state;
+      }
+      return to_state;
+    });
+    roots.resize(num_of_states, -1);
+    roots[current_state] = root;
+  }
+
+  // shifted initial state has the transitions of the initial state
+  roots.resize(num_of_states, -1);
+  roots[sink_state] = builder.MakeLeaf(sink_state);
+  if (shifted_initial_state != -1) {
+    roots[shifted_initial_state] = roots[0];
+  }
+
+  //define accepting and rejecting states
+  char initial_status = '-';
+  char target_status = '+';
+  if (not is_equality) {
+    initial_status = '+';
+    target_status = '-';
+  }
+
+  std::string statuses(num_of_states, initial_status);
+  statuses[0] = '-';
+  auto it = carry_map.find(0);
+  if (it != carry_map.end() and it->second.s == 2) {
+    if (it->second.i == 0 and shifted_initial_state != -1) {
+      statuses[shifted_initial_state] = target_status;
+    } else {
+      statuses[it->second.i] = target_status;
+    }
+  }
+
+  auto equality_dfa = builder.Build(roots, statuses.c_str());
+  auto equality_auto = new BinaryIntAutomaton(equality_dfa, formula, true);
+  CHECK_EQ(false, equality_auto->IsInitialStateAccepting());
+
+  DVLOG(VLOG_LEVEL) << equality_auto->id_ << " = MakeNaturalNumberEquality(" << *formula << ")";
+  return equality_auto;
+}
+
+BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeIntEqualityByEnumeration(ArithmeticFormula_ptr formula) {
+  if (not formula->Simplify()) {
+    auto equality_auto = BinaryIntAutomaton::MakePhi(formula, false);
+    DVLOG(VLOG_LEVEL) << equality_auto->id_ << " = MakeIntEqualityByEnumeration(" << *formula << ")";
+    return equality_auto;
+  }
+
+  CHECK(formula->HasIntCoefficients()) << "coefficients do not fit into int carries: " << *formula;
   auto coeffs_map = formula->GetVariableCoefficientMap();
   auto coeffs = formula->GetCoefficients();
   auto boolean_variables = formula->GetBooleans();
@@ -1343,7 +1730,7 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeIntEquality(ArithmeticFormula_ptr
     }
   }
 
-  const int constant = formula->GetConstant();
+  const int constant = formula->GetConstant().convert_to<int>();
   if (max < constant) {
     max = constant;
   } else if (min > constant) {
@@ -1502,17 +1889,18 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeIntEquality(ArithmeticFormula_ptr
   auto equality_auto = new BinaryIntAutomaton(equality_dfa, formula, false);
   CHECK_EQ(false, equality_auto->IsInitialStateAccepting());
 
-  DVLOG(VLOG_LEVEL) << equality_auto->id_ << " = MakeIntEquality(" << *formula << ")";
+  DVLOG(VLOG_LEVEL) << equality_auto->id_ << " = MakeIntEqualityByEnumeration(" << *formula << ")";
   return equality_auto;
 }
 
-BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeNaturalNumberEquality(ArithmeticFormula_ptr formula) {
+BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeNaturalNumberEqualityByEnumeration(ArithmeticFormula_ptr formula) {
   if (not formula->Simplify()) {
     auto equality_auto = BinaryIntAutomaton::MakePhi(formula, true);
-    DVLOG(VLOG_LEVEL) << equality_auto->id_ << " = MakeNaturalNumberEquality(" << *formula << ")";
+    DVLOG(VLOG_LEVEL) << equality_auto->id_ << " = MakeNaturalNumberEqualityByEnumeration(" << *formula << ")";
     return equality_auto;
   }
 
+  CHECK(formula->HasIntCoefficients()) << "coefficients do not fit into int carries: " << *formula;
   auto coeffs_map = formula->GetVariableCoefficientMap();
 	auto coeffs = formula->GetCoefficients();
 	auto boolean_variables = formula->GetBooleans();
@@ -1527,7 +1915,7 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeNaturalNumberEquality(ArithmeticF
     }
   }
 
-  const int constant = formula->GetConstant();
+  const int constant = formula->GetConstant().convert_to<int>();
   if (max < constant) {
     max = constant;
   } else if (min > constant) {
@@ -1671,11 +2059,20 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeNaturalNumberEquality(ArithmeticF
   auto equality_auto = new BinaryIntAutomaton(equality_dfa, formula, true);
   CHECK_EQ(false, equality_auto->IsInitialStateAccepting());
 
-  DVLOG(VLOG_LEVEL) << equality_auto->id_ << " = MakeNaturalNumberEquality(" << *formula << ")";
+  DVLOG(VLOG_LEVEL) << equality_auto->id_ << " = MakeNaturalNumberEqualityByEnumeration(" << *formula << ")";
   return equality_auto;
 }
 
 BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeLessThan(ArithmeticFormula_ptr formula, bool is_natural_number) {
+  // enumeration works on int carries, coefficients that do not fit are built symbolically
+  if (not Option::Theory::SYMBOLIC_ARITHMETIC_TRANSITIONS and formula->HasIntCoefficients()) {
+    if (is_natural_number) {
+      return MakeNaturalNumberLessThanByEnumeration(formula);
+    } else {
+      return MakeIntLessThanByEnumeration(formula);
+    }
+  }
+
   if (is_natural_number) {
     return MakeNaturalNumberLessThan(formula);
   } else {
@@ -1684,8 +2081,188 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeLessThan(ArithmeticFormula_ptr fo
 }
 
 BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeIntLessThan(ArithmeticFormula_ptr formula) {
+  Util::Trace::Event event("make_int_less_than", "automaton");
+  event.AddArg("variables", formula->GetNumberOfVariables());
+  formula->Simplify();
+
+  const BigInteger constant = formula->GetConstant();
+  int num_of_states = 1;
+
+  // states are generated on demand for the reachable carries
+  std::map<BigInteger, StateIndices> carry_map;  // maps carries to state indices
+  carry_map[constant].sr = 1;
+  carry_map[constant].i = -1;
+  carry_map[constant].ir = 0;
+  std::vector<std::pair<int, BigInteger>> worklist { { 0, constant } };
+
+  // no carry interval: any bit may be the sign bit, which subtracts its weight, so carries of either
+  // sign are still distinguishable whatever the signs of the coefficients
+  TransitionBuilder builder(formula);
+  std::vector<int> roots;
+  for (std::size_t next = 0; next < worklist.size(); ++next) {
+    if (Util::Budget::IsExceededByAutomaton(num_of_states, builder.size())) {
+      // the query is stopped, the partial transitions are dropped
+      auto phi_auto = BinaryIntAutomaton::MakePhi(formula, false);
+      DVLOG(VLOG_LEVEL) << phi_auto->id_ << " = MakeIntLessThan(" << *formula << "), stopped by the query budget";
+      return phi_auto;
+    }
+    const int current_state = worklist[next].first;
+    const BigInteger carry = worklist[next].second;
+    if (carry_map[carry].i == current_state) {
+      carry_map[carry].s = 2;
+    } else {
+      carry_map[carry].sr = 2;
+    }
+
+    const int root = builder.MakeTransitions(carry, current_state, current_state == 0, [&](const BigInteger& sum) {
+      const BigInteger ones = sum - carry;
+      const BigInteger target = (sum >= 0) ? BigInteger(sum / 2) : BigInteger((sum - 1) / 2);
+      BigInteger result = sum;
+      bool write1 = (result % 2 != 0);
+      BigInteger label1 = carry;
+      BigInteger label2 = target;
+      while (label1 != label2) {
+        label1 = label2;
+        result = label1 + ones;
+        if (result >= 0) {
+          label2 = result / 2;
+        } else {
+          label2 = (result - 1) / 2;
+        }
+        write1 = (result % 2 != 0);
+      }
+
+      auto& indices = carry_map[target];
+      if (write1) {
+        if (indices.s == 0) {
+          indices.s = 1;
+          indices.i = num_of_states++;
+          worklist.push_back(std::make_pair(indices.i, target));
+        }
+        return indices.i;
+      }
+      if (indices.sr == 0) {
+        indices.sr = 1;
+        indices.ir = num_of_states++;
+        worklist.push_back(std::make_pair(indices.ir, target));
+      }
+      return indices.ir;
+    });
+    roots.resize(num_of_states, -1);
+    roots[current_state] = root;
+  }
+
+  //define accepting and rejecting states
+  std::string statuses(num_of_states, '-');
+  for (auto& el : carry_map) {
+    if (el.second.s == 2) {
+      statuses[el.second.i] = '+';
+    }
+  }
+
+  auto less_than_dfa = builder.Build(roots, statuses.c_str());
+  auto less_than_auto = new BinaryIntAutomaton(less_than_dfa, formula, false);
+  CHECK_EQ(false, less_than_auto->IsInitialStateAccepting());
+
+  DVLOG(VLOG_LEVEL) << less_than_auto->id_ << " = MakeIntLessThan(" << *formula << ")";
+  return less_than_auto;
+}
+
+BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeNaturalNumberLessThan(ArithmeticFormula_ptr formula) {
+  Util::Trace::Event event("make_natural_number_less_than", "automaton");
+  event.AddArg("variables", formula->GetNumberOfVariables());
   formula->Simplify();
 
+  const BigInteger constant = formula->GetConstant();
+  int shifted_initial_state = -1;
+  int num_of_states = 1;
+
+  // states are generated on demand for the reachable carries
+  std::map<BigInteger, StateIndices> carry_map;  // maps carries to state indices
+  carry_map[constant].s = 1;
+  carry_map[constant].i = 0;
+  std::vector<std::pair<int, BigInteger>> worklist { { 0, constant } };
+
+  TransitionBuilder builder(formula);
+  // with coefficients of one sign carries saturate: without negative coefficients no carry at or above 0
+  // accepts anymore, without positive ones every carry below 0 does
+  bool has_positive_coefficient = false, has_negative_coefficient = false;
+  for (auto& coeff : formula->GetExactCoefficients()) {
+    has_positive_coefficient = has_positive_coefficient or coeff > 0;
+    has_negative_coefficient = has_negative_coefficient or coeff < 0;
+  }
+  if (not has_negative_coefficient) {
+    builder.SetMaxSum(0);
+  }
+  if (not has_positive_coefficient) {
+    builder.SetMinSum(-1);
+  }
+  std::vector<int> roots;
+  for (std::size_t next = 0; next < worklist.size(); ++next) {
+    if (Util::Budget::IsExceededByAutomaton(num_of_states, builder.size())) {
+      // the query is stopped, the partial transitions are dropped
+      auto phi_auto = BinaryIntAutomaton::MakePhi(formula, true);
+      DVLOG(VLOG_LEVEL) << phi_auto->id_ << " = MakeNaturalNumberLessThan(" << *formula << "), stopped by the query budget";
+      return phi_auto;
+    }
+    const int current_state = worklist[next].first;
+    const BigInteger carry = worklist[next].second;
+    carry_map[carry].s = 2;
+
+    const int root = builder.MakeTransitions(carry, current_state, current_state == 0, [&](const BigInteger& result) {
+      const BigInteger target = (result >= 0) ? BigInteger(result / 2) : BigInteger((result - 1) / 2);
+      auto& indices = carry_map[target];
+      if (indices.s == 0) {
+        indices.s = 1;
+        indices.i = num_of_states++;
+        worklist.push_back(std::make_pair(indices.i, target));
+      }
+      // hack to avoid an accepting initial state
+      int to_state = indices.i;
+      if (to_state == 0) {
+        if (shifted_initial_state == -1) {
+          shifted_initial_state = num_of_states++;
+        }
+        to_state = shifted_initial_state;
+      }
+      return to_state;
+    });
+    roots.resize(num_of_states, -1);
+    roots[current_state] = root;
+  }
+
+  // shifted initial state has the transitions of the initial state
+  roots.resize(num_of_states, -1);
+  if (shifted_initial_state != -1) {
+    roots[shifted_initial_state] = roots[0];
+  }
+
+  //define accepting and rejecting states
+  std::string statuses(num_of_states, '-');
+  for (auto& el : carry_map) {
+    if (el.first < 0 and el.second.s == 2) {
+      if (el.second.i == 0) {
+        if (shifted_initial_state != -1) {
+          statuses[shifted_initial_state] = '+';
+        }
+      } else {
+        statuses[el.second.i] = '+';
+      }
+    }
+  }
+
+  auto less_than_dfa = builder.Build(roots, statuses.c_str());
+  auto less_than_auto = new BinaryIntAutomaton(less_than_dfa, formula, true);
+  CHECK_EQ(false, less_than_auto->IsInitialStateAccepting());
+
+  DVLOG(VLOG_LEVEL) << less_than_auto->id_ << " = MakeNaturalNumberLessThan(" << *formula << ")";
+  return less_than_auto;
+}
+
+BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeIntLessThanByEnumeration(ArithmeticFormula_ptr formula) {
+  formula->Simplify();
+
+  CHECK(formula->HasIntCoefficients()) << "coefficients do not fit into int carries: " << *formula;
   auto coeffs_map = formula->GetVariableCoefficientMap();
 	auto boolean_variables = formula->GetBooleans();
   auto coeffs = formula->GetCoefficients();
@@ -1700,7 +2277,7 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeIntLessThan(ArithmeticFormula_ptr
     }
   }
 
-  const int constant = formula->GetConstant();
+  const int constant = formula->GetConstant().convert_to<int>();
   if (max < constant) {
     max = constant;
   } else if (min > constant) {
@@ -1839,13 +2416,14 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeIntLessThan(ArithmeticFormula_ptr
   auto less_than_auto = new BinaryIntAutomaton(less_than_dfa, formula, false);
   CHECK_EQ(false, less_than_auto->IsInitialStateAccepting());
 
-  DVLOG(VLOG_LEVEL) << less_than_auto->id_ << " = MakeIntLessThan(" << *formula << ")";
+  DVLOG(VLOG_LEVEL) << less_than_auto->id_ << " = MakeIntLessThanByEnumeration(" << *formula << ")";
   return less_than_auto;
 }
 
-BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeNaturalNumberLessThan(ArithmeticFormula_ptr formula) {
+BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeNaturalNumberLessThanByEnumeration(ArithmeticFormula_ptr formula) {
   formula->Simplify();
 
+  CHECK(formula->HasIntCoefficients()) << "coefficients do not fit into int carries: " << *formula;
   auto coeffs_map = formula->GetVariableCoefficientMap();
 	auto boolean_variables = formula->GetBooleans();
   auto coeffs = formula->GetCoefficients();
@@ -1860,7 +2438,7 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeNaturalNumberLessThan(ArithmeticF
     }
   }
 
-  const int constant = formula->GetConstant();
+  const int constant = formula->GetConstant().convert_to<int>();
   if (max < constant) {
     max = constant;
   } else if (min > constant) {
@@ -1997,7 +2575,7 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeNaturalNumberLessThan(ArithmeticF
   auto less_than_auto = new BinaryIntAutomaton(less_than_dfa, formula, true);
   CHECK_EQ(false, less_than_auto->IsInitialStateAccepting());
 
-  DVLOG(VLOG_LEVEL) << less_than_auto->id_ << " = MakeNaturalNumberLessThan(" << *formula << ")";
+  DVLOG(VLOG_LEVEL) << less_than_auto->id_ << " = MakeNaturalNumberLessThanByEnumeration(" << *formula << ")";
   return less_than_auto;
 }
 
@@ -2205,6 +2783,38 @@ bool BinaryIntAutomaton::is_accepting_binary_state(BinaryState_ptr binary_state,
   return false;
 }
 
+void BinaryIntAutomaton::GetBitTransitions(std::vector<int>& next_states, std::vector<bool>& accepts_zeros) {
+  const int number_of_states = this->dfa_->ns;
+  std::vector<char> exception = { '0' };
+  next_states.resize(2 * number_of_states);
+  for (int q = 0; q < number_of_states; ++q) {
+    exception[0] = '0';
+    next_states[2 * q] = getNextState(q, exception);
+    exception[0] = '1';
+    next_states[2 * q + 1] = getNextState(q, exception);
+  }
+
+  std::vector<std::vector<int>> previous_states(number_of_states);
+  std::stack<int> work_list;
+  accepts_zeros.assign(number_of_states, false);
+  for (int q = 0; q < number_of_states; ++q) {
+    previous_states[next_states[2 * q]].push_back(q);
+    if (IsAcceptingState(q)) {
+      accepts_zeros[q] = true;
+      work_list.push(q);
+    }
+  }
+  while (not work_list.empty()) {
+    int q = work_list.top(); work_list.pop();
+    for (auto p : previous_states[q]) {
+      if (not accepts_zeros[p]) {
+        accepts_zeros[p] = true;
+        work_list.push(p);
+      }
+    }
+  }
+}
+
 bool BinaryIntAutomaton::GetCycleStatus(std::map<int, bool>& cycle_status) {
   std::map<int, int> disc;
   std::map<int, int> low;
@@ -2539,6 +3149,160 @@ void BinaryIntAutomaton::GetBaseConstants(int state, unsigned char *is_visited,
 //  is_stack_member[state] = false;
 //}
 
+BinaryIntAutomaton::TransitionBuilder::TransitionBuilder(ArithmeticFormula_ptr formula)
+    : num_of_variables_ { formula->GetNumberOfVariables() },
+      coefficients_ { formula->GetExactCoefficients() },
+      boolean_values_(num_of_variables_, -1),
+      unique_nodes_(num_of_variables_),
+      has_min_sum_ { false },
+      has_max_sum_ { false },
+      fix_booleans_ { false },
+      default_leaf_ { -1 } {
+  for (auto& el : formula->GetBooleans()) {
+    boolean_values_[formula->GetVariableIndex(el.first)] = el.second ? 1 : 0;
+  }
+}
+
+int BinaryIntAutomaton::TransitionBuilder::MakeTransitions(const BigInteger& carry, const int default_state,
+                                                           const bool fix_booleans,
+                                                           std::function<int(const BigInteger&)> get_target) {
+  fix_booleans_ = fix_booleans;
+  default_leaf_ = MakeLeaf(default_state);
+  get_target_ = get_target;
+  min_rest_.assign(num_of_variables_ + 1, 0);
+  max_rest_.assign(num_of_variables_ + 1, 0);
+  for (int level = num_of_variables_ - 1; level >= 0; --level) {
+    const BigInteger& coeff = coefficients_[level];
+    if (fix_booleans_ and boolean_values_[level] != -1) {
+      min_rest_[level] = min_rest_[level + 1] + boolean_values_[level] * coeff;
+      max_rest_[level] = max_rest_[level + 1] + boolean_values_[level] * coeff;
+    } else if (coeff < 0) {
+      min_rest_[level] = min_rest_[level + 1] + coeff;
+      max_rest_[level] = max_rest_[level + 1];
+    } else {
+      min_rest_[level] = min_rest_[level + 1];
+      max_rest_[level] = max_rest_[level + 1] + coeff;
+    }
+  }
+  computed_.assign(num_of_variables_ + 1, std::map<BigInteger, int>());
+  int root = MakeNode(0, carry);
+  computed_.clear();
+  min_rest_.clear();
+  max_rest_.clear();
+  get_target_ = nullptr;
+  return root;
+}
+
+int BinaryIntAutomaton::TransitionBuilder::MakeLeaf(const int state) {
+  auto it = leaves_.find(state);
+  if (it != leaves_.end()) {
+    return it->second;
+  }
+  int id = nodes_.size();
+  nodes_.push_back(Node { -1, state, state });
+  leaves_[state] = id;
+  return id;
+}
+
+void BinaryIntAutomaton::TransitionBuilder::SetMinSum(const BigInteger& min_sum) {
+  has_min_sum_ = true;
+  min_sum_ = min_sum;
+}
+
+void BinaryIntAutomaton::TransitionBuilder::SetMaxSum(const BigInteger& max_sum) {
+  has_max_sum_ = true;
+  max_sum_ = max_sum;
+}
+
+DFA_ptr BinaryIntAutomaton::TransitionBuilder::Build(const std::vector<int>& roots, const char* statuses) {
+  const int num_of_states = roots.size();
+  unsigned long max_states_allowed = 0x80000000;
+  unsigned long mona_check = 8UL * num_of_states;
+  CHECK_LE(mona_check, max_states_allowed);  // otherwise, MONA infinite loops
+
+  DFA_ptr dfa = dfaMake(num_of_states);
+  // children are created before their parents; nodes are registered as roots and accessed through their
+  // handles since the bdd manager may relocate the node table while growing
+  std::vector<bdd_handle> handles(nodes_.size());
+  for (std::size_t i = 0; i < nodes_.size(); ++i) {
+    const Node& node = nodes_[i];
+    if (node.index == -1) {
+      bdd_find_leaf_hashed_add_root(dfa->bddm, node.low);
+    } else {
+      bdd_find_node_hashed_add_root(dfa->bddm, BDD_ROOT(dfa->bddm, handles[node.low]),
+                                    BDD_ROOT(dfa->bddm, handles[node.high]), node.index);
+    }
+    handles[i] = BDD_LAST_HANDLE(dfa->bddm);
+  }
+
+  for (int s = 0; s < num_of_states; ++s) {
+    dfa->q[s] = BDD_ROOT(dfa->bddm, handles[roots[s]]);
+    dfa->f[s] = (statuses[s] == '+') ? 1 : -1;
+  }
+  dfa->s = 0;
+
+  DVLOG(VLOG_LEVEL) << "transition builder: " << num_of_states << " states, " << nodes_.size() << " bdd nodes";
+  auto minimized_dfa = dfaMinimize(dfa);
+  dfaFree(dfa);
+  return minimized_dfa;
+}
+
+std::size_t BinaryIntAutomaton::TransitionBuilder::size() const {
+  return nodes_.size();
+}
+
+int BinaryIntAutomaton::TransitionBuilder::MakeNode(const int level, const BigInteger& partial_sum) {
+  // if every completion of the partial sum falls beyond a bound, all of them have the target of the bound;
+  // so do the completions of the sum whose nearest completion is the bound, which is memoised instead
+  BigInteger sum = partial_sum;
+  if (has_max_sum_ and sum + min_rest_[level] > max_sum_) {
+    sum = max_sum_ - min_rest_[level];
+  } else if (has_min_sum_ and sum + max_rest_[level] < min_sum_) {
+    sum = min_sum_ - max_rest_[level];
+  }
+
+  if (level == num_of_variables_) {
+    return MakeLeaf(get_target_(sum));
+  }
+
+  auto it = computed_[level].find(sum);
+  if (it != computed_[level].end()) {
+    return it->second;
+  }
+
+  const BigInteger& coeff = coefficients_[level];
+  int node;
+  if (coeff == 0) {
+    node = MakeNode(level + 1, sum);
+  } else if (fix_booleans_ and boolean_values_[level] != -1) {
+    const int value = boolean_values_[level];
+    const int child = MakeNode(level + 1, sum + value * coeff);
+    node = (value == 1) ? FindNode(level, default_leaf_, child) : FindNode(level, child, default_leaf_);
+  } else {
+    const int low = MakeNode(level + 1, sum);
+    const int high = MakeNode(level + 1, sum + coeff);
+    node = FindNode(level, low, high);
+  }
+
+  computed_[level][sum] = node;
+  return node;
+}
+
+int BinaryIntAutomaton::TransitionBuilder::FindNode(const int index, const int low, const int high) {
+  if (low == high) {
+    return low;
+  }
+  const unsigned long long key = (static_cast<unsigned long long>(low) << 32) | static_cast<unsigned>(high);
+  auto it = unique_nodes_[index].find(key);
+  if (it != unique_nodes_[index].end()) {
+    return it->second;
+  }
+  int id = nodes_.size();
+  nodes_.push_back(Node { index, low, high });
+  unique_nodes_[index][key] = id;
+  return id;
+}
+
 void BinaryIntAutomaton::add_print_label(std::ostream& out) {
   out << " subgraph cluster_0 {\n";
   out << "  style = invis;\n  center = true;\n  margin = 0;\n";
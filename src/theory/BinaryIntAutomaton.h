@@ -14,12 +14,17 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdlib>
+#include <functional>
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <map>
+#include <mutex>
+#include <set>
 #include <sstream>
 #include <stack>
 #include <string>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -28,6 +33,7 @@
 #include <mona/bdd.h>
 #include <mona/dfa.h>
 
+#include "../utils/Budget.h"
 #include "../utils/Cmd.h"
 #include "../utils/List.h"
 #include "ArithmeticFormula.h"
@@ -64,6 +70,8 @@ public:
           ArithmeticFormula_ptr formula, bool add_leading_zeros = false);
   static BinaryIntAutomaton_ptr MakeAutomaton(SemilinearSet_ptr semilinear_set, std::string var_name,
           ArithmeticFormula_ptr formula, bool add_leading_zeros = false);
+  static BinaryIntAutomaton_ptr MakeAutomaton(const std::vector<bool>& lasso_statuses, const int cycle_head,
+          std::string var_name, ArithmeticFormula_ptr formula, bool add_minus_one = false);
 
   ArithmeticFormula_ptr GetFormula();
   void SetFormula(ArithmeticFormula_ptr formula);
@@ -97,6 +105,10 @@ protected:
   static BinaryIntAutomaton_ptr MakeLessThan(ArithmeticFormula_ptr, bool is_natural_number);
   static BinaryIntAutomaton_ptr MakeIntLessThan(ArithmeticFormula_ptr);
   static BinaryIntAutomaton_ptr MakeNaturalNumberLessThan(ArithmeticFormula_ptr);
+  static BinaryIntAutomaton_ptr MakeIntEqualityByEnumeration(ArithmeticFormula_ptr);
+  static BinaryIntAutomaton_ptr MakeNaturalNumberEqualityByEnumeration(ArithmeticFormula_ptr);
+  static BinaryIntAutomaton_ptr MakeIntLessThanByEnumeration(ArithmeticFormula_ptr);
+  static BinaryIntAutomaton_ptr MakeNaturalNumberLessThanByEnumeration(ArithmeticFormula_ptr);
   static BinaryIntAutomaton_ptr MakeLessThanOrEqual(ArithmeticFormula_ptr, bool is_natural_number);
   static BinaryIntAutomaton_ptr MakeGreaterThan(ArithmeticFormula_ptr, bool is_natural_number);
   static BinaryIntAutomaton_ptr MakeGreaterThanOrEqual(ArithmeticFormula_ptr, bool is_natural_number);
@@ -109,6 +121,48 @@ protected:
           int C, int R, BinaryState::Type t, int v, int b);
   static bool is_accepting_binary_state(BinaryState_ptr binary_state, SemilinearSet_ptr semilinear_set);
 
+  /**
+   * Single track automaton over bits, least significant bit first, that accepts the binary representations
+   * of a set of values with any number of leading zeros. State 0 is initial; minimal automata are numbered
+   * in breadth first order, hence two of them accept the same values iff they are equal.
+   */
+  struct ValueAutomaton {
+    std::vector<int> next_states;  // transition of state q with bit b is at 2 * q + b
+    std::vector<bool> is_accepting;
+    bool operator<(const ValueAutomaton& other) const {
+      return std::tie(next_states, is_accepting) < std::tie(other.next_states, other.is_accepting);
+    }
+    bool operator==(const ValueAutomaton& other) const {
+      return next_states == other.next_states and is_accepting == other.is_accepting;
+    }
+  };
+
+  /**
+   * Extracts the semilinear set of a single track automaton from the lasso of its unary automaton.
+   * The state of the unary automaton after x is the residual {z : x + z is accepted}; residuals are
+   * minimal value automata, the cycle head is the first residual that repeats and the period is the
+   * distance to its repetition.
+   */
+  SemilinearSet_ptr ComputeSemilinearSet();
+
+  /**
+   * @return minimal value automaton of the values accepted by this automaton
+   */
+  ValueAutomaton MakeValueAutomaton(const std::vector<int>& next_states, const std::vector<bool>& accepts_zeros);
+
+  /**
+   * @return minimal value automaton of {z : z + offset is accepted by value_auto}
+   */
+  static ValueAutomaton ShiftValueAutomaton(const ValueAutomaton& value_auto, const long offset);
+  static ValueAutomaton MinimizeValueAutomaton(const std::vector<int>& next_states,
+                                               const std::vector<bool>& is_accepting);
+
+  /**
+   * @param next_states transition of state q with bit b is at 2 * q + b
+   * @param accepts_zeros whether an accepting state is reachable with zeros only
+   */
+  void GetBitTransitions(std::vector<int>& next_states, std::vector<bool>& accepts_zeros);
+
   void decide_counting_schema(Eigen::SparseMatrix<BigInteger>& count_matrix) override;
 
   bool GetCycleStatus(std::map<int, bool>& cycle_status);
@@ -132,8 +186,88 @@ protected:
     StateIndices(): i{-1}, ir{-1}, s{0}, sr{0} {}
   };
 
+  /**
+   * Builds transition BDDs of linear arithmetic automata one variable at a time.
+   * A state with carry c reads the bits of the variables in bdd index order and keeps the partial sum
+   * c + a_1*x_1 + ... + a_k*x_k at level k; nodes are memoised by (level, partial sum) and hash-consed,
+   * hence the cost is bounded by the number of distinct partial sums, not by the 2^n assignments.
+   * When the caller declares a carry interval, partial sums whose full sums all fall beyond one of its
+   * bounds are normalised to that bound first, so the number of nodes and targets stays bounded by the
+   * interval instead of growing with the magnitude of the coefficients.
+   */
+  class TransitionBuilder {
+   public:
+    TransitionBuilder(ArithmeticFormula_ptr formula);
+    ~TransitionBuilder() = default;
+
+    /**
+     * Makes the transition BDD of a state
+     * @param carry carry of the state
+     * @param default_state target of the assignments that violate the boolean variables
+     * @param fix_booleans whether boolean variables are fixed to their values
+     * @param get_target maps a full sum (carry + a_1*x_1 + ... + a_n*x_n) to a target state
+     * @return node id of the root
+     */
+    int MakeTransitions(const BigInteger& carry, const int default_state, const bool fix_booleans,
+                        std::function<int(const BigInteger&)> get_target);
+    int MakeLeaf(const int state);
+
+    /**
+     * Declares that every full sum below min_sum has the target of min_sum
+     * @param min_sum lower bound of the carry interval
+     */
+    void SetMinSum(const BigInteger& min_sum);
+
+    /**
+     * Declares that every full sum above max_sum has the target of max_sum
+     * @param max_sum upper bound of the carry interval
+     */
+    void SetMaxSum(const BigInteger& max_sum);
+
+    /**
+     * Assembles the minimized dfa
+     * @param roots transition BDD root of each state
+     * @param statuses '+' for accepting, '-' for rejecting states
+     */
+    DFA_ptr Build(const std::vector<int>& roots, const char* statuses);
+
+    std::size_t size() const;
+
+   protected:
+    struct Node {
+      int index;  // bdd variable index, -1 for leaves
+      int low, high;  // children, or the target state of a leaf in low
+    };
+
+    int MakeNode(const int level, const BigInteger& partial_sum);
+    int FindNode(const int index, const int low, const int high);
+
+    int num_of_variables_;
+    std::vector<BigInteger> coefficients_;
+    std::vector<int> boolean_values_;  // -1 if the variable is not boolean
+    std::vector<Node> nodes_;
+    std::unordered_map<int, int> leaves_;
+    std::vector<std::unordered_map<unsigned long long, int>> unique_nodes_;
+    bool has_min_sum_, has_max_sum_;
+    BigInteger min_sum_, max_sum_;
+
+    // valid during a MakeTransitions call
+    bool fix_booleans_;
+    int default_leaf_;
+    std::function<int(const BigInteger&)> get_target_;
+    std::vector<BigInteger> min_rest_, max_rest_;  // bounds of a_k*x_k + ... + a_n*x_n at level k
+    std::vector<std::map<BigInteger, int>> computed_;
+  };
+
   bool is_natural_number_;
   ArithmeticFormula_ptr formula_;
+
+  static const int SEMILINEAR_SET_CACHE_SIZE;
+  static const int SEMILINEAR_SET_START_BITS;
+  // semilinear sets are memoised by fingerprint, automata with the same fingerprint are checked for equality;
+  // the cache is shared by all drivers of the process
+  static std::unordered_multimap<std::size_t, std::pair<BinaryIntAutomaton_ptr, SemilinearSet_ptr>> semilinear_set_cache_;
+  static std::mutex semilinear_set_cache_mutex_;
 private:
   static const int VLOG_LEVEL;
 };
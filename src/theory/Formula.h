@@ -42,11 +42,11 @@ public:
 	virtual Formula_ptr Complement() = 0;
 
 	virtual void MergeVariables(Formula_ptr) = 0;
-	int GetVariableIndex(std::string) const;
-	int GetVariableIndex(const std::size_t param_index) const;
+	virtual int GetVariableIndex(std::string) const;
+	virtual int GetVariableIndex(const std::size_t param_index) const;
 	int GetVariableCoefficient(std::string) const;
 	void SetVariableCoefficient(std::string, int);
-	std::string GetVariableAtIndex(const std::size_t index) const;
+	virtual std::string GetVariableAtIndex(const std::size_t index) const;
 	int GetNumberOfVariables() const;
 	std::map<std::string,int> GetVariableCoefficientMap() const;
 	void SetVariableCoefficientMap(std::map<std::string, int>& coefficient_map);
@@ -14,7 +14,7 @@ const int IntAutomaton::INFINITE = -2;
 
 const int IntAutomaton::VLOG_LEVEL = 9;
 
-int IntAutomaton::DEFAULT_NUM_OF_VARIABLES = 8;
+thread_local int IntAutomaton::DEFAULT_NUM_OF_VARIABLES = 8;
 
 IntAutomaton::IntAutomaton(DFA_ptr dfa) :
         Automaton(Automaton::Type::INT, dfa, IntAutomaton::DEFAULT_NUM_OF_VARIABLES),
@@ -830,6 +830,19 @@ UnaryAutomaton_ptr IntAutomaton::toUnaryAutomaton() {
   return unary_auto;
 }
 
+/**
+ * Converts directly into binary encoding without going through unary automaton and semilinear set,
+ * -1 is added if the automaton has it
+ */
+BinaryIntAutomaton_ptr IntAutomaton::toBinaryIntAutomaton(std::string var_name, ArithmeticFormula_ptr formula) {
+  std::vector<char> unary_symbol(num_of_bdd_variables_, '0');
+  std::vector<bool> lasso_statuses;
+  int cycle_head = GetUnaryLasso(unary_symbol, lasso_statuses);
+  auto binary_auto = BinaryIntAutomaton::MakeAutomaton(lasso_statuses, cycle_head, var_name, formula, has_negative_1);
+  DVLOG(VLOG_LEVEL) << binary_auto->getId() << " = [" << this->id_ << "]->toBinaryIntAutomaton(" << var_name << ")";
+  return binary_auto;
+}
+
 ArithmeticFormula_ptr IntAutomaton::GetFormula() {
 	return formula_;
 }
@@ -106,12 +106,13 @@ public:
   int getAnAcceptingInt();
 
   UnaryAutomaton_ptr toUnaryAutomaton();
+  BinaryIntAutomaton_ptr toBinaryIntAutomaton(std::string var_name, ArithmeticFormula_ptr formula);
 
   ArithmeticFormula_ptr GetFormula();
   void SetFormula(ArithmeticFormula_ptr);
 
   static const int INFINITE;
-  static int DEFAULT_NUM_OF_VARIABLES;
+  static thread_local int DEFAULT_NUM_OF_VARIABLES;  // set with the encoding of the string automata
 protected:
   IntAutomaton_ptr __plus(IntAutomaton_ptr other_auto);
   IntAutomaton_ptr __minus(IntAutomaton_ptr other_auto);
@@ -15,6 +15,11 @@ bool StringAutomaton::debug = false;
 
 StringAutomaton::TransitionTable StringAutomaton::TRANSITION_TABLE;
 
+thread_local int StringAutomaton::VAR_PER_TRACK = 9;
+thread_local int StringAutomaton::DEFAULT_NUM_OF_VARIABLES = 8;
+thread_local StringEncoding StringAutomaton::encoding_;
+thread_local StringAutomaton::Context* StringAutomaton::Context::current_ = nullptr;
+
 StringAutomaton::StringAutomaton(const DFA_ptr dfa, const int number_of_bdd_variables)
 		:	Automaton(Automaton::Type::MULTITRACK, dfa, number_of_bdd_variables),
 			num_tracks_(number_of_bdd_variables > DEFAULT_NUM_OF_VARIABLES ? number_of_bdd_variables / VAR_PER_TRACK : 1),
@@ -174,6 +179,46 @@ StringAutomaton_ptr StringAutomaton::clone() const {
 	return result_auto;
 }
 
+StringAutomaton::Context::Context() {
+}
+
+StringAutomaton::Context::Scope::Scope(Context* context)
+    : previous_ { current_ } {
+  current_ = context;
+  if (context != previous_) {
+    StringAutomaton::SetEncoding(context->encoding_);
+  }
+}
+
+StringAutomaton::Context::Scope::~Scope() {
+  if (previous_ != nullptr and previous_ != current_) {
+    current_ = previous_;
+    StringAutomaton::SetEncoding(previous_->encoding_);
+  }
+  current_ = previous_;
+}
+
+void StringAutomaton::SetEncoding(const StringEncoding& encoding) {
+  if (Context::current_ != nullptr and &Context::current_->encoding_ != &encoding) {
+    Context::current_->encoding_ = encoding;
+  }
+  encoding_ = encoding;
+  // length and index automata share the alphabet of string automata
+  DEFAULT_NUM_OF_VARIABLES = encoding_.get_number_of_bits();
+  VAR_PER_TRACK = DEFAULT_NUM_OF_VARIABLES + 1;
+  IntAutomaton::DEFAULT_NUM_OF_VARIABLES = DEFAULT_NUM_OF_VARIABLES;
+  if (encoding_.get_character_width() > StringEncoding::DEFAULT_CHARACTER_WIDTH) {
+    Util::RegularExpression::DEFAULT |= Util::RegularExpression::UNICODE;
+  } else {
+    Util::RegularExpression::DEFAULT &= ~Util::RegularExpression::UNICODE;
+  }
+  DVLOG(VLOG_LEVEL) << "StringAutomaton::SetEncoding(" << encoding_.str() << ")";
+}
+
+const StringEncoding& StringAutomaton::GetEncoding() {
+  return encoding_;
+}
+
 StringAutomaton_ptr StringAutomaton::MakePhi(const int number_of_bdd_variables) {
   DFA_ptr non_accepting_string_dfa = Automaton::DFAMakePhi(number_of_bdd_variables);
   StringAutomaton_ptr non_accepting_string_auto = new StringAutomaton(non_accepting_string_dfa, number_of_bdd_variables);
@@ -209,7 +254,8 @@ StringAutomaton_ptr StringAutomaton::MakeString(const std::string str, const int
     return StringAutomaton::MakeEmptyString();
   }
 
-  const int str_length = str.length();
+  const std::vector<unsigned long> characters = encoding_.GetCharacters(str);
+  const int str_length = characters.size();
   const int number_of_states = str_length + 2;
   char* statuses = new char[number_of_states];
 
@@ -217,7 +263,7 @@ StringAutomaton_ptr StringAutomaton::MakeString(const std::string str, const int
 
   for (int i = 0; i < str_length; i++) {
     dfaAllocExceptions(1);
-    dfaStoreException(i + 1, const_cast<char*>(GetBinaryStringMSB((unsigned long) str[i], number_of_bdd_variables).data()));
+    dfaStoreException(i + 1, const_cast<char*>(GetBinaryStringMSB(encoding_.Encode(characters[i]), number_of_bdd_variables).data()));
     dfaStoreState(str_length + 1);
     statuses[i] = '-';
   }
@@ -262,25 +308,27 @@ StringAutomaton_ptr StringAutomaton::MakeAnyOtherString(const std::string str, c
   return not_contains_me_auto;
 }
 
-StringAutomaton_ptr StringAutomaton::MakeCharRange(const char from, const char to, const int number_of_bdd_variables) {
-  unsigned long from_char = (unsigned long) from;
-  unsigned long to_char = (unsigned long) to;
-  if (from_char > to_char) {
-    std::swap(from_char, to_char);
-  }
+StringAutomaton_ptr StringAutomaton::MakeCharRange(const unsigned long from, const unsigned long to, const int number_of_bdd_variables) {
+  const unsigned long last_char = encoding_.get_alphabet_size() - 1;
+  const unsigned long from_char = std::min(std::min(from, to), last_char);
+  const unsigned long to_char = std::min(std::max(from, to), last_char);
 
   char statuses[3] { '-', '+', '-' };
   int* variable_indices = GetBddVariableIndices(number_of_bdd_variables);
 
   dfaSetup(3, number_of_bdd_variables, variable_indices);
 
-  int initial_state = to_char - from_char;
+  // characters of a class share a code; a range of codes is covered by a few transitions with don't care bits
+  std::vector<std::string> transitions;
+  for (auto& code_range : encoding_.EncodeRange(from_char, to_char)) {
+    auto range_transitions = GetBinaryRangeMSB(code_range.first, code_range.second, number_of_bdd_variables);
+    transitions.insert(transitions.end(), range_transitions.begin(), range_transitions.end());
+  }
 
   //state 0
-  dfaAllocExceptions(initial_state + 1);
-  for (unsigned long index = from_char; index <= to_char; index++) {
-    std::vector<char> v = GetBinaryFormat(index,number_of_bdd_variables);
-    dfaStoreException(1, const_cast<char*>(GetBinaryStringMSB(index, number_of_bdd_variables).data()));
+  dfaAllocExceptions(transitions.size());
+  for (auto& transition : transitions) {
+    dfaStoreException(1, const_cast<char*>(transition.data()));
   }
   dfaStoreState(2);
 
@@ -295,7 +343,7 @@ StringAutomaton_ptr StringAutomaton::MakeCharRange(const char from, const char t
   DFA_ptr range_dfa = dfaBuild(statuses);
   StringAutomaton_ptr range_auto = new StringAutomaton(range_dfa, number_of_bdd_variables);
 
-  DVLOG(VLOG_LEVEL) << range_auto->id_ << " = MakeCharRange('" << from << "', '" << to << "')";
+  DVLOG(VLOG_LEVEL) << range_auto->id_ << " = MakeCharRange('" << encoding_.GetString(from) << "', '" << encoding_.GetString(to) << "')";
 
   return range_auto;
 }
@@ -315,6 +363,10 @@ StringAutomaton_ptr StringAutomaton::MakeRegexAuto(const std::string regex, cons
 }
 
 StringAutomaton_ptr StringAutomaton::MakeRegexAuto(Util::RegularExpression_ptr regular_expression, const int number_of_bdd_variables) {
+  if (Util::Budget::IsExceeded()) {
+    // the query is stopped, remaining sub-expressions are not built and the result is not used
+    return StringAutomaton::MakePhi(number_of_bdd_variables);
+  }
   StringAutomaton_ptr regex_auto = nullptr;
   StringAutomaton_ptr regex_expr1_auto = nullptr;
   StringAutomaton_ptr regex_expr2_auto = nullptr;
@@ -372,7 +424,7 @@ StringAutomaton_ptr StringAutomaton::MakeRegexAuto(Util::RegularExpression_ptr r
     delete regex_expr1_auto;
     break;
   case Util::RegularExpression::Type::CHAR:
-    regex_auto = StringAutomaton::MakeString(std::string(1, regular_expression->get_character()), number_of_bdd_variables);
+    regex_auto = StringAutomaton::MakeString(encoding_.GetString(regular_expression->get_character()), number_of_bdd_variables);
     break;
   case Util::RegularExpression::Type::CHAR_RANGE:
     regex_auto = StringAutomaton::MakeCharRange(regular_expression->get_from_character(), regular_expression->get_to_character(), number_of_bdd_variables);
@@ -501,256 +553,26 @@ StringAutomaton_ptr StringAutomaton::MakeAutomaton(StringFormula_ptr formula) {
 }
 
 StringAutomaton_ptr StringAutomaton::MakeBegins(StringFormula_ptr formula) {
-	StringAutomaton_ptr result_auto = nullptr;
-	DFA_ptr temp_dfa, result_dfa;
-	int num_tracks = formula->GetNumberOfVariables(),
-			left_track,right_track;
-	std::string left_data,right_data;
-	TransitionVector tv;
-
-	left_track = formula->GetVariableIndex(1);
-	right_track = formula->GetVariableIndex(2);
-
-	int var = VAR_PER_TRACK;
-	int len = num_tracks * var;
-	int *mindices = Automaton::GetBddVariableIndices(num_tracks*var);
-
-	std::vector<char> exep_lambda(var,'1');
-	tv = GenerateTransitionsForRelation(StringFormula::Type::EQ,var);
-	dfaSetup(4,len,mindices);
-	dfaAllocExceptions(2*tv.size() + 1); // 1 extra for lambda stuff below
-	for(int i = 0; i < tv.size(); i++) {
-		std::vector<char> str(len,'X');
-		for(int k = 0; k < var; k++) {
-			str[left_track+num_tracks*k] = tv[i].first[k];
-			str[right_track+num_tracks*k] = tv[i].second[k];
-		}
-		str.push_back('\0');
-		dfaStoreException(0,&str[0]);
-	}
-
-	// if right is lambda, left can be anything, but go to next state
-	for(int i = 0; i < tv.size(); i++) {
-		std::vector<char> str(len,'X');
-		for (int k = 0; k < var; k++) {
-			str[left_track+num_tracks*k] = tv[i].first[k];
-			str[right_track+num_tracks*k] = exep_lambda[k];
-		}
-		str.push_back('\0');
-		dfaStoreException(1,&str[0]);
-	}
-
-	// if both are lambda, go to next state
-	std::vector<char> str(len,'X');
-	str = std::vector<char>(len,'X');
-	for(int k = 0; k < var; k++) {
-		str[left_track+num_tracks*k] = exep_lambda[k];
-		str[right_track+num_tracks*k] = exep_lambda[k];
-	}
-	str.push_back('\0');
-	dfaStoreException(2,&str[0]);
-	dfaStoreState(3);
-
-	// left anything, right lambda, loop back here
-	dfaAllocExceptions(tv.size()+1);
-	for(int i = 0; i < tv.size(); i++) {
-		std::vector<char> str(len,'X');
-		for (int k = 0; k < var; k++) {
-			str[left_track+num_tracks*k] = tv[i].first[k];
-			str[right_track+num_tracks*k] = exep_lambda[k];
-		}
-		str.push_back('\0');
-		dfaStoreException(1,&str[0]);
-	}
-	// if both lambda, goto 2
-	str = std::vector<char>(len,'X');
-	for(int k = 0; k < var; k++) {
-		str[left_track+num_tracks*k] = exep_lambda[k];
-		str[right_track+num_tracks*k] = exep_lambda[k];
-	}
-	str.push_back('\0');
-	dfaStoreException(2,&str[0]);
-	dfaStoreState(3);
-
-	// lambda/lambda state, loop back on lambda
-	dfaAllocExceptions(1);
-	dfaStoreException(2,&str[0]);
-	dfaStoreState(3);
-
-	// sink
-	dfaAllocExceptions(0);
-	dfaStoreState(3);
-
-	temp_dfa = dfaBuild("--+-");
-	result_dfa = dfaMinimize(temp_dfa);
-	dfaFree(temp_dfa);
-	result_auto = new StringAutomaton(result_dfa,formula,var*num_tracks);
+	int num_tracks = formula->GetNumberOfVariables();
+	int left_track = formula->GetVariableIndex(1);
+	int right_track = formula->GetVariableIndex(2);
+	DFA_ptr result_dfa = MakeBeginsDfa(VAR_PER_TRACK,num_tracks,left_track,right_track);
+	StringAutomaton_ptr result_auto = new StringAutomaton(result_dfa,formula,VAR_PER_TRACK*num_tracks);
 	DVLOG(VLOG_LEVEL) << result_auto->id_ << " = MakeBegins(" << formula->str() << ")";
 	return result_auto;
 }
 
 StringAutomaton_ptr StringAutomaton::MakeNotBegins(StringFormula_ptr formula) {
-	StringAutomaton_ptr result_auto = nullptr;
-	DFA_ptr temp_dfa, result_dfa;
-	int num_tracks = formula->GetNumberOfVariables(),
-			left_track,right_track;
-	std::string left_data,right_data;
-	TransitionVector tv;
-
-	left_track = formula->GetVariableIndex(1);
-	right_track = formula->GetVariableIndex(2);
-
-	int eq_eq = 0, lambda_star = 1, not_eq_eq = 2,
-			lambda_lambda = 3, star_lambda = 4, sink = 5;
-	int var = VAR_PER_TRACK;
-	int len = num_tracks * var;
-	int *mindices = Automaton::GetBddVariableIndices(num_tracks*var);
-	std::vector<char> exep_lambda(var,'1');
-	tv = GenerateTransitionsForRelation(StringFormula::Type::EQ,var);
-
-	dfaSetup(6,len,mindices);
-	// ------init/eq_eq state
-	// if both the same, and not lambda, loop back
-	dfaAllocExceptions(3*tv.size() + 1); // 1 extra for lambda stuff below
-	for(int i = 0; i < tv.size(); i++) {
-		std::vector<char> str(len,'X');
-		for(int k = 0; k < var; k++) {
-			str[left_track+num_tracks*k] = tv[i].first[k];
-			str[right_track+num_tracks*k] = tv[i].second[k];
-		}
-		str.push_back('\0');
-		dfaStoreException(eq_eq,&str[0]);
-	}
-
-	// if left is lambda, right can be anything, but go to lambda_star
-	// but if right is lambda, goto sink
-	for(int i = 0; i < tv.size(); i++) {
-		std::vector<char> str(len,'X');
-		for (int k = 0; k < var; k++) {
-			str[left_track+num_tracks*k] = exep_lambda[k];
-			str[right_track+num_tracks*k] = tv[i].first[k];
-		}
-		str.push_back('\0');
-		dfaStoreException(lambda_star,&str[0]);
-
-		for (int k = 0; k < var; k++) {
-			str[left_track+num_tracks*k] = tv[i].first[k];
-			str[right_track+num_tracks*k] = exep_lambda[k];
-		}
-		dfaStoreException(sink,&str[0]);
-	}
-
-	// if both are lambda, go to sink
-	std::vector<char> str(len,'X');
-	str = std::vector<char>(len,'X');
-	for(int k = 0; k < var; k++) {
-		str[left_track+num_tracks*k] = exep_lambda[k];
-		str[right_track+num_tracks*k] = exep_lambda[k];
-	}
-	str.push_back('\0');
-	dfaStoreException(sink,&str[0]);
-	// otherwise, go to not_eq_eq
-	dfaStoreState(not_eq_eq);
-
-
-	// ------ lambda_star state
-	// left lambda, right star, loop back here
-	dfaAllocExceptions(tv.size() + 1);
-	for(int i = 0; i < tv.size(); i++) {
-		std::vector<char> str(len,'X');
-		for (int k = 0; k < var; k++) {
-			str[left_track+num_tracks*k] = exep_lambda[k];
-			str[right_track+num_tracks*k] = tv[i].first[k];
-		}
-		str.push_back('\0');
-		dfaStoreException(lambda_star,&str[0]);
-	}
-	// if both lambda, goto lambda_lambda
-	str = std::vector<char>(len,'X');
-	for(int k = 0; k < var; k++) {
-		str[left_track+num_tracks*k] = exep_lambda[k];
-		str[right_track+num_tracks*k] = exep_lambda[k];
-	}
-	str.push_back('\0');
-	dfaStoreException(lambda_lambda,&str[0]);
-	// otherwise, goto sink
-	dfaStoreState(sink);
-
-
-
-	// ------ not_eq_eq state
-	// on lambda_star goto lambda_star,
-	// star_lambda goto star_lambda,
-	// lambda_lambda goto lambda,
-	// else loop back
-	dfaAllocExceptions(tv.size()*2 + 1);
-	for(int i = 0; i < tv.size(); i++) {
-		std::vector<char> str(len,'X');
-		for (int k = 0; k < var; k++) {
-			str[left_track+num_tracks*k] = exep_lambda[k];
-			str[right_track+num_tracks*k] = tv[i].first[k];
-		}
-		str.push_back('\0');
-		dfaStoreException(lambda_star,&str[0]);
-
-		for (int k = 0; k < var; k++) {
-			str[left_track+num_tracks*k] = tv[i].first[k];
-			str[right_track+num_tracks*k] = exep_lambda[k];
-		}
-		dfaStoreException(star_lambda,&str[0]);
-	}
-	str = std::vector<char>(len,'X');
-	for(int k = 0; k < var; k++) {
-		str[left_track+num_tracks*k] = exep_lambda[k];
-		str[right_track+num_tracks*k] = exep_lambda[k];
-	}
-	str.push_back('\0');
-	dfaStoreException(lambda_lambda,&str[0]);
-	dfaStoreState(not_eq_eq);
-
-
-
-
-	// ------ lambda/lambda state, loop back on lambda
-	dfaAllocExceptions(1);
-	dfaStoreException(lambda_lambda,&str[0]);
-	dfaStoreState(sink);
-
-
-
-
-	// ------ star/lambda state
-	// loop back on star/lambda, goto lambda_lambda on lambda/lambda
-	// if right is lambda, left can be anything, but go to next state
-	dfaAllocExceptions(tv.size() + 1);
-	for(int i = 0; i < tv.size(); i++) {
-		std::vector<char> str(len,'X');
-		for (int k = 0; k < var; k++) {
-			str[left_track+num_tracks*k] = tv[i].first[k];
-			str[right_track+num_tracks*k] = exep_lambda[k];
-		}
-		str.push_back('\0');
-		dfaStoreException(star_lambda,&str[0]);
-	}
-
-	// if both are lambda, go to next state
-	str = std::vector<char>(len,'X');
-	for(int k = 0; k < var; k++) {
-		str[left_track+num_tracks*k] = exep_lambda[k];
-		str[right_track+num_tracks*k] = exep_lambda[k];
-	}
-	str.push_back('\0');
-	dfaStoreException(lambda_lambda,&str[0]);
-	dfaStoreState(sink);
-
-	// sink
-	dfaAllocExceptions(0);
-	dfaStoreState(sink);
-
-	temp_dfa = dfaBuild("---+--");
-	result_dfa = dfaMinimize(temp_dfa);
-	dfaFree(temp_dfa);
-	result_auto = new StringAutomaton(result_dfa,formula,var*num_tracks);
+	int num_tracks = formula->GetNumberOfVariables();
+	int left_track = formula->GetVariableIndex(1);
+	int right_track = formula->GetVariableIndex(2);
+	// aligned pairs where the right track is not a prefix of the left track
+	DFA_ptr aligned_dfa = MakeBinaryAlignedDfa(left_track,right_track,num_tracks);
+	DFA_ptr begins_dfa = MakeBeginsDfa(VAR_PER_TRACK,num_tracks,left_track,right_track);
+	DFA_ptr result_dfa = Automaton::DFADifference(aligned_dfa,begins_dfa);
+	dfaFree(aligned_dfa);
+	dfaFree(begins_dfa);
+	StringAutomaton_ptr result_auto = new StringAutomaton(result_dfa,formula,VAR_PER_TRACK*num_tracks);
 	DVLOG(VLOG_LEVEL) << result_auto->id_ << " = MakeNotBegins(" << formula->str() << ")";
 	return result_auto;
 }
@@ -1625,6 +1447,9 @@ StringAutomaton_ptr StringAutomaton::SuffixesAtIndex(int index) {
 }
 
 StringAutomaton_ptr StringAutomaton::SuffixesAtIndex(IntAutomaton_ptr indices_auto) {
+  if (Option::Theory::DIRECT_INDEX_CONSTRUCTIONS) {
+    return this->SuffixesAtIndexDirect(indices_auto);
+  }
   StringAutomaton_ptr prefix_suffix_auto = MakePrefixSuffix(0,1,2,3);
   StringAutomaton_ptr original_string_auto = new StringAutomaton(this->getDFA(),0,3,DEFAULT_NUM_OF_VARIABLES);
   StringAutomaton_ptr position_auto = new StringAutomaton(indices_auto->getDFA(),1,3,DEFAULT_NUM_OF_VARIABLES);
@@ -2120,22 +1945,28 @@ StringAutomaton_ptr StringAutomaton::SubString(IntAutomaton_ptr start_auto, IntA
   //   return StringAutomaton::MakeEmptyString();
   // }
 
-  StringAutomaton_ptr suffixes_auto = this->SuffixesAtIndex(start_auto);
-  auto string_end_indices = new StringAutomaton(dfaCopy(length_auto->getDFA()),DEFAULT_NUM_OF_VARIABLES);
-  auto string_length_auto = string_end_indices->Prefixes();
+  StringAutomaton_ptr ret_auto = nullptr;
+  if (Option::Theory::DIRECT_INDEX_CONSTRUCTIONS) {
+    ret_auto = this->SubStringDirect(start_auto, length_auto);
+  } else {
+    StringAutomaton_ptr suffixes_auto = this->SuffixesAtIndex(start_auto);
+    auto string_end_indices = new StringAutomaton(dfaCopy(length_auto->getDFA()),DEFAULT_NUM_OF_VARIABLES);
+    auto string_length_auto = string_end_indices->Prefixes();
 
-  // s1 is prefixesAtIndex
-  // s2 is prefixesBeforeIndex
-  auto s0 = suffixes_auto->Prefixes();
-  auto s1 = s0->Intersect(string_end_indices);
-  auto s2 = suffixes_auto->Intersect(string_length_auto);
-  auto ret_auto = s1->Union(s2);
+    // s1 is prefixesAtIndex
+    // s2 is prefixesBeforeIndex
+    auto s0 = suffixes_auto->Prefixes();
+    auto s1 = s0->Intersect(string_end_indices);
+    auto s2 = suffixes_auto->Intersect(string_length_auto);
+    ret_auto = s1->Union(s2);
 
-  delete s0;
-  delete s1;
-  delete s2;
-  delete string_length_auto;
-  delete string_end_indices;
+    delete s0;
+    delete s1;
+    delete s2;
+    delete string_length_auto;
+    delete string_end_indices;
+    delete suffixes_auto;
+  }
 
   // if either length_auto or start_auto has negative1, substring should
   // also contain the empty string (per SMT specs)
@@ -2355,20 +2186,29 @@ IntAutomaton_ptr StringAutomaton::IndexOf(StringAutomaton_ptr search_auto, IntAu
 	// find all the places where search_param *could* be
 	// note that we could use suffixes_auto to find this, but that would mean an extra concat
 	// with valid_indexes_auto which could potentially be less precise
-  auto concat1_auto = string_length_auto->Concat(any_string_auto);
-	auto concat2_auto = search_param_auto->Concat(any_string_auto);
-  auto prefix_suffix_auto = MakePrefixSuffix(this->getDFA(),concat1_auto->getDFA(),concat2_auto->getDFA(),8);
-  auto temp_auto = prefix_suffix_auto->GetKTrack(1);
-
-  delete prefix_suffix_auto;
-  delete concat1_auto;
-  delete concat2_auto;
+  IntAutomaton_ptr match_indices_auto = nullptr;
+  if (Option::Theory::DIRECT_INDEX_CONSTRUCTIONS) {
+    // matches are found for each subject string, not only on the prefixes of the subject language
+    match_indices_auto = this->MatchIndicesDirect(search_param_auto, valid_lengths_auto);
+  } else {
+    auto concat1_auto = string_length_auto->Concat(any_string_auto);
+    auto concat2_auto = search_param_auto->Concat(any_string_auto);
+    auto prefix_suffix_auto = MakePrefixSuffix(this->getDFA(),concat1_auto->getDFA(),concat2_auto->getDFA(),DEFAULT_NUM_OF_VARIABLES);
+    auto temp_auto = prefix_suffix_auto->GetKTrack(1);
+    match_indices_auto = temp_auto->Length();
+
+    delete prefix_suffix_auto;
+    delete concat1_auto;
+    delete concat2_auto;
+    delete temp_auto;
+  }
 
 	// if no match is found, return -1 as the result
-	if(temp_auto->IsEmptyLanguage() && !search_param_auto->IsEmptyLanguage()) {
+	if(match_indices_auto->IsEmptyLanguage() && !search_param_auto->IsEmptyLanguage()) {
 	  indexof_auto = IntAutomaton::makeInt(-1);
+	  delete match_indices_auto;
 	} else {
-    indexof_auto = temp_auto->Length();
+    indexof_auto = match_indices_auto;
     indexof_auto->setMinus1(negative_index);
   }
 
@@ -2381,7 +2221,6 @@ IntAutomaton_ptr StringAutomaton::IndexOf(StringAutomaton_ptr search_auto, IntAu
   }
 
   delete valid_lengths_auto;
-	delete temp_auto;
 
   DVLOG(VLOG_LEVEL) << indexof_auto->getId() << " = [" << this->id_ << "]->indexOf(" << search_auto->id_ << "," << from_index_auto->getId() << ")";
 	
@@ -2504,23 +2343,8 @@ StringAutomaton_ptr StringAutomaton::Ends(StringAutomaton_ptr search_auto) {
 }
 
 StringAutomaton_ptr StringAutomaton::ToUpperCase() {
-	CHECK_EQ(this->num_tracks_,1);
-  DFA_ptr upper_case_dfa = nullptr;
-  StringAutomaton_ptr upper_case_auto = nullptr;
-
-  int var = this->num_of_bdd_variables_;
-	int nvar = var+1;
-
-	// dfa1 will have var+1 indices, with all valid transitions having extrabit=0
-	DFA_ptr dfa1 = Automaton::DFAExtendExtrabit(this->dfa_,var);
-	int *indices = Automaton::GetBddVariableIndices(nvar);
-
-  upper_case_dfa = Automaton::dfaToUpperCase(dfa1, nvar, indices);
-  DFA_ptr temp_dfa = Automaton::DFAProjectAway(upper_case_dfa,var);
-  dfaFree(upper_case_dfa);
-
-  upper_case_auto = new StringAutomaton(temp_dfa,var);
-
+  CHECK_EQ(this->num_tracks_,1);
+  StringAutomaton_ptr upper_case_auto = this->Transduce(StringAutomaton::MakeToUpperCaseTransducer());
 
   DVLOG(VLOG_LEVEL) << upper_case_auto->id_ << " = [" << this->id_ << "]->toUpperCase()";
 
@@ -2529,21 +2353,7 @@ StringAutomaton_ptr StringAutomaton::ToUpperCase() {
 
 StringAutomaton_ptr StringAutomaton::ToLowerCase() {
   CHECK_EQ(this->num_tracks_,1);
-  DFA_ptr lower_case_dfa = nullptr;
-  StringAutomaton_ptr lower_case_auto = nullptr;
-
-  int var = this->num_of_bdd_variables_;
-	int nvar = var+1;
-
-	// dfa1 will have var+1 indices, with all valid transitions having extrabit=0
-	DFA_ptr dfa1 = Automaton::DFAExtendExtrabit(this->dfa_,var);
-	int *indices = Automaton::GetBddVariableIndices(nvar);
-
-	lower_case_dfa = Automaton::dfaToLowerCase(dfa1, nvar, indices);
-
-	DFA_ptr temp_dfa = Automaton::DFAProjectAway(lower_case_dfa,var);
-	dfaFree(lower_case_dfa);
-	lower_case_auto = new StringAutomaton(temp_dfa, var);
+  StringAutomaton_ptr lower_case_auto = this->Transduce(StringAutomaton::MakeToLowerCaseTransducer());
 
   DVLOG(VLOG_LEVEL) << lower_case_auto->id_ << " = [" << this->id_ << "]->toLowerCase()";
 
@@ -2551,12 +2361,8 @@ StringAutomaton_ptr StringAutomaton::ToLowerCase() {
 }
 
 StringAutomaton_ptr StringAutomaton::Trim(char c) {
-	CHECK_EQ(this->num_tracks_,1);
-  StringAutomaton_ptr trimmed_auto = nullptr;
-
-  auto trim_left = this->TrimPrefix(c);
-  trimmed_auto = trim_left->TrimSuffix(c);
-  delete trim_left;
+  CHECK_EQ(this->num_tracks_,1);
+  StringAutomaton_ptr trimmed_auto = this->Transduce(StringAutomaton::MakeTrimTransducer(c));
 
   DVLOG(VLOG_LEVEL) << trimmed_auto->id_ << " = [" << this->id_ << "]->trim()";
 
@@ -2619,7 +2425,17 @@ StringAutomaton_ptr StringAutomaton::Replace(StringAutomaton_ptr search_auto,
 	CHECK_EQ(this->num_tracks_,1);
   DFA_ptr result_dfa = nullptr, temp_dfa = nullptr;
   StringAutomaton_ptr result_auto = nullptr,temp_auto = nullptr;
-  //LOG(FATAL) << "implement me";
+
+  // constant search strings are replaced with a transducer, regular search patterns use the auxiliary bit construction
+  if (search_auto->IsAcceptingSingleString()) {
+    const std::string search_string = search_auto->GetAnAcceptingString();
+    if (not search_string.empty()) {
+      result_auto = this->Transduce(StringAutomaton::MakeReplaceTransducer(search_string, replace_auto));
+      DVLOG(VLOG_LEVEL) << result_auto->id_ << " = [" << this->id_ << "]->replace(" << search_auto->id_ << ", " << replace_auto->id_ << ")";
+      return result_auto;
+    }
+  }
+
   int var = this->num_of_bdd_variables_;
   int nvar = var+1;
 
@@ -2643,6 +2459,72 @@ StringAutomaton_ptr StringAutomaton::Replace(StringAutomaton_ptr search_auto,
   return result_auto;
 }
 
+StringAutomaton_ptr StringAutomaton::Transduce(const Transducer& transducer) {
+  CHECK_EQ(this->num_tracks_,1);
+  CHECK_EQ(this->num_of_bdd_variables_, transducer.get_number_of_bits());
+  StringAutomaton_ptr result_auto = new StringAutomaton(transducer.Image(this->dfa_), this->num_of_bdd_variables_);
+
+  DVLOG(VLOG_LEVEL) << result_auto->id_ << " = [" << this->id_ << "]->transduce()";
+
+  return result_auto;
+}
+
+StringAutomaton_ptr StringAutomaton::PreTransduce(const Transducer& transducer, StringAutomaton_ptr range_auto) {
+  CHECK_EQ(this->num_tracks_,1);
+  CHECK_EQ(this->num_of_bdd_variables_, transducer.get_number_of_bits());
+  StringAutomaton_ptr result_auto = new StringAutomaton(transducer.PreImage(this->dfa_), this->num_of_bdd_variables_);
+
+  if (range_auto not_eq nullptr) {
+    StringAutomaton_ptr tmp_auto = result_auto;
+    result_auto = tmp_auto->Intersect(range_auto);
+    delete tmp_auto;
+  }
+
+  DVLOG(VLOG_LEVEL) << result_auto->id_ << " = [" << this->id_ << "]->preTransduce()";
+
+  return result_auto;
+}
+
+/**
+ * Case conversions flip a bit of the character, they are only defined on uncompressed alphabets
+ */
+Transducer StringAutomaton::MakeToUpperCaseTransducer() {
+  CHECK(encoding_.is_identity()) << "case conversion needs an uncompressed alphabet";
+  return Transducer::MakeToUpperCase(DEFAULT_NUM_OF_VARIABLES);
+}
+
+Transducer StringAutomaton::MakeToLowerCaseTransducer() {
+  CHECK(encoding_.is_identity()) << "case conversion needs an uncompressed alphabet";
+  return Transducer::MakeToLowerCase(DEFAULT_NUM_OF_VARIABLES);
+}
+
+Transducer StringAutomaton::MakeTrimTransducer(char c) {
+  return Transducer::MakeTrim(encoding_.Encode(static_cast<unsigned char>(c)), DEFAULT_NUM_OF_VARIABLES);
+}
+
+Transducer StringAutomaton::MakeReplaceTransducer(const std::string& search, const std::string& replace) {
+  std::vector<unsigned long> search_codes, replace_codes;
+  for (auto character : encoding_.GetCharacters(search)) {
+    search_codes.push_back(encoding_.Encode(character));
+  }
+  for (auto character : encoding_.GetCharacters(replace)) {
+    replace_codes.push_back(encoding_.Encode(character));
+  }
+  return Transducer::MakeReplace(search_codes, replace_codes, DEFAULT_NUM_OF_VARIABLES);
+}
+
+Transducer StringAutomaton::MakeReplaceTransducer(const std::string& search, StringAutomaton_ptr replace_auto) {
+  CHECK_EQ(replace_auto->num_tracks_, 1);
+  if (replace_auto->IsAcceptingSingleString()) {
+    return MakeReplaceTransducer(search, replace_auto->GetAnAcceptingString());
+  }
+  std::vector<unsigned long> search_codes;
+  for (auto character : encoding_.GetCharacters(search)) {
+    search_codes.push_back(encoding_.Encode(character));
+  }
+  return Transducer::MakeReplace(search_codes, replace_auto->dfa_, DEFAULT_NUM_OF_VARIABLES);
+}
+
 StringAutomaton_ptr StringAutomaton::GetAnyStringNotContainsMe() {
 	CHECK_EQ(this->num_tracks_,1);
 	StringAutomaton_ptr not_contains_auto = nullptr, any_string_auto = nullptr,
@@ -2885,6 +2767,217 @@ IntAutomaton_ptr StringAutomaton::ParseToIntAutomaton() {
   return int_auto;
 }
 
+/**
+ * Values of the prefixes that reach a state are propagated along the digit transitions with the linear relation of
+ * appending a digit, the cost depends on the number of digits of the integer width instead of the numeric range.
+ */
+BinaryIntAutomaton_ptr StringAutomaton::ParseToBinaryIntAutomaton(std::string var_name, ArithmeticFormula_ptr formula) {
+  CHECK_EQ(this->num_tracks_,1);
+  auto digits_auto = StringAutomaton::MakeRegexAuto("[0-9]+");
+  auto numeric_auto = this->Intersect(digits_auto);
+  auto non_numeric_auto = this->Difference(digits_auto);
+  const bool has_negative_1 = not non_numeric_auto->IsEmptyLanguage();
+  delete digits_auto;
+  delete non_numeric_auto;
+
+  const BigInteger max_value = (BigInteger(1) << (Option::Theory::INTEGER_WIDTH - 1)) - 1;
+  DFA_ptr low_dfa = MakeLinearDFA({1}, -max_value, ArithmeticFormula::Type::LE);
+  DFA_ptr non_negative_dfa = MakeLinearDFA({1}, 0, ArithmeticFormula::Type::GE);
+  DFA_ptr tmp_dfa = low_dfa;
+  low_dfa = DFAIntersect(tmp_dfa, non_negative_dfa);
+  dfaFree(tmp_dfa);
+  dfaFree(non_negative_dfa);
+  DFA_ptr high_dfa = MakeLinearDFA({1}, -max_value, ArithmeticFormula::Type::GT);
+  DFA_ptr zero_dfa = MakeLinearDFA({1}, 0, ArithmeticFormula::Type::EQ);
+  std::vector<DFA_ptr> digit_dfas (10, nullptr);
+
+  DFA_ptr numeric_dfa = numeric_auto->getDFA();
+  auto digit_transitions = GetDigitTransitions(numeric_dfa, num_of_bdd_variables_);
+  // values of the non-empty prefixes that reach a state
+  std::vector<DFA_ptr> values (numeric_dfa->ns, nullptr);
+  std::stack<int> pending;
+  std::vector<bool> is_pending (numeric_dfa->ns, false);
+  auto add_values = [&](const int state, const DFA_ptr from_values, const int digit) {
+    if (digit_dfas[digit] == nullptr) {
+      digit_dfas[digit] = MakeDecimalDigitDFA(digit, true);
+    }
+    DFA_ptr next_dfa = ApplyDecimalDigit(from_values, digit_dfas[digit]);
+    DFA_ptr bounded_dfa = BoundIntegerValues(next_dfa, low_dfa, high_dfa);
+    dfaFree(next_dfa);
+    if (values[state] == nullptr) {
+      values[state] = bounded_dfa;
+    } else {
+      DFA_ptr union_dfa = DFAUnion(values[state], bounded_dfa);
+      dfaFree(bounded_dfa);
+      if (DFAIsEqual(union_dfa, values[state])) {
+        dfaFree(union_dfa);
+        return;
+      }
+      dfaFree(values[state]);
+      values[state] = union_dfa;
+    }
+    if (not is_pending[state]) {
+      is_pending[state] = true;
+      pending.push(state);
+    }
+  };
+
+  for (auto& transition : digit_transitions[numeric_dfa->s]) {
+    add_values(transition.second, zero_dfa, transition.first);
+  }
+  while (not pending.empty()) {
+    const int state = pending.top();
+    pending.pop();
+    is_pending[state] = false;
+    for (auto& transition : digit_transitions[state]) {
+      add_values(transition.second, values[state], transition.first);
+    }
+  }
+
+  DFA_ptr result_dfa = DFAMakePhi(1);
+  for (int s = 0; s < numeric_dfa->ns; ++s) {
+    if (values[s] != nullptr and numeric_auto->IsAcceptingState(s)) {
+      tmp_dfa = result_dfa;
+      result_dfa = DFAUnion(tmp_dfa, values[s]);
+      dfaFree(tmp_dfa);
+    }
+  }
+  if (has_negative_1) {
+    DFA_ptr negative_1_dfa = MakeLinearDFA({1}, 1, ArithmeticFormula::Type::EQ);
+    tmp_dfa = result_dfa;
+    result_dfa = DFAUnion(tmp_dfa, negative_1_dfa);
+    dfaFree(tmp_dfa);
+    dfaFree(negative_1_dfa);
+  }
+
+  for (auto values_dfa : values) {
+    if (values_dfa != nullptr) {
+      dfaFree(values_dfa);
+    }
+  }
+  for (auto digit_dfa : digit_dfas) {
+    if (digit_dfa != nullptr) {
+      dfaFree(digit_dfa);
+    }
+  }
+  dfaFree(low_dfa);
+  dfaFree(high_dfa);
+  dfaFree(zero_dfa);
+  delete numeric_auto;
+
+  // move the values to the track of the variable
+  const int var_index = formula->GetVariableIndex(var_name);
+  int* indices_map = CreateBddVariableIndices(formula->GetNumberOfVariables());
+  indices_map[0] = var_index;
+  indices_map[var_index] = 0;
+  dfaReplaceIndices(result_dfa, indices_map);
+  delete[] indices_map;
+
+  formula->ResetCoefficients();
+  formula->SetType(ArithmeticFormula::Type::INTERSECT);
+  auto binary_auto = new BinaryIntAutomaton(result_dfa, formula, false);
+  DVLOG(VLOG_LEVEL) << binary_auto->getId() << " = [" << this->id_ << "]->parseToBinaryIntAutomaton(" << var_name << ")";
+  return binary_auto;
+}
+
+/**
+ * Reads the strings from the last digit to the first one, a state is the set of values the digits before must
+ * have; removing a digit is a linear relation, values larger than the integer width are kept as a single interval
+ * so that there are finitely many states. The reversed automaton is determinized once.
+ */
+StringAutomaton_ptr StringAutomaton::MakeDecimalStrings(BinaryIntAutomaton_ptr binary_auto, const bool with_leading_zeros) {
+  CHECK_EQ(1, binary_auto->get_number_of_bdd_variables()) << "expects a single track binary automaton";
+  const int number_of_bits = DEFAULT_NUM_OF_VARIABLES;
+  const BigInteger max_value = (BigInteger(1) << (Option::Theory::INTEGER_WIDTH - 1)) - 1;
+  DFA_ptr low_dfa = MakeLinearDFA({1}, -max_value, ArithmeticFormula::Type::LE);
+  DFA_ptr non_negative_dfa = MakeLinearDFA({1}, 0, ArithmeticFormula::Type::GE);
+  DFA_ptr tmp_dfa = low_dfa;
+  low_dfa = DFAIntersect(tmp_dfa, non_negative_dfa);
+  dfaFree(tmp_dfa);
+  DFA_ptr high_dfa = MakeLinearDFA({1}, -max_value, ArithmeticFormula::Type::GT);
+  DFA_ptr zero_dfa = MakeLinearDFA({1}, 0, ArithmeticFormula::Type::EQ);
+  std::vector<DFA_ptr> digit_dfas;
+  for (int digit = 0; digit < 10; ++digit) {
+    digit_dfas.push_back(MakeDecimalDigitDFA(digit, false));
+  }
+
+  tmp_dfa = DFAIntersect(binary_auto->getDFA(), non_negative_dfa);
+  dfaFree(non_negative_dfa);
+  std::vector<DFA_ptr> residuals { BoundIntegerValues(tmp_dfa, low_dfa, high_dfa) };
+  dfaFree(tmp_dfa);
+  // residuals with the same number of states are candidates for equality, the first one is never reused
+  std::multimap<int, int> residuals_by_size;
+  std::vector<std::vector<std::pair<int, int>>> digit_transitions (1);
+  for (std::size_t i = 0; i < residuals.size(); ++i) {
+    for (int digit = 0; digit < 10; ++digit) {
+      DFA_ptr next_dfa = ApplyDecimalDigit(residuals[i], digit_dfas[digit]);
+      if (DFAIsMinimizedEmtpy(next_dfa)) {
+        dfaFree(next_dfa);
+        continue;
+      }
+      int next = -1;
+      auto range = residuals_by_size.equal_range(next_dfa->ns);
+      for (auto it = range.first; it != range.second; ++it) {
+        if (DFAIsEqual(residuals[it->second], next_dfa)) {
+          next = it->second;
+          break;
+        }
+      }
+      if (next == -1) {
+        next = residuals.size();
+        residuals.push_back(next_dfa);
+        residuals_by_size.insert(std::make_pair(next_dfa->ns, next));
+        digit_transitions.push_back(std::vector<std::pair<int, int>>());
+      } else {
+        dfaFree(next_dfa);
+      }
+      digit_transitions[i].push_back(std::make_pair(digit, next));
+    }
+  }
+
+  // reverse the transitions, the strings start where the digits before can only be 0
+  Transducer decimal_strings (number_of_bits);
+  decimal_strings.AddState(false);
+  for (std::size_t i = 0; i < residuals.size(); ++i) {
+    decimal_strings.AddState(i == 0);
+  }
+  for (std::size_t i = 1; i < residuals.size(); ++i) {
+    tmp_dfa = DFAIntersect(residuals[i], zero_dfa);
+    if (not DFAIsMinimizedEmtpy(tmp_dfa)) {
+      decimal_strings.AddTransition(0, i + 1, "", "");
+    }
+    dfaFree(tmp_dfa);
+  }
+  for (std::size_t i = 0; i < residuals.size(); ++i) {
+    for (auto& transition : digit_transitions[i]) {
+      const unsigned long code = encoding_.Encode(static_cast<unsigned char>('0' + transition.first));
+      decimal_strings.AddTransition(transition.second + 1, i + 1, Transducer::GetSymbol(code, number_of_bits), "");
+    }
+  }
+
+  for (auto residual_dfa : residuals) {
+    dfaFree(residual_dfa);
+  }
+  for (auto digit_dfa : digit_dfas) {
+    dfaFree(digit_dfa);
+  }
+  dfaFree(low_dfa);
+  dfaFree(high_dfa);
+  dfaFree(zero_dfa);
+
+  auto decimal_auto = new StringAutomaton(decimal_strings.Domain(), number_of_bits);
+  if (not with_leading_zeros) {
+    auto canonical_auto = StringAutomaton::MakeRegexAuto("0|[1-9][0-9]*");
+    auto tmp_auto = decimal_auto;
+    decimal_auto = tmp_auto->Intersect(canonical_auto);
+    delete tmp_auto;
+    delete canonical_auto;
+  }
+  DVLOG(VLOG_LEVEL) << decimal_auto->id_ << " = StringAutomaton::MakeDecimalStrings(" << binary_auto->getId() << ", "
+                    << std::boolalpha << with_leading_zeros << ")";
+  return decimal_auto;
+}
+
 IntAutomaton_ptr StringAutomaton::Length() {
 	CHECK_EQ(this->num_tracks_,1);
   IntAutomaton_ptr length_auto = nullptr;
@@ -2930,6 +3023,22 @@ StringAutomaton_ptr StringAutomaton::RestrictLengthTo(IntAutomaton_ptr length_au
   return restricted_auto;
 }
 
+StringAutomaton_ptr StringAutomaton::WidenToLengths() {
+  CHECK_EQ(this->num_tracks_,1);
+  IntAutomaton_ptr length_auto = this->Length();
+  StringAutomaton_ptr any_string_auto = StringAutomaton::MakeAnyString(num_of_bdd_variables_);
+  if (formula_ != nullptr) {
+    any_string_auto->SetFormula(formula_->clone());
+  }
+  StringAutomaton_ptr widened_auto = any_string_auto->RestrictLengthTo(length_auto);
+  delete any_string_auto; any_string_auto = nullptr;
+  delete length_auto; length_auto = nullptr;
+
+  DVLOG(VLOG_LEVEL) << widened_auto->id_ << " = [" << this->id_ << "]->WidenToLengths()";
+
+  return widened_auto;
+}
+
 StringAutomaton_ptr StringAutomaton::RestrictIndexOfTo(int index,StringAutomaton_ptr search_auto) {
 	CHECK_EQ(this->num_tracks_,1);
   StringAutomaton_ptr restricted_auto = nullptr;
@@ -3077,12 +3186,16 @@ StringAutomaton_ptr StringAutomaton::RestrictIndexOfTo(IntAutomaton_ptr index_au
   }
 
 
-  temp_auto = string_index_auto->Concat(search_param_auto);
-  auto any_after_param_auto = temp_auto->Concat(any_string_auto);
-  delete temp_auto;
+  if (Option::Theory::DIRECT_INDEX_CONSTRUCTIONS) {
+    temp_auto = restricted_auto->RestrictAtIndexDirect(valid_index_auto, search_param_auto, false);
+  } else {
+    temp_auto = string_index_auto->Concat(search_param_auto);
+    auto any_after_param_auto = temp_auto->Concat(any_string_auto);
+    delete temp_auto;
 
-  temp_auto = restricted_auto->Intersect(any_after_param_auto);
-  delete any_after_param_auto;
+    temp_auto = restricted_auto->Intersect(any_after_param_auto);
+    delete any_after_param_auto;
+  }
   delete restricted_auto;
   restricted_auto = temp_auto;
 
@@ -3287,6 +3400,11 @@ StringAutomaton_ptr StringAutomaton::RestrictAtIndexTo(
 		IntAutomaton_ptr index_auto, StringAutomaton_ptr sub_string_auto) {
 	CHECK_EQ(this->num_tracks_,1);
   StringAutomaton_ptr restricted_auto = nullptr, tmp_auto_1 = nullptr, tmp_auto_2;
+  if (Option::Theory::DIRECT_INDEX_CONSTRUCTIONS) {
+    // -1 restricts at the beginning of the string
+    restricted_auto = this->RestrictAtIndexDirect(index_auto, sub_string_auto, index_auto->hasNegative1());
+    return restricted_auto;
+  }
   StringAutomaton_ptr length_string_auto = new StringAutomaton(dfaCopy(index_auto->getDFA()),index_auto->get_number_of_bdd_variables());
   //StringAutomaton_ptr temp_auto = this->Intersect(length_string_auto);
 //  UnaryAutomaton_ptr unary_auto = index_auto->toUnaryAutomaton();
@@ -3361,34 +3479,9 @@ StringAutomaton_ptr StringAutomaton::RestrictAtIndexTo(
   return restricted_auto;
 }
 
-/**
- * TODO Efficiency of the pre image computations can be improved
- * if they are guided by the post image values
- */
 StringAutomaton_ptr StringAutomaton::PreToUpperCase(StringAutomaton_ptr rangeAuto) {
-	CHECK_EQ(this->num_tracks_,1);
-  DFA_ptr result_dfa = nullptr;
-  StringAutomaton_ptr result_auto = nullptr;
-
-  int var = this->num_of_bdd_variables_;
-	int nvar = var+1;
-
-	// dfa1 will have var+1 indices, with all valid transitions having extrabit=0
-	DFA_ptr dfa1 = Automaton::DFAExtendExtrabit(this->dfa_,var);
-	int *indices = Automaton::GetBddVariableIndices(nvar);
-
-  result_dfa = Automaton::dfaPreToUpperCase(dfa1,nvar,indices);
-	DFA_ptr temp_dfa = Automaton::DFAProjectAway(result_dfa,var);
-	dfaFree(result_dfa);
-
-
-  result_auto = new StringAutomaton(temp_dfa,var);
-
-  if (rangeAuto not_eq nullptr) {
-    StringAutomaton_ptr tmp_auto = result_auto;
-    result_auto = tmp_auto->Intersect(rangeAuto);
-    delete tmp_auto;
-  }
+  CHECK_EQ(this->num_tracks_,1);
+  StringAutomaton_ptr result_auto = this->PreTransduce(StringAutomaton::MakeToUpperCaseTransducer(), rangeAuto);
 
   DVLOG(VLOG_LEVEL) << result_auto->id_ << " = [" << this->id_ << "]->preToUpperCase()";
 
@@ -3396,49 +3489,17 @@ StringAutomaton_ptr StringAutomaton::PreToUpperCase(StringAutomaton_ptr rangeAut
 }
 
 StringAutomaton_ptr StringAutomaton::PreToLowerCase(StringAutomaton_ptr rangeAuto) {
-	CHECK_EQ(this->num_tracks_,1);
-  DFA_ptr result_dfa = nullptr;
-  StringAutomaton_ptr result_auto = nullptr;
-
-  int var = this->num_of_bdd_variables_;
-	int nvar = var+1;
-  DFA_ptr dfa1 = Automaton::DFAExtendExtrabit(this->dfa_,var);
-	int *indices = Automaton::GetBddVariableIndices(nvar);
-
-  result_dfa = dfaPreToLowerCase(dfa1,nvar,indices);
-
-
-	DFA_ptr temp_dfa = Automaton::DFAProjectAway(result_dfa,var);
-	dfaFree(result_dfa);
-
-  result_auto = new StringAutomaton(temp_dfa,var);
-
-  if (rangeAuto not_eq nullptr) {
-    StringAutomaton_ptr tmp_auto = result_auto;
-    result_auto = tmp_auto->Intersect(rangeAuto);
-    delete tmp_auto;
-  }
+  CHECK_EQ(this->num_tracks_,1);
+  StringAutomaton_ptr result_auto = this->PreTransduce(StringAutomaton::MakeToLowerCaseTransducer(), rangeAuto);
 
   DVLOG(VLOG_LEVEL) << result_auto->id_ << " = [" << this->id_ << "]->preToLowerCase()";
 
   return result_auto;
 }
 
-// CHECK WITH BAKI
-// may be wrong
 StringAutomaton_ptr StringAutomaton::PreTrim(StringAutomaton_ptr rangeAuto) {
-	CHECK_EQ(this->num_tracks_,1);
-  StringAutomaton_ptr result_auto = nullptr, trim_auto = nullptr, temp_auto = nullptr;
-
-  std::string trim_regex = "' '*";
-  trim_auto = StringAutomaton::MakeRegexAuto(trim_regex);
-
-  result_auto = this->Concat(trim_auto);
-  temp_auto = trim_auto->Concat(result_auto);
-  delete result_auto;
-  result_auto = temp_auto->Intersect(rangeAuto);
-  delete trim_auto;
-  delete temp_auto;
+  CHECK_EQ(this->num_tracks_,1);
+  StringAutomaton_ptr result_auto = this->PreTransduce(StringAutomaton::MakeTrimTransducer(), rangeAuto);
 
   DVLOG(VLOG_LEVEL) << result_auto->id_ << " = [" << this->id_ << "]->preTrim()";
   return result_auto;
@@ -3450,7 +3511,7 @@ StringAutomaton_ptr StringAutomaton::PreConcatLeft(
   DFA_ptr d1,d2,d3;
   d1 = this->dfa_;
   d2 = right_auto->getDFA();
-  d3 = StringAutomaton::PreConcatPrefix(d1,d2,8);
+  d3 = StringAutomaton::PreConcatPrefix(d1,d2,DEFAULT_NUM_OF_VARIABLES);
   return new StringAutomaton(d3,DEFAULT_NUM_OF_VARIABLES);
 }
 
@@ -3463,7 +3524,7 @@ StringAutomaton_ptr StringAutomaton::PreConcatRight(
   DFA_ptr d1,d2,d3;
   d1 = this->dfa_;
   d2 = left_auto->getDFA();
-  d3 = StringAutomaton::PreConcatSuffix(d1,d2,8);
+  d3 = StringAutomaton::PreConcatSuffix(d1,d2,DEFAULT_NUM_OF_VARIABLES);
   return new StringAutomaton(d3,DEFAULT_NUM_OF_VARIABLES);
 }
 
@@ -3473,6 +3534,15 @@ StringAutomaton_ptr StringAutomaton::PreReplace(StringAutomaton_ptr searchAuto,
   DFA_ptr result_dfa = nullptr, temp_dfa = nullptr;
   StringAutomaton_ptr result_auto = nullptr;
 
+  if (searchAuto->IsAcceptingSingleString()) {
+    const std::string search_string = searchAuto->GetAnAcceptingString();
+    if (not search_string.empty()) {
+      result_auto = this->PreTransduce(StringAutomaton::MakeReplaceTransducer(search_string, replaceString), rangeAuto);
+      DVLOG(VLOG_LEVEL) << result_auto->id_ << " = [" << this->id_ << "]->preReplace(" << searchAuto->id_ << ", " << replaceString << ")";
+      return result_auto;
+    }
+  }
+
   std::vector<char> replaceStringVector(replaceString.begin(), replaceString.end());
   replaceStringVector.push_back('\0');
 
@@ -3653,7 +3723,11 @@ StringAutomaton_ptr StringAutomaton::ProjectKTrack(int k_track) {
 void StringAutomaton::SetSymbolicCounter() {
 	// normal symbolic counter for single-track
 	if(num_tracks_ == 1) {
-		Automaton::SetSymbolicCounter();
+		if (encoding_.is_identity()) {
+			Automaton::SetSymbolicCounter();
+		} else {
+			SetWeightedSymbolicCounter();
+		}
 		return;
 	}
 
@@ -3729,11 +3803,102 @@ void StringAutomaton::SetSymbolicCounter() {
 	delete[] statuses;
 
 	this->dfa_ = trimmed_dfa;
-	Automaton::SetSymbolicCounter();
+	// counting may be stopped by the budget of the query, the automaton gets its dfa back
+	try {
+		if (encoding_.is_identity()) {
+			Automaton::SetSymbolicCounter();
+		} else {
+			SetWeightedSymbolicCounter();
+		}
+	} catch (const Util::BudgetExceeded&) {
+		this->dfa_ = original_dfa;
+		dfaFree(trimmed_dfa);
+		throw;
+	}
 	this->dfa_ = original_dfa;
 	dfaFree(trimmed_dfa);
 }
 
+void StringAutomaton::SetWeightedSymbolicCounter() {
+  std::vector<Eigen::Triplet<BigInteger>> entries;
+  const int sink_state = GetSinkState();
+  unsigned left, right, index;
+  std::map<std::string, unsigned long> track_weights;
+  for (int s = 0; s < this->dfa_->ns; ++s) {
+    if (sink_state == s) {
+      continue;
+    }
+    // bdd node and the assignment on the path to it
+    std::stack<std::pair<unsigned, std::vector<char>>> bdd_node_stack;
+    bdd_node_stack.push(std::make_pair(dfa_->q[s], std::vector<char>(num_of_bdd_variables_, 'X')));
+    while (not bdd_node_stack.empty()) {
+      auto current_bdd_node = bdd_node_stack.top(); bdd_node_stack.pop();
+      LOAD_lri(&dfa_->bddm->node_table[current_bdd_node.first], left, right, index);
+      if (index == BDD_LEAF_INDEX) {
+        if (sink_state != static_cast<int>(left)) {
+          BigInteger weight = GetTransitionWeight(current_bdd_node.second, track_weights);
+          if (weight > 0) {
+            entries.push_back(Eigen::Triplet<BigInteger>(s, left, weight));
+          }
+        }
+      } else {
+        auto left_transition = current_bdd_node.second;
+        left_transition[index] = '0';
+        current_bdd_node.second[index] = '1';
+        bdd_node_stack.push(std::make_pair(left, left_transition));
+        bdd_node_stack.push(std::make_pair(right, current_bdd_node.second));
+      }
+    }
+
+    // combine all accepting states into one artifical accepting state
+    if (IsAcceptingState(s)) {
+      entries.push_back(Eigen::Triplet<BigInteger>(s, this->dfa_->ns, 1));
+    }
+  }
+  Eigen::SparseMatrix<BigInteger> count_matrix (this->dfa_->ns + 1, this->dfa_->ns + 1);
+  count_matrix.setFromTriplets(entries.begin(), entries.end());
+  decide_counting_schema(count_matrix);
+  count_matrix.makeCompressed();
+  count_matrix.finalize();
+  counter_.set_transition_count_matrix(count_matrix);
+  counter_.set_initialization_vector(count_matrix.innerVector(count_matrix.cols()-1));
+  is_counter_cached_ = true;
+}
+
+BigInteger StringAutomaton::GetTransitionWeight(const std::vector<char>& transition,
+                                                std::map<std::string, unsigned long>& track_weights) const {
+  // bit j of track i is at i + num_tracks_ * j, the most significant bit first; multitrack automata
+  // keep a lambda bit after the character bits
+  const int number_of_tracks = (num_tracks_ == 1) ? 1 : num_tracks_;
+  const int bits_per_track = num_of_bdd_variables_ / number_of_tracks;
+  const int character_bits = std::min(bits_per_track, DEFAULT_NUM_OF_VARIABLES);
+  BigInteger weight = 1;
+  std::string track_pattern (bits_per_track, 'X');
+  for (int track = 0; track < number_of_tracks; ++track) {
+    for (int j = 0; j < bits_per_track; ++j) {
+      track_pattern[j] = transition[track + number_of_tracks * j];
+    }
+    auto it = track_weights.find(track_pattern);
+    if (it == track_weights.end()) {
+      unsigned long track_weight = 0;
+      const std::string character_pattern = track_pattern.substr(0, character_bits);
+      const char lambda_bit = (bits_per_track > character_bits) ? track_pattern[character_bits] : '0';
+      if (lambda_bit != '0' and character_pattern.find('0') == std::string::npos) {
+        track_weight += 1;
+      }
+      if (lambda_bit != '1') {
+        track_weight += encoding_.get_weight(character_pattern);
+      }
+      it = track_weights.insert(std::make_pair(track_pattern, track_weight)).first;
+    }
+    weight *= it->second;
+    if (weight == 0) {
+      break;
+    }
+  }
+  return weight;
+}
+
 std::vector<std::string> StringAutomaton::GetAnAcceptingStringForEachTrack() {
 	LOG(FATAL) << "IMPLEMENT ME";
 //  std::vector<std::string> strings(num_tracks_, "");
@@ -4067,7 +4232,7 @@ std::map<std::string,std::vector<std::string>> StringAutomaton::GetModelsWithinB
 				if(iter[i][((k+1)*var_per_track)-1] == true) {
 					continue;
 				}
-				unsigned char c = 0;
+				unsigned long c = 0;
 				// var_per_track-1 since we dont' care about the last bit, which is used for lambda
 				for(int j = 0; j < var_per_track-1; j++) {
 					if(iter[i][(k*var_per_track)+j]) {
@@ -4075,14 +4240,14 @@ std::map<std::string,std::vector<std::string>> StringAutomaton::GetModelsWithinB
 					} else {
 						c |= 0;
 					}
-					if(j != 7) {
+					if(j != var_per_track-2) {
 						c <<= 1;
 					}
 				}
 //				char c_arr[4];
 //				charToAscii(c_arr,c);
 //				s += c_arr;
-				s += std::to_string((int)c);
+				s += std::to_string(encoding_.Decode(c));
 				s += " ";
 
 			}
@@ -4152,8 +4317,13 @@ std::string StringAutomaton::GetAnAcceptingString() {
   CHECK_EQ(this->num_tracks_,1);
   std::stringstream ss;
 
-  auto readable_ascii_heuristic = [](unsigned& index) -> bool {
-    switch (index) {
+  // prefers lower case letters, the bits of wider characters above the ascii bits are zero
+  const unsigned ascii_offset = num_of_bdd_variables_ - StringEncoding::DEFAULT_CHARACTER_WIDTH;
+  auto readable_ascii_heuristic = [ascii_offset](unsigned& index) -> bool {
+    if (index < ascii_offset) {
+      return false;
+    }
+    switch (index - ascii_offset) {
       case 1:
       case 2:
       case 6:
@@ -4164,7 +4334,7 @@ std::string StringAutomaton::GetAnAcceptingString() {
   };
   std::vector<bool>* example = getAnAcceptingWord(readable_ascii_heuristic);
 
-  unsigned char c = 0;
+  unsigned long c = 0;
   unsigned bit_range = num_of_bdd_variables_ - 1;
   unsigned read_count = 0;
   for (auto bit: *example) {
@@ -4178,7 +4348,7 @@ std::string StringAutomaton::GetAnAcceptingString() {
       c <<= 1;
     }
     if (read_count == bit_range) {
-      ss << c;
+      ss << DecodeSymbol(c);
       c = 0;
       read_count = 0;
     } else {
@@ -4203,7 +4373,7 @@ std::string StringAutomaton::GetAnAcceptingStringRandom() {
 
   std::vector<bool>* example = getAnAcceptingWordRandom(random_heuristic);
 
-  unsigned char c = 0;
+  unsigned long c = 0;
   unsigned bit_range = num_of_bdd_variables_ - 1;
   unsigned read_count = 0;
   for (auto bit: *example) {
@@ -4217,7 +4387,7 @@ std::string StringAutomaton::GetAnAcceptingStringRandom() {
       c <<= 1;
     }
     if (read_count == bit_range) {
-      ss << c;
+      ss << DecodeSymbol(c);
       c = 0;
       read_count = 0;
     } else {
@@ -4324,6 +4494,20 @@ const StringAutomaton::TransitionVector& StringAutomaton::GenerateTransitionsFor
 
 DFA_ptr StringAutomaton::MakeBinaryRelationDfa(StringFormula::Type type, int bits_per_var, int num_tracks, int left_track, int right_track) {
   DFA_ptr temp_dfa = nullptr, result_dfa = nullptr, aligned_dfa = nullptr;
+  if (StringFormula::Type::EQ == type or StringFormula::Type::NOTEQ == type) {
+    // aligned tracks that read the same symbols (or not), without enumerating the pairs of equal characters
+    DFA_ptr equality_dfa = MakeTrackEqualityDfa(bits_per_var, num_tracks, left_track, right_track);
+    aligned_dfa = MakeBinaryAlignedDfa(left_track, right_track, num_tracks);
+    if (StringFormula::Type::EQ == type) {
+      result_dfa = Automaton::DFAIntersect(aligned_dfa, equality_dfa);
+    } else {
+      result_dfa = Automaton::DFADifference(aligned_dfa, equality_dfa);
+    }
+    dfaFree(aligned_dfa);
+    dfaFree(equality_dfa);
+    return result_dfa;
+  }
+
   int var = bits_per_var;
   int len = num_tracks * var;
   int *mindices = GetBddVariableIndices(num_tracks*var);
@@ -4454,9 +4638,109 @@ DFA_ptr StringAutomaton::MakeBinaryRelationDfa(StringFormula::Type type, int bit
   return result_dfa;
 }
 
+DFA_ptr StringAutomaton::MakeBeginsDfa(int bits_per_var, int num_tracks, int left_track, int right_track) {
+	DFA_ptr temp_dfa, layout_dfa, equality_dfa, result_dfa;
+	int var = bits_per_var;
+	int len = num_tracks * var;
+	int *mindices = Automaton::GetBddVariableIndices(num_tracks*var);
+
+	std::vector<char> exep_lambda(var,'1');
+	std::vector<char> exep_char(var,'X');
+	exep_char[var-1] = '0';
+	auto make_exep = [&](const std::vector<char>& left_exep, const std::vector<char>& right_exep) {
+		std::vector<char> str(len,'X');
+		for(int k = 0; k < var; k++) {
+			str[left_track+num_tracks*k] = left_exep[k];
+			str[right_track+num_tracks*k] = right_exep[k];
+		}
+		str.push_back('\0');
+		return str;
+	};
+	auto char_char = make_exep(exep_char,exep_char);
+	auto char_lambda = make_exep(exep_char,exep_lambda);
+	auto lambda_lambda = make_exep(exep_lambda,exep_lambda);
+
+	// layout only, characters read on both tracks are related below
+	dfaSetup(4,len,mindices);
+	// both read a character, loop back; right ends, go to 1; both end, go to 2
+	dfaAllocExceptions(3);
+	dfaStoreException(0,&char_char[0]);
+	dfaStoreException(1,&char_lambda[0]);
+	dfaStoreException(2,&lambda_lambda[0]);
+	dfaStoreState(3);
+
+	// left anything, right lambda, loop back here; both lambda, goto 2
+	dfaAllocExceptions(2);
+	dfaStoreException(1,&char_lambda[0]);
+	dfaStoreException(2,&lambda_lambda[0]);
+	dfaStoreState(3);
+
+	// lambda/lambda state, loop back on lambda
+	dfaAllocExceptions(1);
+	dfaStoreException(2,&lambda_lambda[0]);
+	dfaStoreState(3);
+
+	// sink
+	dfaAllocExceptions(0);
+	dfaStoreState(3);
+
+	temp_dfa = dfaBuild("--+-");
+	layout_dfa = dfaMinimize(temp_dfa);
+	dfaFree(temp_dfa);
+
+	// left reads the character of right until right ends
+	equality_dfa = MakeTrackEqualityDfa(var,num_tracks,left_track,right_track,right_track);
+	result_dfa = Automaton::DFAIntersect(layout_dfa,equality_dfa);
+	dfaFree(layout_dfa);
+	dfaFree(equality_dfa);
+	return result_dfa;
+}
+
+DFA_ptr StringAutomaton::MakeTrackEqualityDfa(int bits_per_var, int num_tracks, int left_track, int right_track,
+                                              int unless_lambda_track) {
+	DFA_ptr bit_dfa = nullptr, temp_dfa = nullptr, result_dfa = nullptr;
+	int var = bits_per_var;
+	int len = num_tracks * var;
+	int *mindices = GetBddVariableIndices(len);
+
+	// one automaton per bit: the bit is the same on both tracks (or the unless track reads lambda), else sink
+	for(int k = 0; k < var; k++) {
+		std::vector<char> str(len,'X');
+		str.push_back('\0');
+		dfaSetup(2,len,mindices);
+		dfaAllocExceptions(unless_lambda_track == -1 ? 2 : 3);
+		str[left_track+num_tracks*k] = '0';
+		str[right_track+num_tracks*k] = '0';
+		dfaStoreException(0,&str[0]);
+		str[left_track+num_tracks*k] = '1';
+		str[right_track+num_tracks*k] = '1';
+		dfaStoreException(0,&str[0]);
+		if(unless_lambda_track != -1) {
+			str[left_track+num_tracks*k] = 'X';
+			str[right_track+num_tracks*k] = 'X';
+			str[unless_lambda_track+num_tracks*(var-1)] = '1';
+			dfaStoreException(0,&str[0]);
+		}
+		dfaStoreState(1);
+		dfaAllocExceptions(0);
+		dfaStoreState(1);
+		bit_dfa = dfaBuild("+-");
+
+		if(result_dfa == nullptr) {
+			result_dfa = bit_dfa;
+		} else {
+			temp_dfa = Automaton::DFAIntersect(result_dfa,bit_dfa);
+			dfaFree(result_dfa);
+			dfaFree(bit_dfa);
+			result_dfa = temp_dfa;
+		}
+	}
+
+	return result_dfa;
+}
+
 DFA_ptr StringAutomaton::MakeBinaryAlignedDfa(int left_track, int right_track, int num_tracks) {
   DFA_ptr temp_dfa = nullptr, result_dfa = nullptr;
-  TransitionVector tv;
   int init = 0,lambda_star = 1, lambda_lambda = 2,
       star_lambda = 3, sink = 4;
   int var = VAR_PER_TRACK;
@@ -4465,7 +4749,6 @@ DFA_ptr StringAutomaton::MakeBinaryAlignedDfa(int left_track, int right_track, i
   std::vector<char> exep_lambda(var,'1');
   std::vector<char> exep_dont_care(var,'X');
   exep_dont_care[var-1] = '0';
-  tv = GenerateTransitionsForRelation(StringFormula::Type::EQ,var);
 
   dfaSetup(5,len,mindices);
 
@@ -5155,79 +5438,48 @@ DFA_ptr StringAutomaton::MakeRelationalLenDfa(StringFormula_ptr formula, int bit
 
 StringAutomaton_ptr StringAutomaton::MakePrefixSuffix(int left_track, int prefix_track, int suffix_track, int num_tracks) {
 	StringAutomaton_ptr result_auto = nullptr;
-  DFA_ptr temp_dfa, result_dfa;
-  TransitionVector tv;
+  DFA_ptr temp_dfa, layout_dfa, prefix_equality_dfa, suffix_equality_dfa, result_dfa;
 
   int var = VAR_PER_TRACK;
   int len = num_tracks * var;
   int *mindices = GetBddVariableIndices(num_tracks*var);
 
   std::vector<char> exep_lambda(var,'1');
-  tv = GenerateTransitionsForRelation(StringFormula::Type::EQ, var);
-  dfaSetup(4,len,mindices);
-  dfaAllocExceptions(2*tv.size() + 1); // 1 extra for lambda stuff below
-  for(int i = 0; i < tv.size(); i++) {
+  std::vector<char> exep_char(var,'X');
+  exep_char[var-1] = '0';
+  auto make_exep = [&](const std::vector<char>& left_exep, const std::vector<char>& prefix_exep,
+                       const std::vector<char>& suffix_exep) {
     std::vector<char> str(len,'X');
     for(int k = 0; k < var; k++) {
-      str[left_track+num_tracks*k] = tv[i].first[k];
-      str[prefix_track+num_tracks*k] = tv[i].first[k];
-      str[suffix_track+num_tracks*k] = exep_lambda[k];
-    }
-    str.push_back('\0');
-    dfaStoreException(0,&str[0]);
-  }
-
-  // if prefix is lambda, left  and suffix same
-  for(int i = 0; i < tv.size(); i++) {
-    std::vector<char> str(len,'X');
-    for (int k = 0; k < var; k++) {
-      str[left_track+num_tracks*k] = tv[i].first[k];
-      str[prefix_track+num_tracks*k] = exep_lambda[k];
-      str[suffix_track+num_tracks*k] = tv[i].first[k];
+      str[left_track+num_tracks*k] = left_exep[k];
+      str[prefix_track+num_tracks*k] = prefix_exep[k];
+      str[suffix_track+num_tracks*k] = suffix_exep[k];
     }
     str.push_back('\0');
-    dfaStoreException(1,&str[0]);
-  }
+    return str;
+  };
+  auto prefix_exep = make_exep(exep_char,exep_char,exep_lambda);
+  auto suffix_exep = make_exep(exep_char,exep_lambda,exep_char);
+  auto lambda_exep = make_exep(exep_lambda,exep_lambda,exep_lambda);
 
+  // layout only, left reads the prefix then the suffix; characters are related below
+  dfaSetup(4,len,mindices);
+  dfaAllocExceptions(3);
+  dfaStoreException(0,&prefix_exep[0]);
+  dfaStoreException(1,&suffix_exep[0]);
   // if all 3 are lambda, go to next state
-  std::vector<char> str(len,'X');
-  str = std::vector<char>(len,'X');
-  for(int k = 0; k < var; k++) {
-    str[left_track+num_tracks*k] = exep_lambda[k];
-    str[prefix_track+num_tracks*k] = exep_lambda[k];
-    str[suffix_track+num_tracks*k] = exep_lambda[k];
-  }
-  str.push_back('\0');
-  dfaStoreException(2,&str[0]);
+  dfaStoreException(2,&lambda_exep[0]);
   dfaStoreState(3);
 
-  // left = suffix, prefix lambda, loop back here
-  dfaAllocExceptions(tv.size() + 1);
-  for(int i = 0; i < tv.size(); i++) {
-    std::vector<char> str(len,'X');
-    for (int k = 0; k < var; k++) {
-      str[left_track+num_tracks*k] = tv[i].first[k];
-      str[prefix_track+num_tracks*k] = exep_lambda[k];
-      str[suffix_track+num_tracks*k] = tv[i].first[k];
-    }
-    str.push_back('\0');
-    dfaStoreException(1,&str[0]);
-  }
-
-  // if all 3 lambda, goto 2
-  str = std::vector<char>(len,'X');
-  for(int k = 0; k < var; k++) {
-    str[left_track+num_tracks*k] = exep_lambda[k];
-    str[prefix_track+num_tracks*k] = exep_lambda[k];
-    str[suffix_track+num_tracks*k] = exep_lambda[k];
-  }
-  str.push_back('\0');
-  dfaStoreException(2,&str[0]);
+  // prefix lambda, loop back here; if all 3 lambda, goto 2
+  dfaAllocExceptions(2);
+  dfaStoreException(1,&suffix_exep[0]);
+  dfaStoreException(2,&lambda_exep[0]);
   dfaStoreState(3);
 
   // lambda/lambda state, loop back on lambda
   dfaAllocExceptions(1);
-  dfaStoreException(2,&str[0]);
+  dfaStoreException(2,&lambda_exep[0]);
   dfaStoreState(3);
 
   // sink
@@ -5235,8 +5487,18 @@ StringAutomaton_ptr StringAutomaton::MakePrefixSuffix(int left_track, int prefix
   dfaStoreState(3);
 
   temp_dfa = dfaBuild("--+-");
-  result_dfa = dfaMinimize(temp_dfa);
+  layout_dfa = dfaMinimize(temp_dfa);
   dfaFree(temp_dfa);
+
+  // left reads the character of the prefix, or of the suffix once the prefix ends
+  prefix_equality_dfa = MakeTrackEqualityDfa(var,num_tracks,left_track,prefix_track,prefix_track);
+  suffix_equality_dfa = MakeTrackEqualityDfa(var,num_tracks,left_track,suffix_track,suffix_track);
+  temp_dfa = Automaton::DFAIntersect(layout_dfa,prefix_equality_dfa);
+  result_dfa = Automaton::DFAIntersect(temp_dfa,suffix_equality_dfa);
+  dfaFree(temp_dfa);
+  dfaFree(layout_dfa);
+  dfaFree(prefix_equality_dfa);
+  dfaFree(suffix_equality_dfa);
   result_auto = new StringAutomaton(result_dfa,num_tracks,num_tracks*VAR_PER_TRACK);
 
   return result_auto;
@@ -5773,13 +6035,468 @@ std::vector<int> StringAutomaton::GetAcceptingStates() {
  * @param search automaton is an automaton that does not accept empty string
  * @this is an automaton that is known to be contains search automaton
  */
+StringAutomaton_ptr StringAutomaton::SuffixesAtIndexDirect(IntAutomaton_ptr indices_auto) {
+  CHECK_EQ(this->num_tracks_,1);
+  auto transitions = GetSymbolicTransitions(this->dfa_, num_of_bdd_variables_);
+
+  // state 0 is the new initial state, state q of the dfa is q + 1
+  Transducer suffixes (num_of_bdd_variables_);
+  suffixes.AddState(false);
+  for (int q = 0; q < this->dfa_->ns; ++q) {
+    suffixes.AddState(IsAcceptingState(q));
+  }
+  for (auto q : GetStatesAtIndex(transitions, indices_auto)) {
+    suffixes.AddTransition(0, q + 1, "", "");
+  }
+  for (int q = 0; q < this->dfa_->ns; ++q) {
+    for (auto& transition : transitions[q]) {
+      suffixes.AddTransition(q + 1, transition.second + 1, transition.first, "");
+    }
+  }
+
+  auto suffixes_auto = new StringAutomaton(suffixes.Domain(), num_of_bdd_variables_);
+  DVLOG(VLOG_LEVEL) << suffixes_auto->id_ << " = [" << this->id_ << "]->suffixesAtIndexDirect(" << indices_auto->getId() << ")";
+  return suffixes_auto;
+}
+
+/**
+ * Reads the characters before the start index in lockstep with the start auto, then reads the sub string in
+ * lockstep with the length auto. A sub string is accepted when its length is accepted by the length auto and the
+ * subject can still be accepted, or when the subject ends and a longer length is accepted by the length auto.
+ */
+StringAutomaton_ptr StringAutomaton::SubStringDirect(IntAutomaton_ptr start_auto, IntAutomaton_ptr length_auto) {
+  CHECK_EQ(this->num_tracks_,1);
+  auto transitions = GetSymbolicTransitions(this->dfa_, num_of_bdd_variables_);
+  auto is_live = GetLiveStates(this->dfa_, transitions);
+  DFA_ptr length_dfa = length_auto->getDFA();
+  auto length_successors = GetUnarySuccessors(length_dfa);
+  auto is_length_live = GetLiveStates(length_dfa, length_successors);
+
+  Transducer substrings (num_of_bdd_variables_);
+  substrings.AddState(false);
+  std::map<std::pair<int, int>, int> state_ids;
+  std::vector<std::pair<int, int>> worklist;
+  auto get_state = [&](const int q, const int b) {
+    auto it = state_ids.find(std::make_pair(q, b));
+    if (it != state_ids.end()) {
+      return it->second;
+    }
+    const bool is_final = (DFAIsAcceptingState(length_dfa, b) and is_live[q])
+        or (IsAcceptingState(q) and is_length_live[b]);
+    const int state = substrings.AddState(is_final);
+    state_ids[std::make_pair(q, b)] = state;
+    worklist.push_back(std::make_pair(q, b));
+    return state;
+  };
+
+  if (is_length_live[length_dfa->s]) {
+    for (auto q : GetStatesAtIndex(transitions, start_auto)) {
+      if (is_live[q]) {
+        substrings.AddTransition(0, get_state(q, length_dfa->s), "", "");
+      }
+    }
+  }
+  for (std::size_t i = 0; i < worklist.size(); ++i) {
+    const int q = worklist[i].first, b = worklist[i].second;
+    const int from = state_ids[worklist[i]];
+    const int next_b = length_successors[b];
+    if (next_b < 0 or not is_length_live[next_b]) {
+      continue;
+    }
+    for (auto& transition : transitions[q]) {
+      if (is_live[transition.second]) {
+        substrings.AddTransition(from, get_state(transition.second, next_b), transition.first, "");
+      }
+    }
+  }
+
+  auto substring_auto = new StringAutomaton(substrings.Domain(), num_of_bdd_variables_);
+  DVLOG(VLOG_LEVEL) << substring_auto->id_ << " = [" << this->id_ << "]->subStringDirect(" << start_auto->getId() << "," << length_auto->getId() << ")";
+  return substring_auto;
+}
+
+/**
+ * Phase 0 reads the characters before the index in lockstep with the index auto, phase 1 reads the sub string in
+ * lockstep with the sub string auto and phase 2 reads the rest of the subject.
+ */
+StringAutomaton_ptr StringAutomaton::RestrictAtIndexDirect(IntAutomaton_ptr index_auto,
+                                                           StringAutomaton_ptr sub_string_auto, const bool at_zero) {
+  CHECK_EQ(this->num_tracks_,1);
+  auto transitions = GetSymbolicTransitions(this->dfa_, num_of_bdd_variables_);
+  auto is_live = GetLiveStates(this->dfa_, transitions);
+  DFA_ptr sub_string_dfa = sub_string_auto->getDFA();
+  auto sub_string_transitions = GetSymbolicTransitions(sub_string_dfa, num_of_bdd_variables_);
+  DFA_ptr index_dfa = index_auto->getDFA();
+  auto index_successors = GetUnarySuccessors(index_dfa);
+  auto is_index_live = GetLiveStates(index_dfa, index_successors);
+
+  Transducer restricted (num_of_bdd_variables_);
+  restricted.AddState(false);
+  std::map<std::tuple<int, int, int>, int> state_ids;
+  std::vector<std::tuple<int, int, int>> worklist;
+  auto get_state = [&](const int phase, const int q, const int x) {
+    auto key = std::make_tuple(phase, q, x);
+    auto it = state_ids.find(key);
+    if (it != state_ids.end()) {
+      return it->second;
+    }
+    const int state = restricted.AddState(phase == 2 and IsAcceptingState(q));
+    state_ids[key] = state;
+    worklist.push_back(key);
+    return state;
+  };
+
+  if (is_index_live[index_dfa->s]) {
+    restricted.AddTransition(0, get_state(0, this->dfa_->s, index_dfa->s), "", "");
+  }
+  if (at_zero) {
+    restricted.AddTransition(0, get_state(1, this->dfa_->s, sub_string_dfa->s), "", "");
+  }
+  for (std::size_t i = 0; i < worklist.size(); ++i) {
+    const int phase = std::get<0>(worklist[i]), q = std::get<1>(worklist[i]), x = std::get<2>(worklist[i]);
+    const int from = state_ids[worklist[i]];
+    if (phase == 0) {
+      if (DFAIsAcceptingState(index_dfa, x)) {
+        restricted.AddTransition(from, get_state(1, q, sub_string_dfa->s), "", "");
+      }
+      const int next_x = index_successors[x];
+      if (next_x < 0 or not is_index_live[next_x]) {
+        continue;
+      }
+      for (auto& transition : transitions[q]) {
+        if (is_live[transition.second]) {
+          restricted.AddTransition(from, get_state(0, transition.second, next_x), transition.first, "");
+        }
+      }
+    } else if (phase == 1) {
+      if (DFAIsAcceptingState(sub_string_dfa, x)) {
+        restricted.AddTransition(from, get_state(2, q, 0), "", "");
+      }
+      std::string symbol;
+      for (auto& transition : transitions[q]) {
+        for (auto& sub_string_transition : sub_string_transitions[x]) {
+          if (is_live[transition.second] and IntersectSymbols(transition.first, sub_string_transition.first, symbol)) {
+            restricted.AddTransition(from, get_state(1, transition.second, sub_string_transition.second), symbol, "");
+          }
+        }
+      }
+    } else {
+      for (auto& transition : transitions[q]) {
+        if (is_live[transition.second]) {
+          restricted.AddTransition(from, get_state(2, transition.second, 0), transition.first, "");
+        }
+      }
+    }
+  }
+
+  auto restricted_auto = new StringAutomaton(restricted.Domain(), num_of_bdd_variables_);
+  DVLOG(VLOG_LEVEL) << restricted_auto->id_ << " = [" << this->id_ << "]->restrictAtIndexDirect(" << index_auto->getId() << ", " << sub_string_auto->id_ << ")";
+  return restricted_auto;
+}
+
+/**
+ * Index i is a match if the subject can be read up to i, i is not before an index of the from index auto and a
+ * string of the search auto can be read from i on without losing the subject.
+ */
+IntAutomaton_ptr StringAutomaton::MatchIndicesDirect(StringAutomaton_ptr search_auto, IntAutomaton_ptr from_index_auto) {
+  CHECK_EQ(this->num_tracks_,1);
+  auto transitions = GetSymbolicTransitions(this->dfa_, num_of_bdd_variables_);
+  auto is_live = GetLiveStates(this->dfa_, transitions);
+  DFA_ptr search_dfa = search_auto->getDFA();
+  auto search_transitions = GetSymbolicTransitions(search_dfa, num_of_bdd_variables_);
+
+  // backward reachability in the product of the subject and the search auto
+  const int number_of_states = this->dfa_->ns, number_of_search_states = search_dfa->ns;
+  std::vector<std::vector<int>> predecessors (number_of_states * number_of_search_states);
+  std::vector<bool> can_match (number_of_states * number_of_search_states, false);
+  std::stack<int> pending;
+  std::string symbol;
+  for (int q = 0; q < number_of_states; ++q) {
+    for (int r = 0; r < number_of_search_states; ++r) {
+      const int pair_id = q * number_of_search_states + r;
+      if (is_live[q] and DFAIsAcceptingState(search_dfa, r)) {
+        can_match[pair_id] = true;
+        pending.push(pair_id);
+      }
+      for (auto& transition : transitions[q]) {
+        for (auto& search_transition : search_transitions[r]) {
+          if (IntersectSymbols(transition.first, search_transition.first, symbol)) {
+            predecessors[transition.second * number_of_search_states + search_transition.second].push_back(pair_id);
+          }
+        }
+      }
+    }
+  }
+  while (not pending.empty()) {
+    const int pair_id = pending.top();
+    pending.pop();
+    for (auto predecessor : predecessors[pair_id]) {
+      if (not can_match[predecessor]) {
+        can_match[predecessor] = true;
+        pending.push(predecessor);
+      }
+    }
+  }
+
+  // unary automaton of the indices, 'done' stands for any index after an accepted from index
+  DFA_ptr from_index_dfa = from_index_auto->getDFA();
+  auto from_index_successors = GetUnarySuccessors(from_index_dfa);
+  auto is_from_index_live = GetLiveStates(from_index_dfa, from_index_successors);
+  const int done = from_index_dfa->ns;
+  auto normalize = [&](const int a) {
+    return (a != done and DFAIsAcceptingState(from_index_dfa, a)) ? done : a;
+  };
+  const std::string any_symbol (num_of_bdd_variables_, 'X');
+
+  Transducer indices (num_of_bdd_variables_);
+  indices.AddState(false);
+  std::map<std::pair<int, int>, int> state_ids;
+  std::vector<std::pair<int, int>> worklist;
+  auto get_state = [&](const int q, const int a) {
+    auto it = state_ids.find(std::make_pair(q, a));
+    if (it != state_ids.end()) {
+      return it->second;
+    }
+    const int state = indices.AddState(a == done and can_match[q * number_of_search_states + search_dfa->s]);
+    state_ids[std::make_pair(q, a)] = state;
+    worklist.push_back(std::make_pair(q, a));
+    return state;
+  };
+
+  if (is_from_index_live[from_index_dfa->s]) {
+    indices.AddTransition(0, get_state(this->dfa_->s, normalize(from_index_dfa->s)), "", "");
+  }
+  for (std::size_t i = 0; i < worklist.size(); ++i) {
+    const int q = worklist[i].first, a = worklist[i].second;
+    const int from = state_ids[worklist[i]];
+    int next_a = (a == done) ? done : from_index_successors[a];
+    if (next_a < 0 or (next_a != done and not is_from_index_live[next_a])) {
+      continue;
+    }
+    next_a = normalize(next_a);
+    std::set<int> next_states;
+    for (auto& transition : transitions[q]) {
+      if (is_live[transition.second]) {
+        next_states.insert(transition.second);
+      }
+    }
+    for (auto next_q : next_states) {
+      indices.AddTransition(from, get_state(next_q, next_a), any_symbol, "");
+    }
+  }
+
+  auto indices_auto = new IntAutomaton(indices.Domain(), num_of_bdd_variables_);
+  DVLOG(VLOG_LEVEL) << indices_auto->getId() << " = [" << this->id_ << "]->matchIndicesDirect(" << search_auto->id_ << ", " << from_index_auto->getId() << ")";
+  return indices_auto;
+}
+
+std::set<int> StringAutomaton::GetStatesAtIndex(const std::vector<std::vector<std::pair<std::string, int>>>& transitions,
+                                                IntAutomaton_ptr index_auto) {
+  DFA_ptr index_dfa = index_auto->getDFA();
+  auto index_successors = GetUnarySuccessors(index_dfa);
+  auto is_index_live = GetLiveStates(index_dfa, index_successors);
+  std::set<int> states;
+  if (not is_index_live[index_dfa->s]) {
+    return states;
+  }
+
+  const int number_of_index_states = index_dfa->ns;
+  std::vector<bool> is_visited (this->dfa_->ns * number_of_index_states, false);
+  std::stack<std::pair<int, int>> pending;
+  pending.push(std::make_pair(this->dfa_->s, index_dfa->s));
+  is_visited[this->dfa_->s * number_of_index_states + index_dfa->s] = true;
+  while (not pending.empty()) {
+    const int q = pending.top().first, a = pending.top().second;
+    pending.pop();
+    if (DFAIsAcceptingState(index_dfa, a)) {
+      states.insert(q);
+    }
+    const int next_a = index_successors[a];
+    if (next_a < 0 or not is_index_live[next_a]) {
+      continue;
+    }
+    for (auto& transition : transitions[q]) {
+      const int pair_id = transition.second * number_of_index_states + next_a;
+      if (not is_visited[pair_id]) {
+        is_visited[pair_id] = true;
+        pending.push(std::make_pair(transition.second, next_a));
+      }
+    }
+  }
+  return states;
+}
+
+std::vector<std::vector<std::pair<std::string, int>>> StringAutomaton::GetSymbolicTransitions(const DFA_ptr dfa,
+                                                                                              const int number_of_bits) {
+  std::vector<std::vector<std::pair<std::string, int>>> transitions (dfa->ns);
+  const int sink_state = DFAGetSinkState(dfa);
+  int* indices = GetBddVariableIndices(number_of_bits);
+  paths state_paths = nullptr, pp = nullptr;
+  trace_descr tp = nullptr;
+  for (int s = 0; s < dfa->ns; ++s) {
+    if (s == sink_state) {
+      continue;
+    }
+    state_paths = pp = make_paths(dfa->bddm, dfa->q[s]);
+    while (pp) {
+      if (pp->to != (unsigned)sink_state) {
+        std::string symbol (number_of_bits, 'X');
+        for (int j = 0; j < number_of_bits; ++j) {
+          for (tp = pp->trace; tp && (tp->index != (unsigned)indices[j]); tp = tp->next);
+          if (tp) {
+            symbol[j] = tp->value ? '1' : '0';
+          }
+        }
+        transitions[s].push_back(std::make_pair(symbol, (int)pp->to));
+      }
+      pp = pp->next;
+    }
+    kill_paths(state_paths);
+  }
+  return transitions;
+}
+
+std::vector<int> StringAutomaton::GetUnarySuccessors(const DFA_ptr dfa) {
+  std::vector<int> successors (dfa->ns, -1);
+  const int sink_state = DFAGetSinkState(dfa);
+  for (int s = 0; s < dfa->ns; ++s) {
+    if (s == sink_state) {
+      continue;
+    }
+    paths state_paths = make_paths(dfa->bddm, dfa->q[s]);
+    for (paths pp = state_paths; pp; pp = pp->next) {
+      if (pp->to != (unsigned)sink_state) {
+        CHECK(successors[s] == -1 or successors[s] == (int)pp->to) << "not a unary automaton";
+        successors[s] = pp->to;
+      }
+    }
+    kill_paths(state_paths);
+  }
+  return successors;
+}
+
+std::vector<bool> StringAutomaton::GetLiveStates(const DFA_ptr dfa,
+                                                 const std::vector<std::vector<std::pair<std::string, int>>>& transitions) {
+  std::vector<std::vector<int>> predecessors (dfa->ns);
+  for (int s = 0; s < dfa->ns; ++s) {
+    for (auto& transition : transitions[s]) {
+      predecessors[transition.second].push_back(s);
+    }
+  }
+  std::vector<bool> is_live (dfa->ns, false);
+  std::stack<int> pending;
+  for (int s = 0; s < dfa->ns; ++s) {
+    if (DFAIsAcceptingState(dfa, s)) {
+      is_live[s] = true;
+      pending.push(s);
+    }
+  }
+  while (not pending.empty()) {
+    const int s = pending.top();
+    pending.pop();
+    for (auto predecessor : predecessors[s]) {
+      if (not is_live[predecessor]) {
+        is_live[predecessor] = true;
+        pending.push(predecessor);
+      }
+    }
+  }
+  return is_live;
+}
+
+std::vector<bool> StringAutomaton::GetLiveStates(const DFA_ptr dfa, const std::vector<int>& successors) {
+  std::vector<std::vector<std::pair<std::string, int>>> transitions (dfa->ns);
+  for (int s = 0; s < dfa->ns; ++s) {
+    if (successors[s] >= 0) {
+      transitions[s].push_back(std::make_pair(std::string(), successors[s]));
+    }
+  }
+  return GetLiveStates(dfa, transitions);
+}
+
+bool StringAutomaton::IntersectSymbols(const std::string& left, const std::string& right, std::string& result) {
+  result = left;
+  for (std::size_t i = 0; i < left.size(); ++i) {
+    if (left[i] == 'X') {
+      result[i] = right[i];
+    } else if (right[i] != 'X' and right[i] != left[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+DFA_ptr StringAutomaton::MakeLinearDFA(const std::vector<int>& coefficients, const BigInteger& constant,
+                                       const ArithmeticFormula::Type type) {
+  auto formula = new ArithmeticFormula();
+  for (std::size_t i = 0; i < coefficients.size(); ++i) {
+    formula->AddVariable("x" + std::to_string(i), coefficients[i]);
+  }
+  formula->SetConstant(constant);
+  formula->SetType(type);
+  auto binary_auto = BinaryIntAutomaton::MakeAutomaton(formula, false);
+  DFA_ptr linear_dfa = dfaCopy(binary_auto->getDFA());
+  delete binary_auto;
+  return linear_dfa;
+}
+
+DFA_ptr StringAutomaton::MakeDecimalDigitDFA(const int digit, const bool appending) {
+  if (appending) {
+    // x1 = 10 * x0 + digit
+    return MakeLinearDFA({-10, 1}, -digit, ArithmeticFormula::Type::EQ);
+  }
+  // x0 = 10 * x1 + digit
+  return MakeLinearDFA({1, -10}, -digit, ArithmeticFormula::Type::EQ);
+}
+
+DFA_ptr StringAutomaton::ApplyDecimalDigit(const DFA_ptr values_dfa, const DFA_ptr digit_dfa) {
+  DFA_ptr product_dfa = DFAIntersect(values_dfa, digit_dfa);
+  DFA_ptr next_dfa = DFAProjectTo(product_dfa, 2, 1);
+  dfaFree(product_dfa);
+  return next_dfa;
+}
+
+DFA_ptr StringAutomaton::BoundIntegerValues(const DFA_ptr values_dfa, const DFA_ptr low_dfa, const DFA_ptr high_dfa) {
+  DFA_ptr bounded_dfa = DFAIntersect(values_dfa, low_dfa);
+  DFA_ptr large_values_dfa = DFAIntersect(values_dfa, high_dfa);
+  if (not DFAIsMinimizedEmtpy(large_values_dfa)) {
+    DFA_ptr tmp_dfa = bounded_dfa;
+    bounded_dfa = DFAUnion(tmp_dfa, high_dfa);
+    dfaFree(tmp_dfa);
+  }
+  dfaFree(large_values_dfa);
+  return bounded_dfa;
+}
+
+std::vector<std::vector<std::pair<int, int>>> StringAutomaton::GetDigitTransitions(const DFA_ptr dfa,
+                                                                                  const int number_of_bits) {
+  std::vector<std::string> digit_symbols;
+  for (int digit = 0; digit < 10; ++digit) {
+    const unsigned long code = encoding_.Encode(static_cast<unsigned char>('0' + digit));
+    digit_symbols.push_back(Transducer::GetSymbol(code, number_of_bits));
+  }
+  auto transitions = GetSymbolicTransitions(dfa, number_of_bits);
+  std::vector<std::vector<std::pair<int, int>>> digit_transitions (dfa->ns);
+  std::string symbol;
+  for (int s = 0; s < dfa->ns; ++s) {
+    for (auto& transition : transitions[s]) {
+      for (int digit = 0; digit < 10; ++digit) {
+        if (IntersectSymbols(transition.first, digit_symbols[digit], symbol)) {
+          digit_transitions[s].push_back(std::make_pair(digit, transition.second));
+        }
+      }
+    }
+  }
+  return digit_transitions;
+}
+
 StringAutomaton_ptr StringAutomaton::IndexOfHelper(StringAutomaton_ptr search_auto) {
 	StringAutomaton_ptr index_of_auto = nullptr;
 	index_of_auto = this->Search(search_auto);
 	int sink_state = index_of_auto->GetSinkState();
 	int current_state = -1;
 	int next_state = -1;
-	std::vector<char> flag = {'1', '1', '1', '1', '1', '1', '1', '1', '1'}; // 255 (+1 extrabit)
+	std::vector<char> flag(VAR_PER_TRACK, '1'); // 255 (+1 extrabit)
 	std::set<int> next_states;
 	std::stack<int> state_work_list;
 	std::map<int, bool> visited;
@@ -5829,7 +6546,7 @@ StringAutomaton_ptr StringAutomaton::LastIndexOfHelper(StringAutomaton_ptr searc
 
 	Graph_ptr graph = search_result_auto->toGraph();
 	// Mark start state of a match
-	std::vector<char> flag_1_exception = {'1', '1', '1', '1', '1', '1', '1', '1', '1'}; // 255
+	std::vector<char> flag_1_exception(VAR_PER_TRACK, '1'); // 255
 	GraphNode_ptr node = nullptr;
 	int sink_state = search_result_auto->GetSinkState();
 	int next_state = -1;
@@ -6261,7 +6978,7 @@ StringAutomaton_ptr StringAutomaton::Search(StringAutomaton_ptr search_auto) {
  * Can be generalize to general replace algorithm
  */
 StringAutomaton_ptr StringAutomaton::RemoveReservedWords() {
-	if(this->num_of_bdd_variables_ < 9) {
+	if(this->num_of_bdd_variables_ < VAR_PER_TRACK) {
 		LOG(FATAL) << "can't remove reserved words without first having extra bit";
 	}
 	StringAutomaton_ptr string_auto = nullptr;
@@ -6269,8 +6986,9 @@ StringAutomaton_ptr StringAutomaton::RemoveReservedWords() {
 	paths state_paths = nullptr, pp = nullptr;
 	trace_descr tp = nullptr;
 
-	std::vector<char> flag_1 = {'1', '1', '1', '1', '1', '1', '1', '1', '1'}; // 255
-	std::vector<char> flag_2 = {'1', '1', '1', '1', '1', '1', '1', '0', '1'}; // 254
+	std::vector<char> flag_1(VAR_PER_TRACK, '1'); // 255
+	std::vector<char> flag_2(VAR_PER_TRACK, '1'); // 254
+	flag_2[VAR_PER_TRACK - 2] = '0';
 
 	std::map<int, std::set<int>> merged_states_via_reserved_words;
 	std::map<int, int> state_id_map;
@@ -6426,6 +7144,10 @@ StringAutomaton_ptr StringAutomaton::RemoveReservedWords() {
 	return string_auto;
 }
 
+std::string StringAutomaton::DecodeSymbol(const unsigned long symbol) const {
+  return encoding_.GetString(encoding_.Decode(symbol));
+}
+
 void StringAutomaton::AddPrintLabel(std::ostream& out) {
 	out << " subgraph cluster_0 {\n";
 	out << "  style = invis;\n  center = true;\n  margin = 0;\n";
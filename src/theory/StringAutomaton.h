@@ -15,6 +15,7 @@
 #include <set>
 #include <sstream>
 #include <stack>
+#include <tuple>
 #include <string>
 #include <utility>
 #include <vector>
@@ -27,7 +28,9 @@
 #include "Graph.h"
 #include "GraphNode.h"
 #include "IntAutomaton.h"
+#include "StringEncoding.h"
 #include "StringFormula.h"
+#include "Transducer.h"
 
 namespace Vlab {
 namespace Theory {
@@ -93,7 +96,7 @@ public:
    * @param number_of_bdd_variables
    * @return
    */
-  static StringAutomaton_ptr MakeCharRange(const char from, const char to, const int number_of_bdd_variables = StringAutomaton::DEFAULT_NUM_OF_VARIABLES);
+  static StringAutomaton_ptr MakeCharRange(const unsigned long from, const unsigned long to, const int number_of_bdd_variables = StringAutomaton::DEFAULT_NUM_OF_VARIABLES);
 
   /**
    * Generates a string automaton that accepts any character. It is equivalent to the string automaton that accepts any strings with length 1
@@ -240,13 +243,42 @@ public:
 
   StringAutomaton_ptr Replace(StringAutomaton_ptr search_auto, StringAutomaton_ptr replace_auto);
 
+  /**
+   * Image and pre image of the strings under a transducer over the codes of the current encoding
+   */
+  StringAutomaton_ptr Transduce(const Transducer& transducer);
+  StringAutomaton_ptr PreTransduce(const Transducer& transducer, StringAutomaton_ptr range_auto = nullptr);
+
+  static Transducer MakeToUpperCaseTransducer();
+  static Transducer MakeToLowerCaseTransducer();
+  static Transducer MakeTrimTransducer(char c = ' ');
+  static Transducer MakeReplaceTransducer(const std::string& search, const std::string& replace);
+  static Transducer MakeReplaceTransducer(const std::string& search, StringAutomaton_ptr replace_auto);
+
   StringAutomaton_ptr GetAnyStringNotContainsMe();
 
   UnaryAutomaton_ptr ToUnaryAutomaton();
   IntAutomaton_ptr ParseToIntAutomaton();
+
+  /**
+   * Values of the decimal strings as a binary integer automaton over the variables of the formula, only the
+   * track of the variable is constrained; has -1 if there is a non-numeric string. Takes the ownership of the formula.
+   */
+  BinaryIntAutomaton_ptr ParseToBinaryIntAutomaton(std::string var_name, ArithmeticFormula_ptr formula);
+
+  /**
+   * Decimal strings of the non-negative values of a single track binary integer automaton
+   * @param with_leading_zeros accepts strings with leading zeros (str.to.int), canonical strings otherwise
+   */
+  static StringAutomaton_ptr MakeDecimalStrings(BinaryIntAutomaton_ptr binary_auto, const bool with_leading_zeros);
   IntAutomaton_ptr Length();
   StringAutomaton_ptr RestrictLengthTo(int length);
   StringAutomaton_ptr RestrictLengthTo(IntAutomaton_ptr length_auto);
+  /**
+   * Length abstraction, an over-approximation that only keeps the lengths of the strings
+   * @return automaton that accepts any string with the length of an accepted string
+   */
+  StringAutomaton_ptr WidenToLengths();
 
   StringAutomaton_ptr RestrictIndexOfTo(int index, StringAutomaton_ptr search_auto);
   StringAutomaton_ptr RestrictIndexOfTo(IntAutomaton_ptr index_auto, StringAutomaton_ptr search_auto);
@@ -293,12 +325,64 @@ public:
   std::string GetAnAcceptingString();
   std::string GetAnAcceptingStringRandom();
 
+  /**
+   * Encoding of the string automata of one driver. While a context is installed with a Context::Scope,
+   * automata are built, counted and read with its encoding and SetEncoding changes it; the installed context
+   * is per thread. A driver installs its context in each of its entry points, hence the automata of two
+   * drivers can be used alternately.
+   */
+  class Context {
+   public:
+    Context();
+
+    /**
+     * Installs a context until the end of the enclosing block, the previous one is installed again afterwards;
+     * the encoding of the outermost context stays in effect outside of all scopes
+     */
+    class Scope {
+     public:
+      Scope(Context* context);
+      ~Scope();
+      Scope(const Scope&) = delete;
+      Scope& operator=(const Scope&) = delete;
+     private:
+      Context* previous_;
+    };
+
+   private:
+    friend class StringAutomaton;
+    StringEncoding encoding_;
+    static thread_local Context* current_;
+  };
+
+  /**
+   * Sets the encoding used by the automata constructed afterwards, characters of a class share a code
+   * and counts are weighted with class sizes. String tracks take the number of bits of the encoding.
+   * The encoding is stored in the installed context, if any.
+   */
+  static void SetEncoding(const StringEncoding& encoding);
+  static const StringEncoding& GetEncoding();
+
   StringFormula_ptr GetFormula();
   void SetFormula(StringFormula_ptr formula);
 
   static const TransitionVector& GenerateTransitionsForRelation(StringFormula::Type type, int bits_per_var);
 	static DFA_ptr MakeBinaryRelationDfa(StringFormula::Type type, int bits_per_var, int num_tracks, int left_track, int right_track);
 	static DFA_ptr MakeBinaryAlignedDfa(int left_track, int right_track, int total_tracks);
+
+	/**
+	 * Right track is a prefix of the left track
+	 */
+	static DFA_ptr MakeBeginsDfa(int bits_per_var, int num_tracks, int left_track, int right_track);
+
+	/**
+	 * Reads the same symbol on two tracks at every position; built as the conjunction of one automaton per bit,
+	 * so the bdd grows with the number of bits instead of the number of pairs of equal characters.
+	 * Prefixes of accepted words are accepted, intersect it with an automaton that fixes the layout.
+	 * @param unless_lambda_track track whose lambda lifts the equality at a position, -1 for none
+	 */
+	static DFA_ptr MakeTrackEqualityDfa(int bits_per_var, int num_tracks, int left_track, int right_track,
+	                                    int unless_lambda_track = -1);
 	static DFA_ptr MakeRelationalCharAtDfa(StringFormula_ptr formula, int bits_per_var, int num_tracks, int left_track, int right_track);
 	static DFA_ptr MakeRelationalLenDfa(StringFormula_ptr formula, int bits_per_var, int num_tracks, int left_track, int right_track);
 	static StringAutomaton_ptr MakePrefixSuffix(int left_track, int prefix_track, int suffix_track, int num_tracks);
@@ -325,19 +409,101 @@ protected:
 
   StringAutomaton_ptr IndexOfHelper(StringAutomaton_ptr search_auto);
   StringAutomaton_ptr LastIndexOfHelper(StringAutomaton_ptr search_auto);
+
+  /**
+   * Single pass constructions that run the dfa in lockstep with unary index and length automata,
+   * the result is determinized once
+   */
+  StringAutomaton_ptr SuffixesAtIndexDirect(IntAutomaton_ptr indices_auto);
+  StringAutomaton_ptr SubStringDirect(IntAutomaton_ptr start_auto, IntAutomaton_ptr length_auto);
+
+  /**
+   * @return strings that have a sub string of the sub string auto at an index of the index auto (or at 0)
+   */
+  StringAutomaton_ptr RestrictAtIndexDirect(IntAutomaton_ptr index_auto, StringAutomaton_ptr sub_string_auto,
+                                            const bool at_zero);
+
+  /**
+   * @return indices of the matches of the search auto that are not before an index of the from index auto
+   */
+  IntAutomaton_ptr MatchIndicesDirect(StringAutomaton_ptr search_auto, IntAutomaton_ptr from_index_auto);
+
+  /**
+   * States reached by reading n characters for some n of the index auto
+   */
+  std::set<int> GetStatesAtIndex(const std::vector<std::vector<std::pair<std::string, int>>>& transitions,
+                                 IntAutomaton_ptr index_auto);
+
+  /**
+   * @return transitions of each state of a dfa as cubes, transitions to the sink state are left out
+   */
+  static std::vector<std::vector<std::pair<std::string, int>>> GetSymbolicTransitions(const DFA_ptr dfa,
+                                                                                       const int number_of_bits);
+  /**
+   * @return successor of each state of a unary dfa, -1 for the sink state
+   */
+  static std::vector<int> GetUnarySuccessors(const DFA_ptr dfa);
+  static std::vector<bool> GetLiveStates(const DFA_ptr dfa,
+                                         const std::vector<std::vector<std::pair<std::string, int>>>& transitions);
+  static std::vector<bool> GetLiveStates(const DFA_ptr dfa, const std::vector<int>& successors);
+  static bool IntersectSymbols(const std::string& left, const std::string& right, std::string& result);
+
+  /**
+   * @return single track binary dfa of the values of the linear formula over the tracks x0, x1, ...
+   */
+  static DFA_ptr MakeLinearDFA(const std::vector<int>& coefficients, const BigInteger& constant,
+                               const ArithmeticFormula::Type type);
+
+  /**
+   * Relation between binary tracks 0 and 1 for a decimal digit: track 1 is track 0 with the digit appended
+   * if appending, track 0 is track 1 with the digit appended otherwise
+   */
+  static DFA_ptr MakeDecimalDigitDFA(const int digit, const bool appending);
+
+  /**
+   * @return values of track 1 for the values of the single track dfa on track 0
+   */
+  static DFA_ptr ApplyDecimalDigit(const DFA_ptr values_dfa, const DFA_ptr digit_dfa);
+
+  /**
+   * Keeps the values up to the largest integer of the integer width and replaces larger values with all of them
+   */
+  static DFA_ptr BoundIntegerValues(const DFA_ptr values_dfa, const DFA_ptr low_dfa, const DFA_ptr high_dfa);
+
+  /**
+   * @return digit of each transition that reads a decimal digit, a transition may read more than one digit
+   */
+  static std::vector<std::vector<std::pair<int, int>>> GetDigitTransitions(const DFA_ptr dfa, const int number_of_bits);
   StringAutomaton_ptr GetDuplicateStateAutomaton();
   StringAutomaton_ptr ToQueryAutomaton();
   StringAutomaton_ptr Search(StringAutomaton_ptr search_auto);
   StringAutomaton_ptr RemoveReservedWords();
   virtual void AddPrintLabel(std::ostream& out);
+  virtual std::string DecodeSymbol(const unsigned long symbol) const;
+
+  /**
+   * Counts transitions by the number of characters their codes encode
+   */
+  void SetWeightedSymbolicCounter();
+
+  /**
+   * Tracks are independent, the weight of a transition is the product of the weights of its tracks
+   * @param transition bdd variable assignment of a transition ('0', '1' or 'X')
+   * @param track_weights weights of the bit patterns of tracks seen so far
+   * @return number of symbols of the transition, a track with its lambda bit set counts as one
+   */
+  BigInteger GetTransitionWeight(const std::vector<char>& transition,
+                                 std::map<std::string, unsigned long>& track_weights) const;
 
 
   int num_tracks_;
   StringFormula_ptr formula_;
   static TransitionTable TRANSITION_TABLE;
-  static const int VAR_PER_TRACK = 9;
-  static const int DEFAULT_NUM_OF_VARIABLES = 8;
+  // encoding of the installed context and the track widths it implies
+  static thread_local int VAR_PER_TRACK;
+  static thread_local int DEFAULT_NUM_OF_VARIABLES;
   static bool debug;
+  static thread_local StringEncoding encoding_;
 
 private:
   StringAutomaton();
@@ -10,13 +10,297 @@
 namespace Vlab {
 namespace Theory {
 
-StringEncoding::StringEncoding() {
-  // TODO Auto-generated constructor stub
+const int StringEncoding::VLOG_LEVEL = 19;
 
+StringEncoding::StringEncoding(const int character_width)
+    : character_width_ { character_width },
+      alphabet_size_ { 1UL << character_width },
+      is_identity_ { true },
+      rest_class_ { -1 } {
+  CHECK(character_width == 8 or character_width == 16 or character_width == MAX_CHARACTER_WIDTH)
+      << "unsupported character width: " << character_width;
 }
 
 StringEncoding::~StringEncoding() {
-  // TODO Auto-generated destructor stub
+}
+
+void StringEncoding::AddCharacterRange(const unsigned long from, const unsigned long to) {
+  const unsigned long last = alphabet_size_ - 1;
+  ranges_.insert(std::make_pair(std::min(std::min(from, to), last), std::min(std::max(from, to), last)));
+}
+
+void StringEncoding::AddString(const std::string& str) {
+  for (auto c : GetCharacters(str)) {
+    AddCharacterRange(c, c);
+  }
+}
+
+void StringEncoding::AddRegularExpression(Util::RegularExpression_ptr regular_expression) {
+  switch (regular_expression->type()) {
+    case Util::RegularExpression::Type::UNION:
+    case Util::RegularExpression::Type::CONCATENATION:
+    case Util::RegularExpression::Type::INTERSECTION:
+      AddRegularExpression(regular_expression->get_expr1());
+      AddRegularExpression(regular_expression->get_expr2());
+      break;
+    case Util::RegularExpression::Type::OPTIONAL:
+    case Util::RegularExpression::Type::REPEAT_STAR:
+    case Util::RegularExpression::Type::REPEAT_PLUS:
+    case Util::RegularExpression::Type::REPEAT_MIN:
+    case Util::RegularExpression::Type::REPEAT_MINMAX:
+    case Util::RegularExpression::Type::COMPLEMENT:
+      AddRegularExpression(regular_expression->get_expr1());
+      break;
+    case Util::RegularExpression::Type::CHAR:
+      AddCharacterRange(regular_expression->get_character(), regular_expression->get_character());
+      break;
+    case Util::RegularExpression::Type::CHAR_RANGE:
+      AddCharacterRange(regular_expression->get_from_character(), regular_expression->get_to_character());
+      break;
+    case Util::RegularExpression::Type::STRING:
+      AddString(regular_expression->get_string());
+      break;
+    default:
+      // any char, any string and empty do not distinguish characters
+      break;
+  }
+}
+
+void StringEncoding::Build() {
+  // elementary intervals start at 0 and at every boundary of a set
+  std::set<unsigned long> boundaries { 0 };
+  for (auto& range : ranges_) {
+    boundaries.insert(range.first);
+    if (range.second + 1 < alphabet_size_) {
+      boundaries.insert(range.second + 1);
+    }
+  }
+  interval_starts_.assign(boundaries.begin(), boundaries.end());
+  auto interval_of = [this](const unsigned long c) {
+    return std::upper_bound(interval_starts_.begin(), interval_starts_.end(), c) - interval_starts_.begin() - 1;
+  };
+
+  // sets that contain an interval
+  std::vector<std::vector<int>> signatures(interval_starts_.size());
+  int set_id = 0;
+  for (auto& range : ranges_) {
+    for (auto i = interval_of(range.first); i <= interval_of(range.second); ++i) {
+      signatures[i].push_back(set_id);
+    }
+    ++set_id;
+  }
+
+  auto rank = [](const unsigned long c) {
+    if (c >= 'a' and c <= 'z') {
+      return 0;
+    } else if (c >= 'A' and c <= 'Z') {
+      return 1;
+    } else if (c >= '0' and c <= '9') {
+      return 2;
+    } else if (c >= 32 and c <= 126) {
+      return 3;
+    }
+    return 4;
+  };
+  // most readable character of an interval
+  auto representative_of = [&rank](const unsigned long from, const unsigned long to) {
+    for (auto& preferred : { std::make_pair('a', 'z'), std::make_pair('A', 'Z'), std::make_pair('0', '9'),
+                             std::make_pair(' ', '~') }) {
+      const unsigned long candidate = std::max<unsigned long>(from, preferred.first);
+      if (candidate <= to and candidate <= static_cast<unsigned long>(preferred.second)) {
+        return candidate;
+      }
+    }
+    return from;
+  };
+
+  // classes are numbered in the order of their smallest character
+  std::map<std::vector<int>, int> class_ids;
+  interval_classes_.assign(interval_starts_.size(), -1);
+  class_sizes_.clear();
+  representatives_.clear();
+  rest_class_ = -1;
+  for (std::size_t i = 0; i < interval_starts_.size(); ++i) {
+    const unsigned long from = interval_starts_[i];
+    const unsigned long to = (i + 1 < interval_starts_.size()) ? interval_starts_[i + 1] - 1 : alphabet_size_ - 1;
+    auto it = class_ids.find(signatures[i]);
+    if (it == class_ids.end()) {
+      it = class_ids.insert(std::make_pair(signatures[i], static_cast<int>(class_sizes_.size()))).first;
+      class_sizes_.push_back(0);
+      representatives_.push_back(from);
+    }
+    const int class_id = it->second;
+    interval_classes_[i] = class_id;
+    class_sizes_[class_id] += to - from + 1;
+    const unsigned long candidate = representative_of(from, to);
+    if (rank(candidate) < rank(representatives_[class_id])) {
+      representatives_[class_id] = candidate;
+    }
+    if (signatures[i].empty()) {
+      rest_class_ = class_id;
+    }
+  }
+
+  class_size_sums_.assign(1, 0);
+  for (auto class_size : class_sizes_) {
+    class_size_sums_.push_back(class_size_sums_.back() + class_size);
+  }
+
+  // unassigned codes stand for the characters that are not in any set, there must be such a character
+  is_identity_ = (rest_class_ == -1 or class_sizes_.size() == alphabet_size_);
+  DVLOG(VLOG_LEVEL) << "string encoding: " << str();
+}
+
+bool StringEncoding::is_identity() const {
+  return is_identity_;
+}
+
+int StringEncoding::get_character_width() const {
+  return character_width_;
+}
+
+unsigned long StringEncoding::get_alphabet_size() const {
+  return alphabet_size_;
+}
+
+unsigned long StringEncoding::get_number_of_classes() const {
+  if (is_identity_) {
+    return alphabet_size_;
+  }
+  return class_sizes_.size();
+}
+
+int StringEncoding::get_number_of_bits() const {
+  if (is_identity_) {
+    return character_width_;
+  }
+  int number_of_bits = 1;
+  while ((1UL << number_of_bits) < get_number_of_classes()) {
+    ++number_of_bits;
+  }
+  return number_of_bits;
+}
+
+unsigned long StringEncoding::Encode(const unsigned long character) const {
+  if (is_identity_) {
+    return character;
+  }
+  auto it = std::upper_bound(interval_starts_.begin(), interval_starts_.end(), character);
+  return interval_classes_[it - interval_starts_.begin() - 1];
+}
+
+std::vector<std::pair<unsigned long, unsigned long>> StringEncoding::EncodeRange(const unsigned long from,
+                                                                                 const unsigned long to) const {
+  std::vector<std::pair<unsigned long, unsigned long>> code_ranges;
+  if (is_identity_) {
+    code_ranges.push_back(std::make_pair(from, to));
+    return code_ranges;
+  }
+
+  std::set<unsigned long> codes;
+  auto it = std::upper_bound(interval_starts_.begin(), interval_starts_.end(), from) - 1;
+  for (; it != interval_starts_.end() and *it <= to; ++it) {
+    codes.insert(interval_classes_[it - interval_starts_.begin()]);
+  }
+  for (auto code : codes) {
+    if (not code_ranges.empty() and code_ranges.back().second + 1 == code) {
+      code_ranges.back().second = code;
+    } else {
+      code_ranges.push_back(std::make_pair(code, code));
+    }
+  }
+  return code_ranges;
+}
+
+unsigned long StringEncoding::Decode(const unsigned long code) const {
+  if (is_identity_) {
+    return code;
+  } else if (code < class_sizes_.size()) {
+    return representatives_[code];
+  }
+  return representatives_[rest_class_];
+}
+
+unsigned long StringEncoding::get_weight(const unsigned long code) const {
+  if (is_identity_) {
+    return 1;
+  } else if (code < class_sizes_.size()) {
+    return class_sizes_[code];
+  }
+  return 0;
+}
+
+unsigned long StringEncoding::get_weight(const std::string& bit_pattern) const {
+  if (is_identity_) {
+    return 1UL << std::count(bit_pattern.begin(), bit_pattern.end(), 'X');
+  }
+  return get_weight(bit_pattern, 0, 0);
+}
+
+unsigned long StringEncoding::get_weight(const std::string& bit_pattern, const std::size_t position,
+                                         const unsigned long code_prefix) const {
+  // codes that start with the prefix form the range [from, from + 2^remaining_bits)
+  const std::size_t remaining_bits = bit_pattern.size() - position;
+  const unsigned long number_of_classes = class_sizes_.size();
+  const unsigned long from = code_prefix << remaining_bits;
+  if (from >= number_of_classes) {
+    return 0;
+  } else if (bit_pattern.find_first_not_of('X', position) == std::string::npos) {
+    const unsigned long to = std::min(from + (1UL << remaining_bits), number_of_classes);
+    return class_size_sums_[to] - class_size_sums_[from];
+  }
+
+  unsigned long weight = 0;
+  if (bit_pattern[position] != '1') {
+    weight += get_weight(bit_pattern, position + 1, code_prefix << 1);
+  }
+  if (bit_pattern[position] != '0') {
+    weight += get_weight(bit_pattern, position + 1, (code_prefix << 1) | 1);
+  }
+  return weight;
+}
+
+std::vector<unsigned long> StringEncoding::GetCharacters(const std::string& str) const {
+  std::vector<unsigned long> characters;
+  if (character_width_ == DEFAULT_CHARACTER_WIDTH) {
+    for (auto c : str) {
+      characters.push_back(static_cast<unsigned char>(c));
+    }
+    return characters;
+  }
+
+  for (auto code_point : Util::Unicode::to_code_points(str)) {
+    if (code_point < alphabet_size_) {
+      characters.push_back(code_point);
+    } else {
+      // utf-16 code units, a surrogate pair for the code points beyond the basic plane
+      code_point -= 0x10000;
+      characters.push_back(0xD800 + ((code_point >> 10) & 0x3FF));
+      characters.push_back(0xDC00 + (code_point & 0x3FF));
+    }
+  }
+  return characters;
+}
+
+std::string StringEncoding::GetString(const unsigned long character) const {
+  if (character_width_ == DEFAULT_CHARACTER_WIDTH) {
+    return std::string(1, static_cast<char>(character));
+  }
+  return Util::Unicode::to_utf8(character);
+}
+
+std::string StringEncoding::str() const {
+  std::stringstream ss;
+  ss << character_width_ << " bit characters, ";
+  if (is_identity_) {
+    ss << "identity";
+    return ss.str();
+  }
+  ss << class_sizes_.size() << " classes (" << get_number_of_bits() << " bits):";
+  for (std::size_t i = 0; i < class_sizes_.size(); ++i) {
+    ss << " [" << i << ": '" << GetString(representatives_[i]) << "' x " << class_sizes_[i] << "]";
+  }
+  return ss.str();
 }
 
 } /* namespace Theory */
@@ -8,23 +8,123 @@
 #ifndef SRC_THEORY_STRINGENCODING_H_
 #define SRC_THEORY_STRINGENCODING_H_
 
+#include <algorithm>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "../utils/RegularExpression.h"
+#include "../utils/Unicode.h"
+
 namespace Vlab {
 namespace Theory {
 
 /**
- * TODO add an encoding class for all types
- * 1- can be added a base encoding
- * 2- encoding describes how we map alphabet used in automata to bdd transitions
+ * Maps the alphabet used in automata to bdd transitions.
+ * The alphabet has 2^character_width characters; with a width above 8, strings are read as utf-8 and
+ * characters are code points.
+ * Characters that are not distinguished by any of the added character sets form a class and share a code;
+ * codes are dense from 0 and string tracks are narrowed to the bits the codes need. The class of characters
+ * that are not in any set is kept, codes that are not assigned to a class behave like that class.
+ * Without added sets (or when every character is distinguished) the encoding is the identity.
+ * Sets are kept as intervals, the cost of building an encoding does not depend on the alphabet size.
  */
 class StringEncoding {
  public:
-  StringEncoding();
-  StringEncoding(int alphabet_size);
+  StringEncoding(const int character_width = DEFAULT_CHARACTER_WIDTH);
+  virtual ~StringEncoding();
+
+  /**
+   * Distinguishes the characters in the range from the others
+   */
+  void AddCharacterRange(const unsigned long from, const unsigned long to);
+
+  /**
+   * Distinguishes each character of the string
+   */
+  void AddString(const std::string& str);
+
+  /**
+   * Distinguishes characters and character ranges of a regular expression
+   */
+  void AddRegularExpression(Util::RegularExpression_ptr regular_expression);
+
+  /**
+   * Computes the classes from the added sets
+   */
+  void Build();
+
+  bool is_identity() const;
+  int get_character_width() const;
+  unsigned long get_alphabet_size() const;
+  unsigned long get_number_of_classes() const;
+
+  /**
+   * @return number of bits per character in string tracks, log2 of the number of classes rounded up
+   * for compressed alphabets
+   */
+  int get_number_of_bits() const;
+
+  unsigned long Encode(const unsigned long character) const;
+
+  /**
+   * @return codes of the characters in the range, as sorted intervals of codes
+   */
+  std::vector<std::pair<unsigned long, unsigned long>> EncodeRange(const unsigned long from,
+                                                                   const unsigned long to) const;
+
+  /**
+   * @return a character of the class of the code, preferably a printable one
+   */
+  unsigned long Decode(const unsigned long code) const;
+
+  /**
+   * @return number of characters encoded by the code, 0 for codes that are not assigned to a class
+   */
+  unsigned long get_weight(const unsigned long code) const;
+
+  /**
+   * @param bit_pattern bits of a code, the most significant bit first, 'X' matches both values
+   * @return number of characters encoded by the codes that match the pattern
+   */
+  unsigned long get_weight(const std::string& bit_pattern) const;
+
+  /**
+   * @return characters of the string, bytes for the 8 bit alphabet, utf-8 code points otherwise
+   */
+  std::vector<unsigned long> GetCharacters(const std::string& str) const;
+
+  /**
+   * @return the character as a string, a byte for the 8 bit alphabet, utf-8 otherwise
+   */
+  std::string GetString(const unsigned long character) const;
+
+  std::string str() const;
+
+  static const int DEFAULT_CHARACTER_WIDTH = 8;
+  static const int MAX_CHARACTER_WIDTH = 21;
+
  private:
-  int alphabet_size_;
-  int number_of_bdd_variables_;
-  int* bdd_variable_indices_;
+  unsigned long get_weight(const std::string& bit_pattern, const std::size_t position,
+                           const unsigned long code_prefix) const;
+
+  int character_width_;
+  unsigned long alphabet_size_;
+  bool is_identity_;
+  int rest_class_;
+  std::set<std::pair<unsigned long, unsigned long>> ranges_;
+  std::vector<unsigned long> interval_starts_;  // elementary intervals that no set splits
+  std::vector<int> interval_classes_;
+  std::vector<unsigned long> class_sizes_;
+  std::vector<unsigned long> class_size_sums_;  // number of characters with a code below the index
+  std::vector<unsigned long> representatives_;
 
+  static const int VLOG_LEVEL;
 };
 
 } /* namespace Theory */
@@ -25,7 +25,8 @@ StringFormula::~StringFormula() {
 StringFormula::StringFormula(const StringFormula& other)
     : Formula(other),
     	type_(other.type_),
-      constant_(other.constant_) {
+      constant_(other.constant_),
+      track_order_(other.track_order_) {
   this->mixed_terms_ = other.mixed_terms_;
 }
 
@@ -128,6 +129,10 @@ std::string StringFormula::str() const {
 
 StringFormula_ptr StringFormula::Intersect(Formula_ptr other) {
 	StringFormula_ptr intersect_formula = this->clone();
+	auto other_formula = dynamic_cast<StringFormula_ptr>(other);
+	if (intersect_formula->track_order_.empty() and other_formula != nullptr) {
+		intersect_formula->track_order_ = other_formula->track_order_;
+	}
 	//intersect_formula->MergeVariables(other);
 	intersect_formula->ResetCoefficients(0);
 	intersect_formula->SetType(StringFormula::Type::INTERSECT);
@@ -136,6 +141,10 @@ StringFormula_ptr StringFormula::Intersect(Formula_ptr other) {
 
 StringFormula_ptr StringFormula::Union(Formula_ptr other) {
 	StringFormula_ptr union_formula = this->clone();
+	auto other_formula = dynamic_cast<StringFormula_ptr>(other);
+	if (union_formula->track_order_.empty() and other_formula != nullptr) {
+		union_formula->track_order_ = other_formula->track_order_;
+	}
 	//union_formula->MergeVariables(other);
 	union_formula->ResetCoefficients(0);
 	union_formula->SetType(StringFormula::Type::UNION);
@@ -259,6 +268,56 @@ void StringFormula::MergeVariables(Formula_ptr other) {
       variable_coefficient_map_[el.first] = 0;
     }
   }
+  // formulas of a group must agree on the tracks of the variables
+  auto other_formula = dynamic_cast<StringFormula_ptr>(other);
+  if (track_order_.empty() and other_formula != nullptr) {
+    track_order_ = other_formula->track_order_;
+  }
+}
+
+void StringFormula::SetTrackOrder(const std::vector<std::string>& track_order) {
+  track_order_ = track_order;
+}
+
+const std::vector<std::string>& StringFormula::GetTrackOrder() const {
+  return track_order_;
+}
+
+int StringFormula::GetVariableIndex(std::string variable_name) const {
+  if (track_order_.empty()) {
+    return Formula::GetVariableIndex(variable_name);
+  }
+  auto tracks = GetTracks();
+  auto it = std::find(tracks.begin(), tracks.end(), variable_name);
+  if (it != tracks.end()) {
+    return std::distance(tracks.begin(), it);
+  }
+  LOG(FATAL)<< "Variable '" << variable_name << "' is not in formula: " << str();
+  return -1;
+}
+
+int StringFormula::GetVariableIndex(const std::size_t param_index) const {
+  if (track_order_.empty()) {
+    return Formula::GetVariableIndex(param_index);
+  }
+  for (const auto& el : variable_coefficient_map_) {
+    if (el.second == param_index) {
+      return GetVariableIndex(el.first);
+    }
+  }
+  LOG(FATAL)<< "Formula does not have param: " << param_index << ", " << str();
+  return -1;
+}
+
+std::string StringFormula::GetVariableAtIndex(const std::size_t index) const {
+  if (track_order_.empty()) {
+    return Formula::GetVariableAtIndex(index);
+  }
+  auto tracks = GetTracks();
+  if (index >= tracks.size()) {
+    LOG(FATAL) << "Index out of range : " << index;
+  }
+  return tracks[index];
 }
 
 bool StringFormula::GetVarNamesIfEqualityOfTwoVars(std::string &v1, std::string &v2) {
@@ -285,6 +344,21 @@ bool StringFormula::GetVarNamesIfEqualityOfTwoVars(std::string &v1, std::string
   return ((active_vars == 2) and !v1.empty() and !v2.empty());
 }
 
+std::vector<std::string> StringFormula::GetTracks() const {
+  std::vector<std::string> tracks;
+  for (const auto& var_name : track_order_) {
+    if (variable_coefficient_map_.find(var_name) != variable_coefficient_map_.end()) {
+      tracks.push_back(var_name);
+    }
+  }
+  for (const auto& el : variable_coefficient_map_) {
+    if (std::find(track_order_.begin(), track_order_.end(), el.first) == track_order_.end()) {
+      tracks.push_back(el.first);
+    }
+  }
+  return tracks;
+}
+
 std::ostream& operator<<(std::ostream& os, const StringFormula& formula) {
   return os << formula.str();
 }
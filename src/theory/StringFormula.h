@@ -8,6 +8,7 @@
 #ifndef THEORY_STRINGFORMULA_H_
 #define THEORY_STRINGFORMULA_H_
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <locale>
@@ -64,10 +65,21 @@ class StringFormula : public Formula {
   int CountOnes(unsigned long n) const;
   virtual void MergeVariables(Formula_ptr);
 
+  /**
+   * Tracks of the variables in the given order; variables that are not in the order follow the
+   * ordered ones in name order. Without an order tracks are in name order.
+   */
+  void SetTrackOrder(const std::vector<std::string>& track_order);
+  const std::vector<std::string>& GetTrackOrder() const;
+  virtual int GetVariableIndex(std::string) const override;
+  virtual int GetVariableIndex(const std::size_t param_index) const override;
+  virtual std::string GetVariableAtIndex(const std::size_t index) const override;
+
   friend std::ostream& operator<<(std::ostream& os, const StringFormula& formula);
 
 protected:
   bool GetVarNamesIfEqualityOfTwoVars(std::string &v1, std::string &v2);
+  std::vector<std::string> GetTracks() const;
 
   StringFormula::Type type_;
   std::string constant_;
@@ -76,6 +88,8 @@ protected:
   // generalize it as much as possible
   std::map<std::string, std::pair<StringFormula::Type, SMT::Term_ptr>> mixed_terms_;
 
+  std::vector<std::string> track_order_;
+
 private:
   static const int VLOG_LEVEL;
 };
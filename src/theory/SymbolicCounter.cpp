@@ -52,6 +52,9 @@ void SymbolicCounter::set_transition_count_matrix(const Eigen::SparseMatrix<BigI
 }
 
 BigInteger SymbolicCounter::Count(const unsigned long bound) {
+  Util::Trace::Event event("count", "counter");
+  event.AddArg("bound", bound);
+  event.AddArg("states", transition_count_matrix_.cols());
   unsigned long power = bound;
 
   if (SymbolicCounter::Type::BINARYINT == type_) {
@@ -61,17 +64,22 @@ BigInteger SymbolicCounter::Count(const unsigned long bound) {
     power = (base << bound) - 1;
   }
 
+  // the counter is updated once the count completes, a count stopped by the query budget leaves it as it was
+  Eigen::SparseVector<BigInteger> count_vector = initialization_vector_;
   if (power >= bound_) {
     power = power - bound_;
   } else {
-    initialization_vector_ = transition_count_matrix_.innerVector(transition_count_matrix_.cols()-1);
+    count_vector = transition_count_matrix_.innerVector(transition_count_matrix_.cols()-1);
   }
 
+  event.AddArg("steps", power);
   while (power > 0) {
-    initialization_vector_ = transition_count_matrix_ * initialization_vector_;
+    Util::Budget::Check();
+    count_vector = transition_count_matrix_ * count_vector;
     --power;
   }
 
+  initialization_vector_ = count_vector;
   bound_ = bound;
   if (SymbolicCounter::Type::BINARYINT == type_) {
     ++bound_; // handle sign bit
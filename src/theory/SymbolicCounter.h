@@ -14,7 +14,9 @@
 
 #include <glog/logging.h>
 
+#include "../utils/Budget.h"
 #include "../utils/Serialize.h"
+#include "../utils/Trace.h"
 
 namespace Vlab {
 namespace Theory {
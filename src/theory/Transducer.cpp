@@ -0,0 +1,587 @@
+/*
+ * Transducer.cpp
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "Transducer.h"
+
+namespace Vlab {
+namespace Theory {
+
+const int Transducer::VLOG_LEVEL = 9;
+
+Transducer::Transducer(const int number_of_bits)
+    : number_of_bits_ { number_of_bits } {
+}
+
+Transducer::~Transducer() {
+}
+
+int Transducer::AddState(const bool is_final) {
+  final_states_.push_back(is_final);
+  transitions_.push_back(std::vector<Transition>());
+  return final_states_.size() - 1;
+}
+
+void Transducer::AddTransition(const int from, const int to, const std::string& input, const std::string& output) {
+  CHECK(input.empty() or input.size() == static_cast<std::size_t>(number_of_bits_));
+  CHECK(output.empty() or output.size() == static_cast<std::size_t>(number_of_bits_));
+  CHECK(not input.empty() or output.find('X') == std::string::npos) << "nothing to copy on an epsilon input";
+  transitions_[from].push_back( { to, input, output });
+}
+
+void Transducer::AddPath(const int from, const int to, const std::string& input,
+                         const std::vector<std::string>& outputs) {
+  if (outputs.size() < 2) {
+    AddTransition(from, to, input, outputs.empty() ? "" : outputs.front());
+    return;
+  }
+  int current = from;
+  for (std::size_t i = 0; i < outputs.size(); ++i) {
+    const int next = (i + 1 == outputs.size()) ? to : AddState();
+    AddTransition(current, next, (i == 0) ? input : "", outputs[i]);
+    current = next;
+  }
+}
+
+int Transducer::get_number_of_bits() const {
+  return number_of_bits_;
+}
+
+int Transducer::get_number_of_states() const {
+  return final_states_.size();
+}
+
+Transducer Transducer::Compose(const Transducer& next) const {
+  CHECK_EQ(number_of_bits_, next.number_of_bits_);
+  Util::Trace::Event event("transducer_compose", "transducer");
+  event.AddArg("left_states", get_number_of_states());
+  event.AddArg("right_states", next.get_number_of_states());
+  Transducer composition (number_of_bits_);
+  std::map<std::pair<int, int>, int> state_ids;
+  std::vector<std::pair<int, int>> worklist;
+  auto get_state = [&](const int first, const int second) {
+    auto it = state_ids.find(std::make_pair(first, second));
+    if (it != state_ids.end()) {
+      return it->second;
+    }
+    const int state = composition.AddState(final_states_[first] and next.final_states_[second]);
+    state_ids[std::make_pair(first, second)] = state;
+    worklist.push_back(std::make_pair(first, second));
+    return state;
+  };
+
+  // only pairs reachable from the initial pair, state ids follow the worklist
+  get_state(0, 0);
+  for (std::size_t i = 0; i < worklist.size(); ++i) {
+    if (Util::Budget::IsExceededByStates(worklist.size())) {
+      // the query is stopped, remaining pairs are left without transitions
+      break;
+    }
+    const int first = worklist[i].first, second = worklist[i].second;
+    const int from = state_ids[worklist[i]];
+    for (auto& first_transition : transitions_[first]) {
+      if (first_transition.output.empty()) {
+        composition.AddTransition(from, get_state(first_transition.to, second), first_transition.input, "");
+        continue;
+      }
+      for (auto& second_transition : next.transitions_[second]) {
+        std::string input, output;
+        if (not second_transition.input.empty()
+            and ComposeSymbols(first_transition, second_transition, input, output)) {
+          composition.AddTransition(from, get_state(first_transition.to, second_transition.to), input, output);
+        }
+      }
+    }
+    for (auto& second_transition : next.transitions_[second]) {
+      if (second_transition.input.empty()) {
+        composition.AddTransition(from, get_state(first, second_transition.to), "", second_transition.output);
+      }
+    }
+  }
+
+  DVLOG(VLOG_LEVEL) << "compose: " << get_number_of_states() << " x " << next.get_number_of_states() << " -> "
+                    << composition.get_number_of_states() << " states";
+  event.AddArg("out_states", composition.get_number_of_states());
+  return composition;
+}
+
+Transducer Transducer::Inverse() const {
+  Transducer inverse (number_of_bits_);
+  inverse.final_states_ = final_states_;
+  inverse.transitions_.resize(transitions_.size());
+  for (std::size_t state = 0; state < transitions_.size(); ++state) {
+    for (auto& transition : transitions_[state]) {
+      std::string input, output;
+      if (not transition.output.empty()) {
+        input = transition.output;
+        for (int i = 0; i < number_of_bits_; ++i) {
+          if (input[i] == 'X') {
+            input[i] = transition.input[i];
+          } else if (input[i] == '*') {
+            input[i] = 'X';
+          }
+        }
+      }
+      if (not transition.input.empty()) {
+        output = transition.input;
+        for (int i = 0; i < number_of_bits_; ++i) {
+          if (not transition.output.empty() and transition.output[i] == 'X') {
+            output[i] = 'X';
+          } else if (output[i] == 'X') {
+            output[i] = '*';
+          }
+        }
+      }
+      inverse.transitions_[state].push_back( { transition.to, input, output });
+    }
+  }
+  return inverse;
+}
+
+DFA_ptr Transducer::Image(const DFA_ptr dfa) const {
+  return MakeIdentity(dfa, number_of_bits_).Compose(*this).MakeDFA(true);
+}
+
+DFA_ptr Transducer::PreImage(const DFA_ptr dfa) const {
+  return Compose(MakeIdentity(dfa, number_of_bits_)).MakeDFA(false);
+}
+
+DFA_ptr Transducer::Domain() const {
+  return MakeDFA(false);
+}
+
+std::string Transducer::str() const {
+  std::stringstream ss;
+  for (std::size_t state = 0; state < transitions_.size(); ++state) {
+    ss << state << (final_states_[state] ? "+" : "") << ":";
+    for (auto& transition : transitions_[state]) {
+      ss << " [" << (transition.input.empty() ? "e" : transition.input) << "/"
+         << (transition.output.empty() ? "e" : transition.output) << " -> " << transition.to << "]";
+    }
+    ss << "\n";
+  }
+  return ss.str();
+}
+
+Transducer Transducer::MakeToUpperCase(const int number_of_bits) {
+  Transducer to_upper (number_of_bits);
+  to_upper.AddState(true);
+  // upper and lower case ascii letters differ in bit 5
+  std::string copy (number_of_bits, 'X'), upper = copy;
+  upper[number_of_bits - 6] = '0';
+  for (auto& symbol : GetSymbols('a', 'z', number_of_bits)) {
+    to_upper.AddTransition(0, 0, symbol, upper);
+  }
+  for (auto& symbol : GetSymbols(0, 'a' - 1, number_of_bits)) {
+    to_upper.AddTransition(0, 0, symbol, copy);
+  }
+  for (auto& symbol : GetSymbols('z' + 1, (1UL << number_of_bits) - 1, number_of_bits)) {
+    to_upper.AddTransition(0, 0, symbol, copy);
+  }
+  return to_upper;
+}
+
+Transducer Transducer::MakeToLowerCase(const int number_of_bits) {
+  Transducer to_lower (number_of_bits);
+  to_lower.AddState(true);
+  std::string copy (number_of_bits, 'X'), lower = copy;
+  lower[number_of_bits - 6] = '1';
+  for (auto& symbol : GetSymbols('A', 'Z', number_of_bits)) {
+    to_lower.AddTransition(0, 0, symbol, lower);
+  }
+  for (auto& symbol : GetSymbols(0, 'A' - 1, number_of_bits)) {
+    to_lower.AddTransition(0, 0, symbol, copy);
+  }
+  for (auto& symbol : GetSymbols('Z' + 1, (1UL << number_of_bits) - 1, number_of_bits)) {
+    to_lower.AddTransition(0, 0, symbol, copy);
+  }
+  return to_lower;
+}
+
+/**
+ * States: leading codes are dropped in 0, 1 has just written another code, in 2 the codes written
+ * since 1 must be followed by another code and in 3 trailing codes are dropped until the end.
+ */
+Transducer Transducer::MakeTrim(const unsigned long code, const int number_of_bits) {
+  Transducer trim (number_of_bits);
+  const int leading = trim.AddState(true), middle = trim.AddState(true), inner = trim.AddState(false),
+      trailing = trim.AddState(true);
+  const std::string copy (number_of_bits, 'X'), trimmed = GetSymbol(code, number_of_bits);
+  std::vector<std::string> others;
+  if (code > 0) {
+    others = GetSymbols(0, code - 1, number_of_bits);
+  }
+  for (auto& symbol : GetSymbols(code + 1, (1UL << number_of_bits) - 1, number_of_bits)) {
+    others.push_back(symbol);
+  }
+
+  trim.AddTransition(leading, leading, trimmed, "");
+  trim.AddTransition(middle, inner, trimmed, copy);
+  trim.AddTransition(middle, trailing, trimmed, "");
+  trim.AddTransition(inner, inner, trimmed, copy);
+  trim.AddTransition(trailing, trailing, trimmed, "");
+  for (auto& symbol : others) {
+    trim.AddTransition(leading, middle, symbol, copy);
+    trim.AddTransition(middle, middle, symbol, copy);
+    trim.AddTransition(inner, middle, symbol, copy);
+  }
+  return trim;
+}
+
+Transducer Transducer::MakeReplace(const std::vector<unsigned long>& search, const std::vector<unsigned long>& replace,
+                                   const int number_of_bits) {
+  Transducer replacement (number_of_bits);
+  replacement.AddState(replace.empty());
+  for (std::size_t i = 0; i < replace.size(); ++i) {
+    replacement.AddTransition(i, replacement.AddState(i + 1 == replace.size()), "", GetSymbol(replace[i], number_of_bits));
+  }
+  return MakeReplaceWith(search, replacement, number_of_bits);
+}
+
+Transducer Transducer::MakeReplace(const std::vector<unsigned long>& search, const DFA_ptr replace_dfa,
+                                   const int number_of_bits) {
+  // reads nothing and writes the strings of the dfa
+  Transducer replacement = MakeIdentity(replace_dfa, number_of_bits);
+  for (auto& state_transitions : replacement.transitions_) {
+    for (auto& transition : state_transitions) {
+      transition.output = transition.input;
+      std::replace(transition.output.begin(), transition.output.end(), 'X', '*');
+      transition.input.clear();
+    }
+  }
+  return MakeReplaceWith(search, replacement, number_of_bits);
+}
+
+/**
+ * Knuth-Morris-Pratt automaton of the search string (the Aho-Corasick automaton of a single pattern): state k
+ * has read the first k codes of the search string and has not written them yet. A mismatch writes the codes that
+ * cannot start an occurrence anymore; codes that are not in the search string are written after the buffered
+ * prefix, which is also written at the end of the input. The match states are the only states, the dfa is built
+ * without auxiliary bits.
+ */
+Transducer Transducer::MakeReplaceWith(const std::vector<unsigned long>& search, const Transducer& replacement,
+                                       const int number_of_bits) {
+  CHECK(not search.empty());
+  Transducer replace_transducer (number_of_bits);
+  const int length = search.size();
+  for (int k = 0; k < length; ++k) {
+    replace_transducer.AddState(k == 0);
+  }
+
+  auto get_symbols = [number_of_bits](std::vector<unsigned long>::const_iterator begin,
+      std::vector<unsigned long>::const_iterator end) {
+    std::vector<std::string> symbols;
+    for (auto it = begin; it != end; ++it) {
+      symbols.push_back(GetSymbol(*it, number_of_bits));
+    }
+    return symbols;
+  };
+
+  std::set<unsigned long> search_codes (search.begin(), search.end());
+  std::vector<std::string> others;
+  unsigned long from = 0;
+  for (auto code : search_codes) {
+    if (from < code) {
+      auto symbols = GetSymbols(from, code - 1, number_of_bits);
+      others.insert(others.end(), symbols.begin(), symbols.end());
+    }
+    from = code + 1;
+  }
+  if (from < (1UL << number_of_bits)) {
+    auto symbols = GetSymbols(from, (1UL << number_of_bits) - 1, number_of_bits);
+    others.insert(others.end(), symbols.begin(), symbols.end());
+  }
+  const std::string copy (number_of_bits, 'X');
+
+  for (int k = 0; k < length; ++k) {
+    for (auto code : search_codes) {
+      const std::string symbol = GetSymbol(code, number_of_bits);
+      if (code == search[k]) {
+        if (k + 1 == length) {
+          const int offset = replace_transducer.Embed(replacement);
+          replace_transducer.AddTransition(k, offset, symbol, "");
+          for (int state = 0; state < replacement.get_number_of_states(); ++state) {
+            if (replacement.final_states_[state]) {
+              replace_transducer.AddTransition(offset + state, 0, "", "");
+            }
+          }
+        } else {
+          replace_transducer.AddTransition(k, k + 1, symbol, "");
+        }
+        continue;
+      }
+      // longest prefix of the search string that is a suffix of the buffer
+      std::vector<unsigned long> buffer (search.begin(), search.begin() + k);
+      buffer.push_back(code);
+      int next = k;
+      while (next > 0 and not std::equal(search.begin(), search.begin() + next, buffer.end() - next)) {
+        --next;
+      }
+      replace_transducer.AddPath(k, next, symbol, get_symbols(buffer.begin(), buffer.end() - next));
+    }
+
+    int flushed = 0;
+    if (k > 0) {
+      flushed = replace_transducer.AddState(true);
+      replace_transducer.AddPath(k, flushed, "", get_symbols(search.begin(), search.begin() + k));
+    }
+    for (auto& symbol : others) {
+      replace_transducer.AddTransition(flushed, 0, symbol, copy);
+    }
+  }
+  return replace_transducer;
+}
+
+int Transducer::Embed(const Transducer& other) {
+  CHECK_EQ(number_of_bits_, other.number_of_bits_);
+  const int offset = get_number_of_states();
+  for (auto& state_transitions : other.transitions_) {
+    AddState(false);
+    for (auto& transition : state_transitions) {
+      transitions_.back().push_back( { transition.to + offset, transition.input, transition.output });
+    }
+  }
+  return offset;
+}
+
+std::string Transducer::GetSymbol(const unsigned long code, const int number_of_bits) {
+  std::string symbol = Automaton::GetBinaryStringMSB(code, number_of_bits);
+  symbol.resize(number_of_bits);
+  return symbol;
+}
+
+std::vector<std::string> Transducer::GetSymbols(const unsigned long from, const unsigned long to,
+                                                const int number_of_bits) {
+  std::vector<std::string> symbols;
+  if (from > to) {
+    return symbols;
+  }
+  for (auto& symbol : Automaton::GetBinaryRangeMSB(from, to, number_of_bits)) {
+    symbols.push_back(symbol.substr(0, number_of_bits));
+  }
+  return symbols;
+}
+
+Transducer Transducer::MakeIdentity(const DFA_ptr dfa, const int number_of_bits) {
+  Transducer identity (number_of_bits);
+  // initial state of the dfa becomes state 0
+  auto get_state = [dfa](const int state) {
+    return (state == dfa->s) ? 0 : ((state == 0) ? dfa->s : state);
+  };
+  for (int i = 0; i < dfa->ns; ++i) {
+    identity.AddState(false);
+  }
+  for (int i = 0; i < dfa->ns; ++i) {
+    identity.final_states_[get_state(i)] = (dfa->f[i] == 1);
+  }
+
+  const int sink = Automaton::find_sink(dfa);
+  const int* indices = Automaton::GetBddVariableIndices(number_of_bits);
+  const std::string copy (number_of_bits, 'X');
+  paths state_paths, pp;
+  trace_descr tp;
+  for (int i = 0; i < dfa->ns; ++i) {
+    if (i == sink) {
+      continue;
+    }
+    state_paths = pp = make_paths(dfa->bddm, dfa->q[i]);
+    while (pp) {
+      if (pp->to != (unsigned) sink) {
+        std::string symbol (number_of_bits, 'X');
+        for (int j = 0; j < number_of_bits; ++j) {
+          for (tp = pp->trace; tp && (tp->index != (unsigned) indices[j]); tp = tp->next);
+          if (tp) {
+            symbol[j] = tp->value ? '1' : '0';
+          }
+        }
+        identity.AddTransition(get_state(i), get_state(pp->to), symbol, copy);
+      }
+      pp = pp->next;
+    }
+    kill_paths(state_paths);
+  }
+  return identity;
+}
+
+bool Transducer::ComposeSymbols(const Transition& first, const Transition& second, std::string& input,
+                                std::string& output) {
+  input = first.input;
+  output = second.output;
+  for (std::size_t i = 0; i < first.output.size(); ++i) {
+    // bit written by the first transition, constrained by the symbol read by the second one
+    char written = first.output[i];
+    const char read = second.input[i];
+    if (written == '0' or written == '1') {
+      if (read != 'X' and read != written) {
+        return false;
+      }
+    } else if (written == 'X') {
+      if (read != 'X') {
+        if (input[i] == 'X') {
+          input[i] = read;
+        } else if (input[i] != read) {
+          return false;
+        }
+      }
+    } else if (read != 'X') {
+      written = read;
+    }
+    if (not output.empty() and output[i] == 'X') {
+      output[i] = written;
+    }
+  }
+  return true;
+}
+
+DFA_ptr Transducer::MakeDFA(const bool use_outputs) const {
+  Util::Trace::Event event("transducer_determinize", "transducer");
+  event.AddArg("in_states", get_number_of_states());
+  const int number_of_states = transitions_.size();
+  auto get_symbol = [this, use_outputs](const Transition& transition) {
+    if (not use_outputs) {
+      return transition.input;
+    }
+    std::string symbol = transition.output;
+    for (std::size_t i = 0; i < symbol.size(); ++i) {
+      if (symbol[i] == 'X') {
+        symbol[i] = transition.input[i];
+      } else if (symbol[i] == '*') {
+        symbol[i] = 'X';
+      }
+    }
+    return symbol;
+  };
+
+  std::vector<std::set<int>> closures (number_of_states);
+  for (int state = 0; state < number_of_states; ++state) {
+    std::stack<int> states;
+    states.push(state);
+    closures[state].insert(state);
+    while (not states.empty()) {
+      const int current = states.top();
+      states.pop();
+      for (auto& transition : transitions_[current]) {
+        if (get_symbol(transition).empty() and closures[state].insert(transition.to).second) {
+          states.push(transition.to);
+        }
+      }
+    }
+  }
+
+  // subset construction over disjoint cubes, the dfa is built without auxiliary bits
+  std::map<std::set<int>, int> subset_ids { { closures[0], 0 } };
+  std::vector<std::set<int>> subsets { closures[0] };
+  std::vector<std::vector<std::pair<std::string, int>>> subset_transitions;
+  for (std::size_t i = 0; i < subsets.size(); ++i) {
+    if (Util::Budget::IsExceededByStates(subsets.size())) {
+      // the query is stopped, remaining subsets are left without transitions
+      subset_transitions.resize(subsets.size());
+      break;
+    }
+    std::vector<std::pair<std::string, int>> symbol_transitions;
+    for (auto state : subsets[i]) {
+      for (auto& transition : transitions_[state]) {
+        const std::string symbol = get_symbol(transition);
+        if (not symbol.empty()) {
+          symbol_transitions.push_back(std::make_pair(symbol, transition.to));
+        }
+      }
+    }
+
+    std::vector<std::pair<std::string, std::set<int>>> disjoint_transitions;
+    SplitSymbols(symbol_transitions, 0, "", disjoint_transitions);
+    subset_transitions.push_back(std::vector<std::pair<std::string, int>>());
+    for (auto& transition : disjoint_transitions) {
+      std::set<int> next_subset;
+      for (auto state : transition.second) {
+        next_subset.insert(closures[state].begin(), closures[state].end());
+      }
+      auto it = subset_ids.find(next_subset);
+      if (it == subset_ids.end()) {
+        it = subset_ids.insert(std::make_pair(next_subset, subsets.size())).first;
+        subsets.push_back(next_subset);
+      }
+      subset_transitions.back().push_back(std::make_pair(transition.first, it->second));
+    }
+  }
+
+  const int sink = subsets.size();
+  std::string statuses (sink + 1, '-');
+  dfaSetup(sink + 1, number_of_bits_, Automaton::GetBddVariableIndices(number_of_bits_));
+  for (int state = 0; state < sink; ++state) {
+    dfaAllocExceptions(subset_transitions[state].size());
+    for (auto& transition : subset_transitions[state]) {
+      dfaStoreException(transition.second, const_cast<char*>(transition.first.data()));
+    }
+    dfaStoreState(sink);
+    for (auto nfa_state : subsets[state]) {
+      if (final_states_[nfa_state]) {
+        statuses[state] = '+';
+        break;
+      }
+    }
+  }
+  dfaAllocExceptions(0);
+  dfaStoreState(sink);
+
+  DFA_ptr result_dfa = dfaBuild(&statuses[0]);
+  DFA_ptr minimized_dfa = dfaMinimize(result_dfa);
+  dfaFree(result_dfa);
+
+  DVLOG(VLOG_LEVEL) << "transducer dfa: " << number_of_states << " states -> " << sink << " subsets -> "
+                    << minimized_dfa->ns << " states";
+  if (event.is_recording()) {
+    event.AddArg("subsets", sink);
+    event.AddArg("out_states", minimized_dfa->ns);
+    event.AddArg("bdd_nodes", bdd_size(minimized_dfa->bddm));
+  }
+  return minimized_dfa;
+}
+
+void Transducer::SplitSymbols(const std::vector<std::pair<std::string, int>>& symbol_transitions, const int bit,
+                              const std::string& prefix,
+                              std::vector<std::pair<std::string, std::set<int>>>& disjoint_transitions) const {
+  if (symbol_transitions.empty()) {
+    return;
+  }
+  // cubes that do not constrain the remaining bits end the split
+  bool is_free = true, is_free_bit = true;
+  for (auto& transition : symbol_transitions) {
+    if (transition.first[bit] != 'X') {
+      is_free_bit = false;
+    }
+    if (transition.first.find_first_not_of('X', bit) != std::string::npos) {
+      is_free = false;
+    }
+  }
+  if (is_free) {
+    std::set<int> next_states;
+    for (auto& transition : symbol_transitions) {
+      next_states.insert(transition.second);
+    }
+    disjoint_transitions.push_back(std::make_pair(prefix + std::string(number_of_bits_ - bit, 'X'), next_states));
+    return;
+  }
+  if (is_free_bit) {
+    SplitSymbols(symbol_transitions, bit + 1, prefix + 'X', disjoint_transitions);
+    return;
+  }
+  std::vector<std::pair<std::string, int>> zero_transitions, one_transitions;
+  for (auto& transition : symbol_transitions) {
+    if (transition.first[bit] != '1') {
+      zero_transitions.push_back(transition);
+    }
+    if (transition.first[bit] != '0') {
+      one_transitions.push_back(transition);
+    }
+  }
+  SplitSymbols(zero_transitions, bit + 1, prefix + '0', disjoint_transitions);
+  SplitSymbols(one_transitions, bit + 1, prefix + '1', disjoint_transitions);
+}
+
+} /* namespace Theory */
+} /* namespace Vlab */
@@ -0,0 +1,158 @@
+/*
+ * Transducer.h
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef SRC_THEORY_TRANSDUCER_H_
+#define SRC_THEORY_TRANSDUCER_H_
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stack>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "Automaton.h"
+
+namespace Vlab {
+namespace Theory {
+
+class Transducer;
+using Transducer_ptr = Transducer*;
+
+/**
+ * Nondeterministic finite-state transducer over the codes of string automata.
+ * A transition reads at most one symbol and writes at most one symbol, an empty input or output is epsilon.
+ * Symbols are cubes over the character bits, most significant bit first. In an input '0' and '1' are fixed
+ * bits and 'X' is any bit; in an output 'X' copies the bit that is read and '*' is any bit.
+ * State 0 is the initial state.
+ *
+ * Transducers are composed symbolically, a chain of string transformations is applied to an automaton
+ * with a single product and a single determinization.
+ */
+class Transducer {
+ public:
+  Transducer(const int number_of_bits);
+  virtual ~Transducer();
+
+  int AddState(const bool is_final = false);
+  void AddTransition(const int from, const int to, const std::string& input, const std::string& output);
+
+  /**
+   * Adds a path that reads the input (epsilon if empty) and writes the outputs one after the other
+   */
+  void AddPath(const int from, const int to, const std::string& input, const std::vector<std::string>& outputs);
+
+  int get_number_of_bits() const;
+  int get_number_of_states() const;
+
+  /**
+   * @return transducer that applies this transducer and then the next one
+   */
+  Transducer Compose(const Transducer& next) const;
+  Transducer Inverse() const;
+
+  /**
+   * @return minimized dfa of the strings written for the strings of the dfa
+   */
+  DFA_ptr Image(const DFA_ptr dfa) const;
+
+  /**
+   * @return minimized dfa of the strings that are written as a string of the dfa
+   */
+  DFA_ptr PreImage(const DFA_ptr dfa) const;
+
+  /**
+   * @return minimized dfa of the strings the transducer reads, a transducer with empty outputs is an nfa
+   */
+  DFA_ptr Domain() const;
+
+  std::string str() const;
+
+  static Transducer MakeToUpperCase(const int number_of_bits);
+  static Transducer MakeToLowerCase(const int number_of_bits);
+
+  /**
+   * Removes leading and trailing occurrences of the code
+   */
+  static Transducer MakeTrim(const unsigned long code, const int number_of_bits);
+
+  /**
+   * Replaces all occurrences of the search codes from left to right, occurrences do not overlap
+   */
+  static Transducer MakeReplace(const std::vector<unsigned long>& search, const std::vector<unsigned long>& replace,
+                                const int number_of_bits);
+
+  /**
+   * Replaces all occurrences of the search codes with any string of the dfa
+   */
+  static Transducer MakeReplace(const std::vector<unsigned long>& search, const DFA_ptr replace_dfa,
+                                const int number_of_bits);
+
+  static std::string GetSymbol(const unsigned long code, const int number_of_bits);
+  static std::vector<std::string> GetSymbols(const unsigned long from, const unsigned long to, const int number_of_bits);
+
+ protected:
+  struct Transition {
+    int to;
+    std::string input;
+    std::string output;
+  };
+
+  /**
+   * @return transducer that reads and writes the strings of the dfa
+   */
+  static Transducer MakeIdentity(const DFA_ptr dfa, const int number_of_bits);
+
+  /**
+   * @param replacement transducer with epsilon inputs that writes the replacement strings
+   */
+  static Transducer MakeReplaceWith(const std::vector<unsigned long>& search, const Transducer& replacement,
+                                    const int number_of_bits);
+
+  /**
+   * Adds the states and transitions of the other transducer as non-final states
+   * @return state of this transducer that corresponds to the initial state of the other one
+   */
+  int Embed(const Transducer& other);
+
+  /**
+   * Composes a symbol written by the first transition with the symbol read by the second one
+   * @return false if the second transition cannot read any symbol written by the first one
+   */
+  static bool ComposeSymbols(const Transition& first, const Transition& second, std::string& input,
+                             std::string& output);
+
+  /**
+   * @return minimized dfa of the outputs (or inputs) of the transducer, determinized with a subset
+   * construction over disjoint cubes so that no auxiliary bits are needed
+   */
+  DFA_ptr MakeDFA(const bool use_outputs) const;
+
+  /**
+   * Splits overlapping cubes into disjoint cubes, each with the set of states it reaches
+   */
+  void SplitSymbols(const std::vector<std::pair<std::string, int>>& symbol_transitions, const int bit,
+                    const std::string& prefix,
+                    std::vector<std::pair<std::string, std::set<int>>>& disjoint_transitions) const;
+
+  int number_of_bits_;
+  std::vector<bool> final_states_;
+  std::vector<std::vector<Transition>> transitions_;
+
+ private:
+  static const int VLOG_LEVEL;
+};
+
+} /* namespace Theory */
+} /* namespace Vlab */
+
+#endif /* SRC_THEORY_TRANSDUCER_H_ */
@@ -270,30 +270,10 @@ IntAutomaton_ptr UnaryAutomaton::toIntAutomaton(int number_of_variables, bool ad
 }
 
 BinaryIntAutomaton_ptr UnaryAutomaton::toBinaryIntAutomaton(std::string var_name, ArithmeticFormula_ptr formula, bool add_minus_one) {
-  BinaryIntAutomaton_ptr binary_auto = nullptr;
-  SemilinearSet_ptr semilinear_set = getSemilinearSet();
-
-  binary_auto = BinaryIntAutomaton::MakeAutomaton(semilinear_set, var_name, formula, true);
-//  auto test = BinaryIntAutomaton::MakeAutomaton(semilinear_set, var_name, formula, false);
-//
-//  binary_auto->inspectAuto();
-//  test->inspectAuto();
-
-  if (add_minus_one) {
-    BinaryIntAutomaton_ptr minus_one_auto = nullptr, tmp_auto = nullptr;
-    ArithmeticFormula_ptr minus_one_formula = formula->clone();
-    minus_one_formula->ResetCoefficients();
-    minus_one_formula->SetVariableCoefficient(var_name, 1);
-    minus_one_formula->SetConstant(1);
-    minus_one_formula->SetType(ArithmeticFormula::Type::EQ);
-    minus_one_auto = BinaryIntAutomaton::MakeAutomaton(minus_one_formula, false);
-    tmp_auto = binary_auto;
-    binary_auto = tmp_auto->Union(minus_one_auto);
-    delete tmp_auto; tmp_auto = nullptr;
-    delete minus_one_auto; minus_one_auto = nullptr;
-  }
-
-  delete semilinear_set;
+  std::vector<char> unary_symbol {'1'};
+  std::vector<bool> lasso_statuses;
+  int cycle_head = GetUnaryLasso(unary_symbol, lasso_statuses);
+  auto binary_auto = BinaryIntAutomaton::MakeAutomaton(lasso_statuses, cycle_head, var_name, formula, add_minus_one);
 
   DVLOG(VLOG_LEVEL)  << binary_auto->getId() << " = [" << this->id_ << "]->toBinaryIntAutomaton(" << var_name << ", " << binary_auto->GetFormula()->str() << ", " << add_minus_one << ")";
 
@@ -15,6 +15,10 @@ namespace Option {
 
 std::string Theory::TMP_PATH     = ".";
 std::string Theory::SCRIPT_PATH  = ".";
+bool Theory::SYMBOLIC_ARITHMETIC_TRANSITIONS = true;
+bool Theory::DIRECT_INDEX_CONSTRUCTIONS = true;
+int Theory::CHARACTER_WIDTH = 8;
+int Theory::INTEGER_WIDTH = 64;
 
 } /* namespace Option */
 } /* namespace Vlab */
@@ -20,6 +20,23 @@ class Theory {
 public:
   static std::string TMP_PATH;
   static std::string SCRIPT_PATH;
+  /**
+   * Builds arithmetic automata transitions symbolically instead of enumerating variable assignments
+   */
+  static bool SYMBOLIC_ARITHMETIC_TRANSITIONS;
+  /**
+   * Builds substring, charAt and indexOf with symbolic indices in a single pass over the string and the index automata
+   */
+  static bool DIRECT_INDEX_CONSTRUCTIONS;
+  /**
+   * Number of bits of a string character: 8 for bytes, 16 for utf-16 code units, 21 for unicode code points.
+   * Read when a script is initialized; the string encoding built from it is process-wide
+   */
+  static int CHARACTER_WIDTH;
+  /**
+   * Number of bits of the integers converted to and from decimal strings, larger values are over-approximated
+   */
+  static int INTEGER_WIDTH;
 };
 
 } /* namespace Option */
@@ -0,0 +1,92 @@
+/*
+ * Budget.cpp
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "Budget.h"
+
+namespace Vlab {
+namespace Util {
+
+thread_local bool Budget::is_active_ = false;
+thread_local bool Budget::has_deadline_ = false;
+thread_local std::chrono::steady_clock::time_point Budget::deadline_;
+thread_local unsigned long Budget::state_limit_ = 0;
+thread_local unsigned long Budget::bdd_node_limit_ = 0;
+thread_local std::string Budget::exceeded_limit_;
+
+BudgetExceeded::BudgetExceeded(const std::string& what)
+    : std::runtime_error(what) {
+}
+
+Budget::Scope::Scope(const unsigned long time_limit_ms, const unsigned long state_limit,
+                     const unsigned long bdd_node_limit)
+    : is_owner_ { not Budget::is_active_ } {
+  if (not is_owner_) {
+    return;
+  }
+  Budget::is_active_ = true;
+  Budget::has_deadline_ = (time_limit_ms > 0);
+  Budget::deadline_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(time_limit_ms);
+  Budget::state_limit_ = state_limit;
+  Budget::bdd_node_limit_ = bdd_node_limit;
+  Budget::exceeded_limit_.clear();
+}
+
+Budget::Scope::~Scope() {
+  if (is_owner_) {
+    Budget::is_active_ = false;
+  }
+}
+
+void Budget::Check() {
+  if (IsExceeded()) {
+    throw BudgetExceeded(exceeded_limit_);
+  }
+}
+
+void Budget::CheckStates(const unsigned long number_of_states) {
+  if (IsExceededByStates(number_of_states)) {
+    throw BudgetExceeded(exceeded_limit_);
+  }
+}
+
+bool Budget::IsExceeded() {
+  if (not is_active_) {
+    return false;
+  }
+  if (exceeded_limit_.empty() and has_deadline_ and std::chrono::steady_clock::now() > deadline_) {
+    exceeded_limit_ = "time limit exceeded";
+  }
+  return not exceeded_limit_.empty();
+}
+
+bool Budget::IsExceededByStates(const unsigned long number_of_states) {
+  if (not is_active_) {
+    return false;
+  }
+  if (exceeded_limit_.empty() and state_limit_ > 0 and number_of_states > state_limit_) {
+    exceeded_limit_ = "state limit exceeded: " + std::to_string(number_of_states) + " states";
+  }
+  return IsExceeded();
+}
+
+bool Budget::IsExceededByAutomaton(const unsigned long number_of_states, const unsigned long number_of_bdd_nodes) {
+  if (not is_active_) {
+    return false;
+  }
+  if (exceeded_limit_.empty() and bdd_node_limit_ > 0 and number_of_bdd_nodes > bdd_node_limit_) {
+    exceeded_limit_ = "bdd node limit exceeded: " + std::to_string(number_of_bdd_nodes) + " nodes";
+  }
+  return IsExceededByStates(number_of_states);
+}
+
+bool Budget::is_active() {
+  return is_active_;
+}
+
+} /* namespace Util */
+} /* namespace Vlab */
@@ -0,0 +1,98 @@
+/*
+ * Budget.h
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef SRC_UTILS_BUDGET_H_
+#define SRC_UTILS_BUDGET_H_
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+#include <glog/logging.h>
+
+namespace Vlab {
+namespace Util {
+
+/**
+ * Thrown by the checks of a budget when one of its limits is exceeded
+ */
+class BudgetExceeded : public std::runtime_error {
+ public:
+  BudgetExceeded(const std::string& what);
+};
+
+/**
+ * Wall time, state count and bdd node limits of a single query, kept per thread.
+ *
+ * A query opens a scope. Automata constructions hold raw pointers and never throw: they record the first
+ * exceeded limit with the Is* queries and finish early with a partial result. The Check* calls throw
+ * BudgetExceeded, they are only made where every local of the calling frames is owned (between the conjuncts
+ * of the constraint solver, while counting and when the query returns), so the result of a stopped query is
+ * unknown and partial automata are never reported. A single MONA operation cannot be interrupted, its result
+ * is recorded once the call returns. A limit of zero means no limit.
+ */
+class Budget {
+ public:
+  /**
+   * Starts the budget of a query unless one is already running, the outermost scope ends it
+   */
+  class Scope {
+   public:
+    Scope(const unsigned long time_limit_ms, const unsigned long state_limit, const unsigned long bdd_node_limit);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    bool is_owner_;
+  };
+
+  /**
+   * Throws if the wall time is over or a limit is recorded as exceeded
+   */
+  static void Check();
+
+  /**
+   * Throws if the wall time is over or a limit is exceeded by the number of states of an automaton being built
+   */
+  static void CheckStates(const unsigned long number_of_states);
+
+  /**
+   * @return true if the wall time is over or a limit is recorded as exceeded, does not throw
+   */
+  static bool IsExceeded();
+
+  /**
+   * Records the state limit as exceeded by an automaton being built
+   * @return true if the wall time is over or a limit is recorded as exceeded, does not throw
+   */
+  static bool IsExceededByStates(const unsigned long number_of_states);
+
+  /**
+   * Records the state or bdd node limit as exceeded by a built automaton
+   * @return true if the wall time is over or a limit is recorded as exceeded, does not throw
+   */
+  static bool IsExceededByAutomaton(const unsigned long number_of_states, const unsigned long number_of_bdd_nodes);
+
+  static bool is_active();
+
+ private:
+  static thread_local bool is_active_;
+  static thread_local bool has_deadline_;
+  static thread_local std::chrono::steady_clock::time_point deadline_;
+  static thread_local unsigned long state_limit_;
+  static thread_local unsigned long bdd_node_limit_;
+  // first exceeded limit, empty while the query is within its budget
+  static thread_local std::string exceeded_limit_;
+};
+
+} /* namespace Util */
+} /* namespace Vlab */
+
+#endif /* SRC_UTILS_BUDGET_H_ */
@@ -0,0 +1,203 @@
+/*
+ * Metrics.cpp
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "Metrics.h"
+
+namespace Vlab {
+namespace Util {
+
+std::atomic<unsigned long> Metrics::counters_[static_cast<int>(Counter::NUMBER_OF_COUNTERS)];
+std::atomic<unsigned long> Metrics::maximums_[static_cast<int>(Maximum::NUMBER_OF_MAXIMUMS)];
+Metrics::Histogram Metrics::histograms_[static_cast<int>(Phase::NUMBER_OF_PHASES)];
+
+Metrics::Timer::Timer(const Phase phase)
+    : phase_ { phase },
+      start_ { std::chrono::steady_clock::now() } {
+}
+
+Metrics::Timer::~Timer() {
+  Metrics::Observe(phase_, std::chrono::steady_clock::now() - start_);
+}
+
+void Metrics::Increment(const Counter counter, const unsigned long value) {
+  counters_[static_cast<int>(counter)].fetch_add(value, std::memory_order_relaxed);
+}
+
+void Metrics::UpdateMaximum(const Maximum maximum, const unsigned long value) {
+  auto& current = maximums_[static_cast<int>(maximum)];
+  unsigned long current_value = current.load(std::memory_order_relaxed);
+  while (value > current_value
+      and not current.compare_exchange_weak(current_value, value, std::memory_order_relaxed)) {
+  }
+}
+
+void Metrics::Observe(const Phase phase, const std::chrono::steady_clock::duration duration) {
+  const unsigned long duration_us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+  int bucket = 0;
+  while (bucket < NUMBER_OF_BUCKETS - 1 and duration_us > get_bucket_bound_us(bucket)) {
+    ++bucket;
+  }
+  auto& histogram = histograms_[static_cast<int>(phase)];
+  histogram.count.fetch_add(1, std::memory_order_relaxed);
+  histogram.sum_us.fetch_add(duration_us, std::memory_order_relaxed);
+  histogram.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+std::map<std::string, unsigned long> Metrics::GetSnapshot() {
+  std::map<std::string, unsigned long> snapshot;
+  for (int i = 0; i < static_cast<int>(Counter::NUMBER_OF_COUNTERS); ++i) {
+    snapshot[get_name(static_cast<Counter>(i))] = counters_[i].load(std::memory_order_relaxed);
+  }
+  for (int i = 0; i < static_cast<int>(Maximum::NUMBER_OF_MAXIMUMS); ++i) {
+    snapshot[get_name(static_cast<Maximum>(i))] = maximums_[i].load(std::memory_order_relaxed);
+  }
+  for (int i = 0; i < static_cast<int>(Phase::NUMBER_OF_PHASES); ++i) {
+    const std::string name = get_name(static_cast<Phase>(i));
+    auto& histogram = histograms_[i];
+    snapshot[name + "_count"] = histogram.count.load(std::memory_order_relaxed);
+    snapshot[name + "_sum_us"] = histogram.sum_us.load(std::memory_order_relaxed);
+    for (int bucket = 0; bucket < NUMBER_OF_BUCKETS; ++bucket) {
+      const unsigned long value = histogram.buckets[bucket].load(std::memory_order_relaxed);
+      if (value > 0) {
+        const std::string bound = (bucket == NUMBER_OF_BUCKETS - 1) ? "inf" : std::to_string(get_bucket_bound_us(bucket));
+        snapshot[name + "_le_" + bound + "_us"] = value;
+      }
+    }
+  }
+  return snapshot;
+}
+
+std::string Metrics::GetText() {
+  std::stringstream ss;
+  for (int i = 0; i < static_cast<int>(Counter::NUMBER_OF_COUNTERS); ++i) {
+    const std::string name = std::string("abc_") + get_name(static_cast<Counter>(i)) + "_total";
+    ss << "# TYPE " << name << " counter\n";
+    ss << name << " " << counters_[i].load(std::memory_order_relaxed) << "\n";
+  }
+  for (int i = 0; i < static_cast<int>(Maximum::NUMBER_OF_MAXIMUMS); ++i) {
+    const std::string name = std::string("abc_peak_") + get_name(static_cast<Maximum>(i));
+    ss << "# TYPE " << name << " gauge\n";
+    ss << name << " " << maximums_[i].load(std::memory_order_relaxed) << "\n";
+  }
+  ss << "# TYPE abc_phase_duration_seconds histogram\n";
+  for (int i = 0; i < static_cast<int>(Phase::NUMBER_OF_PHASES); ++i) {
+    const std::string label = std::string("phase=\"") + get_name(static_cast<Phase>(i)) + "\"";
+    auto& histogram = histograms_[i];
+    unsigned long cumulative_count = 0;
+    for (int bucket = 0; bucket < NUMBER_OF_BUCKETS; ++bucket) {
+      cumulative_count += histogram.buckets[bucket].load(std::memory_order_relaxed);
+      ss << "abc_phase_duration_seconds_bucket{" << label << ",le=\"";
+      if (bucket == NUMBER_OF_BUCKETS - 1) {
+        ss << "+Inf";
+      } else {
+        ss << (get_bucket_bound_us(bucket) / 1e6);
+      }
+      ss << "\"} " << cumulative_count << "\n";
+    }
+    ss << "abc_phase_duration_seconds_sum{" << label << "} " << (histogram.sum_us.load(std::memory_order_relaxed) / 1e6)
+       << "\n";
+    ss << "abc_phase_duration_seconds_count{" << label << "} " << histogram.count.load(std::memory_order_relaxed)
+       << "\n";
+  }
+  return ss.str();
+}
+
+void Metrics::Reset() {
+  for (auto& counter : counters_) {
+    counter.store(0, std::memory_order_relaxed);
+  }
+  for (auto& maximum : maximums_) {
+    maximum.store(0, std::memory_order_relaxed);
+  }
+  for (auto& histogram : histograms_) {
+    histogram.count.store(0, std::memory_order_relaxed);
+    histogram.sum_us.store(0, std::memory_order_relaxed);
+    for (auto& bucket : histogram.buckets) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+const char* Metrics::get_name(const Counter counter) {
+  switch (counter) {
+    case Counter::SAT:
+      return "sat";
+    case Counter::UNSAT:
+      return "unsat";
+    case Counter::UNKNOWN:
+      return "unknown";
+    case Counter::STOPPED_QUERIES:
+      return "stopped_queries";
+    case Counter::CACHE_HITS:
+      return "cache_hits";
+    case Counter::CACHE_MISSES:
+      return "cache_misses";
+    case Counter::AUTOMATA:
+      return "automata";
+    default:
+      LOG(FATAL)<< "unknown counter: " << static_cast<int>(counter);
+      return "";
+  }
+}
+
+const char* Metrics::get_name(const Maximum maximum) {
+  switch (maximum) {
+    case Maximum::DFA_STATES:
+      return "dfa_states";
+    default:
+      LOG(FATAL)<< "unknown maximum: " << static_cast<int>(maximum);
+      return "";
+  }
+}
+
+const char* Metrics::get_name(const Phase phase) {
+  switch (phase) {
+    case Phase::PARSE:
+      return "parse";
+    case Phase::INITIALIZE:
+      return "initialize";
+    case Phase::INITIALIZER:
+      return "initializer";
+    case Phase::SYNTACTIC_PROCESSOR:
+      return "syntactic_processor";
+    case Phase::SYNTACTIC_OPTIMIZER:
+      return "syntactic_optimizer";
+    case Phase::ALPHABET_PARTITIONER:
+      return "alphabet_partitioner";
+    case Phase::EQUIVALENCE_GENERATOR:
+      return "equivalence_generator";
+    case Phase::DEPENDENCY_SLICER:
+      return "dependency_slicer";
+    case Phase::COMPONENT_CANONICALIZER:
+      return "component_canonicalizer";
+    case Phase::IMPLICATION_RUNNER:
+      return "implication_runner";
+    case Phase::FORMULA_OPTIMIZER:
+      return "formula_optimizer";
+    case Phase::CONSTRAINT_SORTER:
+      return "constraint_sorter";
+    case Phase::CONSTRAINT_SOLVER:
+      return "constraint_solver";
+    case Phase::SOLVE:
+      return "solve";
+    case Phase::COUNT:
+      return "count";
+    case Phase::MODELS:
+      return "models";
+    default:
+      LOG(FATAL)<< "unknown phase: " << static_cast<int>(phase);
+      return "";
+  }
+}
+
+unsigned long Metrics::get_bucket_bound_us(const int bucket) {
+  return 1UL << (2 * bucket);
+}
+
+} /* namespace Util */
+} /* namespace Vlab */
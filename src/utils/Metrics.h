@@ -0,0 +1,130 @@
+/*
+ * Metrics.h
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef SRC_UTILS_METRICS_H_
+#define SRC_UTILS_METRICS_H_
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include <glog/logging.h>
+
+namespace Vlab {
+namespace Util {
+
+/**
+ * Process-wide cumulative counters, maximums and latency histograms of the solver.
+ *
+ * Metrics are a fixed set of relaxed atomics, recording one never locks or allocates. A snapshot reads
+ * each metric on its own, it is not taken at a single point in time while queries are running.
+ */
+class Metrics {
+ public:
+  enum class Counter : int {
+    SAT = 0,
+    UNSAT,
+    UNKNOWN,
+    // queries stopped at a limit of their budget
+    STOPPED_QUERIES,
+    CACHE_HITS,
+    CACHE_MISSES,
+    AUTOMATA,
+    NUMBER_OF_COUNTERS
+  };
+
+  enum class Maximum : int {
+    DFA_STATES = 0,
+    NUMBER_OF_MAXIMUMS
+  };
+
+  /**
+   * Timed phases of a query; passes of InitializeSolver and constraint solver runs are phases of their own
+   */
+  enum class Phase : int {
+    PARSE = 0,
+    INITIALIZE,
+    INITIALIZER,
+    SYNTACTIC_PROCESSOR,
+    SYNTACTIC_OPTIMIZER,
+    ALPHABET_PARTITIONER,
+    EQUIVALENCE_GENERATOR,
+    DEPENDENCY_SLICER,
+    COMPONENT_CANONICALIZER,
+    IMPLICATION_RUNNER,
+    FORMULA_OPTIMIZER,
+    CONSTRAINT_SORTER,
+    CONSTRAINT_SOLVER,
+    SOLVE,
+    COUNT,
+    MODELS,
+    NUMBER_OF_PHASES
+  };
+
+  /**
+   * Times a phase until it goes out of scope
+   */
+  class Timer {
+   public:
+    Timer(const Phase phase);
+    ~Timer();
+
+    Timer(const Timer&) = delete;
+    Timer& operator=(const Timer&) = delete;
+
+   private:
+    const Phase phase_;
+    const std::chrono::steady_clock::time_point start_;
+  };
+
+  static void Increment(const Counter counter, const unsigned long value = 1);
+  static void UpdateMaximum(const Maximum maximum, const unsigned long value);
+  static void Observe(const Phase phase, const std::chrono::steady_clock::duration duration);
+
+  /**
+   * Metric values by name; a histogram is reported with its count, its sum in microseconds and its
+   * non-empty buckets keyed by their upper bound in microseconds
+   */
+  static std::map<std::string, unsigned long> GetSnapshot();
+
+  /**
+   * Metrics in the Prometheus text exposition format
+   */
+  static std::string GetText();
+
+  static void Reset();
+
+  static const char* get_name(const Counter counter);
+  static const char* get_name(const Maximum maximum);
+  static const char* get_name(const Phase phase);
+
+ protected:
+  /**
+   * Bucket i counts durations up to 4^i microseconds, the last bucket counts the rest
+   */
+  static const int NUMBER_OF_BUCKETS = 16;
+
+  struct Histogram {
+    std::atomic<unsigned long> count;
+    std::atomic<unsigned long> sum_us;
+    std::atomic<unsigned long> buckets[NUMBER_OF_BUCKETS];
+  };
+
+  static unsigned long get_bucket_bound_us(const int bucket);
+
+  static std::atomic<unsigned long> counters_[static_cast<int>(Counter::NUMBER_OF_COUNTERS)];
+  static std::atomic<unsigned long> maximums_[static_cast<int>(Maximum::NUMBER_OF_MAXIMUMS)];
+  static Histogram histograms_[static_cast<int>(Phase::NUMBER_OF_PHASES)];
+};
+
+} /* namespace Util */
+} /* namespace Vlab */
+
+#endif /* SRC_UTILS_METRICS_H_ */
@@ -0,0 +1,384 @@
+/*
+ * PersistentCache.cpp
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "PersistentCache.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Vlab {
+namespace Util {
+
+const std::size_t PersistentCache::DEFAULT_MAX_SIZE = 256 * 1024 * 1024;
+const char PersistentCache::MAGIC[8] = { 'A', 'B', 'C', 'C', 'A', 'C', 'H', 'E' };
+const uint32_t PersistentCache::VERSION = 1;
+const uint32_t PersistentCache::BYTE_ORDER_MARK = 0x01020304;
+const uint32_t PersistentCache::RECORD_MAGIC = 0xABCCAC4E;
+const int PersistentCache::VLOG_LEVEL = 15;
+
+static const std::size_t RECORD_ALIGNMENT = 8;
+
+static std::size_t align_record(std::size_t size) {
+  return (size + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1);
+}
+
+PersistentCache::PersistentCache(const std::string file_path, const std::size_t max_size)
+    : file_path_ { file_path },
+      lock_path_ { file_path + ".lock" },
+      max_size_ { max_size },
+      fd_ { -1 },
+      lock_fd_ { -1 },
+      inode_ { 0 },
+      data_ { nullptr },
+      mapped_size_ { 0 },
+      indexed_size_ { 0 } {
+}
+
+PersistentCache::~PersistentCache() {
+  Close();
+  if (lock_fd_ >= 0) {
+    ::close(lock_fd_);
+  }
+}
+
+bool PersistentCache::Get(const std::string& key, std::string& value) {
+  if (not Lock(LOCK_SH)) {
+    return false;
+  }
+  bool is_found = false;
+  if (Refresh()) {
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      value.assign(data_ + it->second.offset, it->second.size);
+      is_found = true;
+    }
+  }
+  Unlock();
+  DVLOG(VLOG_LEVEL) << "cache " << (is_found ? "hit" : "miss") << " in " << file_path_;
+  return is_found;
+}
+
+bool PersistentCache::Put(const std::string& key, const std::string& value) {
+  if (not Lock(LOCK_EX)) {
+    return false;
+  }
+  if (not Refresh()) {
+    Unlock();
+    return false;
+  }
+
+  // drop a record torn by a crashed writer, or start over with an unknown format
+  struct stat file_stat;
+  if (fstat(fd_, &file_stat) != 0) {
+    Unlock();
+    return false;
+  }
+  if (indexed_size_ < sizeof(FileHeader)) {
+    if (ftruncate(fd_, 0) != 0 or not InitializeFile(fd_)) {
+      Unlock();
+      return false;
+    }
+    index_.clear();
+    indexed_size_ = sizeof(FileHeader);
+  } else if (static_cast<std::size_t>(file_stat.st_size) > indexed_size_) {
+    LOG(WARNING)<< "discarding incomplete cache record in " << file_path_;
+    if (ftruncate(fd_, indexed_size_) != 0) {
+      Unlock();
+      return false;
+    }
+  }
+
+  RecordHeader header;
+  header.magic = RECORD_MAGIC;
+  header.key_size = key.size();
+  header.value_size = value.size();
+  header.reserved = 0;
+  header.checksum = Checksum(key.data(), key.size(), value.data(), value.size());
+
+  std::string record(reinterpret_cast<const char*>(&header), sizeof(header));
+  record.append(key);
+  record.append(value);
+  record.resize(align_record(record.size()), '\0');
+
+  bool is_written = WriteAt(fd_, record.data(), record.size(), indexed_size_) and (fdatasync(fd_) == 0);
+  if (is_written) {
+    Refresh();
+    if (indexed_size_ > max_size_) {
+      Compact();
+    }
+  } else {
+    LOG(ERROR)<< "cannot append to cache " << file_path_ << ": " << std::strerror(errno);
+  }
+  Unlock();
+  return is_written;
+}
+
+const std::string& PersistentCache::get_file_path() const {
+  return file_path_;
+}
+
+std::size_t PersistentCache::get_num_of_entries() const {
+  return index_.size();
+}
+
+std::size_t PersistentCache::get_max_size() const {
+  return max_size_;
+}
+
+void PersistentCache::set_max_size(const std::size_t max_size) {
+  max_size_ = max_size;
+}
+
+/**
+ * Follows the file if it is replaced by a compaction and indexes the records appended since
+ * the last refresh. Must be called while holding the lock.
+ */
+bool PersistentCache::Refresh() {
+  struct stat path_stat;
+  if (fd_ >= 0 and stat(file_path_.c_str(), &path_stat) == 0 and path_stat.st_ino != inode_) {
+    Close();
+  }
+  if (fd_ < 0 and not Open()) {
+    return false;
+  }
+
+  struct stat file_stat;
+  if (fstat(fd_, &file_stat) != 0) {
+    return false;
+  }
+  const std::size_t file_size = file_stat.st_size;
+  if (file_size != mapped_size_ and not Map(file_size)) {
+    return false;
+  }
+  IndexRecords();
+  return true;
+}
+
+bool PersistentCache::Open() {
+  fd_ = ::open(file_path_.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd_ < 0) {
+    LOG(ERROR)<< "cannot open cache " << file_path_ << ": " << std::strerror(errno);
+    return false;
+  }
+  struct stat file_stat;
+  if (fstat(fd_, &file_stat) != 0) {
+    Close();
+    return false;
+  }
+  inode_ = file_stat.st_ino;
+  index_.clear();
+  indexed_size_ = 0;
+  return true;
+}
+
+void PersistentCache::Close() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), mapped_size_);
+  }
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+  fd_ = -1;
+  inode_ = 0;
+  data_ = nullptr;
+  mapped_size_ = 0;
+  indexed_size_ = 0;
+  index_.clear();
+}
+
+/**
+ * Maps exactly the current file size, pages past the end of a truncated file must not be touched
+ */
+bool PersistentCache::Map(const std::size_t size) {
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), mapped_size_);
+    data_ = nullptr;
+    mapped_size_ = 0;
+  }
+  if (size == 0) {
+    return true;
+  }
+  void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd_, 0);
+  if (data == MAP_FAILED) {
+    LOG(ERROR)<< "cannot map cache " << file_path_ << ": " << std::strerror(errno);
+    return false;
+  }
+  data_ = static_cast<const char*>(data);
+  mapped_size_ = size;
+  return true;
+}
+
+/**
+ * Indexes valid records up to the first one that is incomplete or fails its checksum
+ */
+void PersistentCache::IndexRecords() {
+  if (indexed_size_ == 0) {
+    if (not IsValidHeader(data_, mapped_size_)) {
+      return;
+    }
+    indexed_size_ = sizeof(FileHeader);
+  }
+
+  std::size_t position = indexed_size_;
+  while (position + sizeof(RecordHeader) <= mapped_size_) {
+    RecordHeader header;
+    std::memcpy(&header, data_ + position, sizeof(header));
+    const std::size_t key_offset = position + sizeof(header);
+    const std::size_t value_offset = key_offset + header.key_size;
+    const std::size_t record_end = align_record(value_offset + header.value_size);
+    if (header.magic != RECORD_MAGIC or record_end > mapped_size_
+        or header.checksum != Checksum(data_ + key_offset, header.key_size, data_ + value_offset, header.value_size)) {
+      break;
+    }
+    Location location { value_offset, header.value_size };
+    index_[std::string(data_ + key_offset, header.key_size)] = location;
+    position = record_end;
+  }
+  indexed_size_ = position;
+}
+
+/**
+ * Keeps the most recently written entries that fit in half of the size limit
+ */
+bool PersistentCache::Compact() {
+  std::vector<std::pair<std::size_t, const std::string*>> entries;
+  for (auto& entry : index_) {
+    entries.push_back(std::make_pair(entry.second.offset, &entry.first));
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const std::pair<std::size_t, const std::string*>& x, const std::pair<std::size_t, const std::string*>& y) {
+    return x.first > y.first;
+  });
+
+  const std::size_t budget = max_size_ / 2;
+  std::size_t kept_size = sizeof(FileHeader);
+  std::size_t num_of_kept = 0;
+  for (auto& entry : entries) {
+    auto& location = index_[*entry.second];
+    std::size_t record_size = align_record(sizeof(RecordHeader) + entry.second->size() + location.size);
+    if (kept_size + record_size > budget) {
+      break;
+    }
+    kept_size += record_size;
+    ++num_of_kept;
+  }
+  entries.resize(num_of_kept);
+  std::reverse(entries.begin(), entries.end());
+
+  const std::string tmp_path = file_path_ + ".compact";
+  int tmp_fd = ::open(tmp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (tmp_fd < 0 or not InitializeFile(tmp_fd)) {
+    LOG(ERROR)<< "cannot compact cache " << file_path_ << ": " << std::strerror(errno);
+    if (tmp_fd >= 0) {
+      ::close(tmp_fd);
+    }
+    return false;
+  }
+
+  off_t position = sizeof(FileHeader);
+  bool is_written = true;
+  for (auto& entry : entries) {
+    auto& location = index_[*entry.second];
+    const std::size_t record_offset = location.offset - entry.second->size() - sizeof(RecordHeader);
+    const std::size_t record_size = align_record(sizeof(RecordHeader) + entry.second->size() + location.size);
+    if (not WriteAt(tmp_fd, data_ + record_offset, record_size, position)) {
+      is_written = false;
+      break;
+    }
+    position += record_size;
+  }
+  is_written = is_written and (fsync(tmp_fd) == 0);
+  ::close(tmp_fd);
+  if (not is_written or std::rename(tmp_path.c_str(), file_path_.c_str()) != 0) {
+    LOG(ERROR)<< "cannot compact cache " << file_path_ << ": " << std::strerror(errno);
+    ::unlink(tmp_path.c_str());
+    return false;
+  }
+
+  DVLOG(VLOG_LEVEL) << "compacted cache " << file_path_ << " to " << num_of_kept << " entries";
+  Close();
+  return Refresh();
+}
+
+bool PersistentCache::Lock(const int operation) {
+  if (lock_fd_ < 0) {
+    lock_fd_ = ::open(lock_path_.c_str(), O_RDWR | O_CREAT, 0644);
+    if (lock_fd_ < 0) {
+      LOG(ERROR)<< "cannot open cache lock " << lock_path_ << ": " << std::strerror(errno);
+      return false;
+    }
+  }
+  while (flock(lock_fd_, operation) != 0) {
+    if (errno != EINTR) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void PersistentCache::Unlock() {
+  flock(lock_fd_, LOCK_UN);
+}
+
+bool PersistentCache::InitializeFile(int fd) {
+  FileHeader header;
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.byte_order = BYTE_ORDER_MARK;
+  return WriteAt(fd, reinterpret_cast<const char*>(&header), sizeof(header), 0);
+}
+
+bool PersistentCache::IsValidHeader(const char* data, const std::size_t size) {
+  if (data == nullptr or size < sizeof(FileHeader)) {
+    return false;
+  }
+  FileHeader header;
+  std::memcpy(&header, data, sizeof(header));
+  return std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 and header.version == VERSION
+      and header.byte_order == BYTE_ORDER_MARK;
+}
+
+uint64_t PersistentCache::Checksum(const char* key, const std::size_t key_size, const char* value,
+                                   const std::size_t value_size) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (std::size_t i = 0; i < key_size; ++i) {
+    hash = (hash ^ static_cast<unsigned char>(key[i])) * 0x100000001b3ULL;
+  }
+  hash = (hash ^ 0xff) * 0x100000001b3ULL;
+  for (std::size_t i = 0; i < value_size; ++i) {
+    hash = (hash ^ static_cast<unsigned char>(value[i])) * 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+bool PersistentCache::WriteAt(int fd, const char* buffer, std::size_t length, off_t offset) {
+  while (length > 0) {
+    ssize_t n = pwrite(fd, buffer, length, offset);
+    if (n < 0 and errno == EINTR) {
+      continue;
+    } else if (n <= 0) {
+      return false;
+    }
+    buffer += n;
+    length -= n;
+    offset += n;
+  }
+  return true;
+}
+
+} /* namespace Util */
+} /* namespace Vlab */
@@ -0,0 +1,110 @@
+/*
+ * PersistentCache.h
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef SRC_UTILS_PERSISTENTCACHE_H_
+#define SRC_UTILS_PERSISTENTCACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <sys/types.h>
+
+#include <glog/logging.h>
+
+namespace Vlab {
+namespace Util {
+
+/**
+ * Memory mapped, append only key value store kept in a single file.
+ *
+ * Records are appended under an exclusive lock on a side lock file and synced before the lock is
+ * released; a record torn by a crash fails its checksum and is cut off by the next writer.
+ * Readers map the file and index records without blocking each other. When the file grows over
+ * the size limit the most recently written entries are copied into a new file which atomically
+ * replaces the old one; readers that still map the old file keep reading it until they refresh.
+ * A later record for the same key shadows the earlier ones.
+ */
+class PersistentCache {
+ public:
+  PersistentCache(const std::string file_path, const std::size_t max_size = DEFAULT_MAX_SIZE);
+  virtual ~PersistentCache();
+
+  PersistentCache(const PersistentCache&) = delete;
+  PersistentCache& operator=(const PersistentCache&) = delete;
+
+  bool Get(const std::string& key, std::string& value);
+  bool Put(const std::string& key, const std::string& value);
+
+  const std::string& get_file_path() const;
+  std::size_t get_num_of_entries() const;
+  std::size_t get_max_size() const;
+  void set_max_size(const std::size_t max_size);
+
+  static const std::size_t DEFAULT_MAX_SIZE;
+
+ protected:
+  struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+  };
+
+  struct RecordHeader {
+    uint32_t magic;
+    uint32_t key_size;
+    uint32_t value_size;
+    uint32_t reserved;
+    uint64_t checksum;
+  };
+
+  struct Location {
+    std::size_t offset;
+    std::size_t size;
+  };
+
+  bool Refresh();
+  bool Open();
+  void Close();
+  bool Map(const std::size_t size);
+  void IndexRecords();
+  bool Compact();
+  bool Lock(const int operation);
+  void Unlock();
+
+  static bool InitializeFile(int fd);
+  static bool IsValidHeader(const char* data, const std::size_t size);
+  static uint64_t Checksum(const char* key, const std::size_t key_size, const char* value,
+                           const std::size_t value_size);
+  static bool WriteAt(int fd, const char* buffer, std::size_t length, off_t offset);
+
+  std::string file_path_;
+  std::string lock_path_;
+  std::size_t max_size_;
+  int fd_;
+  int lock_fd_;
+  ino_t inode_;
+  const char* data_;
+  std::size_t mapped_size_;
+  std::size_t indexed_size_;
+  std::unordered_map<std::string, Location> index_;
+
+ private:
+  static const char MAGIC[8];
+  static const uint32_t VERSION;
+  static const uint32_t BYTE_ORDER_MARK;
+  static const uint32_t RECORD_MAGIC;
+  static const int VLOG_LEVEL;
+};
+
+} /* namespace Util */
+} /* namespace Vlab */
+
+#endif /* SRC_UTILS_PERSISTENTCACHE_H_ */
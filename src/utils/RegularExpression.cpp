@@ -35,6 +35,8 @@
 
 #include "RegularExpression.h"
 
+#include "Unicode.h"
+
 namespace Vlab {
 namespace Util {
 
@@ -46,6 +48,7 @@ const int RegularExpression::EMPTY = 0x0004;
 const int RegularExpression::ANYSTRING = 0x0008;
 const int RegularExpression::AUTOMATON = 0x0010;
 const int RegularExpression::INTERVAL = 0x0020;
+const int RegularExpression::UNICODE = 0x0040;
 const int RegularExpression::ALL = 0xffff;
 const int RegularExpression::NONE = 0x0000;
 int RegularExpression::DEFAULT = 0x000f;
@@ -53,9 +56,9 @@ int RegularExpression::DEFAULT = 0x000f;
 RegularExpression::RegularExpression()
     : type_(Type::NONE),
       flags_(DEFAULT),
-      character_('\0'),
-      from_char_('\0'),
-      to_char_('\0'),
+      character_(0),
+      from_char_(0),
+      to_char_(0),
       digits_(0),
       min_(0),
       max_(0),
@@ -70,9 +73,9 @@ RegularExpression::RegularExpression()
 RegularExpression::RegularExpression(std::string regex)
     : type_(Type::NONE),
       flags_(DEFAULT),
-      character_('\0'),
-      from_char_('\0'),
-      to_char_('\0'),
+      character_(0),
+      from_char_(0),
+      to_char_(0),
       digits_(0),
       min_(0),
       max_(0),
@@ -87,9 +90,9 @@ RegularExpression::RegularExpression(std::string regex)
 RegularExpression::RegularExpression(std::string regex, int syntax_flags)
     : type_(Type::NONE),
       flags_(syntax_flags),
-      character_('\0'),
-      from_char_('\0'),
-      to_char_('\0'),
+      character_(0),
+      from_char_(0),
+      to_char_(0),
       digits_(0),
       min_(0),
       max_(0),
@@ -141,7 +144,7 @@ std::string RegularExpression::constant_str() const {
   std::stringstream ss;
   switch (type_) {
     case Type::CHAR: {
-      ss << character_;
+      ss << char_to_string(character_);
     }
       ;
       break;
@@ -211,14 +214,13 @@ std::string RegularExpression::str() const {
       ss << "~(" << *exp1_ << ')';
       break;
     case Type::CHAR: {
-      std::string character(1, character_);
-      ss << RegularExpression::escape_raw_string(character);
+      ss << RegularExpression::escape_raw_string(char_to_string(character_));
     }
       ;
       break;
     case Type::CHAR_RANGE: {
-      std::string from = std::string(1, from_char_);
-      std::string to = std::string(1, to_char_);
+      std::string from = char_to_string(from_char_);
+      std::string to = char_to_string(to_char_);
       if (from_char_ == '^' or from_char_ == '\\' or from_char_ == '[' or from_char_ == ']') {
         from = "\\" + from;
       }
@@ -313,7 +315,7 @@ RegularExpression_ptr RegularExpression::makeUnion(RegularExpression_ptr exp1, R
     left = exp1->string_;
     is_left_constant = true;
   } else if (exp1->type_ == Type::CHAR) {
-    left = std::string(1, exp1->character_);
+    left = char_to_string(exp1->character_);
     is_left_constant = true;
   }
 
@@ -321,7 +323,7 @@ RegularExpression_ptr RegularExpression::makeUnion(RegularExpression_ptr exp1, R
     right = exp2->string_;
     is_right_constant = true;
   } else if (exp2->type_ == Type::CHAR) {
-    right = std::string(1, exp2->character_);
+    right = char_to_string(exp2->character_);
     is_right_constant = true;
   }
 
@@ -403,7 +405,7 @@ RegularExpression_ptr RegularExpression::makeIntersection(RegularExpression_ptr
     left = exp1->string_;
     is_left_constant = true;
   } else if (exp1->type_ == Type::CHAR) {
-    left = std::string(1, exp1->character_);
+    left = char_to_string(exp1->character_);
     is_left_constant = true;
   }
 
@@ -411,7 +413,7 @@ RegularExpression_ptr RegularExpression::makeIntersection(RegularExpression_ptr
     right = exp2->string_;
     is_right_constant = true;
   } else if (exp2->type_ == Type::CHAR) {
-    right = std::string(1, exp2->character_);
+    right = char_to_string(exp2->character_);
     is_right_constant = true;
   }
 
@@ -510,7 +512,7 @@ RegularExpression_ptr RegularExpression::makeRepeat(RegularExpression_ptr exp, u
     regex->type_ = Type::STRING;
     std::stringstream ss;
     for (unsigned long i = 0; i < min; ++i) {
-      ss << exp->character_;
+      ss << char_to_string(exp->character_);
     }
     regex->string_ = ss.str();
     delete exp;
@@ -536,14 +538,14 @@ RegularExpression_ptr RegularExpression::makeComplement(RegularExpression_ptr ex
   return regex;
 }
 
-RegularExpression_ptr RegularExpression::makeChar(char c) {
+RegularExpression_ptr RegularExpression::makeChar(unsigned long c) {
   RegularExpression_ptr regex = new RegularExpression();
   regex->type_ = Type::CHAR;
   regex->character_ = c;
   return regex;
 }
 
-RegularExpression_ptr RegularExpression::makeCharRange(char from, char to) {
+RegularExpression_ptr RegularExpression::makeCharRange(unsigned long from, unsigned long to) {
   RegularExpression_ptr regex = new RegularExpression();
   if (from == to) {  // optimize
     regex->type_ = Type::CHAR;
@@ -711,7 +713,7 @@ RegularExpression_ptr RegularExpression::parseCharClasses() {
 }
 
 RegularExpression_ptr RegularExpression::parseCharClass() {
-  char c = parseCharExp();
+  unsigned long c = parseCharExp();
   if (match('-')) {
     return makeCharRange(c, parseCharExp());
   } else {
@@ -799,9 +801,22 @@ RegularExpression_ptr RegularExpression::parseSimpleExp() {
   }
 }
 
-char RegularExpression::parseCharExp() {
+unsigned long RegularExpression::parseCharExp() {
+  if (check(UNICODE)) {
+    unsigned long code_point = 0;
+    std::string::size_type length = 0;
+    if (Unicode::parse_escape(input_regex_string_, pos_, code_point, length)) {
+      pos_ += length;
+      return code_point;
+    }
+    match('\\');
+    if (!more()) {
+      LOG(FATAL)<< "unexpected end-of-string";
+    }
+    return Unicode::read_code_point(input_regex_string_, pos_);
+  }
   match('\\');
-  return next();
+  return static_cast<unsigned char>(next());
 }
 
 RegularExpression::Type RegularExpression::type() {
@@ -824,15 +839,15 @@ unsigned long RegularExpression::get_max() {
   return max_;
 }
 
-char RegularExpression::get_character() {
+unsigned long RegularExpression::get_character() {
   return character_;
 }
 
-char RegularExpression::get_from_character() {
+unsigned long RegularExpression::get_from_character() {
   return from_char_;
 }
 
-char RegularExpression::get_to_character() {
+unsigned long RegularExpression::get_to_character() {
   return to_char_;
 }
 
@@ -849,17 +864,24 @@ RegularExpression_ptr RegularExpression::concat_constants(RegularExpression_ptr
   if (exp1->type_ == Type::STRING) {
     ss << exp1->string_;
   } else {
-    ss << exp1->character_;
+    ss << char_to_string(exp1->character_);
   }
 
   if (exp2->type_ == Type::STRING) {
     ss << exp2->string_;
   } else {
-    ss << exp2->character_;
+    ss << char_to_string(exp2->character_);
   }
   return RegularExpression::makeString(ss.str());
 }
 
+std::string RegularExpression::char_to_string(unsigned long c) {
+  if ((DEFAULT & UNICODE) != 0) {
+    return Unicode::to_utf8(c);
+  }
+  return std::string(1, static_cast<char>(c));
+}
+
 void RegularExpression::parse() {
   if (input_regex_string_ == "") {
     type_ = Type::STRING;
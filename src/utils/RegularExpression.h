@@ -82,6 +82,12 @@ public:
    */
   static int const INTERVAL;
 
+  /**
+   * Syntax flag, reads characters as code points: multi-byte utf-8 characters and
+   * <tt>\u</tt><i>XXXX</i>, <tt>\u{</tt><i>X...</i><tt>}</tt> escapes are single characters.
+   */
+  static int const UNICODE;
+
   /**
    * Syntax flag, enables all optional RegularExpression syntax.
    */
@@ -139,8 +145,8 @@ public:
   static RegularExpression_ptr makeRepeat(RegularExpression_ptr exp, unsigned long min);
   static RegularExpression_ptr makeRepeat(RegularExpression_ptr exp, unsigned long min, unsigned long max);
   static RegularExpression_ptr makeComplement(RegularExpression_ptr exp);
-  static RegularExpression_ptr makeChar(char c);
-  static RegularExpression_ptr makeCharRange(char from, char to);
+  static RegularExpression_ptr makeChar(unsigned long c);
+  static RegularExpression_ptr makeCharRange(unsigned long from, unsigned long to);
   static RegularExpression_ptr makeAnyChar();
   static RegularExpression_ptr makeEmpty();
   static RegularExpression_ptr makeString(std::string s);
@@ -156,22 +162,23 @@ public:
   RegularExpression_ptr parseCharClasses();
   RegularExpression_ptr parseCharClass();
   RegularExpression_ptr parseSimpleExp();
-  char parseCharExp();
+  unsigned long parseCharExp();
 
   Type type();
   RegularExpression_ptr get_expr1();
   RegularExpression_ptr get_expr2();
   unsigned long get_min();
   unsigned long get_max();
-  char get_character();
-  char get_from_character();
-  char get_to_character();
+  unsigned long get_character();
+  unsigned long get_from_character();
+  unsigned long get_to_character();
   std::string get_string();
 
   friend std::ostream& operator<<(std::ostream& os, const RegularExpression& regex);
 private:
 
   static RegularExpression_ptr concat_constants(RegularExpression_ptr exp1, RegularExpression_ptr exp2);
+  static std::string char_to_string(unsigned long c);
   void parse();
   bool peek(std::string s);
   bool match(char c);
@@ -181,9 +188,9 @@ private:
 
   Type type_;
   int flags_;
-  char character_;
-  char from_char_;
-  char to_char_;
+  unsigned long character_;
+  unsigned long from_char_;
+  unsigned long to_char_;
   unsigned digits_;
   unsigned long min_;
   unsigned long max_;
@@ -0,0 +1,148 @@
+/*
+ * Trace.cpp
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "Trace.h"
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <sstream>
+
+namespace Vlab {
+namespace Util {
+
+const int Trace::VLOG_LEVEL = 20;
+
+std::atomic<bool> Trace::is_recording_ { false };
+unsigned long Trace::recording_id_ = 0;
+std::string Trace::file_name_;
+std::chrono::steady_clock::time_point Trace::origin_;
+std::mutex Trace::mutex_;
+std::vector<std::string> Trace::events_;
+thread_local std::string Trace::term_;
+
+static std::atomic<int> next_thread_id { 1 };
+static thread_local int thread_id = 0;
+
+Trace::Event::Event(const char* name, const char* category)
+    : is_recording_ { Trace::is_recording_ },
+      name_ { name },
+      category_ { category } {
+  if (is_recording_) {
+    start_ = std::chrono::steady_clock::now();
+  }
+}
+
+Trace::Event::~Event() {
+  if (is_recording_) {
+    Trace::Record(name_, category_, start_, std::chrono::steady_clock::now(), args_);
+  }
+}
+
+void Trace::Event::AddArg(const char* key, const long value) {
+  if (is_recording_) {
+    args_ += ",\"" + std::string(key) + "\":" + std::to_string(value);
+  }
+}
+
+void Trace::Event::AddArg(const char* key, const std::string& value) {
+  if (is_recording_) {
+    args_ += ",\"" + std::string(key) + "\":\"" + Trace::Escape(value) + "\"";
+  }
+}
+
+unsigned long Trace::Start(const std::string& file_name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  StopRecording();
+  file_name_ = file_name;
+  events_.clear();
+  origin_ = std::chrono::steady_clock::now();
+  is_recording_ = true;
+  DVLOG(VLOG_LEVEL) << "trace started: " << file_name_;
+  return ++recording_id_;
+}
+
+void Trace::Stop(const unsigned long recording_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (recording_id == recording_id_) {
+    StopRecording();
+  }
+}
+
+void Trace::Stop() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  StopRecording();
+}
+
+/**
+ * Called with the lock held
+ */
+void Trace::StopRecording() {
+  if (not is_recording_) {
+    return;
+  }
+  is_recording_ = false;
+  std::ofstream out(file_name_);
+  if (not out.good()) {
+    LOG(ERROR)<< "cannot write trace file: " << file_name_;
+    events_.clear();
+    return;
+  }
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  for (std::size_t i = 0; i < events_.size(); ++i) {
+    out << (i == 0 ? "\n" : ",\n") << events_[i];
+  }
+  out << "\n]}\n";
+  DVLOG(VLOG_LEVEL) << "trace written: " << file_name_ << ", " << events_.size() << " events";
+  events_.clear();
+}
+
+void Trace::set_term(const std::string& term) {
+  term_ = term;
+}
+
+std::string Trace::Escape(const std::string& value) {
+  std::string escaped;
+  escaped.reserve(value.size());
+  for (const char c : value) {
+    if (c == '"' or c == '\\') {
+      escaped += '\\';
+      escaped += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char code[8];
+      std::snprintf(code, sizeof(code), "\\u%04x", c);
+      escaped += code;
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+void Trace::Record(const char* name, const char* category, const std::chrono::steady_clock::time_point start,
+                   const std::chrono::steady_clock::time_point end, const std::string& args) {
+  if (thread_id == 0) {
+    thread_id = next_thread_id++;
+  }
+  const std::string term = Escape(term_);
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (not is_recording_) {
+    return;
+  }
+  // the origin is reset by a new recording, it is read under the lock
+  std::stringstream event;
+  event << "{\"name\":\"" << name << "\",\"cat\":\"" << category << "\",\"ph\":\"X\",\"pid\":" << getpid()
+        << ",\"tid\":" << thread_id << std::fixed
+        << ",\"ts\":" << std::chrono::duration<double, std::micro>(start - origin_).count()
+        << ",\"dur\":" << std::chrono::duration<double, std::micro>(end - start).count()
+        << ",\"args\":{\"term\":\"" << term << "\"" << args << "}}";
+  events_.push_back(event.str());
+}
+
+} /* namespace Util */
+} /* namespace Vlab */
@@ -0,0 +1,107 @@
+/*
+ * Trace.h
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef SRC_UTILS_TRACE_H_
+#define SRC_UTILS_TRACE_H_
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <glog/logging.h>
+
+namespace Vlab {
+namespace Util {
+
+/**
+ * Records timed events of automata operations, preprocessing passes and counting, and writes them as
+ * Chrome trace-event json (chrome://tracing, Perfetto) when recording stops.
+ *
+ * Events are complete events that nest by time. Each event is tagged with the term being solved when
+ * it started. When recording is off an event costs a flag check; arguments that are expensive to
+ * compute should be guarded with is_recording().
+ */
+class Trace {
+ public:
+  /**
+   * Timed event that is recorded when it goes out of scope
+   */
+  class Event {
+   public:
+    Event(const char* name, const char* category);
+    ~Event();
+
+    Event(const Event&) = delete;
+    Event& operator=(const Event&) = delete;
+
+    void AddArg(const char* key, const long value);
+    void AddArg(const char* key, const std::string& value);
+    bool is_recording() const {
+      return is_recording_;
+    }
+
+   private:
+    const bool is_recording_;
+    const char* name_;
+    const char* category_;
+    std::chrono::steady_clock::time_point start_;
+    std::string args_;
+  };
+
+  /**
+   * Starts recording, a running recording is written first
+   * @return id of the recording, only the owner of the id stops it
+   */
+  static unsigned long Start(const std::string& file_name);
+
+  /**
+   * Stops the recording of the id and writes the events to the file, a later recording keeps running
+   */
+  static void Stop(const unsigned long recording_id);
+
+  /**
+   * Stops any running recording and writes the events to the file
+   */
+  static void Stop();
+
+  static bool is_recording() {
+    return is_recording_;
+  }
+
+  /**
+   * Sets the term that the following events of the thread belong to
+   */
+  static void set_term(const std::string& term);
+
+ protected:
+  static std::string Escape(const std::string& value);
+  static void Record(const char* name, const char* category, const std::chrono::steady_clock::time_point start,
+                     const std::chrono::steady_clock::time_point end, const std::string& args);
+
+  static void StopRecording();
+
+  // read without the lock by every event, set under the lock
+  static std::atomic<bool> is_recording_;
+  static unsigned long recording_id_;
+  static std::string file_name_;
+  static std::chrono::steady_clock::time_point origin_;
+  static std::mutex mutex_;
+  static std::vector<std::string> events_;
+  static thread_local std::string term_;
+
+ private:
+  static const int VLOG_LEVEL;
+};
+
+} /* namespace Util */
+} /* namespace Vlab */
+
+#endif /* SRC_UTILS_TRACE_H_ */
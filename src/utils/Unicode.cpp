@@ -0,0 +1,110 @@
+/*
+ * Unicode.cpp
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "Unicode.h"
+
+#include <cctype>
+
+namespace Vlab {
+namespace Util {
+namespace Unicode {
+
+std::string to_utf8(unsigned long code_point) {
+  std::string result;
+  if (code_point < 0x80) {
+    result += static_cast<char>(code_point);
+  } else if (code_point < 0x800) {
+    result += static_cast<char>(0xC0 | (code_point >> 6));
+    result += static_cast<char>(0x80 | (code_point & 0x3F));
+  } else if (code_point < 0x10000) {
+    result += static_cast<char>(0xE0 | (code_point >> 12));
+    result += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    result += static_cast<char>(0x80 | (code_point & 0x3F));
+  } else {
+    result += static_cast<char>(0xF0 | ((code_point >> 18) & 0x07));
+    result += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+    result += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    result += static_cast<char>(0x80 | (code_point & 0x3F));
+  }
+  return result;
+}
+
+unsigned long read_code_point(const std::string& str, std::string::size_type& pos) {
+  const unsigned char lead = static_cast<unsigned char>(str[pos]);
+  int continuation_bytes = 0;
+  unsigned long code_point = lead;
+  if (lead >= 0xF0 and lead < 0xF8) {
+    continuation_bytes = 3;
+    code_point = lead & 0x07;
+  } else if (lead >= 0xE0 and lead < 0xF0) {
+    continuation_bytes = 2;
+    code_point = lead & 0x0F;
+  } else if (lead >= 0xC0 and lead < 0xE0) {
+    continuation_bytes = 1;
+    code_point = lead & 0x1F;
+  }
+
+  if (pos + continuation_bytes >= str.length()) {
+    ++pos;
+    return lead;
+  }
+  for (int i = 1; i <= continuation_bytes; ++i) {
+    const unsigned char c = static_cast<unsigned char>(str[pos + i]);
+    if ((c & 0xC0) != 0x80) {
+      ++pos;
+      return lead;
+    }
+    code_point = (code_point << 6) | (c & 0x3F);
+  }
+  pos += continuation_bytes + 1;
+  return code_point;
+}
+
+std::vector<unsigned long> to_code_points(const std::string& str) {
+  std::vector<unsigned long> code_points;
+  std::string::size_type pos = 0;
+  while (pos < str.length()) {
+    code_points.push_back(read_code_point(str, pos));
+  }
+  return code_points;
+}
+
+bool parse_escape(const std::string& str, std::string::size_type pos, unsigned long& code_point,
+                  std::string::size_type& length) {
+  if (pos + 2 >= str.length() or str[pos] != '\\' or str[pos + 1] != 'u') {
+    return false;
+  }
+
+  std::string::size_type start = pos + 2, end = start;
+  if (str[start] == '{') {
+    end = str.find('}', start);
+    if (end == std::string::npos or end == start + 1 or end - start > 7) {
+      return false;
+    }
+    ++start;
+  } else {
+    end = start + 4;
+    if (end > str.length()) {
+      return false;
+    }
+  }
+
+  code_point = 0;
+  for (auto i = start; i < end; ++i) {
+    if (not std::isxdigit(static_cast<unsigned char>(str[i]))) {
+      return false;
+    }
+    code_point = code_point * 16 + std::stoul(str.substr(i, 1), nullptr, 16);
+  }
+  length = (str[pos + 2] == '{') ? end + 1 - pos : end - pos;
+  return true;
+}
+
+} /* namespace Unicode */
+} /* namespace Util */
+} /* namespace Vlab */
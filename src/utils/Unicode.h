@@ -0,0 +1,43 @@
+/*
+ * Unicode.h
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef SRC_UTILS_UNICODE_H_
+#define SRC_UTILS_UNICODE_H_
+
+#include <string>
+#include <vector>
+
+namespace Vlab {
+namespace Util {
+namespace Unicode {
+
+/**
+ * @return utf-8 encoding of the code point
+ */
+std::string to_utf8(unsigned long code_point);
+
+/**
+ * Reads one code point starting at pos and moves pos after it.
+ * A byte that does not start a valid utf-8 sequence is read as a code point by itself.
+ */
+unsigned long read_code_point(const std::string& str, std::string::size_type& pos);
+
+std::vector<unsigned long> to_code_points(const std::string& str);
+
+/**
+ * Parses an escape sequence of the form \uXXXX or \u{X...} starting at pos.
+ * @return true and sets code point and the length of the sequence if there is one
+ */
+bool parse_escape(const std::string& str, std::string::size_type pos, unsigned long& code_point,
+                  std::string::size_type& length);
+
+} /* namespace Unicode */
+} /* namespace Util */
+} /* namespace Vlab */
+
+#endif /* SRC_UTILS_UNICODE_H_ */
@@ -5,25 +5,105 @@
  *      Author: baki
  */
 
+#include <cstdint>
 #include <map>
+#include <streambuf>
 #include <string>
 #include <iostream>
 
 #include "vlab_cs_ucsb_edu_DriverProxy.h"
 #include "Driver.h"
 
+/**
+ * Class and method ids are looked up once when the library is loaded
+ */
+static jclass big_integer_class = nullptr;
+static jmethodID big_integer_ctor = nullptr;
+static jclass hash_map_class = nullptr;
+static jmethodID hash_map_ctor = nullptr;
+static jmethodID hash_map_put = nullptr;
+static jclass long_class = nullptr;
+static jmethodID long_value_of = nullptr;
+static jclass illegal_argument_class = nullptr;
+static jfieldID driver_pointer_field = nullptr;
+
+/**
+ * Read only stream buffer over memory owned by the JVM, avoids copying constraints before parsing
+ */
+class MemoryBuffer : public std::streambuf {
+ public:
+  MemoryBuffer(const char* data, std::size_t length) {
+    char* begin = const_cast<char*>(data);
+    setg(begin, begin, begin + length);
+  }
+};
+
+jclass getGlobalClass(JNIEnv *env, const char* name) {
+  jclass local_class = env->FindClass(name);
+  if (local_class == nullptr or env->ExceptionCheck()) {
+    // a failed lookup leaves NoClassDefFoundError pending, loading fails with JNI_ERR instead
+    env->ExceptionClear();
+    return nullptr;
+  }
+  jclass global_class = reinterpret_cast<jclass>(env->NewGlobalRef(local_class));
+  env->DeleteLocalRef(local_class);
+  return global_class;
+}
 
-jfieldID getHandleField(JNIEnv *env, jobject obj)
-{
-    jclass c = env->GetObjectClass(obj);
-    // J is the type signature for long:
-    return env->GetFieldID(c, "driverPointer", "J");
+JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM *vm, void *reserved) {
+  JNIEnv *env = nullptr;
+  if (vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6) != JNI_OK) {
+    return JNI_ERR;
+  }
+
+  big_integer_class = getGlobalClass(env, "java/math/BigInteger");
+  hash_map_class = getGlobalClass(env, "java/util/HashMap");
+  long_class = getGlobalClass(env, "java/lang/Long");
+  illegal_argument_class = getGlobalClass(env, "java/lang/IllegalArgumentException");
+  jclass driver_proxy_class = env->FindClass("vlab/cs/ucsb/edu/DriverProxy");
+  if (env->ExceptionCheck()) {
+    env->ExceptionClear();
+    driver_proxy_class = nullptr;
+  }
+  if (big_integer_class == nullptr or hash_map_class == nullptr or long_class == nullptr
+      or illegal_argument_class == nullptr or driver_proxy_class == nullptr) {
+    return JNI_ERR;
+  }
+
+  big_integer_ctor = env->GetMethodID(big_integer_class, "<init>", "(Ljava/lang/String;)V");
+  hash_map_ctor = env->GetMethodID(hash_map_class, "<init>", "()V");
+  hash_map_put = env->GetMethodID(hash_map_class, "put", "(Ljava/lang/Object;Ljava/lang/Object;)Ljava/lang/Object;");
+  long_value_of = env->GetStaticMethodID(long_class, "valueOf", "(J)Ljava/lang/Long;");
+  // J is the type signature for long:
+  driver_pointer_field = env->GetFieldID(driver_proxy_class, "driverPointer", "J");
+  env->DeleteLocalRef(driver_proxy_class);
+  if (env->ExceptionCheck()) {
+    env->ExceptionClear();
+    return JNI_ERR;
+  }
+  if (big_integer_ctor == nullptr or hash_map_ctor == nullptr or hash_map_put == nullptr or long_value_of == nullptr
+      or driver_pointer_field == nullptr) {
+    return JNI_ERR;
+  }
+
+  return JNI_VERSION_1_6;
+}
+
+JNIEXPORT void JNICALL JNI_OnUnload(JavaVM *vm, void *reserved) {
+  JNIEnv *env = nullptr;
+  if (vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6) != JNI_OK) {
+    return;
+  }
+  env->DeleteGlobalRef(big_integer_class);
+  env->DeleteGlobalRef(hash_map_class);
+  env->DeleteGlobalRef(long_class);
+  env->DeleteGlobalRef(illegal_argument_class);
 }
 
 template <typename T>
 T *getHandle(JNIEnv *env, jobject obj)
 {
-    jlong handle = env->GetLongField(obj, getHandleField(env, obj));
+    jlong handle = env->GetLongField(obj, driver_pointer_field);
     return reinterpret_cast<T *>(handle);
 }
 
@@ -31,21 +111,91 @@ template <typename T>
 void setHandle(JNIEnv *env, jobject obj, T *t)
 {
     jlong handle = reinterpret_cast<jlong>(t);
-    env->SetLongField(obj, getHandleField(env, obj), handle);
+    env->SetLongField(obj, driver_pointer_field, handle);
 }
 
-jobject newBigInteger(JNIEnv *env, jstring value) {
-  jclass big_integer_class = env->FindClass("java/math/BigInteger");
-  jmethodID big_integer_ctor = env->GetMethodID(big_integer_class, "<init>", "(Ljava/lang/String;)V");
-  jobject big_integer = env->NewObject(big_integer_class, big_integer_ctor, value);
+jobject newBigInteger(JNIEnv *env, const Vlab::Theory::BigInteger& value) {
+  std::stringstream ss;
+  ss << value;
+  jstring value_string = env->NewStringUTF(ss.str().c_str());
+  jobject big_integer = env->NewObject(big_integer_class, big_integer_ctor, value_string);
+  env->DeleteLocalRef(value_string);
   return big_integer;
 }
 
+jobject newHashMap(JNIEnv *env, const std::map<std::string, std::string>& entries) {
+  jobject map = env->NewObject(hash_map_class, hash_map_ctor);
+  for (auto& entry : entries) {
+    jstring var_name = env->NewStringUTF(entry.first.c_str());
+    jstring var_value = env->NewStringUTF(entry.second.c_str());
+    jobject previous = env->CallObjectMethod(map, hash_map_put, var_name, var_value);
+    env->DeleteLocalRef(previous);
+    env->DeleteLocalRef(var_name);
+    env->DeleteLocalRef(var_value);
+  }
+  return map;
+}
+
+jobject newHashMap(JNIEnv *env, const std::map<std::string, unsigned long>& entries) {
+  jobject map = env->NewObject(hash_map_class, hash_map_ctor);
+  for (auto& entry : entries) {
+    jstring name = env->NewStringUTF(entry.first.c_str());
+    jobject value = env->CallStaticObjectMethod(long_class, long_value_of, static_cast<jlong>(entry.second));
+    jobject previous = env->CallObjectMethod(map, hash_map_put, name, value);
+    env->DeleteLocalRef(previous);
+    env->DeleteLocalRef(name);
+    env->DeleteLocalRef(value);
+  }
+  return map;
+}
+
+/**
+ * Returns the address of a direct buffer if it can hold the given number of bytes, throws otherwise
+ */
+void* getDirectBuffer(JNIEnv *env, jobject buffer, const jlong min_capacity) {
+  if (min_capacity < 0) {
+    env->ThrowNew(illegal_argument_class, "negative buffer range");
+    return nullptr;
+  }
+  void* address = (buffer == nullptr) ? nullptr : env->GetDirectBufferAddress(buffer);
+  if (address == nullptr) {
+    env->ThrowNew(illegal_argument_class, "expected a direct ByteBuffer");
+    return nullptr;
+  }
+  if (env->GetDirectBufferCapacity(buffer) < min_capacity) {
+    env->ThrowNew(illegal_argument_class, "ByteBuffer is smaller than the requested range");
+    return nullptr;
+  }
+  return address;
+}
+
+/**
+ * Solves a constraint, throws IllegalArgumentException and returns false if it has a syntax error.
+ * Only decides satisfiability when ENABLE_SATISFIABILITY_ONLY is set, counts and models then solve exactly
+ */
+bool solve(JNIEnv *env, Vlab::Driver *abc_driver, const char* constraint, const std::size_t length) {
+  MemoryBuffer buffer(constraint, length);
+  std::istream input_constraint(&buffer);
+  abc_driver->reset();
+  if (abc_driver->Parse(&input_constraint) != 0) {
+    abc_driver->reset();
+    env->ThrowNew(illegal_argument_class, "syntax error in constraint");
+    return false;
+  }
+  abc_driver->InitializeSolver();
+  if (Vlab::Option::Solver::ENABLE_SATISFIABILITY_ONLY) {
+    abc_driver->SolveSatisfiability();
+  } else {
+    abc_driver->Solve();
+  }
+  return abc_driver->is_sat();
+}
+
 void load_model_counter(JNIEnv *env, Vlab::Solver::ModelCounter& mc, jbyteArray model_counter) {
   jsize length = env->GetArrayLength(model_counter);
   jbyte* buffer = env->GetByteArrayElements(model_counter, nullptr);
-  std::string bin_model_counter_str (const_cast<char*>(reinterpret_cast<char*>(buffer)), length);
-  std::stringstream is (bin_model_counter_str);
+  MemoryBuffer bin_model_counter(reinterpret_cast<const char*>(buffer), length);
+  std::istream is (&bin_model_counter);
   {
     cereal::BinaryInputArchive ar(is);
     mc.load(ar);
@@ -110,22 +260,55 @@ JNIEXPORT void JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_setOption__ILjava_lang_
  * Method:    isSatisfiable
  * Signature: (Ljava/lang/String;)Z
  */
-JNIEXPORT jboolean JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_isSatisfiable
+JNIEXPORT jboolean JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_isSatisfiable__Ljava_lang_String_2
   (JNIEnv *env, jobject obj, jstring constraint) {
 
   Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
-  std::istringstream input_constraint;
   const char* constraint_str = env->GetStringUTFChars(constraint, JNI_FALSE);
-  input_constraint.str(constraint_str);
-  abc_driver->reset();
-  abc_driver->Parse(&input_constraint);
+  jsize length = env->GetStringUTFLength(constraint);
+  bool result = solve(env, abc_driver, constraint_str, length);
   env->ReleaseStringUTFChars(constraint, constraint_str);
-  abc_driver->InitializeSolver();
-  abc_driver->Solve();
-  bool result = abc_driver->is_sat();
   return (jboolean)result;
 }
 
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    isSatisfiable
+ * Signature: (Ljava/nio/ByteBuffer;I)Z
+ */
+JNIEXPORT jboolean JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_isSatisfiable__Ljava_nio_ByteBuffer_2I
+  (JNIEnv *env, jobject obj, jobject constraint, jint length) {
+
+  Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
+  const char* constraint_str = reinterpret_cast<const char*>(getDirectBuffer(env, constraint, length));
+  if (constraint_str == nullptr) {
+    return JNI_FALSE;
+  }
+  return (jboolean)solve(env, abc_driver, constraint_str, length);
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    isUnknown
+ * Signature: ()Z
+ */
+JNIEXPORT jboolean JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_isUnknown
+  (JNIEnv *env, jobject obj) {
+  Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
+  return (jboolean)abc_driver->is_unknown();
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    isExact
+ * Signature: ()Z
+ */
+JNIEXPORT jboolean JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_isExact
+  (JNIEnv *env, jobject obj) {
+  Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
+  return (jboolean)abc_driver->is_exact();
+}
+
 /*
  * Class:     vlab_cs_ucsb_edu_DriverProxy
  * Method:    countVariable
@@ -138,11 +321,8 @@ JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countVariable__Ljava
   const char* var_name_arr = env->GetStringUTFChars(var_name, JNI_FALSE);
   std::string var_name_str {var_name_arr};
   auto result = abc_driver->CountVariable(var_name_str, bound);
-  std::stringstream ss;
-  ss << result;
-  jstring result_string = env->NewStringUTF(ss.str().c_str());
   env->ReleaseStringUTFChars(var_name, var_name_arr);
-  return newBigInteger(env, result_string);
+  return newBigInteger(env, result);
 }
 
 /*
@@ -155,10 +335,7 @@ JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countInts__J
 
   Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
   auto result = abc_driver->CountInts(bound);
-  std::stringstream ss;
-  ss << result;
-  jstring result_string = env->NewStringUTF(ss.str().c_str());
-  return newBigInteger(env, result_string);
+  return newBigInteger(env, result);
 }
 
 /*
@@ -171,10 +348,7 @@ JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countStrs__J
 
   Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
   auto result = abc_driver->CountStrs(bound);
-  std::stringstream ss;
-  ss << result;
-  jstring result_string = env->NewStringUTF(ss.str().c_str());
-  return newBigInteger(env, result_string);
+  return newBigInteger(env, result);
 }
 
 /*
@@ -187,10 +361,7 @@ JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_count__JJ
 
   Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
   auto result = abc_driver->Count(int_bound, str_bound);
-  std::stringstream ss;
-  ss << result;
-  jstring result_string = env->NewStringUTF(ss.str().c_str());
-  return newBigInteger(env, result_string);
+  return newBigInteger(env, result);
 }
 
 /*
@@ -249,10 +420,7 @@ JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countVariable__Ljava
   Vlab::Solver::ModelCounter mc;
   load_model_counter(env, mc, model_counter);
   auto result = mc.Count(bound, bound);
-  std::stringstream ss;
-  ss << result;
-  jstring result_string = env->NewStringUTF(ss.str().c_str());
-  return newBigInteger(env, result_string);
+  return newBigInteger(env, result);
 }
 
 /*
@@ -266,10 +434,7 @@ JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countInts__J_3B
   Vlab::Solver::ModelCounter mc;
   load_model_counter(env, mc, model_counter);
   auto result = mc.CountInts(bound);
-  std::stringstream ss;
-  ss << result;
-  jstring result_string = env->NewStringUTF(ss.str().c_str());
-  return newBigInteger(env, result_string);
+  return newBigInteger(env, result);
 }
 
 /*
@@ -283,10 +448,7 @@ JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countStrs__J_3B
   Vlab::Solver::ModelCounter mc;
   load_model_counter(env, mc, model_counter);
   auto result = mc.CountStrs(bound);
-  std::stringstream ss;
-  ss << result;
-  jstring result_string = env->NewStringUTF(ss.str().c_str());
-  return newBigInteger(env, result_string);
+  return newBigInteger(env, result);
 }
 
 /*
@@ -300,10 +462,160 @@ JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_count__JJ_3B
   Vlab::Solver::ModelCounter mc;
   load_model_counter(env, mc, model_counter);
   auto result = mc.Count(int_bound, str_bound);
-  std::stringstream ss;
-  ss << result;
-  jstring result_string = env->NewStringUTF(ss.str().c_str());
-  return newBigInteger(env, result_string);
+  return newBigInteger(env, result);
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    getModelCounterHandle
+ * Signature: ()J
+ */
+JNIEXPORT jlong JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_getModelCounterHandle
+  (JNIEnv *env, jobject obj) {
+
+  Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
+  auto mc = new Vlab::Solver::ModelCounter(abc_driver->GetModelCounter());
+  return reinterpret_cast<jlong>(mc);
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    getModelCounterHandleForVariable
+ * Signature: (Ljava/lang/String;)J
+ */
+JNIEXPORT jlong JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_getModelCounterHandleForVariable
+  (JNIEnv *env, jobject obj, jstring var_name) {
+
+  Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
+  const char* var_name_arr = env->GetStringUTFChars(var_name, JNI_FALSE);
+  std::string var_name_str {var_name_arr};
+  env->ReleaseStringUTFChars(var_name, var_name_arr);
+  auto mc = new Vlab::Solver::ModelCounter(abc_driver->GetModelCounterForVariable(var_name_str));
+  return reinterpret_cast<jlong>(mc);
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    loadModelCounterHandle
+ * Signature: ([B)J
+ */
+JNIEXPORT jlong JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_loadModelCounterHandle
+  (JNIEnv *env, jclass cls, jbyteArray model_counter) {
+
+  auto mc = new Vlab::Solver::ModelCounter();
+  load_model_counter(env, *mc, model_counter);
+  return reinterpret_cast<jlong>(mc);
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    disposeModelCounterHandle
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_disposeModelCounterHandle
+  (JNIEnv *env, jclass cls, jlong handle) {
+
+  if (handle > 0) {
+    delete reinterpret_cast<Vlab::Solver::ModelCounter*>(handle);
+  }
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    countBatch
+ * Signature: (Ljava/nio/ByteBuffer;Ljava/nio/ByteBuffer;I)[Ljava/math/BigInteger;
+ *
+ * handles: one model counter handle (int64) per query, non-positive handles (unsat or unknown) count 0
+ * bounds : integer bound and string bound (int64, int64) per query, a negative bound excludes that part from the count
+ * Both buffers are read in native byte order.
+ */
+JNIEXPORT jobjectArray JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countBatch
+  (JNIEnv *env, jclass cls, jobject handles, jobject bounds, jint num_of_queries) {
+
+  const jlong num_of_bytes = static_cast<jlong>(num_of_queries) * static_cast<jlong>(sizeof(int64_t));
+  auto handle_arr = reinterpret_cast<const int64_t*>(getDirectBuffer(env, handles, num_of_bytes));
+  if (handle_arr == nullptr) {
+    return nullptr;
+  }
+  auto bound_arr = reinterpret_cast<const int64_t*>(getDirectBuffer(env, bounds, 2 * num_of_bytes));
+  if (bound_arr == nullptr) {
+    return nullptr;
+  }
+
+  jobjectArray results = env->NewObjectArray(num_of_queries, big_integer_class, nullptr);
+  for (jint i = 0; i < num_of_queries; ++i) {
+    auto mc = (handle_arr[i] > 0) ? reinterpret_cast<Vlab::Solver::ModelCounter*>(handle_arr[i]) : nullptr;
+    const int64_t int_bound = bound_arr[2 * i];
+    const int64_t str_bound = bound_arr[2 * i + 1];
+    Vlab::Theory::BigInteger result = 0;
+    if (mc != nullptr) {
+      if (int_bound >= 0 and str_bound >= 0) {
+        result = mc->Count(int_bound, str_bound);
+      } else if (int_bound >= 0) {
+        result = mc->CountInts(int_bound);
+      } else if (str_bound >= 0) {
+        result = mc->CountStrs(str_bound);
+      }
+    }
+    jobject big_integer = newBigInteger(env, result);
+    env->SetObjectArrayElement(results, i, big_integer);
+    env->DeleteLocalRef(big_integer);
+  }
+  return results;
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    solveBatch
+ * Signature: (Ljava/nio/ByteBuffer;Ljava/nio/ByteBuffer;I)[J
+ *
+ * constraints: concatenated constraints
+ * lengths    : byte length (int32) of each constraint in native byte order
+ * Returns a model counter handle per constraint, 0 for unsatisfiable constraints and -1 for constraints
+ * that stopped at a limit (unknown).
+ */
+JNIEXPORT jlongArray JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_solveBatch
+  (JNIEnv *env, jobject obj, jobject constraints, jobject lengths, jint num_of_constraints) {
+
+  auto length_arr = reinterpret_cast<const int32_t*>(getDirectBuffer(
+      env, lengths, static_cast<jlong>(num_of_constraints) * static_cast<jlong>(sizeof(int32_t))));
+  if (length_arr == nullptr) {
+    return nullptr;
+  }
+  jlong total_length = 0;
+  for (jint i = 0; i < num_of_constraints; ++i) {
+    if (length_arr[i] < 0) {
+      env->ThrowNew(illegal_argument_class, "negative constraint length");
+      return nullptr;
+    }
+    total_length += length_arr[i];
+  }
+  auto constraint_arr = reinterpret_cast<const char*>(getDirectBuffer(env, constraints, total_length));
+  if (constraint_arr == nullptr) {
+    return nullptr;
+  }
+
+  Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
+  std::vector<jlong> handles (num_of_constraints, 0);
+  for (jint i = 0; i < num_of_constraints; ++i) {
+    if (solve(env, abc_driver, constraint_arr, length_arr[i])) {
+      handles[i] = reinterpret_cast<jlong>(new Vlab::Solver::ModelCounter(abc_driver->GetModelCounter()));
+    } else if (env->ExceptionCheck()) {
+      for (jlong handle : handles) {
+        if (handle > 0) {
+          delete reinterpret_cast<Vlab::Solver::ModelCounter*>(handle);
+        }
+      }
+      return nullptr;
+    } else if (abc_driver->is_unknown()) {
+      handles[i] = -1;
+    }
+    constraint_arr += length_arr[i];
+  }
+
+  jlongArray results = env->NewLongArray(num_of_constraints);
+  env->SetLongArrayRegion(results, 0, num_of_constraints, handles.data());
+  return results;
 }
 
 /*
@@ -351,21 +663,8 @@ JNIEXPORT void JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_printResultAutomaton__L
  */
 JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_getSatisfyingExamples (JNIEnv *env, jobject obj) {
   Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
-  jclass hashMapClass = env->FindClass("java/util/HashMap");
-  jmethodID hashMapCtor = env->GetMethodID(hashMapClass, "<init>", "()V");
-  jobject map = env->NewObject(hashMapClass, hashMapCtor);
-
   std::map<std::string, std::string> results = abc_driver->getSatisfyingExamples();
-
-  jmethodID hasMapPut = env->GetMethodID(hashMapClass, "put", "(Ljava/lang/Object;Ljava/lang/Object;)Ljava/lang/Object;");
-
-  for (auto var_entry : results) {
-    jstring var_name = env->NewStringUTF(var_entry.first.c_str());
-    jstring var_value = env->NewStringUTF(var_entry.second.c_str());
-    env->CallObjectMethod(map, hasMapPut, var_name, var_value);
-  }
-
-  return map;
+  return newHashMap(env, results);
 }
 
 /*
@@ -375,21 +674,8 @@ JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_getSatisfyingExample
  */
 JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_getSatisfyingExamplesRandom (JNIEnv *env, jobject obj) {
   Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
-  jclass hashMapClass = env->FindClass("java/util/HashMap");
-  jmethodID hashMapCtor = env->GetMethodID(hashMapClass, "<init>", "()V");
-  jobject map = env->NewObject(hashMapClass, hashMapCtor);
-
   std::map<std::string, std::string> results = abc_driver->getSatisfyingExamplesRandom();
-
-  jmethodID hasMapPut = env->GetMethodID(hashMapClass, "put", "(Ljava/lang/Object;Ljava/lang/Object;)Ljava/lang/Object;");
-
-  for (auto var_entry : results) {
-    jstring var_name = env->NewStringUTF(var_entry.first.c_str());
-    jstring var_value = env->NewStringUTF(var_entry.second.c_str());
-    env->CallObjectMethod(map, hasMapPut, var_name, var_value);
-  }
-
-  return map;
+  return newHashMap(env, results);
 }
 
 /*
@@ -399,21 +685,8 @@ JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_getSatisfyingExample
  */
 JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_getSatisfyingExamplesRandomBounded (JNIEnv *env, jobject obj, jint bound) {
   Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
-  jclass hashMapClass = env->FindClass("java/util/HashMap");
-  jmethodID hashMapCtor = env->GetMethodID(hashMapClass, "<init>", "()V");
-  jobject map = env->NewObject(hashMapClass, hashMapCtor);
-
   std::map<std::string, std::string> results = abc_driver->getSatisfyingExamplesRandomBounded((int)bound);
-
-  jmethodID hasMapPut = env->GetMethodID(hashMapClass, "put", "(Ljava/lang/Object;Ljava/lang/Object;)Ljava/lang/Object;");
-
-  for (auto var_entry : results) {
-    jstring var_name = env->NewStringUTF(var_entry.first.c_str());
-    jstring var_value = env->NewStringUTF(var_entry.second.c_str());
-    env->CallObjectMethod(map, hasMapPut, var_name, var_value);
-  }
-
-  return map;
+  return newHashMap(env, results);
 }
 
 /*
@@ -438,3 +711,21 @@ JNIEXPORT void JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_dispose (JNIEnv *env, j
   setHandle(env, obj, abc_driver);
   delete tmp;
 }
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    getMetrics
+ * Signature: ()Ljava/util/Map;
+ */
+JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_getMetrics (JNIEnv *env, jclass cls) {
+  return newHashMap(env, Vlab::Driver::GetMetrics());
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    getMetricsText
+ * Signature: ()Ljava/lang/String;
+ */
+JNIEXPORT jstring JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_getMetricsText (JNIEnv *env, jclass cls) {
+  return env->NewStringUTF(Vlab::Driver::GetMetricsText().c_str());
+}
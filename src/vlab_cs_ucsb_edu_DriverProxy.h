@@ -44,9 +44,33 @@ JNIEXPORT void JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_setOption__ILjava_lang_
  * Method:    isSatisfiable
  * Signature: (Ljava/lang/String;)Z
  */
-JNIEXPORT jboolean JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_isSatisfiable
+JNIEXPORT jboolean JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_isSatisfiable__Ljava_lang_String_2
   (JNIEnv *, jobject, jstring);
 
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    isSatisfiable
+ * Signature: (Ljava/nio/ByteBuffer;I)Z
+ */
+JNIEXPORT jboolean JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_isSatisfiable__Ljava_nio_ByteBuffer_2I
+  (JNIEnv *, jobject, jobject, jint);
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    isUnknown
+ * Signature: ()Z
+ */
+JNIEXPORT jboolean JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_isUnknown
+  (JNIEnv *, jobject);
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    isExact
+ * Signature: ()Z
+ */
+JNIEXPORT jboolean JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_isExact
+  (JNIEnv *, jobject);
+
 /*
  * Class:     vlab_cs_ucsb_edu_DriverProxy
  * Method:    countVariable
@@ -127,6 +151,54 @@ JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countStrs__J_3B
 JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_count__JJ_3B
   (JNIEnv *, jobject, jlong, jlong, jbyteArray);
 
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    getModelCounterHandle
+ * Signature: ()J
+ */
+JNIEXPORT jlong JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_getModelCounterHandle
+  (JNIEnv *, jobject);
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    getModelCounterHandleForVariable
+ * Signature: (Ljava/lang/String;)J
+ */
+JNIEXPORT jlong JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_getModelCounterHandleForVariable
+  (JNIEnv *, jobject, jstring);
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    loadModelCounterHandle
+ * Signature: ([B)J
+ */
+JNIEXPORT jlong JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_loadModelCounterHandle
+  (JNIEnv *, jclass, jbyteArray);
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    disposeModelCounterHandle
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_disposeModelCounterHandle
+  (JNIEnv *, jclass, jlong);
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    countBatch
+ * Signature: (Ljava/nio/ByteBuffer;Ljava/nio/ByteBuffer;I)[Ljava/math/BigInteger;
+ */
+JNIEXPORT jobjectArray JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countBatch
+  (JNIEnv *, jclass, jobject, jobject, jint);
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    solveBatch
+ * Signature: (Ljava/nio/ByteBuffer;Ljava/nio/ByteBuffer;I)[J
+ */
+JNIEXPORT jlongArray JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_solveBatch
+  (JNIEnv *, jobject, jobject, jobject, jint);
+
 /*
  * Class:     vlab_cs_ucsb_edu_DriverProxy
  * Method:    printResultAutomaton
@@ -183,6 +255,22 @@ JNIEXPORT void JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_reset
 JNIEXPORT void JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_dispose
   (JNIEnv *, jobject);
 
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    getMetrics
+ * Signature: ()Ljava/util/Map;
+ */
+JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_getMetrics
+  (JNIEnv *, jclass);
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    getMetricsText
+ * Signature: ()Ljava/lang/String;
+ */
+JNIEXPORT jstring JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_getMetricsText
+  (JNIEnv *, jclass);
+
 #ifdef __cplusplus
 }
 #endif
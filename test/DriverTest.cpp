@@ -0,0 +1,533 @@
+/*
+ * DriverTest.cpp
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "DriverTest.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <sstream>
+#include <vector>
+
+#include <unistd.h>
+
+namespace Vlab {
+namespace Test {
+
+class PublicDriver : public Driver {
+ public:
+  using Driver::GetCache;
+  using Driver::cached_variables_;
+  using Driver::component_keys_;
+  using Driver::is_solved_from_cache_;
+  using Driver::is_satisfiability_only_;
+};
+
+/**
+ * Collects the messages logged while it is installed
+ */
+class MessageSink : public google::LogSink {
+ public:
+  MessageSink() {
+    google::AddLogSink(this);
+  }
+  ~MessageSink() {
+    google::RemoveLogSink(this);
+  }
+  void send(google::LogSeverity severity, const char* full_filename, const char* base_filename, int line,
+            const struct ::tm* tm_time, const char* message, size_t message_len) override {
+    messages_.push_back(std::string(message, message_len));
+  }
+  bool HasMessageStartingWith(const std::string prefix) const {
+    return std::any_of(messages_.begin(), messages_.end(), [&prefix](const std::string& message) {
+      return message.compare(0, prefix.size(), prefix) == 0;
+    });
+  }
+ private:
+  std::vector<std::string> messages_;
+};
+
+using namespace ::testing;
+
+void DriverTest::SetUp() {
+  cache_file_ = std::string(P_tmpdir) + "/abc_driver_test_" + std::to_string(getpid()) + ".cache";
+  std::remove(cache_file_.c_str());
+  std::remove((cache_file_ + ".lock").c_str());
+}
+
+void DriverTest::TearDown() {
+  Option::Solver::CACHE_FILE = "";
+  Option::Solver::ENABLE_ARITHMETIC_QUANTIFIER_SCHEDULING = false;
+  Option::Solver::ENABLE_ALPHABET_COMPRESSION = false;
+  Option::Theory::CHARACTER_WIDTH = Theory::StringEncoding::DEFAULT_CHARACTER_WIDTH;
+  Option::Theory::INTEGER_WIDTH = 64;
+  Option::Solver::STATE_LIMIT = 0;
+  Option::Solver::APPROXIMATION_STATE_LIMIT = 0;
+  std::remove(cache_file_.c_str());
+  std::remove((cache_file_ + ".lock").c_str());
+}
+
+void DriverTest::Solve(Driver& driver, const std::string script) {
+  std::stringstream in(script);
+  ASSERT_EQ(0, driver.Parse(&in));
+  driver.InitializeSolver();
+  driver.Solve();
+}
+
+void DriverTest::SolveSatisfiability(Driver& driver, const std::string script) {
+  std::stringstream in(script);
+  ASSERT_EQ(0, driver.Parse(&in));
+  driver.InitializeSolver();
+  driver.SolveSatisfiability();
+}
+
+TEST_F(DriverTest, CacheKeyIgnoresVariableNamesAndAssertionOrder) {
+  Option::Solver::CACHE_FILE = cache_file_;
+  PublicDriver driver_1, driver_2;
+  Solve(driver_1, "(declare-fun x () String)(declare-fun y () String)"
+                  "(assert (str.in.re x (re.* (str.to.re \"a\"))))"
+                  "(assert (= (str.len x) (str.len y)))");
+  Solve(driver_2, "(declare-fun b () String)(declare-fun a () String)"
+                  "(assert (= (str.len b) (str.len a)))"
+                  "(assert (str.in.re b (re.* (str.to.re \"a\"))))");
+  ASSERT_EQ(1, driver_1.component_keys_.size());
+  ASSERT_EQ(1, driver_2.component_keys_.size());
+  EXPECT_EQ(driver_1.component_keys_.begin()->second, driver_2.component_keys_.begin()->second);
+  EXPECT_FALSE(driver_1.is_solved_from_cache_);
+  EXPECT_TRUE(driver_2.is_solved_from_cache_);
+  EXPECT_EQ(driver_1.CountVariable("y", 3), driver_2.CountVariable("a", 3));
+}
+
+TEST_F(DriverTest, CacheKeyKeepsSubstitutedConstants) {
+  Option::Solver::CACHE_FILE = cache_file_;
+  PublicDriver driver_1, driver_2;
+  Solve(driver_1, "(declare-fun x () String)(assert (= x \"ab\"))");
+  Solve(driver_2, "(declare-fun x () String)(assert (= x \"abc\"))");
+  EXPECT_FALSE(driver_2.is_solved_from_cache_);
+  EXPECT_TRUE(driver_2.cached_variables_.empty());
+  EXPECT_EQ(1, driver_1.CountVariable("x", 2));
+  EXPECT_EQ(0, driver_2.CountVariable("x", 2));
+}
+
+TEST_F(DriverTest, ComponentKeysAreSharedAcrossScripts) {
+  Option::Solver::CACHE_FILE = cache_file_;
+  PublicDriver driver_1, driver_2;
+  Solve(driver_1, "(declare-fun x () String)(declare-fun y () String)"
+                  "(assert (str.in.re x (re.* (str.to.re \"ab\"))))"
+                  "(assert (str.in.re y (re.+ (str.to.re \"c\"))))");
+  Solve(driver_2, "(declare-fun a () String)(declare-fun b () String)"
+                  "(assert (= (str.len a) 3))"
+                  "(assert (str.in.re b (re.* (str.to.re \"ab\"))))"
+                  "(assert (str.in.re a (re.* (str.to.re \"e\"))))");
+  ASSERT_EQ(2, driver_1.component_keys_.size());
+  ASSERT_EQ(2, driver_2.component_keys_.size());
+
+  std::set<std::string> keys_1, keys_2, shared_keys;
+  for (auto& entry : driver_1.component_keys_) {
+    keys_1.insert(entry.second);
+  }
+  for (auto& entry : driver_2.component_keys_) {
+    keys_2.insert(entry.second);
+  }
+  std::set_intersection(keys_1.begin(), keys_1.end(), keys_2.begin(), keys_2.end(),
+                        std::inserter(shared_keys, shared_keys.begin()));
+  // only the component of x and b is the same
+  EXPECT_EQ(1, shared_keys.size());
+}
+
+TEST_F(DriverTest, CachedComponentsKeepCounts) {
+  Option::Solver::CACHE_FILE = cache_file_;
+  const std::string script = "(declare-fun a () String)(declare-fun b () String)"
+                             "(assert (= (str.len a) 3))"
+                             "(assert (str.in.re b (re.* (str.to.re \"ab\"))))"
+                             "(assert (str.in.re a (re.* (str.to.re \"e\"))))";
+  PublicDriver driver_1, driver_2, driver_3;
+  Solve(driver_1, "(declare-fun x () String)(declare-fun y () String)"
+                  "(assert (str.in.re x (re.* (str.to.re \"ab\"))))"
+                  "(assert (str.in.re y (re.+ (str.to.re \"c\"))))");
+  Solve(driver_2, script);
+  // the component of b is loaded, the component of a is solved
+  EXPECT_FALSE(driver_2.is_solved_from_cache_);
+  ASSERT_EQ(1, driver_2.cached_variables_.size());
+  EXPECT_EQ("b", (*driver_2.cached_variables_.begin())->getName());
+
+  Option::Solver::CACHE_FILE = "";
+  Solve(driver_3, script);
+  EXPECT_TRUE(driver_3.cached_variables_.empty());
+  EXPECT_EQ(driver_3.CountVariable("b", 6), driver_2.CountVariable("b", 6));
+  EXPECT_EQ(driver_3.CountVariable("a", 6), driver_2.CountVariable("a", 6));
+  EXPECT_EQ(driver_3.Count(6, 6), driver_2.Count(6, 6));
+  EXPECT_EQ(4, driver_2.CountVariable("b", 6));
+}
+
+TEST_F(DriverTest, CachedVariableCountersAreStoredOnce) {
+  Option::Solver::CACHE_FILE = cache_file_;
+  const std::string script = "(declare-fun x () String)(declare-fun y () String)"
+                             "(assert (str.in.re x (re.* (str.to.re \"ab\"))))"
+                             "(assert (str.in.re y (re.+ (str.to.re \"c\"))))";
+  PublicDriver driver_1;
+  Solve(driver_1, script);
+  auto x_count = driver_1.CountVariable("x", 4);
+  auto y_count = driver_1.CountVariable("y", 4);
+  // one entry for each component and one for each of the projected and tuple counters of a variable
+  EXPECT_EQ(6, driver_1.GetCache()->get_num_of_entries());
+
+  PublicDriver driver_2;
+  Solve(driver_2, script);
+  EXPECT_TRUE(driver_2.is_solved_from_cache_);
+  EXPECT_EQ(x_count, driver_2.CountVariable("x", 4));
+  EXPECT_EQ(y_count, driver_2.CountVariable("y", 4));
+  EXPECT_EQ(6, driver_2.GetCache()->get_num_of_entries());
+}
+
+TEST_F(DriverTest, WorklistPropagatesShrunkValues) {
+  // the length constraint shrinks y after the concatenation is solved, x is only refined by propagating back
+  const std::string script = "(declare-fun x () String)(declare-fun y () String)"
+                             "(assert (= y (str.++ x \"b\")))"
+                             "(assert (str.in.re x (re.+ (str.to.re \"a\"))))"
+                             "(assert (= (str.len y) 3))";
+  Driver driver;
+  Solve(driver, script);
+  ASSERT_TRUE(driver.is_sat());
+  EXPECT_EQ(1, driver.CountVariable("x", 5));
+  EXPECT_EQ(1, driver.CountVariable("y", 5));
+  EXPECT_GE(driver.get_num_of_propagations(), 1);
+
+  auto examples = driver.getSatisfyingExamples();
+  EXPECT_EQ("aa", examples["x"]);
+  EXPECT_EQ("aab", examples["y"]);
+}
+
+TEST_F(DriverTest, WorklistDetectsUnsatisfiability) {
+  const std::string script = "(declare-fun x () String)(declare-fun y () String)"
+                             "(assert (= y (str.++ x \"b\")))"
+                             "(assert (str.in.re x (re.+ (str.to.re \"aa\"))))"
+                             "(assert (= (str.len y) 4))";
+  Driver driver;
+  Solve(driver, script);
+  EXPECT_FALSE(driver.is_sat());
+}
+
+TEST_F(DriverTest, TransformationChainPreImage) {
+  // the chain is applied forward for the equality and backward to refine x
+  const std::string script = "(declare-fun x () String)"
+                             "(assert (str.in.re x (re.* (re.union (str.to.re \"a\") (str.to.re \"b\")))))"
+                             "(assert (= (toUpper (str.replace x \"a\" \"b\")) \"BB\"))";
+  Driver driver;
+  Solve(driver, script);
+  ASSERT_TRUE(driver.is_sat());
+  EXPECT_EQ(4, driver.CountVariable("x", 3));
+}
+
+TEST_F(DriverTest, StringToIntBounds) {
+  // leading zeros keep the value
+  Driver driver_1;
+  Solve(driver_1, "(declare-fun x () String)"
+                  "(assert (str.in.re x (re.+ (re.range \"0\" \"9\"))))"
+                  "(assert (< (str.to.int x) 3))");
+  ASSERT_TRUE(driver_1.is_sat());
+  EXPECT_EQ(6, driver_1.CountVariable("x", 2));
+
+  Driver driver_2;
+  Solve(driver_2, "(declare-fun x () String)(declare-fun i () Int)"
+                  "(assert (str.in.re x (re.+ (re.range \"0\" \"9\"))))"
+                  "(assert (= i (+ (str.to.int x) 1)))"
+                  "(assert (= i 43))");
+  ASSERT_TRUE(driver_2.is_sat());
+  EXPECT_EQ(2, driver_2.CountVariable("x", 3));
+  EXPECT_THAT(driver_2.getSatisfyingExamples()["x"], AnyOf(Eq("42"), Eq("042")));
+}
+
+TEST_F(DriverTest, StringToIntOfNonNumericStrings) {
+  Driver driver;
+  Solve(driver, "(declare-fun x () String)"
+                "(assert (str.in.re x (re.union (str.to.re \"a\") (str.to.re \"7\"))))"
+                "(assert (< (str.to.int x) 0))");
+  ASSERT_TRUE(driver.is_sat());
+  EXPECT_EQ(1, driver.CountVariable("x", 1));
+  EXPECT_EQ("a", driver.getSatisfyingExamples()["x"]);
+}
+
+TEST_F(DriverTest, StringToIntBeyondIntegerWidth) {
+  // values above 127 are a single interval, x keeps all the strings from "128" to "999"
+  Option::Theory::INTEGER_WIDTH = 8;
+  Driver driver;
+  Solve(driver, "(declare-fun x () String)"
+                "(assert (str.in.re x (re.++ (re.range \"0\" \"9\") (re.range \"0\" \"9\") (re.range \"0\" \"9\"))))"
+                "(assert (> (str.to.int x) 200))");
+  ASSERT_TRUE(driver.is_sat());
+  EXPECT_EQ(872, driver.CountVariable("x", 3));
+}
+
+TEST_F(DriverTest, StateLimitMakesSolvingUnknown) {
+  const std::string script = "(declare-fun x () String)"
+                             "(assert (str.in.re x (re.* (str.to.re \"abcdefgh\"))))"
+                             "(assert (str.in.re x (re.* (str.to.re \"abcdefghabcdefgh\"))))";
+  Option::Solver::STATE_LIMIT = 4;
+  Driver driver_1;
+  Solve(driver_1, script);
+  EXPECT_TRUE(driver_1.is_unknown());
+  EXPECT_EQ(0, driver_1.CountVariable("x", 16));
+  EXPECT_TRUE(driver_1.is_unknown());
+
+  Option::Solver::STATE_LIMIT = 0;
+  Driver driver_2;
+  Solve(driver_2, script);
+  EXPECT_FALSE(driver_2.is_unknown());
+  ASSERT_TRUE(driver_2.is_sat());
+  EXPECT_EQ(2, driver_2.CountVariable("x", 16));
+}
+
+TEST_F(DriverTest, SatisfiabilityOnlyStopsAtFirstWitness) {
+  // y occurs only in the disjunction, the full solve still sees both disjuncts when y is counted
+  const std::string script = "(declare-fun x () String)"
+                             "(declare-fun y () String)"
+                             "(assert (str.in.re x (re.* (str.to.re \"ab\"))))"
+                             "(assert (or (= y \"a\") (= y \"b\")))";
+  PublicDriver driver;
+  SolveSatisfiability(driver, script);
+  EXPECT_FALSE(driver.is_unknown());
+  ASSERT_TRUE(driver.is_sat());
+  EXPECT_TRUE(driver.is_satisfiability_only_);
+
+  MessageSink sink;
+  EXPECT_EQ(2, driver.CountVariable("y", 1));
+  EXPECT_FALSE(driver.is_satisfiability_only_);
+  EXPECT_TRUE(sink.HasMessageStartingWith("report satisfiability-only time: "));
+  EXPECT_EQ(2, driver.CountVariable("x", 2));
+}
+
+TEST_F(DriverTest, SatisfiabilityOnlyDecidesUnsat) {
+  Driver driver_1;
+  SolveSatisfiability(driver_1, "(declare-fun x () String)"
+                                "(assert (str.in.re x (re.* (str.to.re \"ab\"))))"
+                                "(assert (= (str.len x) 3))");
+  EXPECT_FALSE(driver_1.is_unknown());
+  EXPECT_FALSE(driver_1.is_sat());
+
+  // x occurs once, its constraint is only checked for emptiness
+  Driver driver_2;
+  SolveSatisfiability(driver_2, "(declare-fun x () String)"
+                                "(assert (str.in.re x (re.inter (str.to.re \"a\") (str.to.re \"b\"))))");
+  EXPECT_FALSE(driver_2.is_unknown());
+  EXPECT_FALSE(driver_2.is_sat());
+}
+
+TEST_F(DriverTest, SatisfiabilityOnlyReportsUnknownAtLimit) {
+  Option::Solver::STATE_LIMIT = 4;
+  Driver driver;
+  SolveSatisfiability(driver, "(declare-fun x () String)"
+                              "(assert (str.in.re x (re.* (str.to.re \"abcdefgh\"))))"
+                              "(assert (str.in.re x (re.* (str.to.re \"abcdefghabcdefgh\"))))");
+  EXPECT_TRUE(driver.is_unknown());
+  EXPECT_FALSE(driver.is_sat());
+}
+
+TEST_F(DriverTest, WideningMakesCountsUpperBounds) {
+  const std::string script = "(declare-fun x () String)"
+                             "(assert (str.in.re x (re.* (str.to.re \"abcd\"))))";
+  Driver driver_1;
+  Solve(driver_1, script);
+  ASSERT_TRUE(driver_1.is_sat());
+  EXPECT_TRUE(driver_1.is_exact());
+  auto exact_bounds = driver_1.CountVariableWithBounds("x", 4);
+  EXPECT_TRUE(exact_bounds.is_exact);
+  EXPECT_EQ(2, exact_bounds.lower);
+  EXPECT_EQ(2, exact_bounds.upper);
+
+  // the value is widened to the strings with lengths 0, 4, 8, ...
+  Option::Solver::APPROXIMATION_STATE_LIMIT = 2;
+  Driver driver_2;
+  Solve(driver_2, script);
+  ASSERT_TRUE(driver_2.is_sat());
+  EXPECT_FALSE(driver_2.is_exact());
+  auto bounds = driver_2.CountVariableWithBounds("x", 4);
+  EXPECT_FALSE(bounds.is_exact);
+  EXPECT_EQ(0, bounds.lower);
+  EXPECT_GT(bounds.upper, exact_bounds.upper);
+}
+
+TEST_F(DriverTest, EmptyApproximationIsExact) {
+  Option::Solver::APPROXIMATION_STATE_LIMIT = 2;
+  Driver driver;
+  Solve(driver, "(declare-fun x () String)"
+                "(assert (str.in.re x (re.* (str.to.re \"abcd\"))))"
+                "(assert (= (str.len x) 3))");
+  EXPECT_FALSE(driver.is_sat());
+  auto bounds = driver.CountVariableWithBounds("x", 4);
+  EXPECT_TRUE(bounds.is_exact);
+  EXPECT_EQ(0, bounds.upper);
+}
+
+TEST_F(DriverTest, TraceIsWrittenByTheDriverThatStartedIt) {
+  const std::string trace_file = cache_file_ + ".trace.json";
+  std::remove(trace_file.c_str());
+  {
+    Driver tracing_driver;
+    tracing_driver.set_option(Option::Name::TRACE_FILE, trace_file);
+    Solve(tracing_driver, "(declare-fun x () String)(assert (str.in.re x (re.* (str.to.re \"ab\"))))");
+    {
+      Driver other_driver;
+      Solve(other_driver, "(declare-fun y () String)(assert (= y \"a\"))");
+    }
+    EXPECT_TRUE(Util::Trace::is_recording());
+    EXPECT_FALSE(std::ifstream(trace_file).good());
+  }
+  EXPECT_FALSE(Util::Trace::is_recording());
+  std::ifstream trace(trace_file);
+  ASSERT_TRUE(trace.good());
+  std::stringstream events;
+  events << trace.rdbuf();
+  EXPECT_THAT(events.str(), HasSubstr("\"traceEvents\""));
+  std::remove(trace_file.c_str());
+}
+
+TEST_F(DriverTest, QuantifierSchedulingKeepsDeclaredVariables) {
+  const std::string script = "(declare-fun x () Int)(declare-fun y () Int)(declare-fun z () Int)"
+                             "(assert (<= 0 x))(assert (< x 4))(assert (= y (+ x 1)))(assert (= z (+ y 2)))";
+  Driver driver_1;
+  Solve(driver_1, script);
+  ASSERT_TRUE(driver_1.is_sat());
+
+  Option::Solver::ENABLE_ARITHMETIC_QUANTIFIER_SCHEDULING = true;
+  Driver driver_2;
+  Solve(driver_2, script);
+  ASSERT_TRUE(driver_2.is_sat());
+
+  for (auto var_name : { "x", "y", "z" }) {
+    SCOPED_TRACE(var_name);
+    EXPECT_EQ(driver_1.CountVariable(var_name, 4), driver_2.CountVariable(var_name, 4));
+  }
+  EXPECT_EQ(driver_1.CountInts(4), driver_2.CountInts(4));
+
+  auto examples = driver_2.getSatisfyingExamples();
+  ASSERT_EQ(1, examples.count("x"));
+  ASSERT_EQ(1, examples.count("y"));
+  ASSERT_EQ(1, examples.count("z"));
+  const int x = std::stoi(examples["x"]), y = std::stoi(examples["y"]), z = std::stoi(examples["z"]);
+  EXPECT_TRUE(0 <= x and x < 4);
+  EXPECT_EQ(x + 1, y);
+  EXPECT_EQ(y + 2, z);
+}
+
+TEST_F(DriverTest, QuantifierSchedulingProjectsInternalVariables) {
+  const std::string script = "(declare-fun x () Int)(declare-fun z () Int)"
+                             "(assert (<= 0 x))(assert (< x 8))(assert (= z (ite (< x 3) 1 2)))";
+  Driver driver_1;
+  Solve(driver_1, script);
+
+  Option::Solver::ENABLE_ARITHMETIC_QUANTIFIER_SCHEDULING = true;
+  Driver driver_2;
+  Solve(driver_2, script);
+
+  EXPECT_EQ(driver_1.is_sat(), driver_2.is_sat());
+  EXPECT_EQ(driver_1.CountVariable("x", 4), driver_2.CountVariable("x", 4));
+  EXPECT_EQ(driver_1.CountVariable("z", 4), driver_2.CountVariable("z", 4));
+}
+
+TEST_F(DriverTest, AlphabetCompressionKeepsCounts) {
+  // the length equality is solved with a multitrack automaton, it does not relate characters
+  const std::string script = "(declare-fun x () String)(declare-fun y () String)"
+                             "(assert (str.in.re x (re.* (re.range \"a\" \"c\"))))"
+                             "(assert (not (str.contains y \"a\")))"
+                             "(assert (= (str.len x) (str.len y)))";
+  Driver driver_1;
+  Solve(driver_1, script);
+  ASSERT_TRUE(driver_1.is_sat());
+  const auto x_count = driver_1.CountVariable("x", 3);
+  const auto y_count = driver_1.CountVariable("y", 3);
+
+  Option::Solver::ENABLE_ALPHABET_COMPRESSION = true;
+  Driver driver_2;
+  Solve(driver_2, script);
+  ASSERT_TRUE(driver_2.is_sat());
+  const auto& encoding = Theory::StringAutomaton::GetEncoding();
+  EXPECT_FALSE(encoding.is_identity());
+  EXPECT_LT(encoding.get_number_of_bits(), 8);
+  EXPECT_EQ(x_count, driver_2.CountVariable("x", 3));
+  EXPECT_EQ(y_count, driver_2.CountVariable("y", 3));
+}
+
+TEST_F(DriverTest, DriversKeepTheirStringEncodings) {
+  const std::string script = "(declare-fun x () String)(declare-fun y () String)"
+                             "(assert (str.in.re x (re.* (re.range \"a\" \"c\"))))"
+                             "(assert (not (str.contains y \"a\")))"
+                             "(assert (= (str.len x) (str.len y)))";
+  Option::Solver::ENABLE_ALPHABET_COMPRESSION = true;
+  Driver compressed_driver;
+  Solve(compressed_driver, script);
+  ASSERT_TRUE(compressed_driver.is_sat());
+
+  Option::Solver::ENABLE_ALPHABET_COMPRESSION = false;
+  Driver driver;
+  Solve(driver, script);
+  ASSERT_TRUE(driver.is_sat());
+  EXPECT_TRUE(Theory::StringAutomaton::GetEncoding().is_identity());
+
+  // each driver counts with its own encoding, whichever driver was initialized last
+  const auto x_count = driver.CountVariable("x", 3);
+  EXPECT_EQ(x_count, compressed_driver.CountVariable("x", 3));
+  EXPECT_FALSE(Theory::StringAutomaton::GetEncoding().is_identity());
+  const auto y_count = compressed_driver.CountVariable("y", 3);
+  EXPECT_EQ(y_count, driver.CountVariable("y", 3));
+  EXPECT_TRUE(Theory::StringAutomaton::GetEncoding().is_identity());
+}
+
+TEST_F(DriverTest, AlphabetCompressionSkipsCharacterRelations) {
+  const std::string script = "(declare-fun x () String)(declare-fun y () String)"
+                             "(assert (= x (str.++ y \"a\")))"
+                             "(assert (str.in.re y (re.* (re.range \"a\" \"c\"))))";
+  Driver driver_1;
+  Solve(driver_1, script);
+  const auto x_count = driver_1.CountVariable("x", 3);
+
+  Option::Solver::ENABLE_ALPHABET_COMPRESSION = true;
+  Driver driver_2;
+  Solve(driver_2, script);
+  EXPECT_TRUE(Theory::StringAutomaton::GetEncoding().is_identity());
+  EXPECT_EQ(x_count, driver_2.CountVariable("x", 3));
+}
+
+TEST_F(DriverTest, RelationalEqualityAndPrefix) {
+  Driver driver_1;
+  Solve(driver_1, "(declare-fun x () String)(declare-fun y () String)"
+                  "(assert (str.in.re x (re.* (re.union (str.to.re \"a\") (str.to.re \"b\")))))"
+                  "(assert (= x y))");
+  ASSERT_TRUE(driver_1.is_sat());
+  EXPECT_EQ(7, driver_1.CountVariable("y", 2));
+
+  Driver driver_2;
+  Solve(driver_2, "(declare-fun x () String)(declare-fun y () String)"
+                  "(assert (str.in.re x (re.union (str.to.re \"ab\") (str.to.re \"ba\"))))"
+                  "(assert (str.prefixof y x))");
+  ASSERT_TRUE(driver_2.is_sat());
+  EXPECT_EQ(5, driver_2.CountVariable("y", 2));
+
+  Driver driver_3;
+  Solve(driver_3, "(declare-fun x () String)(declare-fun y () String)"
+                  "(assert (str.in.re x (re.union (str.to.re \"ab\") (str.to.re \"ba\"))))"
+                  "(assert (str.in.re y (re.* (re.union (str.to.re \"a\") (str.to.re \"b\")))))"
+                  "(assert (not (str.prefixof y x)))");
+  ASSERT_TRUE(driver_3.is_sat());
+  EXPECT_EQ(6, driver_3.CountVariable("y", 2));
+}
+
+TEST_F(DriverTest, RelationalEqualityWithWideCharacters) {
+  Option::Theory::CHARACTER_WIDTH = 16;
+  Driver driver;
+  Solve(driver, "(declare-fun x () String)(declare-fun y () String)"
+                "(assert (str.in.re x (re.* (re.range \"a\" \"c\"))))"
+                "(assert (= x y))");
+  ASSERT_TRUE(driver.is_sat());
+  EXPECT_EQ(13, driver.CountVariable("y", 2));
+}
+
+} /* namespace Test */
+} /* namespace Vlab */
@@ -0,0 +1,45 @@
+/*
+ * DriverTest.h
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef TEST_DRIVERTEST_H_
+#define TEST_DRIVERTEST_H_
+
+#include <string>
+
+#include <glog/logging.h>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "Driver.h"
+#include "theory/StringAutomaton.h"
+#include "theory/options/Theory.h"
+
+namespace Vlab {
+namespace Test {
+
+class DriverTest : public ::testing::Test {
+protected:
+  virtual void SetUp();
+  virtual void TearDown();
+
+  /**
+   * Parses, initializes and solves a script with the options set by the test
+   */
+  void Solve(Driver& driver, const std::string script);
+  /**
+   * Parses, initializes and decides satisfiability of a script only
+   */
+  void SolveSatisfiability(Driver& driver, const std::string script);
+
+  std::string cache_file_;
+};
+
+} /* namespace Test */
+} /* namespace Vlab */
+
+#endif /* TEST_DRIVERTEST_H_ */
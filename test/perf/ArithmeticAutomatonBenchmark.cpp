@@ -0,0 +1,86 @@
+/*
+ * ArithmeticAutomatonBenchmark.cpp
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ *
+ * Scaling benchmark for linear arithmetic automata construction. Builds
+ * x_1 + 2*x_2 + ... + n*x_n (= | <) n for growing n with symbolic transitions and with
+ * transition enumeration and prints the construction times in milliseconds.
+ *
+ * usage: arithbench [max number of variables (default 20)] [max number of variables to enumerate (default 16)]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <glog/logging.h>
+
+#include "theory/ArithmeticFormula.h"
+#include "theory/BinaryIntAutomaton.h"
+#include "theory/options/Theory.h"
+
+using namespace Vlab;
+
+static Theory::ArithmeticFormula_ptr MakeFormula(const int num_of_variables, Theory::ArithmeticFormula::Type type) {
+  auto formula = new Theory::ArithmeticFormula();
+  for (int i = 1; i <= num_of_variables; ++i) {
+    std::string name = (i < 10 ? "x0" : "x") + std::to_string(i);
+    formula->AddVariable(name, i);
+  }
+  formula->SetType(type);
+  formula->SetConstant(-num_of_variables);
+  return formula;
+}
+
+static double Measure(const int num_of_variables, Theory::ArithmeticFormula::Type type, const bool is_natural_number,
+                      const bool is_symbolic, int& num_of_states) {
+  Option::Theory::SYMBOLIC_ARITHMETIC_TRANSITIONS = is_symbolic;
+  auto formula = MakeFormula(num_of_variables, type);
+  auto start = std::chrono::steady_clock::now();
+  auto binary_auto = Theory::BinaryIntAutomaton::MakeAutomaton(formula, is_natural_number);
+  auto end = std::chrono::steady_clock::now();
+  num_of_states = binary_auto->getDFA()->ns;
+  delete binary_auto;
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(const int argc, const char **argv) {
+  google::InitGoogleLogging(argv[0]);
+  FLAGS_logtostderr = 1;
+
+  const int max_num_of_variables = (argc > 1) ? std::atoi(argv[1]) : 20;
+  const int max_num_of_enumerated_variables = (argc > 2) ? std::atoi(argv[2]) : 16;
+
+  const std::pair<Theory::ArithmeticFormula::Type, std::string> relations[] = {
+      { Theory::ArithmeticFormula::Type::EQ, "eq" },
+      { Theory::ArithmeticFormula::Type::LT, "lt" } };
+
+  std::cout << "relation  domain  n  states  symbolic(ms)  enumeration(ms)" << std::endl;
+  for (auto& relation : relations) {
+    for (bool is_natural_number : { false, true }) {
+      for (int n = 4; n <= max_num_of_variables; n += 2) {
+        int num_of_states = 0, num_of_enumerated_states = 0;
+        double symbolic_time = Measure(n, relation.first, is_natural_number, true, num_of_states);
+        std::cout << std::setw(8) << relation.second << std::setw(8) << (is_natural_number ? "nat" : "int")
+                  << std::setw(3) << n << std::setw(8) << num_of_states << std::setw(14) << std::fixed
+                  << std::setprecision(2) << symbolic_time;
+        if (n <= max_num_of_enumerated_variables) {
+          double enumeration_time = Measure(n, relation.first, is_natural_number, false, num_of_enumerated_states);
+          CHECK_EQ(num_of_states, num_of_enumerated_states);
+          std::cout << std::setw(17) << enumeration_time;
+        } else {
+          std::cout << std::setw(17) << "-";
+        }
+        std::cout << std::endl;
+      }
+    }
+  }
+
+  Option::Theory::SYMBOLIC_ARITHMETIC_TRANSITIONS = true;
+  return 0;
+}
@@ -0,0 +1,63 @@
+/*
+ * SatisfiabilityBenchmark.cpp
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ *
+ * Compares the satisfiability-only solve with the full solve. Solves each constraint file in both modes,
+ * checks that they agree and prints the times in milliseconds and the time saved.
+ *
+ * usage: satbench <constraint file>...
+ */
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <glog/logging.h>
+
+#include "Driver.h"
+
+using namespace Vlab;
+
+static double Solve(const std::string& file_name, const bool is_satisfiability_only, bool& is_sat) {
+  std::ifstream input(file_name);
+  CHECK(input.good()) << "cannot open file: " << file_name;
+  Driver driver;
+  driver.Parse(&input);
+  auto start = std::chrono::steady_clock::now();
+  driver.InitializeSolver();
+  if (is_satisfiability_only) {
+    driver.SolveSatisfiability();
+  } else {
+    driver.Solve();
+  }
+  is_sat = driver.is_sat();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(const int argc, const char **argv) {
+  google::InitGoogleLogging(argv[0]);
+  FLAGS_logtostderr = 1;
+
+  std::cout << "result  sat-only(ms)   full(ms)  saved(ms)  file" << std::endl;
+  double total_satisfiability_only_time = 0, total_full_time = 0;
+  for (int i = 1; i < argc; ++i) {
+    bool is_sat = false, is_full_sat = false;
+    double satisfiability_only_time = Solve(argv[i], true, is_sat);
+    double full_time = Solve(argv[i], false, is_full_sat);
+    CHECK_EQ(is_sat, is_full_sat) << "modes disagree on " << argv[i];
+    total_satisfiability_only_time += satisfiability_only_time;
+    total_full_time += full_time;
+    std::cout << std::setw(6) << (is_sat ? "sat" : "unsat") << std::setw(14) << std::fixed << std::setprecision(2)
+              << satisfiability_only_time << std::setw(11) << full_time << std::setw(11)
+              << (full_time - satisfiability_only_time) << "  " << argv[i] << std::endl;
+  }
+  std::cout << std::setw(6) << "total" << std::setw(14) << total_satisfiability_only_time << std::setw(11)
+            << total_full_time << std::setw(11) << (total_full_time - total_satisfiability_only_time) << std::endl;
+  return 0;
+}
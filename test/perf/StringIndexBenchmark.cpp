@@ -0,0 +1,89 @@
+/*
+ * StringIndexBenchmark.cpp
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ *
+ * Scaling benchmark for string operations with symbolic indices. Runs substring, charAt, indexOf and
+ * restrictAtIndexTo with index ranges 0..n for growing n with the direct product constructions and with the
+ * multi-track constructions and prints the times in milliseconds.
+ *
+ * usage: indexbench [max index (default 1000)] [subject regex (default (ab|cd)*e[a-z]*)]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "theory/IntAutomaton.h"
+#include "theory/StringAutomaton.h"
+#include "theory/options/Theory.h"
+
+using namespace Vlab;
+
+static double Measure(std::function<Theory::Automaton_ptr()> operation, const bool is_direct, int& num_of_states) {
+  Option::Theory::DIRECT_INDEX_CONSTRUCTIONS = is_direct;
+  auto start = std::chrono::steady_clock::now();
+  auto result_auto = operation();
+  auto end = std::chrono::steady_clock::now();
+  num_of_states = result_auto->getDFA()->ns;
+  delete result_auto;
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(const int argc, const char **argv) {
+  google::InitGoogleLogging(argv[0]);
+  FLAGS_logtostderr = 1;
+
+  const int max_index = (argc > 1) ? std::atoi(argv[1]) : 1000;
+  const std::string subject_regex = (argc > 2) ? argv[2] : "(ab|cd)*e[a-z]*";
+
+  auto subject_auto = Theory::StringAutomaton::MakeRegexAuto(subject_regex);
+  auto search_auto = Theory::StringAutomaton::MakeString("cde");
+  auto sub_string_auto = Theory::StringAutomaton::MakeRegexAuto("d[a-e]");
+
+  std::cout << "operation     n  states  direct(ms)  states  multitrack(ms)" << std::endl;
+  std::vector<int> sizes;
+  for (int n = 10; n < max_index; n *= 10) {
+    sizes.push_back(n);
+  }
+  sizes.push_back(max_index);
+
+  for (int n : sizes) {
+    auto range_auto = Theory::IntAutomaton::makeIntRange(0, n);
+    auto length_auto = Theory::IntAutomaton::makeIntRange(1, n);
+    const std::pair<std::string, std::function<Theory::Automaton_ptr()>> operations[] = {
+        { "substring", [&]() { return subject_auto->SubString(range_auto, length_auto); } },
+        { "charat", [&]() { return subject_auto->CharAt(range_auto); } },
+        { "indexof", [&]() { return subject_auto->IndexOf(search_auto, range_auto); } },
+        { "restrict", [&]() { return subject_auto->RestrictAtIndexTo(range_auto, sub_string_auto); } } };
+
+    for (auto& operation : operations) {
+      int num_of_states = 0, num_of_multitrack_states = 0;
+      double direct_time = Measure(operation.second, true, num_of_states);
+      double multitrack_time = Measure(operation.second, false, num_of_multitrack_states);
+      // indexof is computed per subject string by the direct construction, it can only be tighter
+      if (operation.first != "indexof") {
+        CHECK_EQ(num_of_states, num_of_multitrack_states);
+      }
+      std::cout << std::setw(9) << operation.first << std::setw(6) << n << std::setw(8) << num_of_states
+                << std::setw(12) << std::fixed << std::setprecision(2) << direct_time << std::setw(8)
+                << num_of_multitrack_states << std::setw(16) << multitrack_time << std::endl;
+    }
+    delete range_auto;
+    delete length_auto;
+  }
+
+  delete subject_auto;
+  delete search_auto;
+  delete sub_string_auto;
+  Option::Theory::DIRECT_INDEX_CONSTRUCTIONS = true;
+  return 0;
+}
@@ -0,0 +1,457 @@
+/*
+ * SuiteBenchmark.cpp
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ *
+ * Benchmark harness for constraint suites. Solves and counts every .smt2 file under the given files and
+ * directories, each file in its own process so that its peak memory is measured on its own and a crash
+ * only fails that file. Writes one tab separated row per file with the result, the count, the median,
+ * median absolute deviation and minimum of the wall times, the peak resident set size, the largest dfa
+ * and the mean time of each solver phase.
+ *
+ * With a baseline written by an earlier run, reports changed results and the files whose time, memory
+ * or dfa size regressed or improved. A time change is reported only when it exceeds both the relative
+ * threshold and the noise of the two runs. Exits with 1 if a result changed or anything regressed.
+ *
+ * usage: suitebench [-bs <str bound>] [-bi <int bound>] [--repetitions <n>] [--time-limit <ms>]
+ *                   [--threshold <percent>] [--output <file>] [--baseline <file>] <file or directory>...
+ */
+
+#include <dirent.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "Driver.h"
+#include "utils/Metrics.h"
+
+using namespace Vlab;
+
+using Metrics = Util::Metrics;
+
+// a time change within this many deviations of the noisier run is noise
+static const double NOISE_FACTOR = 3.0;
+// time changes below this are noise regardless of the deviations
+static const double MIN_TIME_CHANGE_MS = 1.0;
+// peak memory changes below this are noise
+static const long MIN_RSS_CHANGE_KB = 1024;
+
+struct Options {
+  unsigned long str_bound = 10;
+  unsigned long int_bound = 10;
+  int repetitions = 5;
+  int time_limit = 0;
+  double threshold = 0.1;
+  std::string output = "benchmark.tsv";
+  std::string baseline;
+  std::vector<std::string> paths;
+};
+
+struct Record {
+  std::string file;
+  std::string result;
+  std::string count;
+  int repetitions = 0;
+  double median_ms = 0;
+  double mad_ms = 0;
+  double min_ms = 0;
+  long peak_rss_kb = 0;
+  unsigned long max_dfa_states = 0;
+  std::vector<double> phase_ms;
+};
+
+static const int NUMBER_OF_PHASES = static_cast<int>(Metrics::Phase::NUMBER_OF_PHASES);
+
+static std::vector<std::string> GetColumns() {
+  std::vector<std::string> columns { "file", "result", "count", "repetitions", "median_ms", "mad_ms", "min_ms",
+      "peak_rss_kb", "max_dfa_states" };
+  for (int i = 0; i < NUMBER_OF_PHASES; ++i) {
+    columns.push_back(std::string(Metrics::get_name(static_cast<Metrics::Phase>(i))) + "_ms");
+  }
+  return columns;
+}
+
+static std::vector<std::string> Split(const std::string& line) {
+  std::vector<std::string> fields;
+  std::stringstream ss(line);
+  std::string field;
+  while (std::getline(ss, field, '\t')) {
+    fields.push_back(field);
+  }
+  return fields;
+}
+
+static std::string ToRow(const Record& record) {
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(3) << record.file << '\t' << record.result << '\t' << record.count << '\t'
+     << record.repetitions << '\t' << record.median_ms << '\t' << record.mad_ms << '\t' << record.min_ms << '\t'
+     << record.peak_rss_kb << '\t' << record.max_dfa_states;
+  for (double time : record.phase_ms) {
+    ss << '\t' << time;
+  }
+  return ss.str();
+}
+
+/**
+ * Reads a row by column name, columns that are missing keep their defaults
+ */
+static Record FromRow(const std::map<std::string, std::size_t>& column_index, const std::vector<std::string>& fields) {
+  auto get = [&](const std::string& column) -> std::string {
+    auto it = column_index.find(column);
+    return (it == column_index.end() or it->second >= fields.size()) ? "" : fields[it->second];
+  };
+  auto get_number = [&](const std::string& column) -> double {
+    std::string value = get(column);
+    return value.empty() ? 0 : std::stod(value);
+  };
+  Record record;
+  record.file = get("file");
+  record.result = get("result");
+  record.count = get("count");
+  record.repetitions = static_cast<int>(get_number("repetitions"));
+  record.median_ms = get_number("median_ms");
+  record.mad_ms = get_number("mad_ms");
+  record.min_ms = get_number("min_ms");
+  record.peak_rss_kb = static_cast<long>(get_number("peak_rss_kb"));
+  record.max_dfa_states = static_cast<unsigned long>(get_number("max_dfa_states"));
+  for (int i = 0; i < NUMBER_OF_PHASES; ++i) {
+    record.phase_ms.push_back(get_number(std::string(Metrics::get_name(static_cast<Metrics::Phase>(i))) + "_ms"));
+  }
+  return record;
+}
+
+static std::map<std::string, std::size_t> GetColumnIndex(const std::vector<std::string>& columns) {
+  std::map<std::string, std::size_t> column_index;
+  for (std::size_t i = 0; i < columns.size(); ++i) {
+    column_index[columns[i]] = i;
+  }
+  return column_index;
+}
+
+static double GetMedian(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  const std::size_t n = values.size();
+  return (n % 2 == 1) ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+}
+
+static void CollectFiles(const std::string& path, std::vector<std::string>& files) {
+  struct stat path_stat;
+  CHECK_EQ(0, stat(path.c_str(), &path_stat)) << "cannot find: " << path;
+  if (not S_ISDIR(path_stat.st_mode)) {
+    files.push_back(path);
+    return;
+  }
+  DIR* dir = opendir(path.c_str());
+  CHECK(dir != nullptr) << "cannot open directory: " << path;
+  std::vector<std::string> entries;
+  while (struct dirent* entry = readdir(dir)) {
+    std::string name = entry->d_name;
+    if (name != "." and name != "..") {
+      entries.push_back(name);
+    }
+  }
+  closedir(dir);
+  std::sort(entries.begin(), entries.end());
+  const std::string extension = ".smt2";
+  for (auto& name : entries) {
+    std::string entry_path = path + "/" + name;
+    struct stat entry_stat;
+    if (stat(entry_path.c_str(), &entry_stat) != 0) {
+      continue;
+    }
+    if (S_ISDIR(entry_stat.st_mode)) {
+      CollectFiles(entry_path, files);
+    } else if (name.size() > extension.size()
+        and name.compare(name.size() - extension.size(), extension.size(), extension) == 0) {
+      files.push_back(entry_path);
+    }
+  }
+}
+
+/**
+ * Solves and counts a file the given number of times with a new driver each time
+ */
+static Record Run(const std::string& file_name, const Options& options) {
+  Metrics::Reset();
+  Record record;
+  record.file = file_name;
+  record.repetitions = options.repetitions;
+  std::vector<double> times;
+  for (int i = 0; i < options.repetitions; ++i) {
+    std::ifstream input(file_name);
+    CHECK(input.good()) << "cannot open file: " << file_name;
+    auto start = std::chrono::steady_clock::now();
+    Driver driver;
+    if (options.time_limit > 0) {
+      driver.set_option(Option::Name::TIME_LIMIT, options.time_limit);
+    }
+    driver.Parse(&input);
+    driver.InitializeSolver();
+    driver.Solve();
+    std::stringstream count;
+    if (driver.is_unknown()) {
+      record.result = "unknown";
+    } else if (driver.is_sat()) {
+      record.result = "sat";
+      count << driver.Count(options.int_bound, options.str_bound);
+      if (driver.is_unknown()) {
+        count.str("unknown");
+      }
+    } else {
+      record.result = "unsat";
+      count << 0;
+    }
+    record.count = count.str();
+    times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+  }
+
+  record.median_ms = GetMedian(times);
+  std::vector<double> deviations;
+  for (double time : times) {
+    deviations.push_back(std::fabs(time - record.median_ms));
+  }
+  record.mad_ms = GetMedian(deviations);
+  record.min_ms = *std::min_element(times.begin(), times.end());
+
+  auto snapshot = Metrics::GetSnapshot();
+  record.max_dfa_states = snapshot[Metrics::get_name(Metrics::Maximum::DFA_STATES)];
+  for (int i = 0; i < NUMBER_OF_PHASES; ++i) {
+    std::string name = Metrics::get_name(static_cast<Metrics::Phase>(i));
+    record.phase_ms.push_back(snapshot[name + "_sum_us"] / 1000.0 / options.repetitions);
+  }
+  return record;
+}
+
+/**
+ * Runs a file in a child process that sends its record back over a pipe
+ */
+static Record RunInChild(const std::string& file_name, const Options& options) {
+  int fds[2];
+  CHECK_EQ(0, pipe(fds)) << "cannot create pipe: " << std::strerror(errno);
+  std::cout.flush();
+  pid_t pid = fork();
+  CHECK(pid >= 0) << "cannot fork: " << std::strerror(errno);
+  if (pid == 0) {
+    close(fds[0]);
+    std::string row = ToRow(Run(file_name, options));
+    std::size_t written = 0;
+    while (written < row.size()) {
+      ssize_t n = write(fds[1], row.data() + written, row.size() - written);
+      if (n <= 0) {
+        _exit(2);
+      }
+      written += n;
+    }
+    close(fds[1]);
+    _exit(0);
+  }
+
+  close(fds[1]);
+  std::string row;
+  char buffer[4096];
+  ssize_t n;
+  while ((n = read(fds[0], buffer, sizeof(buffer))) > 0) {
+    row.append(buffer, n);
+  }
+  close(fds[0]);
+  int status = 0;
+  struct rusage usage;
+  CHECK_EQ(pid, wait4(pid, &status, 0, &usage)) << "cannot wait for child: " << std::strerror(errno);
+
+  Record record;
+  if (WIFEXITED(status) and WEXITSTATUS(status) == 0 and not row.empty()) {
+    record = FromRow(GetColumnIndex(GetColumns()), Split(row));
+  } else {
+    LOG(ERROR)<< "benchmark failed: " << file_name;
+    record.file = file_name;
+    record.result = "error";
+    record.phase_ms.assign(NUMBER_OF_PHASES, 0);
+  }
+  // kilobytes on linux
+  record.peak_rss_kb = usage.ru_maxrss;
+  return record;
+}
+
+static std::vector<Record> ReadRecords(const std::string& file_name) {
+  std::vector<Record> records;
+  std::ifstream input(file_name);
+  std::string line;
+  if (not std::getline(input, line)) {
+    return records;
+  }
+  auto column_index = GetColumnIndex(Split(line));
+  while (std::getline(input, line)) {
+    if (not line.empty()) {
+      records.push_back(FromRow(column_index, Split(line)));
+    }
+  }
+  return records;
+}
+
+static void WriteRecords(const std::string& file_name, const std::vector<Record>& records) {
+  std::ofstream output(file_name);
+  CHECK(output.good()) << "cannot write file: " << file_name;
+  auto columns = GetColumns();
+  for (std::size_t i = 0; i < columns.size(); ++i) {
+    output << (i == 0 ? "" : "\t") << columns[i];
+  }
+  output << '\n';
+  for (auto& record : records) {
+    output << ToRow(record) << '\n';
+  }
+}
+
+/**
+ * Prints the changes against the baseline, returns the number of changed results and regressions
+ */
+static int Compare(const std::vector<Record>& baseline, const std::vector<Record>& records, const double threshold) {
+  std::map<std::string, const Record*> baseline_records;
+  for (auto& record : baseline) {
+    baseline_records[record.file] = &record;
+  }
+
+  int num_of_failures = 0, num_of_improvements = 0, num_of_compared = 0;
+  double log_ratio_sum = 0;
+  std::cout << std::endl << "change           baseline      current  file" << std::endl;
+  auto print = [](const std::string& change, const std::string& before, const std::string& after,
+                  const std::string& file) {
+    std::cout << std::left << std::setw(14) << change << std::right << std::setw(11) << before << std::setw(13)
+              << after << "  " << file << std::endl;
+  };
+  auto format_ms = [](double value) {
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2) << value << "ms";
+    return ss.str();
+  };
+
+  for (auto& record : records) {
+    auto it = baseline_records.find(record.file);
+    if (it == baseline_records.end()) {
+      print("new", "-", record.result, record.file);
+      continue;
+    }
+    const Record& before = *it->second;
+    baseline_records.erase(it);
+    if (record.result != before.result or record.count != before.count) {
+      print("result", before.result + " " + before.count, record.result + " " + record.count, record.file);
+      ++num_of_failures;
+      continue;
+    }
+    if (record.result == "error" or before.median_ms <= 0 or record.median_ms <= 0) {
+      continue;
+    }
+
+    ++num_of_compared;
+    log_ratio_sum += std::log(record.median_ms / before.median_ms);
+    const double change_ms = record.median_ms - before.median_ms;
+    const double noise_ms = std::max(MIN_TIME_CHANGE_MS, NOISE_FACTOR * std::max(before.mad_ms, record.mad_ms));
+    if (std::fabs(change_ms) > before.median_ms * threshold and std::fabs(change_ms) > noise_ms) {
+      if (change_ms > 0) {
+        print("slower", format_ms(before.median_ms), format_ms(record.median_ms), record.file);
+        ++num_of_failures;
+      } else {
+        print("faster", format_ms(before.median_ms), format_ms(record.median_ms), record.file);
+        ++num_of_improvements;
+      }
+    }
+    const long change_kb = record.peak_rss_kb - before.peak_rss_kb;
+    if (change_kb > before.peak_rss_kb * threshold and change_kb > MIN_RSS_CHANGE_KB) {
+      print("memory", std::to_string(before.peak_rss_kb) + "kB", std::to_string(record.peak_rss_kb) + "kB",
+            record.file);
+      ++num_of_failures;
+    }
+    // dfa sizes do not depend on timing, any growth beyond the threshold is real
+    if (record.max_dfa_states > before.max_dfa_states * (1 + threshold)) {
+      print("dfa states", std::to_string(before.max_dfa_states), std::to_string(record.max_dfa_states),
+            record.file);
+      ++num_of_failures;
+    }
+  }
+  for (auto& entry : baseline_records) {
+    print("missing", entry.second->result, "-", entry.first);
+  }
+
+  std::cout << std::endl << "compared: " << num_of_compared << ", regressions and changed results: "
+            << num_of_failures << ", improvements: " << num_of_improvements;
+  if (num_of_compared > 0) {
+    std::cout << ", geometric mean time ratio: " << std::fixed << std::setprecision(3)
+              << std::exp(log_ratio_sum / num_of_compared);
+  }
+  std::cout << std::endl;
+  return num_of_failures;
+}
+
+int main(const int argc, const char **argv) {
+  google::InitGoogleLogging(argv[0]);
+  FLAGS_logtostderr = 1;
+
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool has_value = (i + 1 < argc);
+    if ((arg == "-bs" or arg == "--bound-str") and has_value) {
+      options.str_bound = std::stoul(argv[++i]);
+    } else if ((arg == "-bi" or arg == "--bound-int") and has_value) {
+      options.int_bound = std::stoul(argv[++i]);
+    } else if (arg == "--repetitions" and has_value) {
+      options.repetitions = std::max(1, std::stoi(argv[++i]));
+    } else if (arg == "--time-limit" and has_value) {
+      options.time_limit = std::stoi(argv[++i]);
+    } else if (arg == "--threshold" and has_value) {
+      options.threshold = std::stod(argv[++i]) / 100;
+    } else if (arg == "--output" and has_value) {
+      options.output = argv[++i];
+    } else if (arg == "--baseline" and has_value) {
+      options.baseline = argv[++i];
+    } else {
+      options.paths.push_back(arg);
+    }
+  }
+
+  std::vector<std::string> files;
+  for (auto& path : options.paths) {
+    CollectFiles(path, files);
+  }
+
+  std::cout << "result    median(ms)     mad(ms)   rss(kB)  dfa states  file" << std::endl;
+  std::vector<Record> records;
+  for (auto& file : files) {
+    records.push_back(RunInChild(file, options));
+    auto& record = records.back();
+    std::cout << std::setw(7) << record.result << std::fixed << std::setprecision(2) << std::setw(14)
+              << record.median_ms << std::setw(12) << record.mad_ms << std::setw(10) << record.peak_rss_kb
+              << std::setw(12) << record.max_dfa_states << "  " << record.file << std::endl;
+  }
+  WriteRecords(options.output, records);
+  std::cout << "results written: " << options.output << std::endl;
+
+  if (options.baseline.empty()) {
+    return 0;
+  }
+  std::ifstream baseline_file(options.baseline);
+  if (not baseline_file.good()) {
+    std::cout << "baseline not found, nothing compared: " << options.baseline << std::endl;
+    return 0;
+  }
+  return (Compare(ReadRecords(options.baseline), records, options.threshold) > 0) ? 1 : 0;
+}
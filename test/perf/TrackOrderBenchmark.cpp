@@ -0,0 +1,155 @@
+/*
+ * TrackOrderBenchmark.cpp
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ *
+ * Benchmark for the track order of multitrack string automata. Solves and counts every .smt2 file under the
+ * given files and directories with tracks in name order and in relation graph order (--enable-track-ordering)
+ * and prints the largest dfa and the minimum wall time of each order. Exits with 1 if the two orders count
+ * differently.
+ *
+ * usage: trackbench [-bs <str bound> (default 10)] [--repetitions <n> (default 3)] <file or directory>...
+ */
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "Driver.h"
+#include "utils/Metrics.h"
+
+using namespace Vlab;
+
+using Metrics = Util::Metrics;
+
+struct Run {
+  std::string count;
+  double min_ms = 0;
+  unsigned long max_dfa_states = 0;
+};
+
+static void CollectFiles(const std::string& path, std::vector<std::string>& files) {
+  struct stat path_stat;
+  CHECK_EQ(0, stat(path.c_str(), &path_stat)) << "cannot find: " << path;
+  if (not S_ISDIR(path_stat.st_mode)) {
+    files.push_back(path);
+    return;
+  }
+  DIR* dir = opendir(path.c_str());
+  CHECK(dir != nullptr) << "cannot open directory: " << path;
+  std::vector<std::string> names;
+  while (struct dirent* entry = readdir(dir)) {
+    names.push_back(entry->d_name);
+  }
+  closedir(dir);
+  std::sort(names.begin(), names.end());
+
+  const std::string extension = ".smt2";
+  for (auto& name : names) {
+    if (name == "." or name == "..") {
+      continue;
+    }
+    std::string entry_path = path + "/" + name;
+    struct stat entry_stat;
+    if (stat(entry_path.c_str(), &entry_stat) != 0) {
+      continue;
+    }
+    if (S_ISDIR(entry_stat.st_mode)) {
+      CollectFiles(entry_path, files);
+    } else if (name.size() > extension.size()
+        and name.compare(name.size() - extension.size(), extension.size(), extension) == 0) {
+      files.push_back(entry_path);
+    }
+  }
+}
+
+static Run Measure(const std::string& file_name, const bool is_ordered, const int str_bound, const int repetitions) {
+  Metrics::Reset();
+  Run run;
+  std::vector<double> times;
+  for (int i = 0; i < repetitions; ++i) {
+    std::ifstream input(file_name);
+    CHECK(input.good()) << "cannot open file: " << file_name;
+    auto start = std::chrono::steady_clock::now();
+    Driver driver;
+    driver.set_option(is_ordered ? Option::Name::ENABLE_TRACK_ORDERING : Option::Name::DISABLE_TRACK_ORDERING);
+    driver.Parse(&input);
+    driver.InitializeSolver();
+    driver.Solve();
+    std::stringstream count;
+    if (driver.is_sat()) {
+      count << driver.Count(str_bound, str_bound);
+    } else {
+      count << 0;
+    }
+    run.count = driver.is_unknown() ? "unknown" : count.str();
+    times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+  }
+  run.min_ms = *std::min_element(times.begin(), times.end());
+  run.max_dfa_states = Metrics::GetSnapshot()[Metrics::get_name(Metrics::Maximum::DFA_STATES)];
+  return run;
+}
+
+int main(const int argc, const char **argv) {
+  google::InitGoogleLogging(argv[0]);
+  FLAGS_logtostderr = 1;
+
+  int str_bound = 10, repetitions = 3;
+  std::vector<std::string> paths;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "-bs" and i + 1 < argc) {
+      str_bound = std::atoi(argv[++i]);
+    } else if (arg == "--repetitions" and i + 1 < argc) {
+      repetitions = std::max(1, std::atoi(argv[++i]));
+    } else {
+      paths.push_back(arg);
+    }
+  }
+  if (paths.empty()) {
+    std::cerr << "usage: trackbench [-bs <str bound>] [--repetitions <n>] <file or directory>..." << std::endl;
+    return 2;
+  }
+
+  std::vector<std::string> files;
+  for (auto& path : paths) {
+    CollectFiles(path, files);
+  }
+
+  int mismatches = 0;
+  double name_order_total = 0, graph_order_total = 0;
+  std::cout << "file\tname_states\tname_ms\tgraph_states\tgraph_ms\tcount" << std::endl;
+  for (auto& file : files) {
+    Run name_order = Measure(file, false, str_bound, repetitions);
+    Run graph_order = Measure(file, true, str_bound, repetitions);
+    name_order_total += name_order.min_ms;
+    graph_order_total += graph_order.min_ms;
+    std::cout << std::fixed << std::setprecision(2) << file << '\t' << name_order.max_dfa_states << '\t'
+              << name_order.min_ms << '\t' << graph_order.max_dfa_states << '\t' << graph_order.min_ms << '\t'
+              << name_order.count;
+    if (name_order.count != graph_order.count) {
+      std::cout << " != " << graph_order.count;
+      ++mismatches;
+    }
+    std::cout << std::endl;
+  }
+  std::cout << std::fixed << std::setprecision(2) << "total\t\t" << name_order_total << "\t\t" << graph_order_total
+            << "\t" << mismatches << " mismatches" << std::endl;
+
+  Option::Solver::ENABLE_TRACK_ORDERING = false;
+  return (mismatches == 0) ? 0 : 1;
+}
@@ -0,0 +1,95 @@
+/*
+ * PreImageCacheTest.cpp
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "PreImageCacheTest.h"
+
+namespace Vlab {
+namespace Solver {
+namespace Test {
+
+using namespace ::testing;
+using Theory::StringAutomaton;
+
+static SMT::Term_ptr MakeTerm(const std::string value) {
+  return new SMT::TermConstant(new SMT::Primitive(value, SMT::Primitive::Type::STRING));
+}
+
+void PreImageCacheTest::SetUp() {
+  parent_term_ = MakeTerm("parent");
+  child_term_ = MakeTerm("child");
+  other_child_term_ = MakeTerm("other child");
+}
+
+void PreImageCacheTest::TearDown() {
+  delete parent_term_;
+  delete child_term_;
+  delete other_child_term_;
+}
+
+TEST_F(PreImageCacheTest, FingerprintOfEqualValues) {
+  Value value_1(StringAutomaton::MakeRegexAuto("(ab)*"));
+  Value value_2(StringAutomaton::MakeRegexAuto("(ab)*"));
+  Value value_3(StringAutomaton::MakeRegexAuto("(ab)+"));
+  EXPECT_EQ(value_1.fingerprint(), value_2.fingerprint());
+  EXPECT_TRUE(value_1.is_equal(&value_2));
+  EXPECT_FALSE(value_1.is_equal(&value_3));
+
+  Value int_value_1(3), int_value_2(3), int_value_3(4);
+  EXPECT_EQ(int_value_1.fingerprint(), int_value_2.fingerprint());
+  EXPECT_TRUE(int_value_1.is_equal(&int_value_2));
+  EXPECT_FALSE(int_value_1.is_equal(&int_value_3));
+  EXPECT_FALSE(int_value_1.is_equal(&value_1));
+}
+
+TEST_F(PreImageCacheTest, GetReturnsPreImageForSameInputs) {
+  PreImageCache cache;
+  Value parent_pre_image(StringAutomaton::MakeRegexAuto("a*b"));
+  Value operand(StringAutomaton::MakeString("b"));
+  Value pre_image(StringAutomaton::MakeRegexAuto("a*"));
+
+  EXPECT_EQ(nullptr, cache.get(parent_term_, child_term_, { &parent_pre_image, &operand }));
+  cache.set(parent_term_, child_term_, { &parent_pre_image, &operand }, &pre_image);
+
+  // inputs are compared by value, not by address
+  Value same_parent_pre_image(StringAutomaton::MakeRegexAuto("a*b"));
+  Value same_operand(StringAutomaton::MakeString("b"));
+  auto cached = cache.get(parent_term_, child_term_, { &same_parent_pre_image, &same_operand });
+  ASSERT_NE(nullptr, cached);
+  EXPECT_NE(&pre_image, cached);
+  EXPECT_TRUE(pre_image.is_equal(cached));
+}
+
+TEST_F(PreImageCacheTest, GetMissesForChangedInputs) {
+  PreImageCache cache;
+  Value parent_pre_image(StringAutomaton::MakeRegexAuto("a*b"));
+  Value operand(StringAutomaton::MakeString("b"));
+  Value pre_image(StringAutomaton::MakeRegexAuto("a*"));
+  cache.set(parent_term_, child_term_, { &parent_pre_image, &operand }, &pre_image);
+
+  Value shrunk_parent_pre_image(StringAutomaton::MakeRegexAuto("aa*b"));
+  Value other_operand(StringAutomaton::MakeString("c"));
+  EXPECT_EQ(nullptr, cache.get(parent_term_, child_term_, { &shrunk_parent_pre_image, &operand }));
+  EXPECT_EQ(nullptr, cache.get(parent_term_, child_term_, { &parent_pre_image, &other_operand }));
+  EXPECT_EQ(nullptr, cache.get(parent_term_, child_term_, { &parent_pre_image }));
+  EXPECT_EQ(nullptr, cache.get(parent_term_, other_child_term_, { &parent_pre_image, &operand }));
+
+  // a later entry for the same edge replaces the earlier one
+  Value other_pre_image(StringAutomaton::MakeRegexAuto("aa*"));
+  cache.set(parent_term_, child_term_, { &shrunk_parent_pre_image, &operand }, &other_pre_image);
+  EXPECT_EQ(nullptr, cache.get(parent_term_, child_term_, { &parent_pre_image, &operand }));
+  auto cached = cache.get(parent_term_, child_term_, { &shrunk_parent_pre_image, &operand });
+  ASSERT_NE(nullptr, cached);
+  EXPECT_TRUE(other_pre_image.is_equal(cached));
+
+  cache.clear();
+  EXPECT_EQ(nullptr, cache.get(parent_term_, child_term_, { &shrunk_parent_pre_image, &operand }));
+}
+
+} /* namespace Test */
+} /* namespace Solver */
+} /* namespace Vlab */
@@ -0,0 +1,39 @@
+/*
+ * PreImageCacheTest.h
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef SOLVER_PREIMAGECACHETEST_H_
+#define SOLVER_PREIMAGECACHETEST_H_
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "smt/ast.h"
+#include "solver/Value.h"
+#include "solver/VariableValueComputer.h"
+#include "theory/StringAutomaton.h"
+
+namespace Vlab {
+namespace Solver {
+namespace Test {
+
+class PreImageCacheTest : public ::testing::Test {
+protected:
+  virtual void SetUp();
+  virtual void TearDown();
+
+  SMT::Term_ptr parent_term_;
+  SMT::Term_ptr child_term_;
+  SMT::Term_ptr other_child_term_;
+};
+
+} /* namespace Test */
+} /* namespace Solver */
+} /* namespace Vlab */
+
+#endif /* SOLVER_PREIMAGECACHETEST_H_ */
@@ -0,0 +1,77 @@
+/*
+ * TransformationChainTest.cpp
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "TransformationChainTest.h"
+
+namespace Vlab {
+namespace Solver {
+namespace Test {
+
+using namespace ::testing;
+using Theory::StringAutomaton;
+using Theory::StringAutomaton_ptr;
+
+static SMT::Term_ptr MakeTerm(const std::string value) {
+  return new SMT::TermConstant(new SMT::Primitive(value, SMT::Primitive::Type::STRING));
+}
+
+void TransformationChainTest::SetUp() {
+  subject_term_ = MakeTerm("ab");
+  inner_term_ = new SMT::Replace(subject_term_, MakeTerm("a"), MakeTerm("b"));
+  chain_term_ = new SMT::ToUpper(inner_term_);
+}
+
+void TransformationChainTest::TearDown() {
+  // deletes the inner terms
+  delete chain_term_;
+}
+
+TEST_F(TransformationChainTest, NestedTransformations) {
+  TransformationChain chain(chain_term_);
+  EXPECT_EQ(2u, chain.size());
+  EXPECT_EQ(subject_term_, chain.get_subject());
+
+  TransformationChain inner_chain(inner_term_);
+  EXPECT_EQ(1u, inner_chain.size());
+  EXPECT_EQ(subject_term_, inner_chain.get_subject());
+
+  TransformationChain no_chain(subject_term_);
+  EXPECT_EQ(0u, no_chain.size());
+}
+
+TEST_F(TransformationChainTest, CachedTransducerIsComposedOnce) {
+  TransducerCache cache;
+  const Theory::Transducer& transducer = TransformationChain(chain_term_).get_transducer(cache);
+  EXPECT_EQ(1u, cache.size());
+  // a new chain of the same term reuses the composed transducer
+  EXPECT_EQ(&transducer, &TransformationChain(chain_term_).get_transducer(cache));
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_EQ(TransformationChain(chain_term_).get_transducer().str(), transducer.str());
+
+  // chains are keyed by their outermost term
+  EXPECT_NE(&transducer, &TransformationChain(inner_term_).get_transducer(cache));
+  EXPECT_EQ(2u, cache.size());
+}
+
+TEST_F(TransformationChainTest, CachedTransducerAppliesChain) {
+  TransducerCache cache;
+  TransformationChain chain(chain_term_);
+  StringAutomaton_ptr subject_auto = StringAutomaton::MakeString("ab");
+  StringAutomaton_ptr expected_auto = StringAutomaton::MakeString("BB");
+  for (int i = 0; i < 2; ++i) {
+    StringAutomaton_ptr result_auto = subject_auto->Transduce(chain.get_transducer(cache));
+    EXPECT_TRUE(result_auto->IsEqual(expected_auto));
+    delete result_auto;
+  }
+  delete subject_auto;
+  delete expected_auto;
+}
+
+} /* namespace Test */
+} /* namespace Solver */
+} /* namespace Vlab */
@@ -0,0 +1,39 @@
+/*
+ * TransformationChainTest.h
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef SOLVER_TRANSFORMATIONCHAINTEST_H_
+#define SOLVER_TRANSFORMATIONCHAINTEST_H_
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "smt/ast.h"
+#include "solver/TransformationChain.h"
+#include "theory/StringAutomaton.h"
+
+namespace Vlab {
+namespace Solver {
+namespace Test {
+
+class TransformationChainTest : public ::testing::Test {
+protected:
+  virtual void SetUp();
+  virtual void TearDown();
+
+  // toUpper(replace(subject, "a", "b"))
+  SMT::Term_ptr chain_term_;
+  SMT::Term_ptr inner_term_;
+  SMT::Term_ptr subject_term_;
+};
+
+} /* namespace Test */
+} /* namespace Solver */
+} /* namespace Vlab */
+
+#endif /* SOLVER_TRANSFORMATIONCHAINTEST_H_ */
@@ -10,6 +10,8 @@
 
 #include "ArithmeticFormulaTest.h"
 
+#include <limits>
+
 namespace Vlab {
 namespace Theory {
 namespace Test {
@@ -60,7 +62,7 @@ TEST_F(ArithmeticFormulaTest, Str) {
   formula_1.type_ = ArithmeticFormula::Type::GE;
   formula_1.variable_coefficient_map_["x"] = -1;
   formula_1.variable_coefficient_map_["y"] = -2;
-  formula_1.set_variable_coefficient("x", -1);
+  formula_1.SetVariableCoefficient("x", -1);
   formula_1.constant_ = 0;
   EXPECT_THAT(formula_1.str(), StrEq(" - x - 2y + z >= 0"));
 
@@ -74,14 +76,14 @@ TEST_F(ArithmeticFormulaTest, Str) {
 
 TEST_F(ArithmeticFormulaTest, SetType) {
   PublicArithmeticFormula formula_1;
-  formula_1.set_type(ArithmeticFormula::Type::LT);
+  formula_1.SetType(ArithmeticFormula::Type::LT);
   EXPECT_EQ(ArithmeticFormula::Type::LT, formula_1.type_);
 }
 
 TEST_F(ArithmeticFormulaTest, GetType) {
   PublicArithmeticFormula formula_1;
   formula_1.type_ = ArithmeticFormula::Type::GE;
-  EXPECT_EQ(ArithmeticFormula::Type::GE, formula_1.get_type());
+  EXPECT_EQ(ArithmeticFormula::Type::GE, formula_1.GetType());
 }
 
 TEST_F(ArithmeticFormulaTest, GetNumberOfVariables) {
@@ -89,7 +91,7 @@ TEST_F(ArithmeticFormulaTest, GetNumberOfVariables) {
   formula_1.type_ = ArithmeticFormula::Type::LT;
   formula_1.variable_coefficient_map_ = variable_coefficient_map_;
   formula_1.constant_ = 3;
-  EXPECT_EQ(3, formula_1.get_number_of_variables());
+  EXPECT_EQ(3, formula_1.GetNumberOfVariables());
 }
 
 TEST_F(ArithmeticFormulaTest, GetVariableCoefficient) {
@@ -98,8 +100,8 @@ TEST_F(ArithmeticFormulaTest, GetVariableCoefficient) {
   formula_1.variable_coefficient_map_ = variable_coefficient_map_;
   formula_1.constant_ = 3;
 
-  EXPECT_EQ(2, formula_1.get_variable_coefficient("y"));
-  EXPECT_DEATH(formula_1.get_variable_coefficient("a"), "");
+  EXPECT_EQ(2, formula_1.GetVariableCoefficient("y"));
+  EXPECT_DEATH(formula_1.GetVariableCoefficient("a"), "");
 }
 
 TEST_F(ArithmeticFormulaTest, SetVariableCoefficient) {
@@ -108,9 +110,9 @@ TEST_F(ArithmeticFormulaTest, SetVariableCoefficient) {
   formula_1.variable_coefficient_map_ = variable_coefficient_map_;
   formula_1.constant_ = 3;
 
-  formula_1.set_variable_coefficient("x", -1);
+  formula_1.SetVariableCoefficient("x", -1);
   EXPECT_EQ(-1, formula_1.variable_coefficient_map_["x"]);
-  EXPECT_DEATH(formula_1.set_variable_coefficient("a", 2), "");
+  EXPECT_DEATH(formula_1.SetVariableCoefficient("a", 2), "");
 }
 
 TEST_F(ArithmeticFormulaTest, AddVariable) {
@@ -119,9 +121,9 @@ TEST_F(ArithmeticFormulaTest, AddVariable) {
   formula_1.variable_coefficient_map_ = variable_coefficient_map_;
   formula_1.constant_ = 3;
 
-  formula_1.add_variable("a", -4);
+  formula_1.AddVariable("a", -4);
   EXPECT_THAT(formula_1.variable_coefficient_map_, ElementsAre(Pair("a", -4), Pair("x", 1), Pair("y", 2), Pair("z", 1)));
-  EXPECT_DEATH(formula_1.add_variable("x", 2), "");
+  EXPECT_DEATH(formula_1.AddVariable("x", 2), "");
 }
 
 TEST_F(ArithmeticFormulaTest, GetCoefficients) {
@@ -130,18 +132,18 @@ TEST_F(ArithmeticFormulaTest, GetCoefficients) {
   formula_1.variable_coefficient_map_ = variable_coefficient_map_;
   formula_1.constant_ = 3;
 
-  EXPECT_THAT(formula_1.get_coefficients(), ElementsAre(1, 2, 1));
+  EXPECT_THAT(formula_1.GetCoefficients(), ElementsAre(1, 2, 1));
 }
 
 TEST_F(ArithmeticFormulaTest, GetConstant) {
   PublicArithmeticFormula formula_1;
   formula_1.constant_ = 4;
-  EXPECT_EQ(4, formula_1.get_constant());
+  EXPECT_EQ(4, formula_1.GetConstant());
 }
 
 TEST_F(ArithmeticFormulaTest, SetConstant) {
   PublicArithmeticFormula formula_1;
-  formula_1.set_constant(-3);
+  formula_1.SetConstant(-3);
   EXPECT_EQ(-3, formula_1.constant_);
 }
 
@@ -151,9 +153,9 @@ TEST_F(ArithmeticFormulaTest, IsConstant) {
   formula_1.variable_coefficient_map_ = variable_coefficient_map_;
   formula_1.constant_ = 3;
 
-  EXPECT_FALSE(formula_1.is_constant());
+  EXPECT_FALSE(formula_1.IsConstant());
   formula_1.variable_coefficient_map_ = {{"x", 0}, {"y", 0}, {"z", 0}};
-  EXPECT_TRUE(formula_1.is_constant());
+  EXPECT_TRUE(formula_1.IsConstant());
 }
 
 TEST_F(ArithmeticFormulaTest, ResetCoefficients) {
@@ -162,10 +164,10 @@ TEST_F(ArithmeticFormulaTest, ResetCoefficients) {
   formula_1.variable_coefficient_map_ = variable_coefficient_map_;
   formula_1.constant_ = 3;
 
-  formula_1.reset_coefficients();
+  formula_1.ResetCoefficients();
   EXPECT_THAT(formula_1.variable_coefficient_map_, ElementsAre(Pair("x", 0), Pair("y", 0), Pair("z", 0)));
   EXPECT_EQ(3, formula_1.constant_);
-  formula_1.reset_coefficients(2);
+  formula_1.ResetCoefficients(2);
   EXPECT_THAT(formula_1.variable_coefficient_map_, ElementsAre(Pair("x", 2), Pair("y", 2), Pair("z", 2)));
 }
 
@@ -175,14 +177,14 @@ TEST_F(ArithmeticFormulaTest, GetVariableIndex) {
   formula_1.variable_coefficient_map_ = variable_coefficient_map_;
   formula_1.constant_ = 3;
 
-  EXPECT_EQ(0, formula_1.get_variable_index("x"));
-  EXPECT_EQ(1, formula_1.get_variable_index("y"));
-  EXPECT_EQ(2, formula_1.get_variable_index("z"));
+  EXPECT_EQ(0, formula_1.GetVariableIndex("x"));
+  EXPECT_EQ(1, formula_1.GetVariableIndex("y"));
+  EXPECT_EQ(2, formula_1.GetVariableIndex("z"));
   formula_1.variable_coefficient_map_["a"] = 1;
-  EXPECT_EQ(0, formula_1.get_variable_index("a"));
-  EXPECT_EQ(1, formula_1.get_variable_index("x"));
-  EXPECT_EQ(2, formula_1.get_variable_index("y"));
-  EXPECT_EQ(3, formula_1.get_variable_index("z"));
+  EXPECT_EQ(0, formula_1.GetVariableIndex("a"));
+  EXPECT_EQ(1, formula_1.GetVariableIndex("x"));
+  EXPECT_EQ(2, formula_1.GetVariableIndex("y"));
+  EXPECT_EQ(3, formula_1.GetVariableIndex("z"));
 }
 
 TEST_F(ArithmeticFormulaTest, Add) {
@@ -369,13 +371,89 @@ TEST_F(ArithmeticFormulaTest, MergeVariables) {
   formula_1.variable_coefficient_map_ = {{"a", 3}, {"x", 9}, {"zz", 5}};
   formula_1.type_ = ArithmeticFormula::Type::EQ;
 
-  formula_0.merge_variables(&formula_1);
+  formula_0.MergeVariables(&formula_1);
   EXPECT_THAT(formula_0.variable_coefficient_map_, ElementsAre(Pair("a", 0), Pair("x", 1), Pair("y", 2), Pair("z", 1), Pair("zz", 0)));
-  formula_1.merge_variables(&formula_0);
+  formula_1.MergeVariables(&formula_0);
   EXPECT_THAT(formula_1.variable_coefficient_map_, ElementsAre(Pair("a", 3), Pair("x", 9), Pair("y", 0), Pair("z", 0), Pair("zz", 5)));
 
 }
 
+TEST_F(ArithmeticFormulaTest, BigCoefficients) {
+  const BigInteger big = BigInteger(1) << 40;
+  PublicArithmeticFormula formula_0;
+  formula_0.type_ = ArithmeticFormula::Type::EQ;
+  formula_0.SetExactCoefficient("x", big);
+  formula_0.SetExactCoefficient("y", -big);
+  formula_0.SetExactCoefficient("z", 3);
+  formula_0.constant_ = 7;
+
+  EXPECT_EQ(big, formula_0.GetExactCoefficient("x"));
+  EXPECT_EQ(-big, formula_0.GetExactCoefficient("y"));
+  EXPECT_EQ(3, formula_0.GetExactCoefficient("z"));
+  EXPECT_EQ(std::numeric_limits<int>::max(), formula_0.GetVariableCoefficient("x"));
+  EXPECT_EQ(std::numeric_limits<int>::min(), formula_0.GetVariableCoefficient("y"));
+  EXPECT_THAT(formula_0.GetExactCoefficients(), ElementsAre(big, -big, 3));
+  EXPECT_FALSE(formula_0.HasIntCoefficients());
+
+  formula_0.SetExactCoefficient("x", 5);
+  EXPECT_EQ(5, formula_0.GetVariableCoefficient("x"));
+  EXPECT_EQ(5, formula_0.GetExactCoefficient("x"));
+}
+
+TEST_F(ArithmeticFormulaTest, BigCoefficientArithmetic) {
+  const BigInteger big = BigInteger(1) << 40;
+  PublicArithmeticFormula formula_0;
+  formula_0.type_ = ArithmeticFormula::Type::EQ;
+  formula_0.SetExactCoefficient("x", big);
+  formula_0.SetExactCoefficient("y", 2 * big);
+  formula_0.constant_ = -4 * big;
+
+  auto result = formula_0.Add(&formula_0);
+  EXPECT_EQ(2 * big, result->GetExactCoefficient("x"));
+  EXPECT_EQ(4 * big, result->GetExactCoefficient("y"));
+  EXPECT_EQ(-8 * big, result->GetConstant());
+  delete result;
+
+  result = formula_0.Subtract(&formula_0);
+  EXPECT_EQ(0, result->GetExactCoefficient("x"));
+  EXPECT_EQ(0, result->GetVariableCoefficient("x"));
+  delete result;
+
+  result = formula_0.Multiply(-big);
+  EXPECT_EQ(-big * big, result->GetExactCoefficient("x"));
+  EXPECT_EQ(4 * big * big, result->GetConstant());
+  delete result;
+
+  // the gcd of the coefficients divides the formula down to int coefficients
+  EXPECT_TRUE(formula_0.Simplify());
+  EXPECT_EQ(1, formula_0.GetExactCoefficient("x"));
+  EXPECT_EQ(2, formula_0.GetExactCoefficient("y"));
+  EXPECT_EQ(-4, formula_0.GetConstant());
+  EXPECT_TRUE(formula_0.HasIntCoefficients());
+}
+
+TEST_F(ArithmeticFormulaTest, BigConstant) {
+  const BigInteger big = BigInteger(1) << 70;
+  PublicArithmeticFormula formula_0;
+  formula_0.type_ = ArithmeticFormula::Type::EQ;
+  formula_0.variable_coefficient_map_ = variable_coefficient_map_;
+  formula_0.SetConstant(big);
+  EXPECT_EQ(big, formula_0.GetConstant());
+  EXPECT_FALSE(formula_0.HasIntCoefficients());
+
+  formula_0.SetConstant(std::numeric_limits<int>::max());
+  EXPECT_TRUE(formula_0.HasIntCoefficients());
+
+  // 3x + 6y + 3 * 2^70 = 0 is divided by the gcd 3, 3x + 6y + 3 * 2^70 + 1 = 0 has no solution
+  formula_0.variable_coefficient_map_ = { { "x", 3 }, { "y", 6 } };
+  formula_0.SetConstant(3 * big);
+  EXPECT_TRUE(formula_0.Simplify());
+  EXPECT_EQ(big, formula_0.GetConstant());
+  formula_0.variable_coefficient_map_ = { { "x", 3 }, { "y", 6 } };
+  formula_0.SetConstant(3 * big + 1);
+  EXPECT_FALSE(formula_0.Simplify());
+}
+
 
 
 } /* namespace Test */
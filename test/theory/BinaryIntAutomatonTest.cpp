@@ -18,15 +18,59 @@ class PublicBinaryIntAutomaton : public BinaryIntAutomaton {
  public:
   using BinaryIntAutomaton::BinaryIntAutomaton;
   using BinaryIntAutomaton::type_;
-  using BinaryIntAutomaton::is_count_matrix_cached_;
   using BinaryIntAutomaton::dfa_;
   using BinaryIntAutomaton::num_of_bdd_variables_;
-  using BinaryIntAutomaton::count_matrix_;
   using BinaryIntAutomaton::is_natural_number_;
   using BinaryIntAutomaton::formula_;
+  using BinaryIntAutomaton::MakeIntEquality;
+  using BinaryIntAutomaton::MakeNaturalNumberEquality;
+  using BinaryIntAutomaton::MakeIntLessThan;
+  using BinaryIntAutomaton::MakeNaturalNumberLessThan;
+  using BinaryIntAutomaton::MakeIntEqualityByEnumeration;
+  using BinaryIntAutomaton::MakeNaturalNumberEqualityByEnumeration;
+  using BinaryIntAutomaton::MakeIntLessThanByEnumeration;
+  using BinaryIntAutomaton::MakeNaturalNumberLessThanByEnumeration;
 
 };
 
+/**
+ * sum(coefficients[i] * x<i>) + constant <type> 0
+ */
+static ArithmeticFormula_ptr MakeFormula(ArithmeticFormula::Type type, const std::vector<BigInteger>& coefficients,
+                                         const BigInteger& constant) {
+  auto formula = new ArithmeticFormula();
+  formula->SetType(type);
+  for (std::size_t i = 0; i < coefficients.size(); ++i) {
+    formula->SetExactCoefficient("x" + std::to_string(i), coefficients[i]);
+  }
+  formula->SetConstant(constant);
+  return formula;
+}
+
+/**
+ * Compares the values in [0, bound) accepted by a binary automaton of x0 with a unary reference
+ * @return number of values the binary automaton accepts
+ */
+static int CountAgainstUnary(BinaryIntAutomaton_ptr binary_auto, std::function<bool(int)> is_accepted_by_unary,
+                             const int bound) {
+  int count = 0;
+  for (int value = 0; value < bound; ++value) {
+    auto value_auto = BinaryIntAutomaton::MakeAutomaton(value, "x0", MakeFormula(ArithmeticFormula::Type::EQ, { 1 }, 0),
+                                                        true);
+    const bool is_accepted = not binary_auto->IsIntersectionEmpty(value_auto);
+    EXPECT_EQ(is_accepted_by_unary(value), is_accepted) << "value " << value;
+    if (is_accepted) {
+      ++count;
+    }
+    delete value_auto;
+  }
+  return count;
+}
+
+static const std::vector<std::vector<BigInteger>> COEFFICIENT_SETS = { { 1 }, { -1 }, { 3 }, { 2, -3 }, { -1, -1 },
+    { 2, 0, -5 }, { -2, 3, 1 }, { 4, 6, -7, 1 } };
+static const std::vector<BigInteger> CONSTANTS = { -9, -2, -1, 0, 1, 4, 11 };
+
 using namespace ::testing;
 using namespace Vlab::Test::Path;
 
@@ -54,11 +98,11 @@ TEST_F(BinaryIntAutomatonTest, ConstructorWith3Args) {
   EXPECT_EQ(5, b_int_auto_0.num_of_bdd_variables_);
 
   auto formula = new ArithmeticFormula();
-  formula->set_type(ArithmeticFormula::Type::EQ);
-  formula->set_constant(7);
-  formula->add_variable("x", 1);
-  formula->add_variable("y", 2);
-  formula->add_variable("z", 3);
+  formula->SetType(ArithmeticFormula::Type::EQ);
+  formula->SetConstant(7);
+  formula->AddVariable("x", 1);
+  formula->AddVariable("y", 2);
+  formula->AddVariable("z", 3);
   PublicBinaryIntAutomaton b_int_auto_1(nullptr, formula, true);
   EXPECT_EQ(Automaton::Type::BINARYINT, b_int_auto_1.type_);
   EXPECT_EQ(formula, b_int_auto_1.formula_);
@@ -70,16 +114,16 @@ TEST_F(BinaryIntAutomatonTest, ConstructorWith3Args) {
 
 TEST_F(BinaryIntAutomatonTest, CopyConstructor) {
   auto formula = new ArithmeticFormula();
-  formula->set_type(ArithmeticFormula::Type::EQ);
-  formula->set_constant(7);
-  formula->add_variable("x", 1);
-  formula->add_variable("y", 2);
-  formula->add_variable("z", 3);
+  formula->SetType(ArithmeticFormula::Type::EQ);
+  formula->SetConstant(7);
+  formula->AddVariable("x", 1);
+  formula->AddVariable("y", 2);
+  formula->AddVariable("z", 3);
 
   PublicBinaryIntAutomaton b_int_auto_0(nullptr, formula, true);
   PublicBinaryIntAutomaton b_int_auto_1(b_int_auto_0);
   EXPECT_EQ(Automaton::Type::BINARYINT, b_int_auto_1.type_);
-  EXPECT_THAT(b_int_auto_1.formula_->get_variable_coefficient_map(), ElementsAre(Pair("x", 1), Pair("y", 2), Pair("z", 3)));
+  EXPECT_THAT(b_int_auto_1.formula_->GetVariableCoefficientMap(), ElementsAre(Pair("x", 1), Pair("y", 2), Pair("z", 3)));
   EXPECT_EQ(nullptr, b_int_auto_1.dfa_);
   EXPECT_EQ(true, b_int_auto_1.is_natural_number_);
   EXPECT_EQ(3, b_int_auto_1.num_of_bdd_variables_);
@@ -87,11 +131,11 @@ TEST_F(BinaryIntAutomatonTest, CopyConstructor) {
 
 TEST_F(BinaryIntAutomatonTest, MakePhi) {
   auto formula = new ArithmeticFormula();
-  formula->set_type(ArithmeticFormula::Type::EQ);
-  formula->set_constant(7);
-  formula->add_variable("x", 1);
-  formula->add_variable("y", 2);
-  formula->add_variable("z", 3);
+  formula->SetType(ArithmeticFormula::Type::EQ);
+  formula->SetConstant(7);
+  formula->AddVariable("x", 1);
+  formula->AddVariable("y", 2);
+  formula->AddVariable("z", 3);
 
   auto result = BinaryIntAutomaton::MakePhi(formula, false);
   PublicBinaryIntAutomaton* presult = static_cast<PublicBinaryIntAutomaton*>(result);
@@ -102,6 +146,215 @@ TEST_F(BinaryIntAutomatonTest, MakePhi) {
   // TODO add an automaton check wrt a expectation
 }
 
+TEST_F(BinaryIntAutomatonTest, SymbolicEqualityMatchesEnumeration) {
+  for (auto& coefficients : COEFFICIENT_SETS) {
+    for (auto& constant : CONSTANTS) {
+      auto formula = MakeFormula(ArithmeticFormula::Type::EQ, coefficients, constant);
+      SCOPED_TRACE(formula->str());
+
+      auto symbolic_auto = PublicBinaryIntAutomaton::MakeIntEquality(formula->clone());
+      auto enumerated_auto = PublicBinaryIntAutomaton::MakeIntEqualityByEnumeration(formula->clone());
+      EXPECT_TRUE(symbolic_auto->IsEqual(enumerated_auto));
+      delete symbolic_auto;
+      delete enumerated_auto;
+
+      symbolic_auto = PublicBinaryIntAutomaton::MakeNaturalNumberEquality(formula->clone());
+      enumerated_auto = PublicBinaryIntAutomaton::MakeNaturalNumberEqualityByEnumeration(formula->clone());
+      EXPECT_TRUE(symbolic_auto->IsEqual(enumerated_auto));
+      delete symbolic_auto;
+      delete enumerated_auto;
+      delete formula;
+    }
+  }
+}
+
+TEST_F(BinaryIntAutomatonTest, SymbolicLessThanMatchesEnumeration) {
+  for (auto& coefficients : COEFFICIENT_SETS) {
+    for (auto& constant : CONSTANTS) {
+      auto formula = MakeFormula(ArithmeticFormula::Type::LT, coefficients, constant);
+      SCOPED_TRACE(formula->str());
+
+      auto symbolic_auto = PublicBinaryIntAutomaton::MakeIntLessThan(formula->clone());
+      auto enumerated_auto = PublicBinaryIntAutomaton::MakeIntLessThanByEnumeration(formula->clone());
+      EXPECT_TRUE(symbolic_auto->IsEqual(enumerated_auto));
+      delete symbolic_auto;
+      delete enumerated_auto;
+
+      symbolic_auto = PublicBinaryIntAutomaton::MakeNaturalNumberLessThan(formula->clone());
+      enumerated_auto = PublicBinaryIntAutomaton::MakeNaturalNumberLessThanByEnumeration(formula->clone());
+      EXPECT_TRUE(symbolic_auto->IsEqual(enumerated_auto));
+      delete symbolic_auto;
+      delete enumerated_auto;
+      delete formula;
+    }
+  }
+}
+
+TEST_F(BinaryIntAutomatonTest, SymbolicEqualityWithBigCoefficients) {
+  const BigInteger big = BigInteger(1) << 40;
+  // big * x0 + 3 * x1 - (big + 3) = 0 has the solution x0 = x1 = 1 and no solution with x1 = 0
+  auto formula = MakeFormula(ArithmeticFormula::Type::EQ, { big, 3 }, -(big + 3));
+  EXPECT_FALSE(formula->HasIntCoefficients());
+  auto equality_auto = PublicBinaryIntAutomaton::MakeIntEquality(formula);
+
+  auto one_one_auto = PublicBinaryIntAutomaton::MakeIntEquality(MakeFormula(ArithmeticFormula::Type::EQ, { 1, 0 }, -1));
+  auto x1_one_auto = PublicBinaryIntAutomaton::MakeIntEquality(MakeFormula(ArithmeticFormula::Type::EQ, { 0, 1 }, -1));
+  auto x1_zero_auto = PublicBinaryIntAutomaton::MakeIntEquality(MakeFormula(ArithmeticFormula::Type::EQ, { 0, 1 }, 0));
+  auto point_auto = one_one_auto->Intersect(x1_one_auto);
+  EXPECT_FALSE(equality_auto->IsIntersectionEmpty(point_auto));
+  EXPECT_TRUE(equality_auto->IsIntersectionEmpty(x1_zero_auto));
+
+  delete equality_auto;
+  delete one_one_auto;
+  delete x1_one_auto;
+  delete x1_zero_auto;
+  delete point_auto;
+}
+
+TEST_F(BinaryIntAutomatonTest, NaturalNumberCarriesSaturateWithWideCoefficients) {
+  using Type = ArithmeticFormula::Type;
+  // with b = 2^w, (b + 1) * x0 + (b + 3) * x1 + (b + 5) * x2 + x3 - 10 <type> 0 has x0 = x1 = x2 = 0 whenever
+  // the sum is at most 10; the automata only need the carries in [-10, 0] for any width
+  auto zero_auto = PublicBinaryIntAutomaton::MakeNaturalNumberEquality(MakeFormula(Type::EQ, { 1, 1, 1, 0 }, 0));
+  auto x3_ten_auto = PublicBinaryIntAutomaton::MakeNaturalNumberEquality(MakeFormula(Type::EQ, { 0, 0, 0, 1 }, -10));
+  auto x3_less_auto = PublicBinaryIntAutomaton::MakeNaturalNumberLessThan(MakeFormula(Type::LT, { 0, 0, 0, 1 }, -10));
+  auto nonzero_auto = PublicBinaryIntAutomaton::MakeNaturalNumberLessThan(MakeFormula(Type::LT, { -1, -1, -1, 0 }, 0));
+  auto x3_greater_auto = PublicBinaryIntAutomaton::MakeNaturalNumberLessThan(
+      MakeFormula(Type::LT, { 0, 0, 0, -1 }, 10));
+  auto expected_equality_auto = zero_auto->Intersect(x3_ten_auto);
+  auto expected_less_than_auto = zero_auto->Intersect(x3_less_auto);
+  auto expected_greater_than_auto = nonzero_auto->Union(x3_greater_auto);
+
+  for (int width : { 8, 32, 128 }) {
+    SCOPED_TRACE(width);
+    const BigInteger b = BigInteger(1) << width;
+    BinaryIntAutomaton_ptr equality_auto = nullptr, negated_equality_auto = nullptr;
+    BinaryIntAutomaton_ptr less_than_auto = nullptr, greater_than_auto = nullptr;
+    {
+      // without saturation the reachable carries grow with b and the wider constructions are stopped
+      Util::Budget::Scope scope(0, 32, 256);
+      equality_auto = PublicBinaryIntAutomaton::MakeNaturalNumberEquality(
+          MakeFormula(Type::EQ, { b + 1, b + 3, b + 5, 1 }, -10));
+      negated_equality_auto = PublicBinaryIntAutomaton::MakeNaturalNumberEquality(
+          MakeFormula(Type::EQ, { -b - 1, -b - 3, -b - 5, -1 }, 10));
+      less_than_auto = PublicBinaryIntAutomaton::MakeNaturalNumberLessThan(
+          MakeFormula(Type::LT, { b + 1, b + 3, b + 5, 1 }, -10));
+      greater_than_auto = PublicBinaryIntAutomaton::MakeNaturalNumberLessThan(
+          MakeFormula(Type::LT, { -b - 1, -b - 3, -b - 5, -1 }, 10));
+      EXPECT_FALSE(Util::Budget::IsExceeded());
+    }
+    EXPECT_TRUE(equality_auto->IsEqual(expected_equality_auto));
+    EXPECT_TRUE(negated_equality_auto->IsEqual(expected_equality_auto));
+    EXPECT_TRUE(less_than_auto->IsEqual(expected_less_than_auto));
+    EXPECT_TRUE(greater_than_auto->IsEqual(expected_greater_than_auto));
+    delete equality_auto;
+    delete negated_equality_auto;
+    delete less_than_auto;
+    delete greater_than_auto;
+  }
+
+  delete zero_auto;
+  delete x3_ten_auto;
+  delete x3_less_auto;
+  delete nonzero_auto;
+  delete x3_greater_auto;
+  delete expected_equality_auto;
+  delete expected_less_than_auto;
+  delete expected_greater_than_auto;
+}
+
+TEST_F(BinaryIntAutomatonTest, MakeAutomatonFromLasso) {
+  struct Lasso {
+    std::vector<bool> statuses;
+    int cycle_head;
+    int expected_count;  // accepted values below 64
+  };
+  const std::vector<Lasso> lassos = {
+      { { true, false, true, true, false }, 4, 3 },             // pure prefix, {0, 2, 3}
+      { { false, true, true }, 0, 42 },                         // cycle only, 1 and 2 modulo 3
+      { { true, false, false, true, false, true }, 3, 42 } };   // mixed, 0 and from 3 on 3 + {0, 2} modulo 3
+  for (auto& lasso : lassos) {
+    SCOPED_TRACE(lasso.cycle_head);
+    const int lasso_length = lasso.statuses.size();
+    auto is_accepted_by_lasso = [&lasso, lasso_length](int value) {
+      if (value >= lasso_length) {
+        value = lasso.cycle_head + (value - lasso.cycle_head) % (lasso_length - lasso.cycle_head);
+      }
+      return static_cast<bool>(lasso.statuses[value]);
+    };
+
+    auto binary_auto = BinaryIntAutomaton::MakeAutomaton(lasso.statuses, lasso.cycle_head, "x0",
+                                                         MakeFormula(ArithmeticFormula::Type::EQ, { 1 }, 0));
+    EXPECT_EQ(lasso.expected_count, CountAgainstUnary(binary_auto, is_accepted_by_lasso, 64));
+    delete binary_auto;
+  }
+}
+
+TEST_F(BinaryIntAutomatonTest, IntAutomatonToBinaryIntAutomaton) {
+  auto at_least_five_auto = IntAutomaton::makeIntGreaterThanOrEqual(5);
+  auto values_auto = IntAutomaton::makeInts( { 1, 3 });
+  std::vector<IntAutomaton_ptr> unary_autos = {
+      IntAutomaton::makeInts( { 0, 2, 7 }),      // pure prefix
+      IntAutomaton::makeIntGreaterThanOrEqual(0),  // cycle only
+      at_least_five_auto->Union(values_auto) };  // mixed
+  const std::vector<int> expected_counts = { 3, 64, 61 };  // accepted values below 64
+  delete at_least_five_auto;
+  delete values_auto;
+
+  for (std::size_t i = 0; i < unary_autos.size(); ++i) {
+    SCOPED_TRACE(i);
+    auto unary_auto = unary_autos[i];
+    auto is_accepted_by_unary = [unary_auto](int value) {
+      auto value_auto = unary_auto->Intersect(value);
+      const bool is_accepted = not value_auto->isEmptyLanguage();
+      delete value_auto;
+      return is_accepted;
+    };
+
+    auto binary_auto = unary_auto->toBinaryIntAutomaton("x0", MakeFormula(ArithmeticFormula::Type::EQ, { 1 }, 0));
+    EXPECT_EQ(expected_counts[i], CountAgainstUnary(binary_auto, is_accepted_by_unary, 64));
+    delete binary_auto;
+    delete unary_auto;
+  }
+}
+
+TEST_F(BinaryIntAutomatonTest, GetSemilinearSet) {
+  // 0, and from 3 on 3 + {0, 2} modulo 3
+  auto lasso_auto = BinaryIntAutomaton::MakeAutomaton(std::vector<bool> { true, false, false, true, false, true }, 3,
+                                                      "x0", MakeFormula(ArithmeticFormula::Type::EQ, { 1 }, 0));
+  auto semilinear_set = lasso_auto->GetSemilinearSet();
+  EXPECT_THAT(semilinear_set->get_constants(), ElementsAre(0));
+  EXPECT_EQ(3, semilinear_set->get_cycle_head());
+  EXPECT_EQ(3, semilinear_set->get_period());
+  EXPECT_THAT(semilinear_set->get_periodic_constants(), ElementsAre(0, 2));
+  delete semilinear_set;
+  delete lasso_auto;
+
+  // -x0 + 100000 < 0, the cycle head is read from the residuals, not from enumerated values
+  auto greater_than_auto = PublicBinaryIntAutomaton::MakeNaturalNumberLessThan(
+      MakeFormula(ArithmeticFormula::Type::LT, { -1 }, 100000));
+  semilinear_set = greater_than_auto->GetSemilinearSet();
+  EXPECT_TRUE(semilinear_set->get_constants().empty());
+  EXPECT_EQ(100001, semilinear_set->get_cycle_head());
+  EXPECT_EQ(1, semilinear_set->get_period());
+  EXPECT_THAT(semilinear_set->get_periodic_constants(), ElementsAre(0));
+  delete semilinear_set;
+  delete greater_than_auto;
+
+  auto phi_auto = BinaryIntAutomaton::MakePhi(MakeFormula(ArithmeticFormula::Type::EQ, { 1 }, 0), true);
+  semilinear_set = phi_auto->GetSemilinearSet();
+  EXPECT_TRUE(semilinear_set->is_empty_set());
+  delete semilinear_set;
+  delete phi_auto;
+}
+
+TEST_F(BinaryIntAutomatonTest, EnumerationRequiresIntCoefficients) {
+  const BigInteger big = BigInteger(1) << 40;
+  auto formula = MakeFormula(ArithmeticFormula::Type::LT, { big, -3 }, 1);
+  EXPECT_DEATH(PublicBinaryIntAutomaton::MakeIntLessThanByEnumeration(formula->clone()), "int carries");
+  delete formula;
+}
+
 //TEST_F(BinaryIntAutomatonTest, Complement) {
 //  std::stringstream ss;
 //    std::string expected;
@@ -12,11 +12,16 @@
 #define THEORY_BINARYINTAUTOMATONTEST_H_
 
 
+#include <functional>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 #include "helper/FileHelper.h"
 //#include "theory/mock/MockBinaryIntAutomaton.h"
 #include "theory/BinaryIntAutomaton.h"
+#include "theory/IntAutomaton.h"
+#include "utils/Budget.h"
 
 namespace Vlab {
 namespace Theory {
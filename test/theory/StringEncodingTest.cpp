@@ -0,0 +1,69 @@
+/*
+ * StringEncodingTest.cpp
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "StringEncodingTest.h"
+
+namespace Vlab {
+namespace Theory {
+namespace Test {
+
+using namespace ::testing;
+
+void StringEncodingTest::SetUp() {
+  // classes: the other 252 characters, 'a'-'c' and 'x'
+  encoding_.AddCharacterRange('a', 'c');
+  encoding_.AddString("x");
+  encoding_.Build();
+}
+
+void StringEncodingTest::TearDown() {
+}
+
+TEST_F(StringEncodingTest, Classes) {
+  EXPECT_FALSE(encoding_.is_identity());
+  EXPECT_EQ(3UL, encoding_.get_number_of_classes());
+  EXPECT_EQ(encoding_.Encode('a'), encoding_.Encode('c'));
+  EXPECT_NE(encoding_.Encode('a'), encoding_.Encode('x'));
+  EXPECT_EQ(encoding_.Encode('0'), encoding_.Encode('z'));
+  EXPECT_EQ(3UL, encoding_.get_weight(encoding_.Encode('b')));
+  EXPECT_EQ(1UL, encoding_.get_weight(encoding_.Encode('x')));
+  EXPECT_EQ(252UL, encoding_.get_weight(encoding_.Encode('z')));
+  EXPECT_EQ(0UL, encoding_.get_weight(3));
+}
+
+TEST_F(StringEncodingTest, NarrowTracks) {
+  EXPECT_EQ(2, encoding_.get_number_of_bits());
+
+  StringEncoding two_classes;
+  two_classes.AddString("a");
+  two_classes.Build();
+  EXPECT_EQ(1, two_classes.get_number_of_bits());
+
+  StringEncoding identity;
+  identity.Build();
+  EXPECT_TRUE(identity.is_identity());
+  EXPECT_EQ(8, identity.get_number_of_bits());
+}
+
+TEST_F(StringEncodingTest, WeightOfBitPatterns) {
+  EXPECT_EQ(256UL, encoding_.get_weight("XX"));
+  EXPECT_EQ(255UL, encoding_.get_weight("0X"));
+  EXPECT_EQ(1UL, encoding_.get_weight("1X"));
+  EXPECT_EQ(3UL, encoding_.get_weight("X1"));
+  EXPECT_EQ(253UL, encoding_.get_weight("X0"));
+  EXPECT_EQ(0UL, encoding_.get_weight("11"));
+
+  StringEncoding identity;
+  identity.Build();
+  EXPECT_EQ(1UL, identity.get_weight("01100001"));
+  EXPECT_EQ(16UL, identity.get_weight("0110XXXX"));
+}
+
+} /* namespace Test */
+} /* namespace Theory */
+} /* namespace Vlab */
@@ -0,0 +1,32 @@
+/*
+ * StringEncodingTest.h
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef THEORY_STRINGENCODINGTEST_H_
+#define THEORY_STRINGENCODINGTEST_H_
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "theory/StringEncoding.h"
+
+namespace Vlab {
+namespace Theory {
+namespace Test {
+
+class StringEncodingTest : public ::testing::Test {
+protected:
+  virtual void SetUp();
+  virtual void TearDown();
+
+  StringEncoding encoding_;
+};
+
+} /* namespace Test */
+} /* namespace Theory */
+} /* namespace Vlab */
+
+#endif /* THEORY_STRINGENCODINGTEST_H_ */
@@ -0,0 +1,95 @@
+/*
+ * StringIndexTest.cpp
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "StringIndexTest.h"
+
+namespace Vlab {
+namespace Theory {
+namespace Test {
+
+using namespace ::testing;
+
+void StringIndexTest::SetUp() {
+  subject_auto_ = StringAutomaton::MakeRegexAuto("ab(c|d)e");
+}
+
+void StringIndexTest::TearDown() {
+  delete subject_auto_;
+  Option::Theory::DIRECT_INDEX_CONSTRUCTIONS = true;
+}
+
+bool StringIndexTest::IsResult(std::function<StringAutomaton_ptr()> operation, const std::string expected_regex) {
+  StringAutomaton_ptr expected_auto = StringAutomaton::MakeRegexAuto(expected_regex);
+  Option::Theory::DIRECT_INDEX_CONSTRUCTIONS = true;
+  StringAutomaton_ptr direct_auto = operation();
+  Option::Theory::DIRECT_INDEX_CONSTRUCTIONS = false;
+  StringAutomaton_ptr multitrack_auto = operation();
+  bool is_equal = direct_auto->IsEqual(expected_auto) and multitrack_auto->IsEqual(expected_auto);
+  delete expected_auto;
+  delete direct_auto;
+  delete multitrack_auto;
+  return is_equal;
+}
+
+TEST_F(StringIndexTest, SuffixesAtIndex) {
+  IntAutomaton_ptr index_auto = IntAutomaton::makeIntRange(2, 3);
+  EXPECT_TRUE(IsResult([&]() { return subject_auto_->SuffixesAtIndex(index_auto); }, "(c|d)e|e"));
+  delete index_auto;
+}
+
+TEST_F(StringIndexTest, SubString) {
+  IntAutomaton_ptr start_auto = IntAutomaton::makeIntRange(1, 2);
+  IntAutomaton_ptr length_auto = IntAutomaton::makeInt(2);
+  EXPECT_TRUE(IsResult([&]() { return subject_auto_->SubString(start_auto, length_auto); }, "b(c|d)|(c|d)e"));
+  delete start_auto;
+  delete length_auto;
+}
+
+TEST_F(StringIndexTest, CharAt) {
+  IntAutomaton_ptr index_auto = IntAutomaton::makeInts({ 0, 2 });
+  EXPECT_TRUE(IsResult([&]() { return subject_auto_->CharAt(index_auto); }, "a|c|d"));
+  delete index_auto;
+}
+
+TEST_F(StringIndexTest, RestrictAtIndexTo) {
+  IntAutomaton_ptr index_auto = IntAutomaton::makeInt(2);
+  StringAutomaton_ptr sub_string_auto = StringAutomaton::MakeString("d");
+  EXPECT_TRUE(IsResult([&]() { return subject_auto_->RestrictAtIndexTo(index_auto, sub_string_auto); }, "abde"));
+  delete index_auto;
+  delete sub_string_auto;
+}
+
+TEST_F(StringIndexTest, IndexOfIsTighterPerSubjectString) {
+  StringAutomaton_ptr subject_auto = StringAutomaton::MakeRegexAuto("xabab|abx");
+  StringAutomaton_ptr search_auto = StringAutomaton::MakeString("ab");
+  IntAutomaton_ptr from_index_auto = IntAutomaton::makeIntRange(0, 2);
+  IntAutomaton_ptr expected_auto = IntAutomaton::makeInts({ 0, 1, 3 });
+  expected_auto->setMinus1(true);
+
+  Option::Theory::DIRECT_INDEX_CONSTRUCTIONS = true;
+  IntAutomaton_ptr direct_auto = subject_auto->IndexOf(search_auto, from_index_auto);
+  Option::Theory::DIRECT_INDEX_CONSTRUCTIONS = false;
+  IntAutomaton_ptr multitrack_auto = subject_auto->IndexOf(search_auto, from_index_auto);
+
+  EXPECT_TRUE(direct_auto->checkEquivalance(expected_auto));
+  // the multi-track construction may over-approximate
+  IntAutomaton_ptr difference_auto = direct_auto->Difference(multitrack_auto);
+  EXPECT_TRUE(difference_auto->isEmptyLanguage());
+
+  delete subject_auto;
+  delete search_auto;
+  delete from_index_auto;
+  delete expected_auto;
+  delete direct_auto;
+  delete multitrack_auto;
+  delete difference_auto;
+}
+
+} /* namespace Test */
+} /* namespace Theory */
+} /* namespace Vlab */
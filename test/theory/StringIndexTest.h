@@ -0,0 +1,45 @@
+/*
+ * StringIndexTest.h
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef THEORY_STRINGINDEXTEST_H_
+#define THEORY_STRINGINDEXTEST_H_
+
+#include <functional>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "theory/IntAutomaton.h"
+#include "theory/StringAutomaton.h"
+#include "theory/options/Theory.h"
+
+namespace Vlab {
+namespace Theory {
+namespace Test {
+
+/**
+ * Compares the direct index constructions with the multi-track constructions
+ */
+class StringIndexTest : public ::testing::Test {
+protected:
+  virtual void SetUp();
+  virtual void TearDown();
+
+  /**
+   * @return true if the operation gives the language of the expected regex with both constructions
+   */
+  bool IsResult(std::function<StringAutomaton_ptr()> operation, const std::string expected_regex);
+
+  StringAutomaton_ptr subject_auto_;
+};
+
+} /* namespace Test */
+} /* namespace Theory */
+} /* namespace Vlab */
+
+#endif /* THEORY_STRINGINDEXTEST_H_ */
@@ -0,0 +1,80 @@
+/*
+ * TransducerTest.cpp
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "TransducerTest.h"
+
+namespace Vlab {
+namespace Theory {
+namespace Test {
+
+using namespace ::testing;
+
+void TransducerTest::SetUp() {
+}
+
+void TransducerTest::TearDown() {
+}
+
+bool TransducerTest::IsReplaceResult(const std::string subject_regex, const std::string search,
+                                     const std::string replace_regex, const std::string expected_regex) {
+  StringAutomaton_ptr subject_auto = StringAutomaton::MakeRegexAuto(subject_regex);
+  StringAutomaton_ptr search_auto = StringAutomaton::MakeString(search);
+  StringAutomaton_ptr replace_auto = StringAutomaton::MakeRegexAuto(replace_regex);
+  StringAutomaton_ptr expected_auto = StringAutomaton::MakeRegexAuto(expected_regex);
+  StringAutomaton_ptr result_auto = subject_auto->Replace(search_auto, replace_auto);
+  bool is_equal = result_auto->IsEqual(expected_auto);
+  delete subject_auto;
+  delete search_auto;
+  delete replace_auto;
+  delete expected_auto;
+  delete result_auto;
+  return is_equal;
+}
+
+TEST_F(TransducerTest, ReplaceConstantFromLeftToRight) {
+  // occurrences do not overlap
+  EXPECT_TRUE(IsReplaceResult("aaa", "aa", "b", "ba"));
+  EXPECT_TRUE(IsReplaceResult("aaaa", "aa", "b", "bb"));
+  EXPECT_TRUE(IsReplaceResult("ab|ba|c", "a", "d", "db|bd|c"));
+}
+
+TEST_F(TransducerTest, ReplaceFollowsPartialMatches) {
+  // after a failed match the matched suffix is a prefix of the search string
+  EXPECT_TRUE(IsReplaceResult("ababa", "aba", "x", "xba"));
+  EXPECT_TRUE(IsReplaceResult("aabab", "abab", "x", "ax"));
+  EXPECT_TRUE(IsReplaceResult("(ab)*", "ab", "c", "c*"));
+}
+
+TEST_F(TransducerTest, ReplaceWithRegularLanguage) {
+  EXPECT_TRUE(IsReplaceResult("ab", "a", "c|dd", "cb|ddb"));
+  EXPECT_TRUE(IsReplaceResult("aba", "a", "c*", "c*bc*"));
+}
+
+TEST_F(TransducerTest, PreImageOfReplace) {
+  Transducer transducer = StringAutomaton::MakeReplaceTransducer("a", "b");
+  StringAutomaton_ptr image_auto = StringAutomaton::MakeString("bb");
+  StringAutomaton_ptr range_auto = StringAutomaton::MakeRegexAuto("(a|b|c)*");
+  StringAutomaton_ptr expected_auto = StringAutomaton::MakeRegexAuto("(a|b)(a|b)");
+
+  StringAutomaton_ptr pre_image_auto = image_auto->PreTransduce(transducer, range_auto);
+  EXPECT_TRUE(pre_image_auto->IsEqual(expected_auto));
+
+  // inverse of the image
+  StringAutomaton_ptr result_auto = pre_image_auto->Transduce(transducer);
+  EXPECT_TRUE(result_auto->IsEqual(image_auto));
+
+  delete image_auto;
+  delete range_auto;
+  delete expected_auto;
+  delete pre_image_auto;
+  delete result_auto;
+}
+
+} /* namespace Test */
+} /* namespace Theory */
+} /* namespace Vlab */
@@ -0,0 +1,40 @@
+/*
+ * TransducerTest.h
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef THEORY_TRANSDUCERTEST_H_
+#define THEORY_TRANSDUCERTEST_H_
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "theory/StringAutomaton.h"
+#include "theory/Transducer.h"
+
+namespace Vlab {
+namespace Theory {
+namespace Test {
+
+class TransducerTest : public ::testing::Test {
+protected:
+  virtual void SetUp();
+  virtual void TearDown();
+
+  /**
+   * @return true if replacing the search string with the replacement language in the subject language gives the
+   * expected language
+   */
+  bool IsReplaceResult(const std::string subject_regex, const std::string search, const std::string replace_regex,
+                       const std::string expected_regex);
+};
+
+} /* namespace Test */
+} /* namespace Theory */
+} /* namespace Vlab */
+
+#endif /* THEORY_TRANSDUCERTEST_H_ */
@@ -0,0 +1,73 @@
+/*
+ * BudgetTest.cpp
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "BudgetTest.h"
+
+namespace Vlab {
+namespace Util {
+namespace Test {
+
+using namespace ::testing;
+
+void BudgetTest::SetUp() {
+}
+
+void BudgetTest::TearDown() {
+}
+
+TEST_F(BudgetTest, InactiveBudgetHasNoLimits) {
+  EXPECT_FALSE(Budget::is_active());
+  EXPECT_FALSE(Budget::IsExceededByAutomaton(1000000, 1000000));
+  EXPECT_NO_THROW(Budget::CheckStates(1000000));
+}
+
+TEST_F(BudgetTest, ExceededLimitIsRecordedUntilTheScopeEnds) {
+  {
+    Budget::Scope scope(0, 10, 100);
+    EXPECT_TRUE(Budget::is_active());
+    EXPECT_FALSE(Budget::IsExceededByStates(10));
+    EXPECT_NO_THROW(Budget::Check());
+
+    EXPECT_TRUE(Budget::IsExceededByAutomaton(5, 101));
+    // smaller automata do not clear it, the next check stops the query
+    EXPECT_TRUE(Budget::IsExceededByStates(1));
+    EXPECT_THROW(Budget::Check(), BudgetExceeded);
+  }
+  EXPECT_FALSE(Budget::is_active());
+
+  Budget::Scope scope(0, 10, 100);
+  EXPECT_FALSE(Budget::IsExceeded());
+  EXPECT_THROW(Budget::CheckStates(11), BudgetExceeded);
+}
+
+TEST_F(BudgetTest, InnerScopeKeepsOuterLimits) {
+  Budget::Scope scope(0, 10, 0);
+  {
+    Budget::Scope inner_scope(0, 0, 0);
+    EXPECT_TRUE(Budget::IsExceededByStates(11));
+  }
+  EXPECT_TRUE(Budget::is_active());
+  EXPECT_TRUE(Budget::IsExceeded());
+}
+
+TEST_F(BudgetTest, ConstructionsDoNotThrow) {
+  Budget::Scope scope(0, 2, 0);
+  Theory::StringAutomaton_ptr string_auto = nullptr;
+  ASSERT_NO_THROW(string_auto = Theory::StringAutomaton::MakeString("abcd"));
+  EXPECT_TRUE(Budget::IsExceeded());
+
+  Theory::StringAutomaton_ptr upper_case_auto = nullptr;
+  ASSERT_NO_THROW(upper_case_auto = string_auto->Transduce(Theory::StringAutomaton::MakeToUpperCaseTransducer()));
+  EXPECT_THROW(Budget::Check(), BudgetExceeded);
+  delete string_auto;
+  delete upper_case_auto;
+}
+
+} /* namespace Test */
+} /* namespace Util */
+} /* namespace Vlab */
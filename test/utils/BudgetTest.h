@@ -0,0 +1,31 @@
+/*
+ * BudgetTest.h
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef UTILS_BUDGETTEST_H_
+#define UTILS_BUDGETTEST_H_
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "theory/StringAutomaton.h"
+#include "utils/Budget.h"
+
+namespace Vlab {
+namespace Util {
+namespace Test {
+
+class BudgetTest : public ::testing::Test {
+protected:
+  virtual void SetUp();
+  virtual void TearDown();
+};
+
+} /* namespace Test */
+} /* namespace Util */
+} /* namespace Vlab */
+
+#endif /* UTILS_BUDGETTEST_H_ */
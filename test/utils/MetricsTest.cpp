@@ -0,0 +1,154 @@
+/*
+ * MetricsTest.cpp
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#include "MetricsTest.h"
+
+namespace Vlab {
+namespace Util {
+namespace Test {
+
+class PublicMetrics : public Metrics {
+ public:
+  using Metrics::NUMBER_OF_BUCKETS;
+  using Metrics::get_bucket_bound_us;
+};
+
+using namespace ::testing;
+
+void MetricsTest::SetUp() {
+  // metrics are process-wide, other tests record them too
+  Metrics::Reset();
+}
+
+void MetricsTest::TearDown() {
+  Metrics::Reset();
+}
+
+std::string MetricsTest::GetHistogramText(const std::string phase, const std::vector<unsigned long> cumulative_counts,
+                                          const std::string sum, const unsigned long count) {
+  const std::vector<std::string> bounds { "1e-06", "4e-06", "1.6e-05", "6.4e-05", "0.000256", "0.001024", "0.004096",
+                                          "0.016384", "0.065536", "0.262144", "1.04858", "4.1943", "16.7772",
+                                          "67.1089", "268.435", "+Inf" };
+  const std::string label = "phase=\"" + phase + "\"";
+  std::string text;
+  for (std::size_t bucket = 0; bucket < bounds.size(); ++bucket) {
+    text += "abc_phase_duration_seconds_bucket{" + label + ",le=\"" + bounds[bucket] + "\"} "
+        + std::to_string(cumulative_counts[bucket]) + "\n";
+  }
+  text += "abc_phase_duration_seconds_sum{" + label + "} " + sum + "\n";
+  text += "abc_phase_duration_seconds_count{" + label + "} " + std::to_string(count) + "\n";
+  return text;
+}
+
+TEST_F(MetricsTest, Increment) {
+  Metrics::Increment(Metrics::Counter::SAT);
+  Metrics::Increment(Metrics::Counter::SAT);
+  Metrics::Increment(Metrics::Counter::CACHE_HITS, 5);
+  auto snapshot = Metrics::GetSnapshot();
+  EXPECT_EQ(2, snapshot["sat"]);
+  EXPECT_EQ(5, snapshot["cache_hits"]);
+  EXPECT_EQ(0, snapshot["unsat"]);
+
+  Metrics::Reset();
+  EXPECT_EQ(0, Metrics::GetSnapshot()["sat"]);
+}
+
+TEST_F(MetricsTest, ConcurrentUpdates) {
+  const unsigned long number_of_threads = 8, number_of_updates = 10000;
+  std::vector<std::thread> threads;
+  for (unsigned long t = 0; t < number_of_threads; ++t) {
+    threads.push_back(std::thread([t, number_of_threads, number_of_updates]() {
+      // values of the threads interleave, the largest one is written by the last thread
+      for (unsigned long i = 0; i < number_of_updates; ++i) {
+        Metrics::UpdateMaximum(Metrics::Maximum::DFA_STATES, i * number_of_threads + t);
+        Metrics::Increment(Metrics::Counter::AUTOMATA);
+      }
+    }));
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  auto snapshot = Metrics::GetSnapshot();
+  EXPECT_EQ(number_of_threads * number_of_updates - 1, snapshot["dfa_states"]);
+  EXPECT_EQ(number_of_threads * number_of_updates, snapshot["automata"]);
+
+  // a smaller value does not lower the maximum
+  Metrics::UpdateMaximum(Metrics::Maximum::DFA_STATES, 1);
+  EXPECT_EQ(number_of_threads * number_of_updates - 1, Metrics::GetSnapshot()["dfa_states"]);
+}
+
+TEST_F(MetricsTest, HistogramBucketBoundaries) {
+  // the constant has no definition, it is copied before gtest takes it by reference
+  const int number_of_buckets = PublicMetrics::NUMBER_OF_BUCKETS;
+  ASSERT_EQ(16, number_of_buckets);
+  EXPECT_EQ(1, PublicMetrics::get_bucket_bound_us(0));
+  EXPECT_EQ(4, PublicMetrics::get_bucket_bound_us(1));
+  EXPECT_EQ(16, PublicMetrics::get_bucket_bound_us(2));
+  EXPECT_EQ(268435456, PublicMetrics::get_bucket_bound_us(14));
+
+  // a bound belongs to its bucket, one more microsecond goes to the next one
+  Metrics::Observe(Metrics::Phase::PARSE, std::chrono::microseconds(0));
+  Metrics::Observe(Metrics::Phase::PARSE, std::chrono::microseconds(1));
+  Metrics::Observe(Metrics::Phase::PARSE, std::chrono::microseconds(2));
+  Metrics::Observe(Metrics::Phase::PARSE, std::chrono::microseconds(4));
+  Metrics::Observe(Metrics::Phase::PARSE, std::chrono::microseconds(5));
+  Metrics::Observe(Metrics::Phase::PARSE, std::chrono::microseconds(268435456));
+  Metrics::Observe(Metrics::Phase::PARSE, std::chrono::microseconds(268435457));
+  auto snapshot = Metrics::GetSnapshot();
+  EXPECT_EQ(2, snapshot["parse_le_1_us"]);
+  EXPECT_EQ(2, snapshot["parse_le_4_us"]);
+  EXPECT_EQ(1, snapshot["parse_le_16_us"]);
+  EXPECT_EQ(1, snapshot["parse_le_268435456_us"]);
+  EXPECT_EQ(1, snapshot["parse_le_inf_us"]);
+  EXPECT_EQ(0, snapshot.count("parse_le_64_us"));
+  EXPECT_EQ(7, snapshot["parse_count"]);
+  EXPECT_EQ(536870925, snapshot["parse_sum_us"]);
+}
+
+TEST_F(MetricsTest, GetText) {
+  Metrics::Increment(Metrics::Counter::SAT, 2);
+  Metrics::Increment(Metrics::Counter::CACHE_MISSES);
+  Metrics::UpdateMaximum(Metrics::Maximum::DFA_STATES, 42);
+  Metrics::Observe(Metrics::Phase::SOLVE, std::chrono::microseconds(3));
+  Metrics::Observe(Metrics::Phase::SOLVE, std::chrono::microseconds(20));
+
+  std::string expected = "# TYPE abc_sat_total counter\n"
+                         "abc_sat_total 2\n"
+                         "# TYPE abc_unsat_total counter\n"
+                         "abc_unsat_total 0\n"
+                         "# TYPE abc_unknown_total counter\n"
+                         "abc_unknown_total 0\n"
+                         "# TYPE abc_stopped_queries_total counter\n"
+                         "abc_stopped_queries_total 0\n"
+                         "# TYPE abc_cache_hits_total counter\n"
+                         "abc_cache_hits_total 0\n"
+                         "# TYPE abc_cache_misses_total counter\n"
+                         "abc_cache_misses_total 1\n"
+                         "# TYPE abc_automata_total counter\n"
+                         "abc_automata_total 0\n"
+                         "# TYPE abc_peak_dfa_states gauge\n"
+                         "abc_peak_dfa_states 42\n"
+                         "# TYPE abc_phase_duration_seconds histogram\n";
+  const std::vector<std::string> phases { "parse", "initialize", "initializer", "syntactic_processor",
+                                          "syntactic_optimizer", "alphabet_partitioner", "equivalence_generator",
+                                          "dependency_slicer", "component_canonicalizer", "implication_runner",
+                                          "formula_optimizer", "constraint_sorter", "constraint_solver", "solve",
+                                          "count", "models" };
+  for (auto& phase : phases) {
+    if (phase == "solve") {
+      expected += GetHistogramText(phase, { 0, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2 }, "2.3e-05", 2);
+    } else {
+      expected += GetHistogramText(phase, std::vector<unsigned long>(16, 0), "0", 0);
+    }
+  }
+  EXPECT_EQ(expected, Metrics::GetText());
+}
+
+} /* namespace Test */
+} /* namespace Util */
+} /* namespace Vlab */
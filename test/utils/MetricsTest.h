@@ -0,0 +1,41 @@
+/*
+ * MetricsTest.h
+ *
+ *   Copyright: Copyright 2015 The ABC Authors. All rights reserved.
+ *              Use of this source code is governed license that can
+ *              be found in the COPYING file.
+ */
+
+#ifndef UTILS_METRICSTEST_H_
+#define UTILS_METRICSTEST_H_
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "utils/Metrics.h"
+
+namespace Vlab {
+namespace Util {
+namespace Test {
+
+class MetricsTest : public ::testing::Test {
+protected:
+  virtual void SetUp();
+  virtual void TearDown();
+
+  /**
+   * Prometheus lines of the duration histogram of a phase, with the cumulative count of each bucket
+   */
+  std::string GetHistogramText(const std::string phase, const std::vector<unsigned long> cumulative_counts,
+                               const std::string sum, const unsigned long count);
+};
+
+} /* namespace Test */
+} /* namespace Util */
+} /* namespace Vlab */
+
+#endif /* UTILS_METRICSTEST_H_ */